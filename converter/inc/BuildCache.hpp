@@ -0,0 +1,53 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace orbtool
+{
+
+    namespace fs = std::filesystem;
+
+    // Content addressed cache of converted input files. An entry holds the
+    // objects a reader produced for one file and is keyed by a hash of the
+    // file's bytes, the cache version and the conversion options, so an
+    // entry never has to be invalidated. Only self contained formats are
+    // cached, files referencing other inputs (.rorb) are always read.
+    class BuildCache
+    {
+    private:
+        fs::path m_directory;
+        std::string m_options;
+        uint32_t m_hits = 0u;
+        uint32_t m_misses = 0u;
+        uint64_t m_bytesLoaded = 0u;
+    private:
+        fs::path EntryPath(uint64_t key) const;
+    public:
+        // @member: bump whenever a reader or the serialized objects change
+        static constexpr uint32_t sVersion = 2u;
+
+        // @param directory: where the entries are stored. Created if it doesn't exist
+        // @param options: conversion options that change the result, e.g. "lods=3"
+        BuildCache(const fs::path& directory, const std::string& options);
+
+        // @method: returns whether files of this type can be cached
+        static bool IsCacheable(const fs::path& file);
+
+        // @method: hashes the file's bytes together with the version and options
+        uint64_t Key(const fs::path& file, bool triangulate) const;
+
+        // @method: appends the cached objects to the intermediate
+        // @return: false on a cache miss, the intermediate is unchanged then
+        bool Load(uint64_t key, OrbIntermediate* intermediate);
+
+        // @method: stores the objects of the intermediate. Intermediates holding
+        //  objects other than meshes, materials and textures are not stored
+        void Store(uint64_t key, const OrbIntermediate& intermediate) const;
+
+        void PrintStatistics() const;
+    };
+
+}
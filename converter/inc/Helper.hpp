@@ -11,6 +11,13 @@ namespace orbtool
 
     extern void Do_Analyze(const char* file, const char* item);
     extern void Do_ReadFile(const fs::path& file, OrbIntermediate* intermediate, bool triangulateMeshes = false);
-    extern void Do_WriteAppend(const char*const* files, uint32_t numFiles, const char* output, bool append, bool triangulateMeshes = false);
+    extern void Do_GenerateTangents(OrbIntermediate* intermediate);
+    extern void Do_ProcessTextures(OrbIntermediate* intermediate);
+    extern void Do_BuildLods(OrbIntermediate* intermediate, uint32_t numLods);
+    extern void Do_BuildClusters(OrbIntermediate* intermediate);
+    extern void Do_CompressAnimations(OrbIntermediate* intermediate);
+    extern void Do_BakeSplines(OrbIntermediate* intermediate);
+    extern void Do_CookCollisionMeshes(OrbIntermediate* intermediate);
+    extern void Do_WriteAppend(const char*const* files, uint32_t numFiles, const char* output, bool append, bool triangulateMeshes = false, uint32_t numLods = 0u, bool buildClusters = false, bool processTextures = false, const char* cacheDirectory = nullptr, const char* loadTrace = nullptr);
 
 }
\ No newline at end of file
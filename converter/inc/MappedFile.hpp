@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+
+namespace orbtool
+{
+
+    namespace fs = std::filesystem;
+
+    // Read-only memory mapping of a whole file. The mapped bytes stay valid
+    // until the MappedFile is closed or destroyed.
+    class MappedFile
+    {
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0u;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#else
+        int m_file = -1;
+#endif
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { Close(); }
+
+        // @method: maps the file into memory
+        // @return: false if the file can't be opened or mapped
+        bool Open(const fs::path& filepath);
+        void Close();
+
+        const uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+        bool IsOpen() const;
+    };
+
+}
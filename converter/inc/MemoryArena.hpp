@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+
+namespace orbtool
+{
+
+    // Bump allocator handing out memory from large blocks. Everything is
+    // released at once when the arena is destroyed, so only trivially
+    // destructible objects may be placed in it.
+    class MemoryArena
+    {
+    private:
+        struct Block
+        {
+            std::unique_ptr<uint8_t[]> data;
+            size_t size;
+            size_t used;
+        };
+        std::vector<Block> m_blocks;
+        size_t m_blockSize;
+        size_t m_bytesAllocated = 0u;
+    public:
+        explicit MemoryArena(size_t blockSize = 1024u * 1024u) :
+            m_blockSize(blockSize)
+        {}
+        MemoryArena(const MemoryArena&) = delete;
+        MemoryArena& operator=(const MemoryArena&) = delete;
+
+        // @method: allocates uninitialized memory
+        // @param size: number of bytes
+        // @param alignment: must be a power of two
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+        {
+            if (!m_blocks.empty())
+            {
+                auto& block = m_blocks.back();
+                auto offset = (reinterpret_cast<uintptr_t>(block.data.get()) + block.used + alignment - 1) & ~(alignment - 1);
+                offset -= reinterpret_cast<uintptr_t>(block.data.get());
+                if (offset + size <= block.size)
+                {
+                    block.used = offset + size;
+                    m_bytesAllocated += size;
+                    return block.data.get() + offset;
+                }
+            }
+
+            // Oversized allocations get a block of their own
+            const auto blockSize = std::max(m_blockSize, size + alignment);
+            m_blocks.push_back(Block{ std::make_unique<uint8_t[]>(blockSize), blockSize, 0u });
+            return Allocate(size, alignment);
+        }
+
+        template<typename T, typename...Args>
+        T* New(Args&&...args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+            return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        template<typename T>
+        T* NewArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+            auto data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+            for (auto i = 0u; i < count; ++i)
+                new (data + i) T();
+            return data;
+        }
+
+        // @method: returns the number of bytes handed out so far
+        size_t BytesAllocated() const { return m_bytesAllocated; }
+    };
+
+}
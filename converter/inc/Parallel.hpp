@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <execution>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+namespace orbtool
+{
+
+    // @method: std::for_each with the parallel execution policy.
+    //  Exceptions thrown by f would terminate the program, so the first
+    //  one is caught and rethrown on the calling thread instead
+    template<typename It, typename F>
+    void ParallelForEach(It begin, It end, F&& f)
+    {
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::for_each(std::execution::par, begin, end, [&](auto&& item) {
+            try
+            {
+                f(item);
+            }
+            catch (...)
+            {
+                std::scoped_lock<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // @method: calls f(i) for every i in [0, count) in parallel
+    template<typename F>
+    void ParallelFor(size_t count, F&& f)
+    {
+        std::vector<size_t> indices(count);
+        std::iota(indices.begin(), indices.end(), size_t(0));
+        ParallelForEach(indices.begin(), indices.end(), [&](size_t i) { f(i); });
+    }
+
+}
@@ -3,17 +3,93 @@
 #include "Reader.hpp"
 
 #include <filesystem>
+#include <string_view>
+#include <unordered_map>
 
 namespace orbtool
 {
 
     namespace fs = std::filesystem;
 
+    class XmlStream;
+
+    // Reads the geometries, materials and images of a Collada document. The
+    // file is parsed as a stream of xml events, without building a tree, and
+    // numbers are converted straight into the mesh buffers. Only the sources
+    // of the geometry being read are kept in memory.
     class DaeReader : public Reader
     {
     private:
+        enum class UpAxis
+        {
+            X_UP,
+            Y_UP,
+            Z_UP
+        };
+        // @brief: a <source> of the current geometry
+        struct DaeSource
+        {
+            std::vector<float> values;
+            uint32_t stride = 1u;
+        };
+        struct DaeInput
+        {
+            std::string semantic;
+            std::string source;
+            uint32_t offset = 0u;
+            uint32_t set = 0u;
+        };
+        struct DaeEffect
+        {
+            Vector4f diffuse = Vector4f::Ones();
+            Vector4f specular = Vector4f::Zero();
+            float shininess = 0.f;
+            // @member: image ids of the textures
+            std::string diffuseImage;
+            std::string normalImage;
+        };
+        struct DaeMaterial
+        {
+            std::string name;
+            std::string effect;
+        };
+        struct DaeImage
+        {
+            std::string name;
+            fs::path path;
+        };
+        struct DaeGeometry
+        {
+            std::string id;
+            std::string name;
+            // @member: the material symbol of the first primitive group
+            std::string symbol;
+            OrbMesh mesh;
+        };
+        // @brief: the sources and vertices of the geometry being read
+        struct GeometryState;
+        bool m_warnOnQuads = true;
+        float m_unitScale = 1.f;
+        UpAxis m_upAxis = UpAxis::Y_UP;
+        std::unordered_map<std::string, DaeImage> m_images;
+        std::unordered_map<std::string, DaeEffect> m_effects;
+        std::unordered_map<std::string, DaeMaterial> m_materials;
+        // @member: geometry id -> material symbol -> material id
+        std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_bindings;
+        std::vector<DaeGeometry> m_geometries;
+    private:
+        static std::string ReadText(XmlStream* xml);
+        void ReadImage(XmlStream* xml);
+        void ReadEffect(XmlStream* xml);
+        void ReadMaterial(XmlStream* xml);
+        void ReadGeometry(XmlStream* xml);
+        void ReadPrimitives(XmlStream* xml, GeometryState* state, DaeGeometry* geometry);
+        void ReadInstanceGeometry(XmlStream* xml);
+        Vector3f ConvertAxis(const Vector3f& v) const;
+        void AppendObjects();
     public:
+        void WarnOnQuads(bool warn) { m_warnOnQuads = warn; }
         bool ReadFile(const fs::path& filepath, OrbIntermediate* intermediate) override;
     };
 
-}
\ No newline at end of file
+}
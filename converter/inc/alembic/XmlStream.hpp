@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace orbtool
+{
+
+    enum class XmlEvent
+    {
+        START_ELEMENT,
+        END_ELEMENT,
+        TEXT,
+        END_OF_DOCUMENT
+    };
+
+    // Pull style SAX parser over a buffer, usually a mapped file. No tree is
+    // built, every event only references the buffer, so arbitrarily large
+    // documents can be read with constant memory. Entities are not decoded
+    // in text events, use Decode() where they are expected.
+    class XmlStream
+    {
+    private:
+        struct Attribute
+        {
+            std::string_view name;
+            std::string_view value;
+        };
+        const char* m_begin;
+        const char* m_cursor;
+        const char* m_end;
+        std::string_view m_name;
+        std::string_view m_text;
+        std::vector<Attribute> m_attributes;
+        // @member: a self closing element was returned, its end comes next
+        bool m_pendingEnd = false;
+    private:
+        bool StartsWith(std::string_view str) const;
+        void SkipPast(std::string_view terminator);
+        void SkipWhitespace();
+        std::string_view ReadName();
+        void ReadAttributes();
+    public:
+        XmlStream(const char* begin, const char* end);
+
+        // @method: advances to the next event. Whitespace only text is skipped
+        XmlEvent Next();
+
+        // @method: the name of the current element (START_ELEMENT and END_ELEMENT)
+        std::string_view Name() const { return m_name; }
+        // @method: the text of a TEXT event
+        std::string_view Text() const { return m_text; }
+        // @method: returns the raw value of an attribute of the current element or an empty view
+        std::string_view GetAttribute(std::string_view name) const;
+
+        // @method: returns the offset of the cursor, used for error messages
+        size_t Position() const { return static_cast<size_t>(m_cursor - m_begin); }
+
+        // @method: replaces the predefined entities (&amp; &lt; &gt; &quot; &apos;)
+        static std::string Decode(std::string_view str);
+    };
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Compresses the sampled poses of an animation clip. Every channel of
+    // every joint is reduced to the keys that can't be reconstructed by
+    // interpolating their neighbours within a tolerance, rotations are
+    // quantized to 48 bits. Tracks are independent and compressed in parallel.
+    class AnimationCompressor
+    {
+    private:
+        // @method: returns the frames of the keys to be kept
+        // @param error: returns the interpolation error at a frame if the keys were at first and last
+        template<typename Error>
+        static std::vector<uint32_t> ReduceKeys(uint32_t numFrames, float tolerance, Error&& error);
+    public:
+        // @member: maximum angle in radians between a sampled and a reconstructed rotation
+        static constexpr float sRotationTolerance = 0.001f;
+        // @member: maximum distance in meters between a sampled and a reconstructed translation
+        static constexpr float sTranslationTolerance = 0.0001f;
+        static constexpr float sScaleTolerance = 0.0001f;
+
+        // @method: replaces the samples of the clip with compressed tracks.
+        //  Compressed clips are left untouched
+        static void Compress(OrbAnimationClip* clip);
+    };
+
+}
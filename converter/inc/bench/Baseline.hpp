@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace orbtool
+{
+
+    namespace fs = std::filesystem;
+
+    // @brief: the measurements of one stage run over one corpus entry
+    struct StageResult
+    {
+        std::string corpus;
+        std::string stage;
+        double seconds = 0.0;
+        // @member: bytes read (readers) or written (OrbFile)
+        uint64_t bytes = 0u;
+        // @member: vertices produced or written. 0 if the stage has no vertices
+        uint64_t vertices = 0u;
+        // @member: the highest resident set size observed while the stage ran
+        uint64_t peakRss = 0u;
+
+        std::string Key() const { return corpus + "/" + stage; }
+        double MegabytesPerSecond() const { return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0; }
+        double VerticesPerSecond() const { return seconds > 0.0 ? vertices / seconds : 0.0; }
+        double PeakRssMegabytes() const { return peakRss / (1024.0 * 1024.0); }
+    };
+
+    // Stored results of a previous benchmark run. The file is a small JSON
+    // document keyed by "<corpus>/<stage>":
+    //  { "version": 1, "results": { "grid_255/FbxReader": { "mbps": 180.2,
+    //    "verticesPerSecond": 3.1e6, "peakRssMB": 42.0 }, ... } }
+    class Baseline
+    {
+    private:
+        struct Entry
+        {
+            double megabytesPerSecond = 0.0;
+            double verticesPerSecond = 0.0;
+            double peakRssMegabytes = 0.0;
+        };
+        std::map<std::string, Entry> m_entries;
+    public:
+        static constexpr uint32_t sVersion = 1u;
+
+        bool Load(const fs::path& path);
+        static bool Save(const fs::path& path, const std::vector<StageResult>& results);
+
+        // @method: logs every stage that regressed past the threshold
+        // @param threshold: allowed relative change, e.g. 0.1 allows the throughput
+        //  to drop and the peak memory to grow by 10%
+        // @return: the number of regressions
+        uint32_t Compare(const std::vector<StageResult>& results, double threshold) const;
+    };
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace orbtool
+{
+
+    using namespace Eigen;
+    namespace fs = std::filesystem;
+
+    enum class SyntheticShape : uint8_t
+    {
+        GRID,
+        SPHERE,
+        SOUP
+    };
+
+    // @brief: an indexed triangle mesh generated for the benchmark corpus
+    struct SyntheticMesh
+    {
+        std::string name;
+        std::vector<Vector3f> positions;
+        std::vector<Vector3f> normals;
+        std::vector<Vector2f> uvs;
+        std::vector<uint32_t> indices;
+    };
+
+    // Generates the meshes of the benchmark corpus and writes them in the
+    // formats the converter reads. The output is deterministic, so two runs
+    // with the same parameters convert exactly the same bytes.
+    class SyntheticMeshes
+    {
+    public:
+        // @method: a flat grid of (resolution + 1)^2 vertices
+        static SyntheticMesh Grid(uint32_t resolution);
+
+        // @method: a uv sphere with (rings + 1) * (segments + 1) vertices
+        static SyntheticMesh Sphere(uint32_t rings, uint32_t segments);
+
+        // @method: unconnected triangles with random positions. Every triangle
+        //  has its own three vertices, so nothing can be welded
+        static SyntheticMesh Soup(uint32_t numTriangles, uint32_t seed);
+
+        // @method: generates a mesh of the given shape with roughly numVertices vertices
+        static SyntheticMesh Generate(SyntheticShape shape, uint32_t numVertices);
+
+        // @method: writes the mesh as a single wavefront object
+        static bool WriteObj(const SyntheticMesh& mesh, const fs::path& path);
+
+        // @method: writes a binary fbx (version 7500) with one model and one geometry
+        // @param compressArrays: deflates the geometry arrays like most exporters do
+        static bool WriteFbx(const SyntheticMesh& mesh, const fs::path& path, bool compressArrays);
+
+        // @method: writes a raw orb file that declares one material per 64
+        //  triangles of the mesh, so the parser's workload scales with the corpus
+        static bool WriteRorb(const SyntheticMesh& mesh, const fs::path& path);
+    };
+
+}
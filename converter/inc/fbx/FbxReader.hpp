@@ -15,17 +15,43 @@ namespace orbtool
     private:
         bool m_warnOnQuads = true;
         FBXInterType m_fbx;
+        // @member: joints of the skeleton in the order they are written, parents first
+        std::vector<const FBXModel*> m_joints;
+        std::unordered_map<const FBXModel*, uint32_t> m_jointIndices;
+        std::string m_skeletonName;
+    public:
+        // @member: fbx times are stored in ticks
+        static constexpr int64_t sTicksPerSecond = 46186158000ll;
+        // @member: rate at which animation stacks are sampled into clips
+        static constexpr float sAnimationSampleRate = 30.f;
+        // @member: fbx files are in centimeters
+        static constexpr double sUnitScale = 0.01;
     private:
         static Quaterniond QuatFromEuler(Vector3d euler);
+        // @method: returns the local transform of a model with the given animated properties
+        static Matrix4d LocalTransform(const FBXModel* model, const Vector3d& translation, const Vector3d& rotation, const Vector3d& scaling);
+        // @method: converts a transform in centimeters to a pose in meters
+        static JointPose ToJointPose(const Matrix4d& transform);
 
         std::unordered_map<int64_t, std::shared_ptr<FBXInterModel>>::iterator TryInsert(std::shared_ptr<FBXModel> model);
 
-        void FBXGeometryAppendToMesh(const FBXGeometry* geometry, OrbMesh* mesh);
-        void LoadPositions(const FBXGeometry* geometry, OrbMesh* mesh);
-        void LoadNormals(const FBXGeometry* geometry, OrbMesh* mesh);
-        void LoadTangents(const FBXGeometry* geometry, OrbMesh* mesh);
-        void LoadUVs(const FBXGeometry* geometry, OrbMesh* mesh);
-        void CleanupGeometry(OrbMesh* mesh);
+        // @method: builds the vertex data of a single geometry. Geometries are
+        //  independent, so this is called for all of them in parallel
+        void LoadGeometry(const FBXGeometry* geometry, OrbMesh* tmpMesh) const;
+        // @method: appends a loaded geometry as a submesh
+        static void AppendGeometry(const OrbMesh& tmpMesh, OrbMesh* mesh);
+        void LoadPositions(const FBXGeometry* geometry, OrbMesh* mesh) const;
+        void LoadNormals(const FBXGeometry* geometry, OrbMesh* mesh) const;
+        void LoadTangents(const FBXGeometry* geometry, OrbMesh* mesh) const;
+        void LoadUVs(const FBXGeometry* geometry, OrbMesh* mesh) const;
+        void CleanupGeometry(OrbMesh* mesh) const;
+
+        // @method: collects the bones of all skins and their ancestors into one
+        //  skeleton and computes the joint influences of the skinned geometries
+        void BuildSkeleton(const FBXData* data, OrbIntermediate* orb);
+        // @method: samples every animation stack into a clip of the skeleton
+        void BuildAnimations(const FBXData* data, OrbIntermediate* orb) const;
+        static void LoadSkinWeights(FBXGeometry* geometry, const std::unordered_map<const FBXModel*, uint32_t>& jointIndices);
 
         static MappingInformationType LoadMIT(const FBXNode* mitNode);
         static ReferenceInformationType LoadRIT(const FBXNode* ritNode);
@@ -36,6 +62,8 @@ namespace orbtool
         static void LoadConnections(const FBXNode* connectionsNode, FBXData* data);
         static void LoadTextures(const FBXNode* objectsNode, FBXData* data);
         static void LoadAttributes(const FBXNode* objectsNode, FBXData* data);
+        static void LoadDeformers(const FBXNode* objectsNode, FBXData* data);
+        static void LoadAnimations(const FBXNode* objectsNode, FBXData* data);
         static void GetFBXGeometry(FBXGeometry* geometry, const FBXNode* geometryNode);
         static void GetFBXMaterial(FBXMaterial* material, const FBXNode* materialNode);
         void FBXToIntermediate(const FBXData* data);
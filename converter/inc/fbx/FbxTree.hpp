@@ -1,39 +1,164 @@
 #pragma once
 #include <filesystem>
-#include <istream>
 #include <ostream>
 #include <string_view>
 #include <vector>
-#include <variant>
-#include <cassert>
+#include <cstring>
 
-#include "zlib.h"
+#include "MappedFile.hpp"
+#include "MemoryArena.hpp"
 
 namespace orbtool
 {
 
     namespace fs = std::filesystem;
 
-	using FBXProperty = std::variant<
-		int16_t,
-		bool,
-		int32_t,
-		float,
-		double,
-		int64_t,
-		std::string,
-		std::vector<float>,
-		std::vector<int32_t>,
-		std::vector<double>,
-		std::vector<int64_t>,
-		std::vector<bool>,
-		std::vector<uint8_t>>;
+	// @brief: the data type identifiers of binary fbx properties
+	enum class FBXPropertyType : char
+	{
+		INT16 = 'Y',
+		BOOL = 'C',
+		INT32 = 'I',
+		FLOAT = 'F',
+		DOUBLE = 'D',
+		INT64 = 'L',
+		STRING = 'S',
+		RAW = 'R',
+		ARRAY_FLOAT = 'f',
+		ARRAY_INT32 = 'i',
+		ARRAY_DOUBLE = 'd',
+		ARRAY_INT64 = 'l',
+		ARRAY_BOOL = 'b',
+		ARRAY_UINT8 = 'c',
+	};
+
+	template<typename T> struct FBXTypeCode;
+	template<> struct FBXTypeCode<int16_t> { static constexpr auto value = FBXPropertyType::INT16; };
+	template<> struct FBXTypeCode<bool>    { static constexpr auto value = FBXPropertyType::BOOL;  static constexpr auto array = FBXPropertyType::ARRAY_BOOL; };
+	template<> struct FBXTypeCode<int32_t> { static constexpr auto value = FBXPropertyType::INT32; static constexpr auto array = FBXPropertyType::ARRAY_INT32; };
+	template<> struct FBXTypeCode<float>   { static constexpr auto value = FBXPropertyType::FLOAT; static constexpr auto array = FBXPropertyType::ARRAY_FLOAT; };
+	template<> struct FBXTypeCode<double>  { static constexpr auto value = FBXPropertyType::DOUBLE; static constexpr auto array = FBXPropertyType::ARRAY_DOUBLE; };
+	template<> struct FBXTypeCode<int64_t> { static constexpr auto value = FBXPropertyType::INT64; static constexpr auto array = FBXPropertyType::ARRAY_INT64; };
+	template<> struct FBXTypeCode<uint8_t> { static constexpr auto array = FBXPropertyType::ARRAY_UINT8; };
+
+	// @brief: non-owning view of contiguous elements
+	template<typename T>
+	class FBXView
+	{
+	private:
+		const T* m_data = nullptr;
+		size_t m_size = 0u;
+	public:
+		FBXView() = default;
+		FBXView(const T* data, size_t size) : m_data(data), m_size(size) {}
+		const T* begin() const { return m_data; }
+		const T* end() const { return m_data + m_size; }
+		const T* data() const { return m_data; }
+		size_t size() const { return m_size; }
+		bool empty() const { return m_size == 0u; }
+		const T& operator[](size_t index) const { return m_data[index]; }
+		const T& front() const { return m_data[0]; }
+		const T& back() const { return m_data[m_size - 1u]; }
+		std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+	};
+
+	// @brief: a property of a fbx node. The property only references the bytes
+	//	of the memory mapped file. Compressed arrays are inflated into the
+	//	tree's arena the first time they are accessed.
+	class FBXProperty
+	{
+	private:
+		friend class FbxTree;
+		FBXPropertyType m_type = FBXPropertyType::INT32;
+		// @member: number of characters (strings) or elements (arrays)
+		uint32_t m_length = 0u;
+		// @member: 1 if the array is zlib compressed
+		uint32_t m_encoding = 0u;
+		// @member: number of bytes stored in the file (arrays only)
+		uint32_t m_storedLength = 0u;
+		// @member: the property's data inside of the mapped file
+		const uint8_t* m_data = nullptr;
+		// @member: the decoded array data. Equals m_data for uncompressed, aligned arrays
+		mutable const uint8_t* m_decoded = nullptr;
+		MemoryArena* m_arena = nullptr;
+	private:
+		[[noreturn]] void TypeMismatch(FBXPropertyType expected) const;
+		size_t ElementSize() const;
+		// @method: returns the destination of the decoded data or nullptr
+		//	if the array can be used in place
+		uint8_t* Reserve() const;
+		void DecodeInto(uint8_t* target) const;
+		const uint8_t* Decode() const;
+	public:
+		FBXPropertyType GetType() const { return m_type; }
+		bool IsArray() const { return m_type >= FBXPropertyType::ARRAY_BOOL; }
+		bool IsString() const { return m_type == FBXPropertyType::STRING || m_type == FBXPropertyType::RAW; }
+		// @method: returns the number of array elements (or characters of a string)
+		uint32_t Length() const { return m_length; }
+		// @method: returns whether the array data has been decoded already
+		bool IsDecoded() const { return m_decoded != nullptr; }
+
+		template<typename T>
+		bool Is() const { return m_type == FBXTypeCode<T>::value; }
+
+		// @method: returns the value of a primitive property
+		// @throws: if the property has a different type
+		template<typename T>
+		T Get() const
+		{
+			if (m_type != FBXTypeCode<T>::value)
+				TypeMismatch(FBXTypeCode<T>::value);
+			T value;
+			std::memcpy(&value, m_data, sizeof(T));
+			return value;
+		}
+
+		// @method: returns a string property (without copying)
+		std::string_view GetString() const;
+
+		// @method: returns the elements of an array property. Compressed
+		//	arrays are inflated on the first call
+		template<typename T>
+		FBXView<T> GetArray() const
+		{
+			if (m_type != FBXTypeCode<T>::array)
+				TypeMismatch(FBXTypeCode<T>::array);
+			return FBXView<T>(reinterpret_cast<const T*>(Decode()), m_length);
+		}
+	};
 
 	struct FBXNode
 	{
-		std::string name;
-		std::vector<FBXProperty> properties;
-		std::vector<FBXNode> children;
+		// @brief: iterates over the children of a node
+		class ChildList
+		{
+		private:
+			const FBXNode* m_first = nullptr;
+		public:
+			class Iterator
+			{
+			private:
+				const FBXNode* m_node;
+			public:
+				Iterator(const FBXNode* node) : m_node(node) {}
+				const FBXNode& operator*() const { return *m_node; }
+				const FBXNode* operator->() const { return m_node; }
+				Iterator& operator++() { m_node = m_node->next; return *this; }
+				bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+				bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+			};
+			ChildList() = default;
+			ChildList(const FBXNode* first) : m_first(first) {}
+			Iterator begin() const { return Iterator(m_first); }
+			Iterator end() const { return Iterator(nullptr); }
+			bool empty() const { return m_first == nullptr; }
+		};
+
+		std::string_view name;
+		FBXView<FBXProperty> properties;
+		ChildList children;
+		// @member: the next sibling
+		const FBXNode* next = nullptr;
 
         const FBXNode* FindChild(std::string_view childName, size_t nthChild = 0U) const;
 	};
@@ -41,78 +166,47 @@ namespace orbtool
     class FbxTree
     {
     private:
-        std::istream* m_stream;
+        MappedFile m_file;
+        MemoryArena m_arena;
+        const uint8_t* m_cursor = nullptr;
+        const uint8_t* m_begin = nullptr;
+        const uint8_t* m_end = nullptr;
+        uint32_t m_version = 0u;
         FBXNode m_root;
     private:
-        bool ReadNode(FBXNode* node);
+        const FBXNode* ReadNode();
         void ReadProperty(FBXProperty* property);
-        std::string ReadString(size_t length);
-        void ReadString(std::string* str);
-        size_t Position() { return static_cast<size_t>(m_stream->tellg()); }
+        std::string_view ReadString(size_t length);
+        size_t Position() const { return static_cast<size_t>(m_cursor - m_begin); }
+        void Require(size_t bytes) const;
         void PrintProperty(std::ostream* stream, const FBXProperty* property);
         template<typename T>
         T ReadPrimitive()
         {
+            Require(sizeof(T));
             T t;
-            ReadPrimitive(&t);
+            std::memcpy(&t, m_cursor, sizeof(T));
+            m_cursor += sizeof(T);
             return t;
         }
-        template<typename T>
-        void ReadPrimitive(T* t)
-        {
-            m_stream->read((char*)t, sizeof(T));
-        }
-        template<typename T>
-        void InitVariant(FBXProperty* property)
+        // @method: node headers use 64 bit offsets since version 7.5
+        uint64_t ReadOffset()
         {
-            *property = T();
-        }
-        template<typename T>
-        void ReadArray(std::vector<T>* array)
-        {
-            auto length = ReadPrimitive<uint32_t>();
-            auto encoding = ReadPrimitive<uint32_t>();
-            auto compLen = ReadPrimitive<uint32_t>();
-            auto stride = sizeof(T);
-
-            array->resize(length);
-            std::vector<uint8_t> data(compLen);
-
-            m_stream->read((char*)data.data(), compLen);
-
-            if (encoding == 1)
-            {
-                // Data is compressed
-                auto data2 = data;
-                uLongf destLen = static_cast<uLongf>(length * stride);
-                data.resize(destLen);
-
-                uncompress((Bytef*)data.data(), &destLen, (const Bytef*)data2.data(), compLen);
-            }
-
-            assert(data.size() == length * stride);
-            // Possible byte swap if endianness doesn't fit
-
-            for (auto i = 0u; i < length; ++i)
-            {
-                auto pos = i * stride;
-                array->at(i) = *reinterpret_cast<T*>(data.data() + pos);
-            }
-        }
-        template<size_t Length>
-        bool ArrayCompare(std::string_view str, const char arr[Length])
-        {
-            if (str.size() != Length)
-                return false;
-
-            return std::memcmp(str.data(), arr, Length) == 0;
+            return m_version >= 7500u ? ReadPrimitive<uint64_t>() : ReadPrimitive<uint32_t>();
         }
         void PrintTree(std::ostream* stream, const FBXNode* node, unsigned offset = 0U);
     public:
         void PrintTree(std::ostream* stream);
-        FbxTree(std::istream* stream);
+        // @method: maps the file and builds the node tree. Array data is not decoded
+        FbxTree(const fs::path& filepath);
 
         const FBXNode* GetRootNode() const { return &m_root; }
+        // @method: decodes all arrays within the subtrees of the given nodes in parallel.
+        //	Afterwards the arrays can be read from multiple threads at once
+        // @param nodes: the subtrees to decode. The nodes must belong to this tree
+        void DecodeArrays(const std::vector<const FBXNode*>& nodes);
+        // @method: returns the number of bytes allocated for nodes, properties and decoded arrays
+        size_t BytesAllocated() const { return m_arena.BytesAllocated(); }
     };
 
-}
\ No newline at end of file
+}
@@ -8,6 +8,8 @@
 #include <Eigen/Dense>
 
 #include "implementation/rendering/MaterialFlags.hpp"
+#include "implementation/rendering/MeshChunk.hpp"
+#include "fbx/FbxTree.hpp"
 
 namespace orbtool
 {
@@ -46,7 +48,13 @@ namespace orbtool
 		TYPE_TEXTURE,
 		TYPE_MATERIAL,
 		TYPE_ATTRIBUTE,
-		TYPE_INTERMODEL
+		TYPE_INTERMODEL,
+		TYPE_SKIN,
+		TYPE_CLUSTER,
+		TYPE_ANIMATION_STACK,
+		TYPE_ANIMATION_LAYER,
+		TYPE_ANIMATION_CURVE_NODE,
+		TYPE_ANIMATION_CURVE
 	};
 
 	struct FBXBase
@@ -72,38 +80,45 @@ namespace orbtool
 		REFERENCE_UNKNOWN
 	};
 
+	// The arrays of the following types are views into the FbxTree's file and arena,
+	//	they are valid until FbxReader::ReadFile() returns
 	struct NormalInfo
 	{
-		std::vector<double> normals;
-		std::vector<int> normalIndices;
+		FBXView<double> normals;
+		FBXView<int32_t> normalIndices;
 		MappingInformationType mit;
 		ReferenceInformationType rit;
 	};
 
 	struct TangentInfo
 	{
-		std::vector<double> tangents;
-		std::vector<int> tangentIndices;
+		FBXView<double> tangents;
+		FBXView<int32_t> tangentIndices;
 		MappingInformationType mit;
 		ReferenceInformationType rit;
 	};
 
 	struct UVInfo
 	{
-		std::vector<double> uvs;
-		std::vector<int> uvIndices;
+		FBXView<double> uvs;
+		FBXView<int32_t> uvIndices;
 		MappingInformationType mit;
 		ReferenceInformationType rit;
 	};
 
+	struct FBXSkin;
+
 	struct FBXGeometry : public FBXBase
 	{
 		std::string name;
-		std::vector<double> vertices;
-		std::vector<int> indices;
+		FBXView<double> vertices;
+		FBXView<int32_t> indices;
 		NormalInfo normals;
 		TangentInfo tangents;
 		UVInfo uvs;
+		std::shared_ptr<FBXSkin> skin;
+		// @member: joint influences of every control point (vertices / 3). Empty if the geometry isn't skinned
+		std::vector<orbit::SkinWeights> skinWeights;
 	};
 
 	struct FBXModel : public FBXBase
@@ -111,6 +126,61 @@ namespace orbtool
 		FBXTransform transform;
 		std::string modelType;
 		std::string modelName;
+		// @member: the parent model or nullptr for models below the scene root
+		FBXModel* parent = nullptr;
+		// @member: local transform properties. Rotations are XYZ euler angles in degrees
+		Vector3d localTranslation = Vector3d::Zero();
+		Vector3d localRotation = Vector3d::Zero();
+		Vector3d localScaling = Vector3d::Ones();
+		Vector3d preRotation = Vector3d::Zero();
+		Vector3d postRotation = Vector3d::Zero();
+	};
+
+	// @brief: binds the control points of a geometry to a bone
+	struct FBXCluster : public FBXBase
+	{
+		FBXView<int32_t> indices;
+		FBXView<double> weights;
+		// @member: global transform of the geometry at bind time
+		Matrix4d transform = Matrix4d::Identity();
+		// @member: global transform of the bone at bind time
+		Matrix4d transformLink = Matrix4d::Identity();
+		std::shared_ptr<FBXModel> bone;
+	};
+
+	struct FBXSkin : public FBXBase
+	{
+		std::vector<std::shared_ptr<FBXCluster>> clusters;
+	};
+
+	struct FBXAnimationCurve : public FBXBase
+	{
+		// @member: key times in fbx ticks, @see FbxReader::sTicksPerSecond
+		FBXView<int64_t> times;
+		FBXView<float> values;
+	};
+
+	// @brief: animates one property (translation, rotation or scaling) of a model
+	struct FBXAnimationCurveNode : public FBXBase
+	{
+		// @member: the animated property, e.g. "Lcl Rotation"
+		std::string property;
+		// @member: curves of the x, y and z components. Components without a curve keep the model's value
+		std::shared_ptr<FBXAnimationCurve> curves[3];
+		std::shared_ptr<FBXModel> model;
+	};
+
+	struct FBXAnimationLayer : public FBXBase
+	{
+		std::vector<std::shared_ptr<FBXAnimationCurveNode>> curveNodes;
+	};
+
+	struct FBXAnimationStack : public FBXBase
+	{
+		std::string name;
+		int64_t start = 0;
+		int64_t stop = 0;
+		std::vector<std::shared_ptr<FBXAnimationLayer>> layers;
 	};
 
 	enum class TextureType : uint32_t
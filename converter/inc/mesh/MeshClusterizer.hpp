@@ -0,0 +1,38 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Splits the triangles of a mesh into small clusters of neighbouring
+    // triangles. Every cluster gets a bounding sphere and a normal cone so
+    // that the runtime can reject off-screen and back-facing clusters.
+    class MeshClusterizer
+    {
+    private:
+        const OrbVertex* m_vertices;
+        size_t m_vertexCount;
+        uint32_t m_maxVertices;
+        uint32_t m_maxTriangles;
+    private:
+        orbit::MeshCluster CalculateBounds(const uint32_t* indices, size_t indexCount) const;
+    public:
+        static constexpr uint32_t sMaxClusterVertices = 64u;
+        static constexpr uint32_t sMaxClusterTriangles = 124u;
+
+        MeshClusterizer(const OrbVertex* vertices, size_t vertexCount,
+            uint32_t maxVertices = sMaxClusterVertices, uint32_t maxTriangles = sMaxClusterTriangles);
+
+        // @method: reorders the triangles so that every cluster is a contiguous index range
+        // @param indices: the triangle list to be reordered (in place)
+        // @return: the clusters with startIndex relative to the beginning of indices
+        std::vector<orbit::MeshCluster> Build(std::vector<uint32_t>& indices) const;
+
+        // @method: clusters every submesh of the mesh and stores the result in mesh->clusters.
+        //  Non-indexed meshes are converted to indexed meshes first.
+        static void BuildClusters(OrbMesh* mesh);
+    };
+
+}
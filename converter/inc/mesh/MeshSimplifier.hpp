@@ -0,0 +1,82 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+#include <queue>
+#include <functional>
+
+namespace orbtool
+{
+
+    // Quadric error metric (Garland & Heckbert) edge collapse simplifier.
+    // A collapse always moves a vertex onto one of its neighbours, so the
+    // simplified index buffers keep referencing the original vertex buffer
+    // and every level of detail can share the same vertex data.
+    class MeshSimplifier
+    {
+    private:
+        using Quadric = Matrix4d;
+        struct Triangle
+        {
+            uint32_t corners[3];
+            bool removed = false;
+        };
+        struct Collapse
+        {
+            double cost;
+            uint32_t from;
+            uint32_t to;
+            uint32_t fromStamp;
+            uint32_t toStamp;
+            bool operator>(const Collapse& other) const { return cost > other.cost; }
+        };
+        const OrbVertex* m_vertices;
+        size_t m_vertexCount;
+        // @member: maps every vertex to the first vertex sharing its position.
+        //  Collapses operate on these groups so that uv seams don't tear open
+        std::vector<uint32_t> m_groups;
+        std::vector<std::vector<uint32_t>> m_groupMembers;
+        std::vector<std::vector<uint32_t>> m_groupTriangles;
+        std::vector<Quadric> m_quadrics;
+        // @member: the summed area weights of each quadric, dividing by them turns the
+        //  error into an area weighted mean squared distance to the planes
+        std::vector<double> m_quadricWeights;
+        std::vector<uint32_t> m_stamps;
+        std::vector<bool> m_locked;
+        std::vector<bool> m_collapsed;
+        std::vector<Triangle> m_triangles;
+        size_t m_liveTriangles = 0u;
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_queue;
+    private:
+        Vector3d Position(uint32_t group) const { return m_vertices[group].position.cast<double>(); }
+        uint32_t Group(uint32_t vertex) const { return m_groups[vertex]; }
+        void BuildGroups();
+        void BuildQuadrics();
+        void LockBorders();
+        void PushCollapses(uint32_t group);
+        void PushCollapse(uint32_t from, uint32_t to);
+        bool IsCollapseValid(const Collapse& collapse) const;
+        void PerformCollapse(uint32_t from, uint32_t to);
+        uint32_t FindWedge(uint32_t vertex, uint32_t group) const;
+    public:
+        // @member: the most lods a chain can have, each level doubles the error bound
+        //  and halves the screen size, so further levels would not be selected anyway
+        static constexpr uint32_t sMaxLods = 16u;
+
+        MeshSimplifier(const OrbVertex* vertices, size_t vertexCount);
+
+        // @method: simplifies an indexed triangle list
+        // @param indices: indices into the vertices passed to the constructor
+        // @param targetIndexCount: stops once the index count drops below this value
+        // @param maxError: stops once the cheapest collapse exceeds this error, the area weighted
+        //  mean squared distance of the moved vertex to the planes of its removed triangles
+        // @return: the simplified index list
+        std::vector<uint32_t> Simplify(const std::vector<uint32_t>& indices, size_t targetIndexCount, double maxError);
+
+        // @method: appends a chain of simplified index buffers to mesh->lods.
+        //  Each level roughly halves the triangle count of the previous one.
+        // @param numLods: maximum number of lods to generate (excluding the full mesh), at most sMaxLods
+        static void BuildLodChain(OrbMesh* mesh, uint32_t numLods);
+    };
+
+}
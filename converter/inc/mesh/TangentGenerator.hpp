@@ -0,0 +1,37 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Generates per vertex tangents the way MikkTSpace does: the tangents of
+    // all triangle corners sharing position, normal and texture coordinates
+    // are projected onto the normal plane, weighted by the corner angle and
+    // summed. Triangles are processed in parallel and every vertex group is
+    // accumulated by exactly one thread, so no locks are needed.
+    class TangentGenerator
+    {
+    private:
+        OrbVertex* m_vertices;
+        size_t m_vertexCount;
+    private:
+        // @method: assigns identical vertices (ignoring the tangent) to the same group
+        // @return: the number of groups
+        uint32_t WeldVertices(std::vector<uint32_t>* groups) const;
+    public:
+        TangentGenerator(OrbVertex* vertices, size_t vertexCount);
+
+        // @method: overwrites the tangents of all vertices referenced by the triangles
+        // @param indices: triangle list relative to the first vertex
+        void Generate(const uint32_t* indices, size_t indexCount);
+
+        // @method: returns whether any of the vertices has a tangent
+        static bool HasTangents(const OrbVertex* vertices, size_t vertexCount);
+
+        // @method: generates tangents for every submesh of the mesh that has none
+        static void GenerateTangents(OrbMesh* mesh);
+    };
+
+}
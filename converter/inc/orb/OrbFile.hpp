@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <filesystem>
 #include <string>
+#include <ostream>
+#include <vector>
 
 namespace orbtool
 {
@@ -27,6 +29,7 @@ namespace orbtool
         {
             size_t       offset;
             ResourceType type;
+            uint32_t     payloadSize;
         };
         struct ResourceHeader
         {
@@ -37,8 +40,21 @@ namespace orbtool
         };
         std::unordered_map<ResourceId, Index> m_indices;
         fs::path m_filepath;
+        // @member: padding records are not indexed, but part of the object count
+        uint32_t m_numPaddingRecords = 0u;
+        std::vector<std::string> m_loadOrder;
+        uint32_t m_payloadAlignment = 0u;
         uint64_t NextIndex() const;
+        bool WritePadding(std::ostream* output, size_t headerSize) const;
     public:
+        static constexpr uint32_t sPageSize = 4096u;
+
+        // @method: objects are written in this order (resource names as written by
+        //  ResourceManager::RMWriteLoadTrace) instead of by name
+        void SetLoadOrder(std::vector<std::string> names) { m_loadOrder = std::move(names); }
+        // @method: lets the payloads of meshes and textures start at a multiple of the
+        //  alignment. Smaller objects are packed in between
+        void SetPayloadAlignment(uint32_t alignment) { m_payloadAlignment = alignment; }
         bool ParseFile(const fs::path& filepath);
         void PrintIndex() const;
         void PrintItemDetails(ResourceId itemId) const;
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <variant>
 #include <set>
@@ -15,7 +16,11 @@
 #include "implementation/misc/RasterizerInfo.hpp"
 #include "implementation/rendering/Light.hpp"
 #include "implementation/rendering/Submesh.hpp"
+#include "implementation/rendering/MeshChunk.hpp"
 #include "implementation/rendering/MaterialFlags.hpp"
+#include "implementation/rendering/AnimationFormat.hpp"
+#include "implementation/misc/SplineFormat.hpp"
+#include "implementation/engine/CollisionMeshFormat.hpp"
 #include "implementation/misc/BlendInfo.hpp"
 #include "implementation/misc/SamplerInfo.hpp"
 #include "implementation/misc/PrimitiveType.hpp"
@@ -36,6 +41,9 @@ namespace orbtool
     using LightType = orbit::LightType;
     using SubMesh = orbit::Submesh;
     using MaterialFlag = orbit::MaterialFlag;
+    using JointPose = orbit::JointPose;
+    using CollisionShape = orbit::CollisionShape;
+    using SkinWeights = orbit::SkinWeights;
     using EBlendOp = orbit::EBlendOperation;
     using EBlend = orbit::EBlend;
     using EChannel = orbit::EChannel;
@@ -71,12 +79,127 @@ namespace orbtool
             v0.textureCoords == v1.textureCoords;
     }
 
+    struct OrbMeshLod
+    {
+        // @member: the lod is used once the projected size of the mesh
+        //  (relative to the screen height) drops below this value
+        float screenSize = 0.f;
+        // @member: index ranges into this lod's indices. The vertices are
+        //  shared with the full resolution mesh
+        std::vector<SubMesh> submeshes;
+        std::vector<uint32_t> indices;
+    };
+
+    struct OrbSkin
+    {
+        // @member: name of the skeleton. Empty if the mesh isn't skinned
+        std::string skeleton;
+        // @member: one entry per vertex, indices into the joints of the skeleton
+        std::vector<SkinWeights> weights;
+    };
+
     struct OrbMesh
     {
         std::string material;
         std::vector<SubMesh> submeshes;
         std::vector<OrbVertex> vertices;
         std::vector<uint32_t> indices;
+        std::vector<OrbMeshLod> lods;
+        std::vector<orbit::MeshCluster> clusters;
+        OrbSkin skin;
+    };
+
+    struct OrbJoint
+    {
+        std::string name;
+        // @member: index of the parent joint (always smaller than the joint's index) or -1
+        int32_t parent = -1;
+        JointPose bindPose;
+        Matrix4f inverseBindPose = Matrix4f::Identity();
+    };
+
+    struct OrbSkeleton
+    {
+        std::vector<OrbJoint> joints;
+    };
+
+    struct OrbAnimationClip
+    {
+        std::string skeleton;
+        float sampleRate = 30.f;
+        uint32_t numFrames = 0u;
+        // @member: the local pose of every joint at every frame (frame major).
+        //  Replaced by the keys below once the clip is compressed
+        std::vector<JointPose> samples;
+        // @member: one track per joint, @see orbit::AnimationTrackHeader
+        std::vector<orbit::AnimationTrackHeader> tracks;
+        std::vector<uint16_t> rotationFrames;
+        std::vector<orbit::QuantizedQuaternion> rotations;
+        std::vector<uint16_t> translationFrames;
+        std::vector<Vector3f> translations;
+        std::vector<uint16_t> scaleFrames;
+        std::vector<Vector3f> scales;
+
+        bool IsCompressed() const { return !tracks.empty(); }
+    };
+
+    // @brief: the kind of points a spline is authored with
+    enum class SplineType : uint8_t
+    {
+        // @note: the curve passes through every point
+        CATMULL_ROM,
+        // @note: anchor, control, control, anchor, ... The anchors are shared by neighbouring segments
+        BEZIER
+    };
+
+    struct OrbSpline
+    {
+        SplineType type = SplineType::CATMULL_ROM;
+        bool closed = false;
+        // @member: the authored points
+        std::vector<Vector3f> points;
+        // @member: resolution of the arc length table, 0 chooses it from the curve
+        uint32_t numSamples = 0u;
+        // @member: the cubic Bezier segments the points describe, @see orbit::SplineFormat.hpp.
+        //  Filled in by the SplineBaker together with the arc length table
+        std::vector<Vector3f> controlPoints;
+        std::vector<float> samples;
+        float length = 0.f;
+
+        bool IsBaked() const { return !samples.empty(); }
+        uint32_t NumSegments() const { return controlPoints.empty() ? 0u : static_cast<uint32_t>(controlPoints.size() - 1u) / 3u; }
+    };
+
+    struct OrbCollisionMesh
+    {
+        // @member: name of the mesh the collision geometry is cooked from
+        std::string mesh;
+        CollisionShape shape = CollisionShape::TRIANGLE_MESH;
+        // @member: vertex limit of every convex hull
+        uint32_t maxHullVertices = 64u;
+        // @member: limits of CONVEX_DECOMPOSITION, @see ConvexDecomposer
+        uint32_t maxHulls = 16u;
+        uint32_t resolution = 64u;
+        float maxConcavity = 0.02f;
+        // @member: the output of the PhysX cooking library, one stream per part.
+        //  Filled in by the CollisionCooker
+        std::vector<std::vector<uint8_t>> cookedParts;
+        uint32_t physxVersion = 0u;
+
+        bool IsCooked() const { return !cookedParts.empty(); }
+    };
+
+    // @brief: the block compression a texture is encoded with
+    enum class TextureCompression : uint8_t
+    {
+        // @note: chosen from the way materials use the texture
+        AUTO,
+        // @note: the source file is embedded as it is
+        NONE,
+        BC1,
+        BC3,
+        BC5,
+        BC7
     };
 
     struct OrbTexture
@@ -84,6 +207,9 @@ namespace orbtool
         fs::path texturePath;
         fs::path referencePath;
         bool onlyReference = false;
+        TextureCompression compression = TextureCompression::AUTO;
+        // @member: the processed DDS file. Embedded instead of the source file if not empty
+        std::vector<uint8_t> ddsData;
     };
 
     struct OrbInputLayoutElement
@@ -174,7 +300,11 @@ namespace orbtool
             OrbShaderBinary, 
             OrbRasterizerState,
             OrbBlendState,
-            OrbSamplerState> value;
+            OrbSamplerState,
+            OrbSkeleton,
+            OrbAnimationClip,
+            OrbSpline,
+            OrbCollisionMesh> value;
     };
 
     static bool operator==(const OrbObject& a, const OrbObject& b)
@@ -195,16 +325,28 @@ namespace orbtool
         mutable std::unordered_map<std::string, uint32_t> m_objectIndices;
     public:
         void MakeUnique() const;
+        // @method: moves the named objects to the front in the given order. All
+        //  other objects follow them in name order
+        void OrderBy(const std::vector<std::string>& names) const;
         uint32_t NumObjects() const { return m_objects.size(); }
         ResourceType GetObjectType(uint32_t objectIndex) const;
         std::string GetObjectName(uint32_t objectIndex) const { return m_objects.at(objectIndex).name; }
         int64_t GetOffsetFromName(const std::string& name, uint64_t offsetId) const;
+        // @method: returns the index of the object or -1 if there is no object with the name
+        int64_t FindObject(const std::string& name) const;
         template<typename T>
         const T& GetObject(uint32_t objectIndex) const
         {
             return std::get<T>(m_objects.at(objectIndex).value);
         }
         template<typename T>
+        T& GetObject(uint32_t objectIndex)
+        {
+            return std::get<T>(m_objects.at(objectIndex).value);
+        }
+        // @method: moves all objects of another intermediate to the end of this one
+        void Append(OrbIntermediate&& other);
+        template<typename T>
         void AppendObject(const std::string& name, const T& object)
         {
             m_objects.emplace_back(OrbObject{ name, object });
@@ -0,0 +1,24 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Cooks the collision geometry of meshes with the PhysX cooking library,
+    // so the engine only has to deserialize it. Vertices are welded before
+    // cooking, the attributes that split them for rendering don't matter here.
+    // Cooking is only available if orbtool is built with PHYSX_ROOT_PATH set.
+    class CollisionCooker
+    {
+    private:
+        // @method: collects the welded positions and the triangles of all submeshes
+        static void CollectTriangles(const OrbMesh& mesh, std::vector<Vector3f>* positions, std::vector<uint32_t>* indices);
+    public:
+        // @method: cooks the collision mesh from the mesh it references. Cooked meshes are left untouched
+        // @return: false if the mesh can't be cooked
+        static bool Cook(const OrbMesh& mesh, OrbCollisionMesh* collisionMesh);
+    };
+
+}
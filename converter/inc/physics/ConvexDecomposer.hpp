@@ -0,0 +1,45 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Approximate convex decomposition in the spirit of V-HACD. The mesh is
+    // voxelized, the solid voxels are split recursively by axis aligned planes
+    // and every part ends up as one convex hull. The part with the highest
+    // concavity is split first, until the hull budget is used up or every part
+    // is convex enough. The concavity of a part is the number of voxels inside
+    // its hull that are not solid, relative to the solid voxels of the mesh.
+    class ConvexDecomposer
+    {
+    public:
+        static constexpr uint32_t sDefaultMaxHulls = 16u;
+        static constexpr uint32_t sDefaultResolution = 64u;
+        static constexpr float sDefaultMaxConcavity = 0.02f;
+
+        struct Settings
+        {
+            // @member: upper bound of the number of hulls
+            uint32_t maxHulls = sDefaultMaxHulls;
+            // @member: number of voxels along the longest side of the mesh
+            uint32_t resolution = sDefaultResolution;
+            // @member: parts with a lower concavity are not split any further
+            float maxConcavity = sDefaultMaxConcavity;
+        };
+
+        // @method: decomposes a closed triangle mesh
+        // @param positions, indices: the welded triangles, @see CollisionCooker
+        // @return: the vertices of every hull
+        static std::vector<std::vector<Vector3f>> Decompose(const std::vector<Vector3f>& positions,
+            const std::vector<uint32_t>& indices, const Settings& settings);
+
+        // @method: computes the convex hull of a point cloud (incremental quickhull)
+        // @param triangles: receives the faces of the hull, three point indices each
+        //  in counter clockwise order seen from the outside. May be nullptr
+        // @return: the volume of the hull, 0 for flat or degenerate clouds
+        static double ConvexHull(const std::vector<Vector3d>& points, std::vector<uint32_t>* triangles = nullptr);
+    };
+
+}
@@ -26,6 +26,8 @@ namespace orbtool
         OrbPipelineState Read_PipelineState();
         OrbRasterizerState Read_RasterizerState();
         OrbMaterial Read_Material();
+        OrbSpline Read_Spline();
+        OrbCollisionMesh Read_CollisionMesh();
     public:
         bool ReadFile(const fs::path& filepath, OrbIntermediate* intermediate) override;
     };
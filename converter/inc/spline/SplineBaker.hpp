@@ -0,0 +1,33 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <vector>
+
+namespace orbtool
+{
+
+    // Converts the authored points of a spline to cubic Bezier segments and
+    // tabulates the curve parameter at uniform distances along the curve, so
+    // the engine can move along it at constant speed with a table lookup.
+    // Catmull-Rom splines use the centripetal parameterization, which neither
+    // overshoots nor forms cusps at unevenly spaced points. Arc lengths are
+    // integrated with Gauss-Legendre quadrature and inverted with Newton's method.
+    class SplineBaker
+    {
+    private:
+        // @method: fills in the Bezier control points of the spline
+        // @return: false if the number of points doesn't fit the spline type
+        static bool BuildSegments(OrbSpline* spline);
+    public:
+        // @member: maximum distance along the curve between the position the
+        //  table interpolates and the exact one, used to choose the table size
+        static constexpr float sDistanceTolerance = 0.001f;
+        static constexpr uint32_t sMinSamples = 64u;
+        static constexpr uint32_t sMaxSamples = 1u << 16u;
+
+        // @method: builds the segments and the arc length table. Baked splines are left untouched
+        // @return: false if the points don't describe a curve
+        static bool Bake(OrbSpline* spline);
+    };
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace orbtool
+{
+
+    // CPU encoder for the BC formats used by the engine. Every function
+    // takes a 4x4 block of RGBA8 pixels in row major order.
+    class BlockCompressor
+    {
+    public:
+        static constexpr uint32_t sBlockDim = 4u;
+
+        // @method: encodes the rgb channels into 8 bytes (4 color mode)
+        static void EncodeBC1(const uint8_t* pixels, uint8_t* block);
+        // @method: encodes a single channel into 8 bytes
+        static void EncodeBC4(const uint8_t* pixels, uint32_t channel, uint8_t* block);
+        // @method: BC4 alpha followed by BC1 color (16 bytes)
+        static void EncodeBC3(const uint8_t* pixels, uint8_t* block);
+        // @method: BC4 red followed by BC4 green (16 bytes)
+        static void EncodeBC5(const uint8_t* pixels, uint8_t* block);
+        // @method: encodes rgba into 16 bytes using BC7 mode 6
+        static void EncodeBC7(const uint8_t* pixels, uint8_t* block);
+
+        // @method: returns the number of bytes of a compressed 4x4 block
+        static uint32_t BlockSize(TextureCompression compression);
+
+        // @method: compresses an image. Rows of blocks are encoded in parallel and
+        //  blocks overlapping the border repeat the last row/column
+        // @param rgba: width * height RGBA8 pixels
+        static std::vector<uint8_t> Compress(const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompression compression);
+    };
+
+}
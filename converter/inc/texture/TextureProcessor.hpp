@@ -0,0 +1,41 @@
+#pragma once
+#include "orb/OrbIntermediate.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace orbtool
+{
+
+    // @brief: an uncompressed RGBA8 image
+    struct TextureImage
+    {
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        std::vector<uint8_t> pixels;
+    };
+
+    // Turns source images into DDS files with a full mip chain, so the
+    // runtime can upload them without decoding anything.
+    class TextureProcessor
+    {
+    public:
+        // @method: decodes an image file (everything WIC can read) to RGBA8
+        static bool Decode(const fs::path& path, TextureImage* image);
+
+        // @method: generates the mip chain down to 1x1 with a 2x2 box filter.
+        //  The first element is a copy of the image
+        // @param srgb: the rgb channels are sRGB encoded and filtered in linear space
+        // @param normalMap: the rgb channels are renormalized after filtering
+        static std::vector<TextureImage> GenerateMips(const TextureImage& image, bool srgb, bool normalMap);
+
+        // @method: encodes the mip chain and prepends the DDS headers.
+        //  TextureCompression::NONE stores the pixels as R8G8B8A8
+        static std::vector<uint8_t> WriteDds(const std::vector<TextureImage>& mips, TextureCompression compression);
+
+        // @method: decodes the texture's source file and stores the processed result in ddsData
+        // @param compression: resolved format, must not be AUTO
+        static bool Process(OrbTexture* texture, TextureCompression compression, bool srgb, bool normalMap);
+    };
+
+}
@@ -0,0 +1,388 @@
+#include "BuildCache.hpp"
+#include "MappedFile.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+namespace orbtool
+{
+
+    static constexpr uint32_t sEntryMagic = 0x4342524fu; // "ORBC"
+
+    static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0u; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // @brief: serializes cache entries into a byte buffer. Values are written
+    //  as raw bytes like in OrbFile, so Eigen types must be fixed size
+    class EntryWriter
+    {
+    private:
+        std::vector<uint8_t> m_data;
+    public:
+        template<typename T>
+        void Write(const T& value)
+        {
+            auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+        }
+        template<typename T>
+        void WriteVector(const std::vector<T>& values)
+        {
+            Write(static_cast<uint64_t>(values.size()));
+            auto bytes = reinterpret_cast<const uint8_t*>(values.data());
+            m_data.insert(m_data.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+        void WriteString(const std::string& str)
+        {
+            Write(static_cast<uint32_t>(str.size()));
+            m_data.insert(m_data.end(), str.begin(), str.end());
+        }
+        const std::vector<uint8_t>& Data() const { return m_data; }
+    };
+
+    // @brief: reads cache entries. Every read is bounds checked so that a
+    //  truncated entry is a cache miss instead of a crash
+    class EntryReader
+    {
+    private:
+        const uint8_t* m_cursor;
+        const uint8_t* m_end;
+        bool m_valid = true;
+    private:
+        bool Require(size_t bytes)
+        {
+            m_valid = m_valid && static_cast<size_t>(m_end - m_cursor) >= bytes;
+            return m_valid;
+        }
+    public:
+        EntryReader(const uint8_t* data, size_t size) : m_cursor(data), m_end(data + size) {}
+        bool IsValid() const { return m_valid; }
+
+        template<typename T>
+        T Read()
+        {
+            T value{};
+            if (Require(sizeof(T)))
+            {
+                std::memcpy(&value, m_cursor, sizeof(T));
+                m_cursor += sizeof(T);
+            }
+            return value;
+        }
+        template<typename T>
+        std::vector<T> ReadVector()
+        {
+            const auto count = Read<uint64_t>();
+            std::vector<T> values;
+            if (count > static_cast<uint64_t>(m_end - m_cursor) / sizeof(T) || !Require(count * sizeof(T)))
+            {
+                m_valid = false;
+                return values;
+            }
+            values.resize(count);
+            std::memcpy(values.data(), m_cursor, count * sizeof(T));
+            m_cursor += count * sizeof(T);
+            return values;
+        }
+        std::string ReadString()
+        {
+            const auto length = Read<uint32_t>();
+            if (!Require(length))
+                return std::string();
+            std::string str(reinterpret_cast<const char*>(m_cursor), length);
+            m_cursor += length;
+            return str;
+        }
+    };
+
+    static void WriteMesh(EntryWriter* writer, const OrbMesh& mesh)
+    {
+        writer->WriteString(mesh.material);
+        writer->WriteVector(mesh.submeshes);
+        writer->WriteVector(mesh.vertices);
+        writer->WriteVector(mesh.indices);
+        writer->Write(static_cast<uint32_t>(mesh.lods.size()));
+        for (const auto& lod : mesh.lods)
+        {
+            writer->Write(lod.screenSize);
+            writer->WriteVector(lod.submeshes);
+            writer->WriteVector(lod.indices);
+        }
+        writer->WriteVector(mesh.clusters);
+        writer->WriteString(mesh.skin.skeleton);
+        writer->WriteVector(mesh.skin.weights);
+    }
+
+    static OrbMesh ReadMesh(EntryReader* reader)
+    {
+        OrbMesh mesh;
+        mesh.material = reader->ReadString();
+        mesh.submeshes = reader->ReadVector<SubMesh>();
+        mesh.vertices = reader->ReadVector<OrbVertex>();
+        mesh.indices = reader->ReadVector<uint32_t>();
+        const auto numLods = reader->Read<uint32_t>();
+        for (auto i = 0u; i < numLods && reader->IsValid(); ++i)
+        {
+            OrbMeshLod lod;
+            lod.screenSize = reader->Read<float>();
+            lod.submeshes = reader->ReadVector<SubMesh>();
+            lod.indices = reader->ReadVector<uint32_t>();
+            mesh.lods.emplace_back(std::move(lod));
+        }
+        mesh.clusters = reader->ReadVector<orbit::MeshCluster>();
+        mesh.skin.skeleton = reader->ReadString();
+        mesh.skin.weights = reader->ReadVector<SkinWeights>();
+        return mesh;
+    }
+
+    static void WriteMaterial(EntryWriter* writer, const OrbMaterial& material)
+    {
+        writer->Write(material.roughness);
+        writer->Write(material.diffuse);
+        writer->Write(material.specular);
+        writer->WriteString(material.diffuseTextureId);
+        writer->WriteString(material.normalMapId);
+        writer->WriteString(material.roughnessMapId);
+        writer->WriteString(material.occlusionMapId);
+    }
+
+    static OrbMaterial ReadMaterial(EntryReader* reader)
+    {
+        OrbMaterial material;
+        material.roughness = reader->Read<float>();
+        material.diffuse = reader->Read<Vector4f>();
+        material.specular = reader->Read<Vector4f>();
+        material.diffuseTextureId = reader->ReadString();
+        material.normalMapId = reader->ReadString();
+        material.roughnessMapId = reader->ReadString();
+        material.occlusionMapId = reader->ReadString();
+        return material;
+    }
+
+    static void WriteTexture(EntryWriter* writer, const OrbTexture& texture)
+    {
+        writer->WriteString(texture.texturePath.generic_string());
+        writer->WriteString(texture.referencePath.generic_string());
+        writer->Write(texture.onlyReference);
+        writer->Write(texture.compression);
+    }
+
+    static OrbTexture ReadTexture(EntryReader* reader)
+    {
+        OrbTexture texture;
+        texture.texturePath = reader->ReadString();
+        texture.referencePath = reader->ReadString();
+        texture.onlyReference = reader->Read<bool>();
+        texture.compression = reader->Read<TextureCompression>();
+        return texture;
+    }
+
+    static void WriteSkeleton(EntryWriter* writer, const OrbSkeleton& skeleton)
+    {
+        writer->Write(static_cast<uint32_t>(skeleton.joints.size()));
+        for (const auto& joint : skeleton.joints)
+        {
+            writer->WriteString(joint.name);
+            writer->Write(joint.parent);
+            writer->Write(joint.bindPose);
+            writer->Write(joint.inverseBindPose);
+        }
+    }
+
+    static OrbSkeleton ReadSkeleton(EntryReader* reader)
+    {
+        OrbSkeleton skeleton;
+        skeleton.joints.resize(reader->Read<uint32_t>());
+        for (auto& joint : skeleton.joints)
+        {
+            joint.name = reader->ReadString();
+            joint.parent = reader->Read<int32_t>();
+            joint.bindPose = reader->Read<JointPose>();
+            joint.inverseBindPose = reader->Read<Matrix4f>();
+        }
+        return skeleton;
+    }
+
+    // @note: clips are stored compressed, Do_ReadFile compresses them before storing
+    static void WriteAnimationClip(EntryWriter* writer, const OrbAnimationClip& clip)
+    {
+        writer->WriteString(clip.skeleton);
+        writer->Write(clip.sampleRate);
+        writer->Write(clip.numFrames);
+        writer->WriteVector(clip.samples);
+        writer->WriteVector(clip.tracks);
+        writer->WriteVector(clip.rotationFrames);
+        writer->WriteVector(clip.rotations);
+        writer->WriteVector(clip.translationFrames);
+        writer->WriteVector(clip.translations);
+        writer->WriteVector(clip.scaleFrames);
+        writer->WriteVector(clip.scales);
+    }
+
+    static OrbAnimationClip ReadAnimationClip(EntryReader* reader)
+    {
+        OrbAnimationClip clip;
+        clip.skeleton = reader->ReadString();
+        clip.sampleRate = reader->Read<float>();
+        clip.numFrames = reader->Read<uint32_t>();
+        clip.samples = reader->ReadVector<JointPose>();
+        clip.tracks = reader->ReadVector<orbit::AnimationTrackHeader>();
+        clip.rotationFrames = reader->ReadVector<uint16_t>();
+        clip.rotations = reader->ReadVector<orbit::QuantizedQuaternion>();
+        clip.translationFrames = reader->ReadVector<uint16_t>();
+        clip.translations = reader->ReadVector<Vector3f>();
+        clip.scaleFrames = reader->ReadVector<uint16_t>();
+        clip.scales = reader->ReadVector<Vector3f>();
+        return clip;
+    }
+
+    BuildCache::BuildCache(const fs::path& directory, const std::string& options) :
+        // Readers change the working directory, relative paths would move with it
+        m_directory(fs::absolute(directory)),
+        m_options(options)
+    {
+        std::error_code error;
+        fs::create_directories(m_directory, error);
+        if (error)
+            ORBIT_ERROR("Unable to create the cache directory '%s'", m_directory.generic_string().c_str());
+    }
+
+    fs::path BuildCache::EntryPath(uint64_t key) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.orbc", static_cast<unsigned long long>(key));
+        return m_directory / name;
+    }
+
+    bool BuildCache::IsCacheable(const fs::path& file)
+    {
+        const auto extension = file.extension();
+        return extension == ".fbx" || extension == ".obj" || extension == ".dae" || extension == ".mtl";
+    }
+
+    uint64_t BuildCache::Key(const fs::path& file, bool triangulate) const
+    {
+        const auto settings = m_options + (triangulate ? ";triangulate" : "") + ";" + file.extension().generic_string();
+        auto hash = Fnv1a(&sVersion, sizeof(sVersion));
+        hash = Fnv1a(settings.data(), settings.size(), hash);
+
+        MappedFile mapped;
+        if (mapped.Open(file))
+            hash = Fnv1a(mapped.Data(), mapped.Size(), hash);
+        return hash;
+    }
+
+    bool BuildCache::Load(uint64_t key, OrbIntermediate* intermediate)
+    {
+        MappedFile mapped;
+        if (!mapped.Open(EntryPath(key)))
+        {
+            ++m_misses;
+            return false;
+        }
+
+        EntryReader reader(mapped.Data(), mapped.Size());
+        const auto magic = reader.Read<uint32_t>();
+        const auto version = reader.Read<uint32_t>();
+        const auto storedKey = reader.Read<uint64_t>();
+        const auto numObjects = reader.Read<uint32_t>();
+        if (magic != sEntryMagic || version != sVersion || storedKey != key)
+        {
+            ++m_misses;
+            return false;
+        }
+
+        OrbIntermediate objects;
+        for (auto i = 0u; i < numObjects && reader.IsValid(); ++i)
+        {
+            auto name = reader.ReadString();
+            switch (reader.Read<ResourceType>())
+            {
+            case ResourceType::MESH: objects.AppendObject(name, ReadMesh(&reader)); break;
+            case ResourceType::MATERIAL: objects.AppendObject(name, ReadMaterial(&reader)); break;
+            case ResourceType::TEXTURE:
+            case ResourceType::TEXTURE_REFERENCE: objects.AppendObject(name, ReadTexture(&reader)); break;
+            case ResourceType::SKELETON: objects.AppendObject(name, ReadSkeleton(&reader)); break;
+            case ResourceType::ANIMATION_CLIP: objects.AppendObject(name, ReadAnimationClip(&reader)); break;
+            default:
+                ORBIT_ERROR("Cache entry %016llx is corrupted", static_cast<unsigned long long>(key));
+                ++m_misses;
+                return false;
+            }
+        }
+        if (!reader.IsValid())
+        {
+            ORBIT_ERROR("Cache entry %016llx is truncated", static_cast<unsigned long long>(key));
+            ++m_misses;
+            return false;
+        }
+
+        intermediate->Append(std::move(objects));
+        ++m_hits;
+        m_bytesLoaded += mapped.Size();
+        return true;
+    }
+
+    void BuildCache::Store(uint64_t key, const OrbIntermediate& intermediate) const
+    {
+        EntryWriter writer;
+        writer.Write(sEntryMagic);
+        writer.Write(sVersion);
+        writer.Write(key);
+        writer.Write(intermediate.NumObjects());
+        for (auto i = 0u; i < intermediate.NumObjects(); ++i)
+        {
+            const auto type = intermediate.GetObjectType(i);
+            writer.WriteString(intermediate.GetObjectName(i));
+            writer.Write(type);
+            switch (type)
+            {
+            case ResourceType::MESH: WriteMesh(&writer, intermediate.GetObject<OrbMesh>(i)); break;
+            case ResourceType::MATERIAL: WriteMaterial(&writer, intermediate.GetObject<OrbMaterial>(i)); break;
+            case ResourceType::TEXTURE:
+            case ResourceType::TEXTURE_REFERENCE: WriteTexture(&writer, intermediate.GetObject<OrbTexture>(i)); break;
+            case ResourceType::SKELETON: WriteSkeleton(&writer, intermediate.GetObject<OrbSkeleton>(i)); break;
+            case ResourceType::ANIMATION_CLIP: WriteAnimationClip(&writer, intermediate.GetObject<OrbAnimationClip>(i)); break;
+            default:
+                return;
+            }
+        }
+
+        // Write to a temporary file first so that an interrupted run never leaves a broken entry
+        const auto path = EntryPath(key);
+        auto tmpPath = path;
+        tmpPath += ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::out | std::ios::trunc);
+            if (!file.is_open())
+            {
+                ORBIT_ERROR("Unable to write cache entry '%s'", tmpPath.generic_string().c_str());
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(writer.Data().data()), writer.Data().size());
+        }
+        std::error_code error;
+        fs::rename(tmpPath, path, error);
+        if (error)
+            ORBIT_ERROR("Unable to write cache entry '%s'", path.generic_string().c_str());
+    }
+
+    void BuildCache::PrintStatistics() const
+    {
+        const auto total = m_hits + m_misses;
+        ORBIT_LOG("Build cache: %u hits, %u misses (%.1f%% hit rate), %llu bytes loaded from %s",
+            m_hits, m_misses, total > 0u ? 100.f * m_hits / total : 0.f,
+            static_cast<unsigned long long>(m_bytesLoaded), m_directory.generic_string().c_str());
+    }
+
+}
@@ -6,6 +6,21 @@
 #include "fbx/FbxReader.hpp"
 #include "alembic/DaeReader.hpp"
 #include "raw/RawReader.hpp"
+#include "mesh/MeshSimplifier.hpp"
+#include "mesh/MeshClusterizer.hpp"
+#include "mesh/TangentGenerator.hpp"
+#include "texture/TextureProcessor.hpp"
+#include "anim/AnimationCompressor.hpp"
+#include "spline/SplineBaker.hpp"
+#include "physics/CollisionCooker.hpp"
+#include "BuildCache.hpp"
+
+#include "Parallel.hpp"
+
+#include <numeric>
+#include <unordered_map>
+#include <memory>
+#include <fstream>
 
 namespace orbtool
 {
@@ -32,16 +47,15 @@ namespace orbtool
 		}
     }
 
-    void Do_ReadFile(const fs::path& file, OrbIntermediate* intermediate, bool triangulateMeshes)
+    static bool ReadFileUncached(const fs::path& file, OrbIntermediate* intermediate, bool triangulateMeshes)
     {
-        ORBIT_LOG("Reading file %s", file.generic_string().c_str());
         if (file.extension() == ".mtl")
         {
             WFMaterialReader reader;
             if (!reader.ReadFile(file, intermediate))
             {
                 ORBIT_ERROR("Failed to read file '%s'", file.generic_string().c_str());
-                return;
+                return false;
             }
         }
         else if (file.extension() == ".obj")
@@ -53,7 +67,7 @@ namespace orbtool
             if (!reader.ReadFile(file, intermediate))
             {
                 ORBIT_ERROR("Failed to read file '%s'", file.generic_string().c_str());
-                return;
+                return false;
             }
         }
         else if (file.extension() == ".fbx")
@@ -64,16 +78,18 @@ namespace orbtool
             if (!reader.ReadFile(file, intermediate))
             {
                 ORBIT_ERROR("Failed to read file '%s'", file.generic_string().c_str());
-                return;
+                return false;
             }
         }
         else if (file.extension() == ".dae")
         {
             DaeReader reader;
+            if (triangulateMeshes)
+                reader.WarnOnQuads(false);
             if (!reader.ReadFile(file, intermediate))
             {
                 ORBIT_ERROR("Failed to read file '%s'", file.generic_string().c_str());
-                return;
+                return false;
             }
         }
         else if (file.extension() == ".rorb")
@@ -82,17 +98,218 @@ namespace orbtool
             if (!reader.ReadFile(file, intermediate))
             {
                 ORBIT_ERROR("Failed to read file '%s'", file.generic_string().c_str());
-                return;
+                return false;
             }
         }
         else
         {
             ORBIT_ERROR("Unsupported file extension: %s", file.extension().generic_string().c_str());
-            return;
+            return false;
         }
+        return true;
     }   
 
-    void Do_WriteAppend(const char* const* files, uint32_t numFiles, const char* output, bool append, bool triangulateMeshes)
+    // @brief: the build cache of the current Do_WriteAppend call. Nested reads
+    //  of .rorb files go through Do_ReadFile as well and use it too
+    struct CacheContext
+    {
+        BuildCache* cache = nullptr;
+        uint32_t numLods = 0u;
+        bool buildClusters = false;
+    };
+    static CacheContext s_cacheContext;
+
+    void Do_ReadFile(const fs::path& file, OrbIntermediate* intermediate, bool triangulateMeshes)
+    {
+        ORBIT_LOG("Reading file %s", file.generic_string().c_str());
+        auto cache = s_cacheContext.cache;
+        if (!cache || !BuildCache::IsCacheable(file))
+        {
+            ReadFileUncached(file, intermediate, triangulateMeshes);
+            return;
+        }
+
+        const auto key = cache->Key(file, triangulateMeshes);
+        if (cache->Load(key, intermediate))
+        {
+            // Reading a file makes its directory the working directory, later relative paths depend on it
+            fs::current_path(fs::absolute(file).parent_path());
+            ORBIT_LOG("Loaded %s from the build cache", file.generic_string().c_str());
+            return;
+        }
+
+        // The per mesh processing is part of the entry, so a hit skips it as well
+        OrbIntermediate fileIntermediate;
+        if (!ReadFileUncached(file, &fileIntermediate, triangulateMeshes))
+            return;
+        Do_GenerateTangents(&fileIntermediate);
+        Do_BuildLods(&fileIntermediate, s_cacheContext.numLods);
+        if (s_cacheContext.buildClusters)
+            Do_BuildClusters(&fileIntermediate);
+        Do_CompressAnimations(&fileIntermediate);
+        cache->Store(key, fileIntermediate);
+        intermediate->Append(std::move(fileIntermediate));
+    }
+
+    void Do_GenerateTangents(OrbIntermediate* intermediate)
+    {
+        std::vector<uint32_t> meshes;
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+            if (intermediate->GetObjectType(i) == ResourceType::MESH)
+                meshes.push_back(i);
+
+        ParallelForEach(meshes.begin(), meshes.end(), [&](uint32_t index) {
+            TangentGenerator::GenerateTangents(&intermediate->GetObject<OrbMesh>(index));
+        });
+    }
+
+    void Do_ProcessTextures(OrbIntermediate* intermediate)
+    {
+        // @note: the usage of a texture decides its format. Normal maps only need
+        //  two channels, roughness and occlusion maps no alpha
+        struct TextureUsage
+        {
+            TextureCompression compression = TextureCompression::BC7;
+            bool srgb = true;
+            bool normalMap = false;
+        };
+        std::unordered_map<uint32_t, TextureUsage> usages;
+        auto use = [&](const std::string& name, TextureUsage usage) {
+            const auto index = intermediate->FindObject(name);
+            if (!name.empty() && index >= 0 && intermediate->GetObjectType(static_cast<uint32_t>(index)) == ResourceType::TEXTURE)
+                usages[static_cast<uint32_t>(index)] = usage;
+        };
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+        {
+            if (intermediate->GetObjectType(i) != ResourceType::MATERIAL)
+                continue;
+            const auto& material = intermediate->GetObject<OrbMaterial>(i);
+            use(material.diffuseTextureId, TextureUsage{ TextureCompression::BC7, true, false });
+            use(material.normalMapId, TextureUsage{ TextureCompression::BC5, false, true });
+            use(material.roughnessMapId, TextureUsage{ TextureCompression::BC1, false, false });
+            use(material.occlusionMapId, TextureUsage{ TextureCompression::BC1, false, false });
+        }
+
+        std::vector<uint32_t> textures;
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+        {
+            if (intermediate->GetObjectType(i) == ResourceType::TEXTURE &&
+                intermediate->GetObject<OrbTexture>(i).compression != TextureCompression::NONE)
+                textures.push_back(i);
+        }
+
+        ORBIT_LOG("Processing %zu textures", textures.size());
+        ParallelForEach(textures.begin(), textures.end(), [&](uint32_t index) {
+            auto& texture = intermediate->GetObject<OrbTexture>(index);
+            auto it = usages.find(index);
+            auto usage = it != usages.end() ? it->second : TextureUsage{};
+            if (texture.compression != TextureCompression::AUTO)
+                usage.compression = texture.compression;
+            if (!TextureProcessor::Process(&texture, usage.compression, usage.srgb, usage.normalMap))
+                ORBIT_ERROR("Embedding the source file of texture '%s' instead", intermediate->GetObjectName(index).c_str());
+        });
+    }
+
+    void Do_BuildLods(OrbIntermediate* intermediate, uint32_t numLods)
+    {
+        if (numLods == 0u)
+            return;
+
+        // Meshes loaded from the build cache already have their lods
+        std::vector<uint32_t> meshes;
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+            if (intermediate->GetObjectType(i) == ResourceType::MESH && intermediate->GetObject<OrbMesh>(i).lods.empty())
+                meshes.push_back(i);
+
+        ORBIT_LOG("Generating up to %u lods for %zu meshes", numLods, meshes.size());
+        ParallelForEach(meshes.begin(), meshes.end(), [&](uint32_t index) {
+            MeshSimplifier::BuildLodChain(&intermediate->GetObject<OrbMesh>(index), numLods);
+        });
+    }
+
+    void Do_BuildClusters(OrbIntermediate* intermediate)
+    {
+        std::vector<uint32_t> meshes;
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+            if (intermediate->GetObjectType(i) == ResourceType::MESH && intermediate->GetObject<OrbMesh>(i).clusters.empty())
+                meshes.push_back(i);
+
+        ParallelForEach(meshes.begin(), meshes.end(), [&](uint32_t index) {
+            MeshClusterizer::BuildClusters(&intermediate->GetObject<OrbMesh>(index));
+        });
+    }
+
+    void Do_CompressAnimations(OrbIntermediate* intermediate)
+    {
+        // Clips loaded from the build cache are compressed already
+        std::vector<uint32_t> clips;
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+            if (intermediate->GetObjectType(i) == ResourceType::ANIMATION_CLIP && !intermediate->GetObject<OrbAnimationClip>(i).IsCompressed())
+                clips.push_back(i);
+
+        // Each clip compresses its tracks in parallel
+        for (auto index : clips)
+        {
+            ORBIT_LOG("Compressing animation '%s'", intermediate->GetObjectName(index).c_str());
+            AnimationCompressor::Compress(&intermediate->GetObject<OrbAnimationClip>(index));
+        }
+    }
+
+    void Do_BakeSplines(OrbIntermediate* intermediate)
+    {
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+        {
+            if (intermediate->GetObjectType(i) != ResourceType::SPLINE)
+                continue;
+            auto& spline = intermediate->GetObject<OrbSpline>(i);
+            if (!spline.IsBaked() && !SplineBaker::Bake(&spline))
+                ORBIT_ERROR("Unable to bake spline '%s'", intermediate->GetObjectName(i).c_str());
+        }
+    }
+
+    void Do_CookCollisionMeshes(OrbIntermediate* intermediate)
+    {
+        for (auto i = 0u; i < intermediate->NumObjects(); ++i)
+        {
+            if (intermediate->GetObjectType(i) != ResourceType::COLLISION_MESH)
+                continue;
+            auto& collisionMesh = intermediate->GetObject<OrbCollisionMesh>(i);
+            if (collisionMesh.IsCooked())
+                continue;
+
+            const auto meshIndex = intermediate->FindObject(collisionMesh.mesh);
+            if (meshIndex < 0 || intermediate->GetObjectType(static_cast<uint32_t>(meshIndex)) != ResourceType::MESH)
+            {
+                ORBIT_ERROR("Collision mesh '%s' references the unknown mesh '%s'", intermediate->GetObjectName(i).c_str(), collisionMesh.mesh.c_str());
+                continue;
+            }
+            if (!CollisionCooker::Cook(intermediate->GetObject<OrbMesh>(static_cast<uint32_t>(meshIndex)), &collisionMesh))
+                ORBIT_ERROR("Unable to cook collision mesh '%s'", intermediate->GetObjectName(i).c_str());
+        }
+    }
+
+    // @method: reads a load trace written by ResourceManager::RMWriteLoadTrace, one resource name per line
+    static bool ReadLoadTrace(const fs::path& path, std::vector<std::string>* names)
+    {
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            ORBIT_ERROR("Unable to open load trace '%s'", path.generic_string().c_str());
+            return false;
+        }
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty())
+                names->push_back(line);
+        }
+        ORBIT_LOG("Read load trace of %zu resources from '%s'", names->size(), path.generic_string().c_str());
+        return true;
+    }
+
+    void Do_WriteAppend(const char* const* files, uint32_t numFiles, const char* output, bool append, bool triangulateMeshes, uint32_t numLods, bool buildClusters, bool processTextures, const char* cacheDirectory, const char* loadTrace)
     {
         if (append)
 		{
@@ -101,13 +318,44 @@ namespace orbtool
 			return;
 		}
 
+        // Read before the readers change the working directory
+        std::vector<std::string> loadOrder;
+        if (loadTrace && !ReadLoadTrace(loadTrace, &loadOrder))
+            return;
+
+        std::unique_ptr<BuildCache> cache;
+        if (cacheDirectory)
+        {
+            cache = std::make_unique<BuildCache>(cacheDirectory, "lods=" + std::to_string(numLods) + (buildClusters ? ";clusters" : ""));
+            s_cacheContext = CacheContext{ cache.get(), numLods, buildClusters };
+        }
+
         OrbIntermediate intermediate;
 		for (auto i = 0u; i < numFiles; ++i)
 		{
 			fs::path file = files[i];
 			Do_ReadFile(file, &intermediate, triangulateMeshes);
 		}
+        if (cache)
+        {
+            cache->PrintStatistics();
+            s_cacheContext = CacheContext{};
+        }
+		Do_GenerateTangents(&intermediate);
+		if (processTextures)
+			Do_ProcessTextures(&intermediate);
+		Do_BuildLods(&intermediate, numLods);
+		if (buildClusters)
+			Do_BuildClusters(&intermediate);
+		Do_CompressAnimations(&intermediate);
+		Do_BakeSplines(&intermediate);
+		Do_CookCollisionMeshes(&intermediate);
 		OrbFile file;
+		if (loadTrace)
+		{
+			file.SetLoadOrder(std::move(loadOrder));
+			file.SetPayloadAlignment(OrbFile::sPageSize);
+		}
 		
 		if (append)
 			file.ParseFile(output);
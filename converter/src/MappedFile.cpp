@@ -0,0 +1,111 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace orbtool
+{
+
+#ifdef _WIN32
+    bool MappedFile::Open(const fs::path& filepath)
+    {
+        Close();
+        m_file = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE)
+        {
+            m_file = nullptr;
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size))
+        {
+            Close();
+            return false;
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size == 0u)
+            return true; // Empty files can't be mapped
+
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping)
+            m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file)
+            CloseHandle(m_file);
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0u;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return m_file != nullptr;
+    }
+#else
+    bool MappedFile::Open(const fs::path& filepath)
+    {
+        Close();
+        m_file = open(filepath.c_str(), O_RDONLY);
+        if (m_file < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(m_file, &info) != 0)
+        {
+            Close();
+            return false;
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size == 0u)
+            return true; // Empty files can't be mapped
+
+        auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (data == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(data);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data)
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        if (m_file >= 0)
+            close(m_file);
+        m_data = nullptr;
+        m_file = -1;
+        m_size = 0u;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return m_file >= 0;
+    }
+#endif
+
+}
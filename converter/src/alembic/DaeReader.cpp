@@ -1,17 +1,622 @@
 #include "alembic/DaeReader.hpp"
+#include "alembic/XmlStream.hpp"
 #include "implementation/misc/Logger.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
 
 namespace orbtool
 {
 
+    static constexpr uint32_t sNoIndex = std::numeric_limits<uint32_t>::max();
+
+    // @brief: a vertex is identified by the indices of its attributes
+    struct VertexKey
+    {
+        uint32_t position = sNoIndex;
+        uint32_t normal = sNoIndex;
+        uint32_t uv = sNoIndex;
+
+        bool operator==(const VertexKey& other) const
+        {
+            return position == other.position && normal == other.normal && uv == other.uv;
+        }
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey& key) const
+        {
+            auto hash = static_cast<uint64_t>(key.position) * 0x9e3779b97f4a7c15ull;
+            hash ^= (static_cast<uint64_t>(key.normal) + 0x7f4a7c15ull + (hash << 6) + (hash >> 2)) * 0xbf58476d1ce4e5b9ull;
+            hash ^= (static_cast<uint64_t>(key.uv) + 0x7f4a7c15ull + (hash << 6) + (hash >> 2)) * 0x94d049bb133111ebull;
+            return static_cast<size_t>(hash ^ (hash >> 31));
+        }
+    };
+
+    struct DaeReader::GeometryState
+    {
+        std::unordered_map<std::string, DaeSource> sources;
+        // @member: <vertices> id -> the inputs it is made of
+        std::unordered_map<std::string, std::vector<DaeInput>> vertexInputs;
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertices;
+    };
+
+    static bool IsWhitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // @method: removes the '#' of an url referencing an element of the document
+    static std::string StripUrl(std::string_view url)
+    {
+        if (!url.empty() && url.front() == '#')
+            url.remove_prefix(1);
+        return XmlStream::Decode(url);
+    }
+
+    static uint32_t ParseUInt(std::string_view str, uint32_t fallback)
+    {
+        uint32_t value = fallback;
+        std::from_chars(str.data(), str.data() + str.size(), value);
+        return value;
+    }
+
+    // @method: skips the current element including all of its children
+    static void SkipElement(XmlStream* xml)
+    {
+        auto depth = 0u;
+        while (true)
+        {
+            const auto event = xml->Next();
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file");
+            if (event == XmlEvent::START_ELEMENT)
+                ++depth;
+            else if (event == XmlEvent::END_ELEMENT && depth-- == 0u)
+                return;
+        }
+    }
+
+    // @method: converts the whitespace separated numbers of the current element
+    //  and passes them to consume. Returns after the end of the element
+    template<typename T, typename F>
+    static void ReadNumbers(XmlStream* xml, F&& consume)
+    {
+        const auto element = xml->Name();
+        auto depth = 0u;
+        while (true)
+        {
+            const auto event = xml->Next();
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in <%.*s>", static_cast<int>(element.size()), element.data());
+            if (event == XmlEvent::START_ELEMENT)
+                ++depth;
+            else if (event == XmlEvent::END_ELEMENT)
+            {
+                if (depth-- == 0u)
+                    return;
+            }
+            else if (depth == 0u)
+            {
+                const auto text = xml->Text();
+                auto cursor = text.data();
+                const auto end = cursor + text.size();
+                while (true)
+                {
+                    while (cursor < end && IsWhitespace(*cursor))
+                        ++cursor;
+                    if (cursor >= end)
+                        break;
+
+                    T value;
+                    const auto [next, error] = std::from_chars(cursor, end, value);
+                    if (error != std::errc())
+                        ORBIT_THROW("Corrupted collada file. Invalid number in <%.*s> at offset %zu", static_cast<int>(element.size()), element.data(), xml->Position());
+                    consume(value);
+                    cursor = next;
+                }
+            }
+        }
+    }
+
+    std::string DaeReader::ReadText(XmlStream* xml)
+    {
+        std::string text;
+        auto depth = 0u;
+        while (true)
+        {
+            const auto event = xml->Next();
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file");
+            if (event == XmlEvent::START_ELEMENT)
+                ++depth;
+            else if (event == XmlEvent::END_ELEMENT)
+            {
+                if (depth-- == 0u)
+                    break;
+            }
+            else
+                text += XmlStream::Decode(xml->Text());
+        }
+
+        const auto begin = std::find_if_not(text.begin(), text.end(), IsWhitespace);
+        const auto end = std::find_if_not(text.rbegin(), text.rend(), IsWhitespace).base();
+        return begin < end ? std::string(begin, end) : std::string();
+    }
+
+    void DaeReader::ReadImage(XmlStream* xml)
+    {
+        const auto id = StripUrl(xml->GetAttribute("id"));
+        const auto name = xml->GetAttribute("name");
+        DaeImage image;
+        image.name = name.empty() ? id : XmlStream::Decode(name);
+
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != "image")
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in image '%s'", id.c_str());
+            if (event != XmlEvent::START_ELEMENT || xml->Name() != "init_from")
+                continue;
+
+            // Exporters write absolute paths as file urls
+            auto path = ReadText(xml);
+            if (path.compare(0, 7, "file://") == 0)
+                path.erase(0, 7);
+            if (path.size() > 2u && path[0] == '/' && path[2] == ':')
+                path.erase(0, 1);
+            for (size_t i = 0u; (i = path.find("%20", i)) != std::string::npos;)
+                path.replace(i, 3, " ");
+            image.path = path;
+        }
+        m_images.emplace(id, std::move(image));
+    }
+
+    void DaeReader::ReadEffect(XmlStream* xml)
+    {
+        const auto id = StripUrl(xml->GetAttribute("id"));
+        DaeEffect effect;
+        // @note: textures reference a sampler, which references a surface, which references an image
+        std::unordered_map<std::string, std::string> surfaces;
+        std::unordered_map<std::string, std::string> samplers;
+        std::string param, channel, diffuseSampler, normalSampler;
+
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != "effect")
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in effect '%s'", id.c_str());
+            if (event == XmlEvent::END_ELEMENT)
+            {
+                if (xml->Name() == channel)
+                    channel.clear();
+                else if (xml->Name() == "newparam")
+                    param.clear();
+                continue;
+            }
+            if (event != XmlEvent::START_ELEMENT)
+                continue;
+
+            const auto element = xml->Name();
+            if (element == "newparam")
+                param = XmlStream::Decode(xml->GetAttribute("sid"));
+            else if (element == "image")
+                ReadImage(xml);
+            else if (element == "init_from" && !param.empty())
+                surfaces[param] = ReadText(xml);
+            else if (element == "source" && !param.empty())
+                samplers[param] = ReadText(xml);
+            else if (element == "instance_image" && !param.empty())
+                samplers[param] = StripUrl(xml->GetAttribute("url"));
+            else if (element == "emission" || element == "ambient" || element == "diffuse" || element == "specular" ||
+                element == "shininess" || element == "reflective" || element == "transparent" || element == "bump")
+                channel = std::string(element);
+            else if (element == "color" && (channel == "diffuse" || channel == "specular"))
+            {
+                auto& color = channel == "diffuse" ? effect.diffuse : effect.specular;
+                auto component = 0u;
+                ReadNumbers<float>(xml, [&](float value) {
+                    if (component < 4u)
+                        color[component++] = value;
+                });
+            }
+            else if (element == "float" && channel == "shininess")
+                ReadNumbers<float>(xml, [&](float value) { effect.shininess = value; });
+            else if (element == "texture" && channel == "diffuse")
+                diffuseSampler = XmlStream::Decode(xml->GetAttribute("texture"));
+            else if (element == "texture" && channel == "bump")
+                normalSampler = XmlStream::Decode(xml->GetAttribute("texture"));
+        }
+
+        // Some exporters reference the surface or the image directly
+        auto resolve = [&](const std::string& sampler) {
+            auto samplerIt = samplers.find(sampler);
+            const auto surface = samplerIt != samplers.end() ? samplerIt->second : sampler;
+            auto surfaceIt = surfaces.find(surface);
+            return surfaceIt != surfaces.end() ? surfaceIt->second : surface;
+        };
+        if (!diffuseSampler.empty())
+            effect.diffuseImage = resolve(diffuseSampler);
+        if (!normalSampler.empty())
+            effect.normalImage = resolve(normalSampler);
+        m_effects.emplace(id, std::move(effect));
+    }
+
+    void DaeReader::ReadMaterial(XmlStream* xml)
+    {
+        const auto id = StripUrl(xml->GetAttribute("id"));
+        const auto name = xml->GetAttribute("name");
+        DaeMaterial material;
+        material.name = name.empty() ? id : XmlStream::Decode(name);
+
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != "material")
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in material '%s'", id.c_str());
+            if (event == XmlEvent::START_ELEMENT && xml->Name() == "instance_effect")
+                material.effect = StripUrl(xml->GetAttribute("url"));
+        }
+        m_materials.emplace(id, std::move(material));
+    }
+
+    void DaeReader::ReadGeometry(XmlStream* xml)
+    {
+        DaeGeometry geometry;
+        geometry.id = StripUrl(xml->GetAttribute("id"));
+        const auto name = xml->GetAttribute("name");
+        geometry.name = name.empty() ? geometry.id : XmlStream::Decode(name);
+
+        // Only the current geometry's sources are kept, they are released once it is converted
+        GeometryState state;
+        std::string source, vertices;
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != "geometry")
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in geometry '%s'", geometry.id.c_str());
+            if (event == XmlEvent::END_ELEMENT && xml->Name() == "vertices")
+                vertices.clear();
+            if (event != XmlEvent::START_ELEMENT)
+                continue;
+
+            const auto element = xml->Name();
+            if (element == "source")
+                source = StripUrl(xml->GetAttribute("id"));
+            else if (element == "float_array")
+            {
+                auto& values = state.sources[source].values;
+                values.reserve(ParseUInt(xml->GetAttribute("count"), 0u));
+                ReadNumbers<float>(xml, [&](float value) { values.push_back(value); });
+            }
+            else if (element == "accessor")
+                state.sources[source].stride = std::max(ParseUInt(xml->GetAttribute("stride"), 1u), 1u);
+            else if (element == "vertices")
+                vertices = StripUrl(xml->GetAttribute("id"));
+            else if (element == "input" && !vertices.empty())
+            {
+                DaeInput input;
+                input.semantic = std::string(xml->GetAttribute("semantic"));
+                input.source = StripUrl(xml->GetAttribute("source"));
+                state.vertexInputs[vertices].push_back(std::move(input));
+            }
+            else if (element == "triangles" || element == "polylist" || element == "polygons")
+                ReadPrimitives(xml, &state, &geometry);
+            else if (element == "lines" || element == "linestrips" || element == "trifans" || element == "tristrips")
+            {
+                ORBIT_LOG("Skipping <%.*s> of geometry '%s'. Only triangles and polygons are supported",
+                    static_cast<int>(element.size()), element.data(), geometry.id.c_str());
+                SkipElement(xml);
+            }
+        }
+
+        for (auto& submesh : geometry.mesh.submeshes)
+            submesh.vertexCount = geometry.mesh.vertices.size();
+        if (!geometry.mesh.indices.empty())
+            m_geometries.emplace_back(std::move(geometry));
+    }
+
+    void DaeReader::ReadPrimitives(XmlStream* xml, GeometryState* state, DaeGeometry* geometry)
+    {
+        struct Channel
+        {
+            const DaeSource* source = nullptr;
+            uint32_t offset = 0u;
+        };
+
+        const auto type = xml->Name();
+        const auto isPolygons = type == "polygons";
+        const auto isTriangles = type == "triangles";
+        auto& mesh = geometry->mesh;
+
+        SubMesh submesh;
+        submesh.startIndex = mesh.indices.size();
+        const auto material = XmlStream::Decode(xml->GetAttribute("material"));
+        if (geometry->symbol.empty())
+            geometry->symbol = material;
+
+        std::vector<DaeInput> inputs;
+        std::vector<uint32_t> vertexCounts;
+        Channel position, normal, uv;
+        auto stride = 0u;
+        auto uvSet = sNoIndex;
+        auto resolve = [&]() {
+            auto assign = [&](const std::string& semantic, const std::string& source, uint32_t offset, uint32_t set) {
+                auto it = state->sources.find(source);
+                if (it == state->sources.end())
+                {
+                    ORBIT_ERROR("Geometry '%s' references the unknown source '%s'", geometry->id.c_str(), source.c_str());
+                    return;
+                }
+                if (semantic == "POSITION")
+                    position = Channel{ &it->second, offset };
+                else if (semantic == "NORMAL")
+                    normal = Channel{ &it->second, offset };
+                else if (semantic == "TEXCOORD" && set < uvSet)
+                {
+                    uv = Channel{ &it->second, offset };
+                    uvSet = set;
+                }
+            };
+
+            for (const auto& input : inputs)
+            {
+                stride = std::max(stride, input.offset + 1u);
+                if (input.semantic != "VERTEX")
+                {
+                    assign(input.semantic, input.source, input.offset, input.set);
+                    continue;
+                }
+                for (const auto& vertexInput : state->vertexInputs[input.source])
+                    assign(vertexInput.semantic, vertexInput.source, input.offset, 0u);
+            }
+            if (!position.source)
+                ORBIT_THROW("Geometry '%s' has no positions", geometry->id.c_str());
+        };
+
+        auto fetch = [&](const Channel& channel, uint32_t index, uint32_t components) {
+            const auto begin = static_cast<size_t>(index) * channel.source->stride;
+            if (begin + components > channel.source->values.size())
+                ORBIT_THROW("Corrupted collada file. Index %u is out of range in geometry '%s'", index, geometry->id.c_str());
+            return channel.source->values.data() + begin;
+        };
+
+        // @note: maps the attribute indices of a corner to a vertex, creating it on first use
+        auto corner = [&](const uint32_t* indices) {
+            VertexKey key;
+            key.position = indices[position.offset];
+            if (normal.source)
+                key.normal = indices[normal.offset];
+            if (uv.source)
+                key.uv = indices[uv.offset];
+
+            auto [it, inserted] = state->vertices.emplace(key, static_cast<uint32_t>(mesh.vertices.size()));
+            if (inserted)
+            {
+                OrbVertex vertex{ Vector3f::Zero(), Vector3f::Zero(), Vector3f::Zero(), Vector2f::Zero() };
+                const auto p = fetch(position, key.position, 3u);
+                vertex.position = ConvertAxis(Vector3f{ p[0], p[1], p[2] }) * m_unitScale;
+                if (normal.source)
+                {
+                    const auto n = fetch(normal, key.normal, 3u);
+                    vertex.normal = ConvertAxis(Vector3f{ n[0], n[1], n[2] }).normalized();
+                }
+                if (uv.source)
+                {
+                    const auto t = fetch(uv, key.uv, 2u);
+                    vertex.textureCoords = Vector2f{ t[0], t[1] };
+                }
+                mesh.vertices.push_back(vertex);
+            }
+            return it->second;
+        };
+
+        std::vector<uint32_t> tuple, polygon;
+        auto polygonIndex = 0u;
+        auto emit = [&]() {
+            if (polygon.size() > 3u && m_warnOnQuads)
+                ORBIT_THROW("This collada file contains polygons. Triangulate your mesh or use -triangulate.");
+            // Naive fan triangulation like the other readers
+            for (size_t i = 1u; i + 1u < polygon.size(); ++i)
+                mesh.indices.insert(mesh.indices.end(), { polygon[0], polygon[i], polygon[i + 1u] });
+            polygon.clear();
+            ++polygonIndex;
+        };
+        auto expectedCorners = [&]() -> size_t {
+            if (isTriangles)
+                return 3u;
+            while (polygonIndex < vertexCounts.size() && vertexCounts[polygonIndex] == 0u)
+                ++polygonIndex;
+            if (polygonIndex >= vertexCounts.size())
+                ORBIT_THROW("Corrupted collada file. <p> has more polygons than <vcount> in geometry '%s'", geometry->id.c_str());
+            return vertexCounts[polygonIndex];
+        };
+
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != type)
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in geometry '%s'", geometry->id.c_str());
+            if (event != XmlEvent::START_ELEMENT)
+                continue;
+
+            const auto element = xml->Name();
+            if (element == "input")
+            {
+                DaeInput input;
+                input.semantic = std::string(xml->GetAttribute("semantic"));
+                input.source = StripUrl(xml->GetAttribute("source"));
+                input.offset = ParseUInt(xml->GetAttribute("offset"), 0u);
+                input.set = ParseUInt(xml->GetAttribute("set"), 0u);
+                inputs.push_back(std::move(input));
+            }
+            else if (element == "vcount")
+                ReadNumbers<uint32_t>(xml, [&](uint32_t count) { vertexCounts.push_back(count); });
+            else if (element == "p")
+            {
+                if (stride == 0u)
+                    resolve();
+                // The indices are consumed while parsing, <p> is never stored
+                ReadNumbers<uint32_t>(xml, [&](uint32_t index) {
+                    tuple.push_back(index);
+                    if (tuple.size() < stride)
+                        return;
+                    polygon.push_back(corner(tuple.data()));
+                    tuple.clear();
+                    if (!isPolygons && polygon.size() == expectedCorners())
+                        emit();
+                });
+                // Every <p> of <polygons> is a single polygon
+                if (isPolygons)
+                    emit();
+            }
+            else if (element == "ph")
+                SkipElement(xml); // Polygons with holes are not supported
+        }
+
+        submesh.indexCount = mesh.indices.size() - submesh.startIndex;
+        if (submesh.indexCount > 0u)
+            mesh.submeshes.push_back(submesh);
+    }
+
+    void DaeReader::ReadInstanceGeometry(XmlStream* xml)
+    {
+        auto& bindings = m_bindings[StripUrl(xml->GetAttribute("url"))];
+
+        XmlEvent event;
+        while ((event = xml->Next()) != XmlEvent::END_ELEMENT || xml->Name() != "instance_geometry")
+        {
+            if (event == XmlEvent::END_OF_DOCUMENT)
+                ORBIT_THROW("Corrupted collada file. Unexpected end of file in <instance_geometry>");
+            if (event == XmlEvent::START_ELEMENT && xml->Name() == "instance_material")
+                bindings[XmlStream::Decode(xml->GetAttribute("symbol"))] = StripUrl(xml->GetAttribute("target"));
+        }
+    }
+
+    Vector3f DaeReader::ConvertAxis(const Vector3f& v) const
+    {
+        switch (m_upAxis)
+        {
+        case UpAxis::X_UP: return Vector3f{ -v.y(), v.x(), v.z() };
+        case UpAxis::Z_UP: return Vector3f{ v.x(), v.z(), -v.y() };
+        default: return v;
+        }
+    }
+
+    void DaeReader::AppendObjects()
+    {
+        std::unordered_set<std::string> textures;
+        auto appendTexture = [&](const std::string& imageId) -> std::string {
+            auto it = m_images.find(imageId);
+            if (it == m_images.end())
+            {
+                ORBIT_ERROR("Unknown image '%s'", imageId.c_str());
+                return std::string();
+            }
+            if (textures.insert(it->second.name).second)
+            {
+                OrbTexture texture;
+                texture.texturePath = it->second.path;
+                m_orb->AppendObject(it->second.name, std::move(texture));
+            }
+            return it->second.name;
+        };
+
+        for (const auto& [id, daeMaterial] : m_materials)
+        {
+            OrbMaterial material;
+            material.diffuse = Vector4f::Ones();
+            material.specular = Vector4f::Zero();
+            material.roughness = 1.f;
+            auto effectIt = m_effects.find(daeMaterial.effect);
+            if (effectIt != m_effects.end())
+            {
+                const auto& effect = effectIt->second;
+                material.diffuse = effect.diffuse;
+                material.specular = effect.specular;
+                // Blinn-Phong exponent to roughness
+                material.roughness = std::clamp(std::sqrt(2.f / (std::max(effect.shininess, 0.f) + 2.f)), 0.f, 1.f);
+                if (!effect.diffuseImage.empty())
+                    material.diffuseTextureId = appendTexture(effect.diffuseImage);
+                if (!effect.normalImage.empty())
+                    material.normalMapId = appendTexture(effect.normalImage);
+            }
+            m_orb->AppendObject(daeMaterial.name, std::move(material));
+        }
+
+        for (auto& geometry : m_geometries)
+        {
+            // The scene binds the symbols of the primitives to materials. Simple
+            // exporters use the material's id as its symbol and don't bind anything
+            auto materialId = geometry.symbol;
+            auto bindingIt = m_bindings.find(geometry.id);
+            if (bindingIt != m_bindings.end())
+            {
+                auto symbolIt = bindingIt->second.find(geometry.symbol);
+                if (symbolIt != bindingIt->second.end())
+                    materialId = symbolIt->second;
+            }
+            auto materialIt = m_materials.find(materialId);
+            if (materialIt != m_materials.end())
+                geometry.mesh.material = materialIt->second.name;
+            m_orb->AppendObject(geometry.name, std::move(geometry.mesh));
+        }
+    }
+
     bool DaeReader::ReadFile(const fs::path& filepath, OrbIntermediate* orb)
     {
+        // Map the file before OpenFile() changes the working directory
+        MappedFile file;
+        if (!file.Open(filepath))
+        {
+            ORBIT_ERROR("Unable to map file '%s'", filepath.generic_string().c_str());
+            return false;
+        }
         if (!OpenFile(filepath))
             return false;
 
-        ORBIT_THROW("Reader for this file type not implemented yet: '%s'", filepath.generic_string().c_str());
-        
+        m_orb = orb;
+        const auto begin = reinterpret_cast<const char*>(file.Data());
+        XmlStream xml(begin, begin + file.Size());
+
+        XmlEvent event;
+        while ((event = xml.Next()) != XmlEvent::END_OF_DOCUMENT)
+        {
+            if (event != XmlEvent::START_ELEMENT)
+                continue;
+
+            const auto element = xml.Name();
+            if (element == "unit")
+            {
+                const auto meter = xml.GetAttribute("meter");
+                std::from_chars(meter.data(), meter.data() + meter.size(), m_unitScale);
+            }
+            else if (element == "up_axis")
+            {
+                const auto axis = ReadText(&xml);
+                m_upAxis = axis == "Z_UP" ? UpAxis::Z_UP : (axis == "X_UP" ? UpAxis::X_UP : UpAxis::Y_UP);
+            }
+            else if (element == "image")
+                ReadImage(&xml);
+            else if (element == "effect")
+                ReadEffect(&xml);
+            else if (element == "material")
+                ReadMaterial(&xml);
+            else if (element == "geometry")
+                ReadGeometry(&xml);
+            else if (element == "instance_geometry")
+                ReadInstanceGeometry(&xml);
+        }
+
+        ORBIT_LOG("Read %zu geometries, %zu materials and %zu images from '%s'",
+            m_geometries.size(), m_materials.size(), m_images.size(), filepath.generic_string().c_str());
+        AppendObjects();
         return true;
     }
 
-}
\ No newline at end of file
+}
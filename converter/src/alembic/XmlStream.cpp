@@ -0,0 +1,194 @@
+#include "alembic/XmlStream.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <cstring>
+
+namespace orbtool
+{
+
+    static bool IsWhitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static bool IsNameEnd(char c)
+    {
+        return IsWhitespace(c) || c == '>' || c == '/' || c == '=';
+    }
+
+    XmlStream::XmlStream(const char* begin, const char* end) :
+        m_begin(begin),
+        m_cursor(begin),
+        m_end(end)
+    {
+        // Skip the byte order mark
+        if (StartsWith("\xEF\xBB\xBF"))
+            m_cursor += 3;
+    }
+
+    bool XmlStream::StartsWith(std::string_view str) const
+    {
+        return static_cast<size_t>(m_end - m_cursor) >= str.size() && std::memcmp(m_cursor, str.data(), str.size()) == 0;
+    }
+
+    void XmlStream::SkipPast(std::string_view terminator)
+    {
+        while (m_cursor < m_end && !StartsWith(terminator))
+            ++m_cursor;
+        if (m_cursor >= m_end)
+            ORBIT_THROW("Corrupted xml file. Expected '%.*s' before the end of the file", static_cast<int>(terminator.size()), terminator.data());
+        m_cursor += terminator.size();
+    }
+
+    void XmlStream::SkipWhitespace()
+    {
+        while (m_cursor < m_end && IsWhitespace(*m_cursor))
+            ++m_cursor;
+    }
+
+    std::string_view XmlStream::ReadName()
+    {
+        const auto begin = m_cursor;
+        while (m_cursor < m_end && !IsNameEnd(*m_cursor))
+            ++m_cursor;
+        if (m_cursor == begin)
+            ORBIT_THROW("Corrupted xml file. Expected a name at offset %zu", Position());
+        return std::string_view(begin, m_cursor - begin);
+    }
+
+    void XmlStream::ReadAttributes()
+    {
+        m_attributes.clear();
+        while (true)
+        {
+            SkipWhitespace();
+            if (m_cursor >= m_end)
+                ORBIT_THROW("Corrupted xml file. Unterminated element '%.*s'", static_cast<int>(m_name.size()), m_name.data());
+            if (*m_cursor == '>')
+            {
+                ++m_cursor;
+                return;
+            }
+            if (StartsWith("/>"))
+            {
+                m_cursor += 2;
+                m_pendingEnd = true;
+                return;
+            }
+
+            Attribute attribute;
+            attribute.name = ReadName();
+            SkipWhitespace();
+            if (m_cursor >= m_end || *m_cursor != '=')
+                ORBIT_THROW("Corrupted xml file. Expected '=' at offset %zu", Position());
+            ++m_cursor;
+            SkipWhitespace();
+            if (m_cursor >= m_end || (*m_cursor != '"' && *m_cursor != '\''))
+                ORBIT_THROW("Corrupted xml file. Expected a quoted value at offset %zu", Position());
+            const auto quote = *m_cursor++;
+            const auto begin = m_cursor;
+            while (m_cursor < m_end && *m_cursor != quote)
+                ++m_cursor;
+            if (m_cursor >= m_end)
+                ORBIT_THROW("Corrupted xml file. Unterminated attribute value at offset %zu", Position());
+            attribute.value = std::string_view(begin, m_cursor - begin);
+            ++m_cursor;
+            m_attributes.push_back(attribute);
+        }
+    }
+
+    XmlEvent XmlStream::Next()
+    {
+        if (m_pendingEnd)
+        {
+            m_pendingEnd = false;
+            m_attributes.clear();
+            return XmlEvent::END_ELEMENT;
+        }
+
+        while (m_cursor < m_end)
+        {
+            if (*m_cursor != '<')
+            {
+                const auto begin = m_cursor;
+                auto whitespace = true;
+                for (; m_cursor < m_end && *m_cursor != '<'; ++m_cursor)
+                    whitespace = whitespace && IsWhitespace(*m_cursor);
+                if (whitespace)
+                    continue;
+                m_text = std::string_view(begin, m_cursor - begin);
+                return XmlEvent::TEXT;
+            }
+
+            if (StartsWith("<!--"))
+                SkipPast("-->");
+            else if (StartsWith("<![CDATA["))
+            {
+                m_cursor += 9;
+                const auto begin = m_cursor;
+                SkipPast("]]>");
+                m_text = std::string_view(begin, m_cursor - 3 - begin);
+                return XmlEvent::TEXT;
+            }
+            else if (StartsWith("<?") || StartsWith("<!"))
+                SkipPast(">");
+            else if (StartsWith("</"))
+            {
+                m_cursor += 2;
+                m_name = ReadName();
+                SkipPast(">");
+                m_attributes.clear();
+                return XmlEvent::END_ELEMENT;
+            }
+            else
+            {
+                ++m_cursor;
+                m_name = ReadName();
+                ReadAttributes();
+                return XmlEvent::START_ELEMENT;
+            }
+        }
+        return XmlEvent::END_OF_DOCUMENT;
+    }
+
+    std::string_view XmlStream::GetAttribute(std::string_view name) const
+    {
+        for (const auto& attribute : m_attributes)
+        {
+            if (attribute.name == name)
+                return attribute.value;
+        }
+        return std::string_view();
+    }
+
+    std::string XmlStream::Decode(std::string_view str)
+    {
+        static const std::pair<std::string_view, char> entities[] = {
+            { "&amp;", '&' }, { "&lt;", '<' }, { "&gt;", '>' }, { "&quot;", '"' }, { "&apos;", '\'' }
+        };
+
+        std::string result;
+        result.reserve(str.size());
+        for (size_t i = 0u; i < str.size(); ++i)
+        {
+            auto replaced = false;
+            if (str[i] == '&')
+            {
+                for (const auto& [entity, c] : entities)
+                {
+                    if (str.compare(i, entity.size(), entity) == 0)
+                    {
+                        result.push_back(c);
+                        i += entity.size() - 1u;
+                        replaced = true;
+                        break;
+                    }
+                }
+            }
+            if (!replaced)
+                result.push_back(str[i]);
+        }
+        return result;
+    }
+
+}
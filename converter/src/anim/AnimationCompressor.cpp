@@ -0,0 +1,152 @@
+#include "anim/AnimationCompressor.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace orbtool
+{
+
+    // @brief: the compressed channels of a single joint
+    struct CompressedTrack
+    {
+        std::vector<uint16_t> rotationFrames;
+        std::vector<orbit::QuantizedQuaternion> rotations;
+        std::vector<uint16_t> translationFrames;
+        std::vector<Vector3f> translations;
+        std::vector<uint16_t> scaleFrames;
+        std::vector<Vector3f> scales;
+    };
+
+    static Quaternionf ToQuaternion(const float* q)
+    {
+        return Quaternionf(q[3], q[0], q[1], q[2]);
+    }
+
+    // @method: interpolates like the runtime does (normalized lerp along the shorter arc)
+    static Quaternionf Nlerp(const Quaternionf& a, const Quaternionf& b, float t)
+    {
+        const auto sign = a.dot(b) < 0.f ? -1.f : 1.f;
+        return Quaternionf(a.coeffs() * (1.f - t) + b.coeffs() * (t * sign)).normalized();
+    }
+
+    // @method: returns the angle between two rotations. acos() of the dot product
+    //  is too imprecise for the small angles the tolerance is about
+    static float Angle(const Quaternionf& a, const Quaternionf& b)
+    {
+        return 2.f * std::asin(std::min((a.conjugate() * b).vec().norm(), 1.f));
+    }
+
+    template<typename Error>
+    std::vector<uint32_t> AnimationCompressor::ReduceKeys(uint32_t numFrames, float tolerance, Error&& error)
+    {
+        auto constant = true;
+        for (auto frame = 1u; frame < numFrames && constant; ++frame)
+            constant = error(0u, 0u, frame) <= tolerance;
+        if (constant)
+            return { 0u };
+
+        // Greedily extend every segment as long as all frames in between are reconstructed
+        std::vector<uint32_t> keys{ 0u };
+        auto start = 0u;
+        for (auto end = 2u; end < numFrames; ++end)
+        {
+            for (auto frame = start + 1u; frame < end; ++frame)
+            {
+                if (error(start, end, frame) > tolerance)
+                {
+                    start = end - 1u;
+                    keys.push_back(start);
+                    break;
+                }
+            }
+        }
+        keys.push_back(numFrames - 1u);
+        return keys;
+    }
+
+    void AnimationCompressor::Compress(OrbAnimationClip* clip)
+    {
+        if (clip->IsCompressed() || clip->numFrames == 0u)
+            return;
+        if (clip->numFrames > std::numeric_limits<uint16_t>::max())
+            ORBIT_THROW("Animation clips are limited to %u frames, this one has %u", std::numeric_limits<uint16_t>::max(), clip->numFrames);
+
+        const auto numFrames = clip->numFrames;
+        const auto numJoints = static_cast<uint32_t>(clip->samples.size() / numFrames);
+        auto sample = [&](uint32_t frame, uint32_t joint) -> const JointPose& {
+            return clip->samples[static_cast<size_t>(frame) * numJoints + joint];
+        };
+
+        std::vector<CompressedTrack> tracks(numJoints);
+        ParallelFor(numJoints, [&](size_t joint) {
+            auto& track = tracks[joint];
+            const auto j = static_cast<uint32_t>(joint);
+
+            // Errors are measured against the quantized rotations the runtime will see
+            std::vector<orbit::QuantizedQuaternion> quantized(numFrames);
+            std::vector<Quaternionf> decoded(numFrames);
+            for (auto frame = 0u; frame < numFrames; ++frame)
+            {
+                quantized[frame] = orbit::QuantizedQuaternion::Encode(sample(frame, j).rotation);
+                float q[4];
+                quantized[frame].Decode(q);
+                decoded[frame] = ToQuaternion(q);
+            }
+            auto rotationKeys = ReduceKeys(numFrames, sRotationTolerance, [&](uint32_t a, uint32_t b, uint32_t frame) {
+                const auto t = a == b ? 0.f : static_cast<float>(frame - a) / static_cast<float>(b - a);
+                return Angle(ToQuaternion(sample(frame, j).rotation), Nlerp(decoded[a], decoded[b], t));
+            });
+            for (auto key : rotationKeys)
+            {
+                track.rotationFrames.push_back(static_cast<uint16_t>(key));
+                track.rotations.push_back(quantized[key]);
+            }
+
+            auto reduceVectors = [&](float (JointPose::* member)[3], float tolerance, std::vector<uint16_t>* frames, std::vector<Vector3f>* values, bool relative) {
+                auto value = [&](uint32_t frame) -> Vector3f { return Map<const Vector3f>(sample(frame, j).*member); };
+                auto keys = ReduceKeys(numFrames, tolerance, [&](uint32_t a, uint32_t b, uint32_t frame) {
+                    const auto t = a == b ? 0.f : static_cast<float>(frame - a) / static_cast<float>(b - a);
+                    const Vector3f difference = value(frame) - (value(a) * (1.f - t) + value(b) * t);
+                    return relative ? difference.cwiseAbs().maxCoeff() : difference.norm();
+                });
+                for (auto key : keys)
+                {
+                    frames->push_back(static_cast<uint16_t>(key));
+                    values->push_back(value(key));
+                }
+            };
+            reduceVectors(&JointPose::translation, sTranslationTolerance, &track.translationFrames, &track.translations, false);
+            reduceVectors(&JointPose::scale, sScaleTolerance, &track.scaleFrames, &track.scales, true);
+        });
+
+        auto numKeys = 0u;
+        for (const auto& track : tracks)
+        {
+            clip->tracks.push_back(orbit::AnimationTrackHeader{
+                static_cast<uint32_t>(track.rotations.size()),
+                static_cast<uint32_t>(track.translations.size()),
+                static_cast<uint32_t>(track.scales.size())
+            });
+            clip->rotationFrames.insert(clip->rotationFrames.end(), track.rotationFrames.begin(), track.rotationFrames.end());
+            clip->rotations.insert(clip->rotations.end(), track.rotations.begin(), track.rotations.end());
+            clip->translationFrames.insert(clip->translationFrames.end(), track.translationFrames.begin(), track.translationFrames.end());
+            clip->translations.insert(clip->translations.end(), track.translations.begin(), track.translations.end());
+            clip->scaleFrames.insert(clip->scaleFrames.end(), track.scaleFrames.begin(), track.scaleFrames.end());
+            clip->scales.insert(clip->scales.end(), track.scales.begin(), track.scales.end());
+            numKeys += static_cast<uint32_t>(track.rotations.size() + track.translations.size() + track.scales.size());
+        }
+
+        const auto rawSize = clip->samples.size() * sizeof(JointPose);
+        const auto compressedSize = clip->tracks.size() * sizeof(orbit::AnimationTrackHeader) +
+            clip->rotations.size() * (sizeof(uint16_t) + sizeof(orbit::QuantizedQuaternion)) +
+            (clip->translations.size() + clip->scales.size()) * (sizeof(uint16_t) + sizeof(Vector3f));
+        ORBIT_LOG("Compressed %u frames of %u joints to %u keys (%zu -> %zu bytes)",
+            numFrames, numJoints, numKeys, rawSize, compressedSize);
+
+        clip->samples.clear();
+        clip->samples.shrink_to_fit();
+    }
+
+}
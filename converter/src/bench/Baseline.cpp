@@ -0,0 +1,182 @@
+#include "bench/Baseline.hpp"
+#include "MappedFile.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+
+namespace orbtool
+{
+
+    // @brief: reads the subset of JSON the baseline uses (objects, numbers and
+    //  strings) and flattens it into "a.b.c" -> number
+    class JsonReader
+    {
+    private:
+        const char* m_cursor;
+        const char* m_end;
+        std::unordered_map<std::string, double>* m_values;
+    private:
+        void SkipWhitespace()
+        {
+            while (m_cursor < m_end && std::isspace(static_cast<unsigned char>(*m_cursor)))
+                ++m_cursor;
+        }
+        bool Match(char c)
+        {
+            SkipWhitespace();
+            if (m_cursor < m_end && *m_cursor == c)
+            {
+                ++m_cursor;
+                return true;
+            }
+            return false;
+        }
+        bool ReadString(std::string* str)
+        {
+            if (!Match('"'))
+                return false;
+            while (m_cursor < m_end && *m_cursor != '"')
+            {
+                if (*m_cursor == '\\' && m_cursor + 1 < m_end)
+                    ++m_cursor;
+                str->push_back(*m_cursor++);
+            }
+            return Match('"');
+        }
+        bool ReadValue(const std::string& path)
+        {
+            SkipWhitespace();
+            if (m_cursor >= m_end)
+                return false;
+            if (*m_cursor == '{')
+            {
+                ++m_cursor;
+                if (Match('}'))
+                    return true;
+                do
+                {
+                    std::string key;
+                    if (!ReadString(&key) || !Match(':') || !ReadValue(path.empty() ? key : path + "." + key))
+                        return false;
+                } while (Match(','));
+                return Match('}');
+            }
+            if (*m_cursor == '"')
+            {
+                std::string ignored;
+                return ReadString(&ignored);
+            }
+
+            char* end = nullptr;
+            const auto value = std::strtod(m_cursor, &end);
+            if (end == m_cursor)
+                return false;
+            m_cursor = end;
+            (*m_values)[path] = value;
+            return true;
+        }
+    public:
+        JsonReader(const char* begin, const char* end, std::unordered_map<std::string, double>* values) :
+            m_cursor(begin), m_end(end), m_values(values) {}
+
+        bool Read() { return ReadValue(std::string()) && (SkipWhitespace(), m_cursor == m_end); }
+    };
+
+    bool Baseline::Load(const fs::path& path)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+        {
+            ORBIT_ERROR("Unable to open baseline '%s'", path.generic_string().c_str());
+            return false;
+        }
+
+        std::unordered_map<std::string, double> values;
+        auto begin = reinterpret_cast<const char*>(file.Data());
+        if (!JsonReader(begin, begin + file.Size(), &values).Read())
+        {
+            ORBIT_ERROR("Baseline '%s' is not valid JSON", path.generic_string().c_str());
+            return false;
+        }
+        if (values["version"] != sVersion)
+        {
+            ORBIT_ERROR("Baseline '%s' has version %g, expected %u", path.generic_string().c_str(), values["version"], sVersion);
+            return false;
+        }
+
+        static const std::string prefix = "results.";
+        for (const auto& [name, value] : values)
+        {
+            // Keys contain a '/' but no '.', so the metric follows the last dot
+            const auto dot = name.rfind('.');
+            if (name.compare(0, prefix.size(), prefix) != 0 || dot < prefix.size())
+                continue;
+            auto& entry = m_entries[name.substr(prefix.size(), dot - prefix.size())];
+            const auto metric = name.substr(dot + 1u);
+            if (metric == "mbps")
+                entry.megabytesPerSecond = value;
+            else if (metric == "verticesPerSecond")
+                entry.verticesPerSecond = value;
+            else if (metric == "peakRssMB")
+                entry.peakRssMegabytes = value;
+        }
+        return true;
+    }
+
+    bool Baseline::Save(const fs::path& path, const std::vector<StageResult>& results)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            ORBIT_ERROR("Unable to write baseline '%s'", path.generic_string().c_str());
+            return false;
+        }
+
+        char line[256];
+        file << "{\n\t\"version\": " << sVersion << ",\n\t\"results\": {\n";
+        for (auto i = 0u; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+            snprintf(line, sizeof(line), "\t\t\"%s\": { \"mbps\": %.3f, \"verticesPerSecond\": %.1f, \"peakRssMB\": %.2f }%s\n",
+                result.Key().c_str(), result.MegabytesPerSecond(), result.VerticesPerSecond(), result.PeakRssMegabytes(),
+                i + 1u < results.size() ? "," : "");
+            file << line;
+        }
+        file << "\t}\n}\n";
+        ORBIT_LOG("Wrote baseline with %zu results to '%s'", results.size(), path.generic_string().c_str());
+        return file.good();
+    }
+
+    uint32_t Baseline::Compare(const std::vector<StageResult>& results, double threshold) const
+    {
+        auto regressions = 0u;
+        auto report = [&](const StageResult& result, const char* metric, double baseline, double current) {
+            ORBIT_LOG("REGRESSION %s: %s %.2f -> %.2f (%+.1f%%)", result.Key().c_str(), metric, baseline, current, (current / baseline - 1.0) * 100.0);
+            ++regressions;
+        };
+
+        for (const auto& result : results)
+        {
+            auto it = m_entries.find(result.Key());
+            if (it == m_entries.end())
+            {
+                ORBIT_LOG("%s is not part of the baseline", result.Key().c_str());
+                continue;
+            }
+
+            const auto& entry = it->second;
+            if (entry.megabytesPerSecond > 0.0 && result.MegabytesPerSecond() < entry.megabytesPerSecond * (1.0 - threshold))
+                report(result, "MB/s", entry.megabytesPerSecond, result.MegabytesPerSecond());
+            if (entry.verticesPerSecond > 0.0 && result.VerticesPerSecond() < entry.verticesPerSecond * (1.0 - threshold))
+                report(result, "vertices/s", entry.verticesPerSecond, result.VerticesPerSecond());
+            if (entry.peakRssMegabytes > 0.0 && result.PeakRssMegabytes() > entry.peakRssMegabytes * (1.0 + threshold))
+                report(result, "peak RSS MB", entry.peakRssMegabytes, result.PeakRssMegabytes());
+        }
+        return regressions;
+    }
+
+}
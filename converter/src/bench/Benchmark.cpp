@@ -0,0 +1,237 @@
+#include "implementation/misc/Logger.hpp"
+#include "orb/OrbFile.hpp"
+#include "orb/OrbIntermediate.hpp"
+#include "wavefront/ObjectReader.hpp"
+#include "fbx/FbxReader.hpp"
+#include "raw/RawReader.hpp"
+#include "bench/SyntheticMesh.hpp"
+#include "bench/Baseline.hpp"
+#include "ArgumentParser.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#include <fstream>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+
+using namespace orbtool;
+
+// @method: returns the current resident set size in bytes
+static uint64_t CurrentRss()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.WorkingSetSize;
+#else
+	uint64_t pages = 0u, resident = 0u;
+	std::ifstream statm("/proc/self/statm");
+	statm >> pages >> resident;
+	return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// @method: returns the highest resident set size of the process so far in bytes
+static uint64_t PeakRss()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage{};
+	getrusage(RUSAGE_SELF, &usage);
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024u;
+#endif
+}
+
+// @brief: measures the peak RSS of a single stage. The process peak can't be
+//	reset, so the stage's peak is sampled in the background. If the process
+//	peak grew during the stage it is exact and preferred over the samples
+class RssSampler
+{
+private:
+	std::atomic<bool> m_running{ true };
+	std::atomic<uint64_t> m_peak;
+	uint64_t m_processPeak;
+	std::thread m_thread;
+public:
+	RssSampler() :
+		m_peak(CurrentRss()),
+		m_processPeak(PeakRss())
+	{
+		m_thread = std::thread([this]() {
+			while (m_running)
+			{
+				const auto rss = CurrentRss();
+				auto peak = m_peak.load();
+				while (rss > peak && !m_peak.compare_exchange_weak(peak, rss));
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+	}
+
+	uint64_t Stop()
+	{
+		m_running = false;
+		m_thread.join();
+		const auto processPeak = PeakRss();
+		return processPeak > m_processPeak ? processPeak : std::max(m_peak.load(), CurrentRss());
+	}
+};
+
+static uint64_t CountVertices(const OrbIntermediate& intermediate)
+{
+	uint64_t vertices = 0u;
+	for (auto i = 0u; i < intermediate.NumObjects(); ++i)
+	{
+		if (intermediate.GetObjectType(i) == ResourceType::MESH)
+			vertices += intermediate.GetObject<OrbMesh>(i).vertices.size();
+	}
+	return vertices;
+}
+
+// @method: runs the stage repeatedly and keeps the fastest run and the highest peak
+// @param stage: runs the stage once and returns the number of vertices it produced
+static StageResult RunStage(const std::string& corpus, const char* name, uint64_t bytes, uint32_t repeat, const std::function<uint64_t()>& stage)
+{
+	StageResult result{ corpus, name };
+	result.bytes = bytes;
+	result.seconds = -1.0;
+	for (auto i = 0u; i < repeat; ++i)
+	{
+		RssSampler sampler;
+		const auto begin = std::chrono::steady_clock::now();
+		result.vertices = stage();
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		result.peakRss = std::max(result.peakRss, sampler.Stop());
+		if (result.seconds < 0.0 || seconds < result.seconds)
+			result.seconds = seconds;
+	}
+
+	// Stages without vertices leave the column empty instead of reporting 0 verts/s
+	char verticesPerSecond[32] = "";
+	if (result.vertices > 0u)
+		snprintf(verticesPerSecond, sizeof(verticesPerSecond), "%12.0f verts/s", result.VerticesPerSecond());
+	ORBIT_LOG("%-20s %-28s %9.3f ms %9.2f MB/s %20s %9.2f MB peak",
+		corpus.c_str(), name, result.seconds * 1000.0, result.MegabytesPerSecond(), verticesPerSecond, result.PeakRssMegabytes());
+	return result;
+}
+
+// @method: writes the corpus entry in every input format and benchmarks all stages on it
+static void RunCorpusEntry(const SyntheticMesh& mesh, const fs::path& directory, uint32_t repeat, bool compressArrays, std::vector<StageResult>* results)
+{
+	const auto objPath = directory / (mesh.name + ".obj");
+	const auto fbxPath = directory / (mesh.name + ".fbx");
+	const auto rorbPath = directory / (mesh.name + ".rorb");
+	const auto orbPath = directory / (mesh.name + ".orb");
+	if (!SyntheticMeshes::WriteObj(mesh, objPath) || !SyntheticMeshes::WriteFbx(mesh, fbxPath, compressArrays) || !SyntheticMeshes::WriteRorb(mesh, rorbPath))
+		ORBIT_THROW("Unable to write the corpus entry '%s'", mesh.name.c_str());
+
+	results->push_back(RunStage(mesh.name, "FbxReader", fs::file_size(fbxPath), repeat, [&]() {
+		OrbIntermediate intermediate;
+		FbxReader reader;
+		reader.ReadFile(fbxPath, &intermediate);
+		return CountVertices(intermediate);
+	}));
+
+	results->push_back(RunStage(mesh.name, "WFObjectReader", fs::file_size(objPath), repeat, [&]() {
+		OrbIntermediate intermediate;
+		WFObjectReader reader;
+		reader.ReadFile(objPath, &intermediate);
+		return CountVertices(intermediate);
+	}));
+
+	results->push_back(RunStage(mesh.name, "RawReader", fs::file_size(rorbPath), repeat, [&]() {
+		OrbIntermediate intermediate;
+		RawReader reader;
+		reader.ReadFile(rorbPath, &intermediate);
+		// Raw orb files have no mesh directive, the stage is measured in MB/s only
+		return uint64_t{ 0u };
+	}));
+
+	// The intermediate is built outside of the measured region
+	OrbIntermediate intermediate;
+	FbxReader reader;
+	reader.ReadFile(fbxPath, &intermediate);
+	OrbFile orbFile;
+	orbFile.WriteIntermediate(intermediate, orbPath);
+	results->push_back(RunStage(mesh.name, "OrbFile::WriteIntermediate", fs::file_size(orbPath), repeat, [&]() {
+		orbFile.WriteIntermediate(intermediate, orbPath);
+		return CountVertices(intermediate);
+	}));
+}
+
+int main(int argc, const char** argv)
+{
+	ArgumentParser parser;
+	parser.RegisterArgument("Approximate number of vertices of each generated mesh (default 16384).", "vertices", "v");
+	parser.RegisterArgument("Number of runs per stage. The fastest run is reported (default 3).", "repeat", "r");
+	parser.RegisterArgument("Directory the corpus is written to (default: <temp>/orbtool_bench).", "directory", "d");
+	parser.RegisterArgument("Baseline JSON to compare against. Exits with 1 if a stage regressed.", "baseline", "b");
+	parser.RegisterArgument("Writes the results as a new baseline JSON.", "save", "s");
+	parser.RegisterArgument("Allowed relative regression against the baseline (default 0.1).", "threshold", "t");
+	parser.RegisterFlag("Store the fbx arrays uncompressed.", "uncompressed", "u");
+	parser.RegisterValidConfigurations({ "XXXXXXX" });
+	parser.WarnOnInvalid(true);
+	parser.WarnOnUnknownSwitch(true);
+	parser.AllowFreeArguments(false);
+	parser.SetExecutableName("orbtool_bench");
+	if (!parser.ParseArguments(argc, argv))
+		return -1;
+
+	auto argument = [&](const char* name) { auto value = parser.GetSwitch(name); return value ? *value : nullptr; };
+	const auto verticesStr = argument("vertices");
+	const auto repeatStr = argument("repeat");
+	const auto directoryStr = argument("directory");
+	const auto baselineStr = argument("baseline");
+	const auto saveStr = argument("save");
+	const auto thresholdStr = argument("threshold");
+
+	const auto numVertices = verticesStr ? static_cast<uint32_t>(strtoul(verticesStr, nullptr, 10)) : 16384u;
+	const auto repeat = std::max(repeatStr ? static_cast<uint32_t>(strtoul(repeatStr, nullptr, 10)) : 3u, 1u);
+	const auto threshold = thresholdStr ? strtod(thresholdStr, nullptr) : 0.1;
+	// Readers change the working directory, every path has to be absolute
+	const auto directory = fs::absolute(directoryStr ? fs::path(directoryStr) : fs::temp_directory_path() / "orbtool_bench");
+	const auto baselinePath = baselineStr ? fs::absolute(baselineStr) : fs::path();
+	const auto savePath = saveStr ? fs::absolute(saveStr) : fs::path();
+
+	std::vector<StageResult> results;
+	try {
+		fs::create_directories(directory);
+		for (auto shape : { SyntheticShape::GRID, SyntheticShape::SPHERE, SyntheticShape::SOUP })
+			RunCorpusEntry(SyntheticMeshes::Generate(shape, numVertices), directory, repeat, parser.GetSwitch("uncompressed") == nullptr, &results);
+	}
+	catch (std::exception& e) {
+		ORBIT_LOG("%s", e.what());
+		return -1;
+	}
+
+	if (!savePath.empty() && !Baseline::Save(savePath, results))
+		return -1;
+
+	if (!baselinePath.empty())
+	{
+		Baseline baseline;
+		if (!baseline.Load(baselinePath))
+			return -1;
+		const auto regressions = baseline.Compare(results, threshold);
+		if (regressions > 0u)
+		{
+			ORBIT_LOG("%u regressions against '%s' (threshold %.1f%%)", regressions, baselinePath.generic_string().c_str(), threshold * 100.0);
+			return 1;
+		}
+		ORBIT_LOG("No regressions against '%s' (threshold %.1f%%)", baselinePath.generic_string().c_str(), threshold * 100.0);
+	}
+	return 0;
+}
@@ -0,0 +1,368 @@
+#include "bench/SyntheticMesh.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "zlib.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace orbtool
+{
+
+    static constexpr float sPi = 3.14159265358979f;
+
+    // @brief: xorshift generator. The standard distributions are implementation
+    //  defined, this keeps the corpus identical across compilers
+    class Random
+    {
+    private:
+        uint32_t m_state;
+    public:
+        Random(uint32_t seed) : m_state(seed != 0u ? seed : 0x9e3779b9u) {}
+        uint32_t Next()
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+        // @method: returns a value in [0, 1)
+        float NextFloat() { return (Next() >> 8) * (1.f / 16777216.f); }
+    };
+
+    // @brief: builds a binary fbx node by node. Offsets are 64 bit (version 7500)
+    class FbxWriter
+    {
+    private:
+        static constexpr size_t sNullRecordSize = 25u;
+        struct OpenNode
+        {
+            size_t begin;
+            size_t propertiesBegin;
+            uint64_t numProperties;
+            bool hasChildren;
+        };
+        std::vector<uint8_t> m_data;
+        std::vector<OpenNode> m_stack;
+        bool m_compressArrays;
+    private:
+        template<typename T>
+        void Write(const T& value)
+        {
+            auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            m_data.insert(m_data.end(), bytes, bytes + sizeof(T));
+        }
+        template<typename T>
+        void Patch(size_t offset, const T& value)
+        {
+            std::memcpy(m_data.data() + offset, &value, sizeof(T));
+        }
+        void PatchPropertyListLength(OpenNode* node)
+        {
+            // The property list ends where the first child (or the node) begins
+            const auto length = static_cast<uint64_t>(m_data.size() - node->propertiesBegin);
+            Patch(node->begin + 8u, node->numProperties);
+            Patch(node->begin + 16u, length);
+        }
+        template<typename T>
+        void AddArray(char type, const std::vector<T>& values)
+        {
+            const auto byteLength = values.size() * sizeof(T);
+            Write(type);
+            Write(static_cast<uint32_t>(values.size()));
+            if (m_compressArrays)
+            {
+                auto compressedLength = compressBound(static_cast<uLong>(byteLength));
+                std::vector<uint8_t> compressed(compressedLength);
+                compress(compressed.data(), &compressedLength, reinterpret_cast<const Bytef*>(values.data()), static_cast<uLong>(byteLength));
+                Write(1u);
+                Write(static_cast<uint32_t>(compressedLength));
+                m_data.insert(m_data.end(), compressed.begin(), compressed.begin() + compressedLength);
+            }
+            else
+            {
+                auto bytes = reinterpret_cast<const uint8_t*>(values.data());
+                Write(0u);
+                Write(static_cast<uint32_t>(byteLength));
+                m_data.insert(m_data.end(), bytes, bytes + byteLength);
+            }
+            ++m_stack.back().numProperties;
+        }
+    public:
+        FbxWriter(bool compressArrays) : m_compressArrays(compressArrays)
+        {
+            static const char header[23] = "Kaydara FBX Binary\x20\x20\x00\x1a";
+            m_data.insert(m_data.end(), header, header + sizeof(header));
+            Write(7500u);
+        }
+
+        void BeginNode(const char* name)
+        {
+            if (!m_stack.empty() && !m_stack.back().hasChildren)
+            {
+                PatchPropertyListLength(&m_stack.back());
+                m_stack.back().hasChildren = true;
+            }
+            const auto nameLength = static_cast<uint8_t>(std::strlen(name));
+            OpenNode node{ m_data.size(), 0u, 0u, false };
+            m_data.resize(m_data.size() + 3u * sizeof(uint64_t), 0u);
+            Write(nameLength);
+            m_data.insert(m_data.end(), name, name + nameLength);
+            node.propertiesBegin = m_data.size();
+            m_stack.push_back(node);
+        }
+
+        void EndNode()
+        {
+            auto node = m_stack.back();
+            m_stack.pop_back();
+            if (node.hasChildren)
+                m_data.resize(m_data.size() + sNullRecordSize, 0u);
+            else
+                PatchPropertyListLength(&node);
+            Patch(node.begin, static_cast<uint64_t>(m_data.size()));
+        }
+
+        void AddInt64(int64_t value)
+        {
+            Write('L');
+            Write(value);
+            ++m_stack.back().numProperties;
+        }
+
+        // @note: fbx strings may contain zero bytes ("Name\0\1Class")
+        void AddString(const std::string& value)
+        {
+            Write('S');
+            Write(static_cast<uint32_t>(value.size()));
+            m_data.insert(m_data.end(), value.begin(), value.end());
+            ++m_stack.back().numProperties;
+        }
+
+        void AddDoubleArray(const std::vector<double>& values) { AddArray('d', values); }
+        void AddInt32Array(const std::vector<int32_t>& values) { AddArray('i', values); }
+
+        // @method: terminates the top level node list and returns the file
+        const std::vector<uint8_t>& Finish()
+        {
+            m_data.resize(m_data.size() + sNullRecordSize, 0u);
+            return m_data;
+        }
+    };
+
+    static bool WriteBytes(const fs::path& path, const char* data, size_t size)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            ORBIT_ERROR("Unable to write '%s'", path.generic_string().c_str());
+            return false;
+        }
+        file.write(data, size);
+        return file.good();
+    }
+
+    SyntheticMesh SyntheticMeshes::Grid(uint32_t resolution)
+    {
+        SyntheticMesh mesh;
+        mesh.name = "grid_" + std::to_string(resolution);
+        const auto stride = resolution + 1u;
+        for (auto y = 0u; y < stride; ++y)
+        {
+            for (auto x = 0u; x < stride; ++x)
+            {
+                const Vector2f uv{ static_cast<float>(x) / resolution, static_cast<float>(y) / resolution };
+                mesh.positions.emplace_back(uv.x() * 2.f - 1.f, 0.f, uv.y() * 2.f - 1.f);
+                mesh.normals.emplace_back(0.f, 1.f, 0.f);
+                mesh.uvs.push_back(uv);
+            }
+        }
+        for (auto y = 0u; y < resolution; ++y)
+        {
+            for (auto x = 0u; x < resolution; ++x)
+            {
+                const auto i = y * stride + x;
+                mesh.indices.insert(mesh.indices.end(), { i, i + stride, i + 1u, i + 1u, i + stride, i + stride + 1u });
+            }
+        }
+        return mesh;
+    }
+
+    SyntheticMesh SyntheticMeshes::Sphere(uint32_t rings, uint32_t segments)
+    {
+        SyntheticMesh mesh;
+        mesh.name = "sphere_" + std::to_string(rings) + "x" + std::to_string(segments);
+        const auto stride = segments + 1u;
+        for (auto r = 0u; r <= rings; ++r)
+        {
+            const auto theta = sPi * r / rings;
+            for (auto s = 0u; s <= segments; ++s)
+            {
+                const auto phi = 2.f * sPi * s / segments;
+                const Vector3f normal{ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+                mesh.positions.push_back(normal);
+                mesh.normals.push_back(normal);
+                mesh.uvs.emplace_back(static_cast<float>(s) / segments, static_cast<float>(r) / rings);
+            }
+        }
+        for (auto r = 0u; r < rings; ++r)
+        {
+            for (auto s = 0u; s < segments; ++s)
+            {
+                const auto i = r * stride + s;
+                mesh.indices.insert(mesh.indices.end(), { i, i + 1u, i + stride, i + 1u, i + stride + 1u, i + stride });
+            }
+        }
+        return mesh;
+    }
+
+    SyntheticMesh SyntheticMeshes::Soup(uint32_t numTriangles, uint32_t seed)
+    {
+        SyntheticMesh mesh;
+        mesh.name = "soup_" + std::to_string(numTriangles);
+        Random random(seed);
+        auto point = [&]() { return Vector3f{ random.NextFloat() * 2.f - 1.f, random.NextFloat() * 2.f - 1.f, random.NextFloat() * 2.f - 1.f }; };
+        for (auto i = 0u; i < numTriangles; ++i)
+        {
+            const auto p0 = point();
+            const auto p1 = point();
+            const auto p2 = point();
+            Vector3f normal = (p1 - p0).cross(p2 - p0);
+            normal = normal.squaredNorm() > 0.f ? normal.normalized() : Vector3f::UnitY();
+            for (const auto& p : { p0, p1, p2 })
+            {
+                mesh.indices.push_back(static_cast<uint32_t>(mesh.positions.size()));
+                mesh.positions.push_back(p);
+                mesh.normals.push_back(normal);
+                mesh.uvs.emplace_back(random.NextFloat(), random.NextFloat());
+            }
+        }
+        return mesh;
+    }
+
+    SyntheticMesh SyntheticMeshes::Generate(SyntheticShape shape, uint32_t numVertices)
+    {
+        numVertices = std::max(numVertices, 16u);
+        switch (shape)
+        {
+        case SyntheticShape::GRID:
+            return Grid(std::max(static_cast<uint32_t>(std::sqrt(static_cast<float>(numVertices))), 2u) - 1u);
+        case SyntheticShape::SPHERE:
+        {
+            // (rings + 1) * (2 * rings + 1) vertices
+            const auto rings = std::max(static_cast<uint32_t>(std::sqrt(numVertices * 0.5f)), 2u);
+            return Sphere(rings, rings * 2u);
+        }
+        default:
+            return Soup(numVertices / 3u, numVertices);
+        }
+    }
+
+    bool SyntheticMeshes::WriteObj(const SyntheticMesh& mesh, const fs::path& path)
+    {
+        std::string text;
+        char line[128];
+        text += "o " + mesh.name + "\n";
+        for (const auto& p : mesh.positions)
+            text.append(line, snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", p.x(), p.y(), p.z()));
+        for (const auto& uv : mesh.uvs)
+            text.append(line, snprintf(line, sizeof(line), "vt %.6f %.6f\n", uv.x(), uv.y()));
+        for (const auto& n : mesh.normals)
+            text.append(line, snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", n.x(), n.y(), n.z()));
+        for (auto i = 0u; i + 2u < mesh.indices.size(); i += 3u)
+        {
+            const auto a = mesh.indices[i] + 1u, b = mesh.indices[i + 1u] + 1u, c = mesh.indices[i + 2u] + 1u;
+            text.append(line, snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c));
+        }
+        return WriteBytes(path, text.data(), text.size());
+    }
+
+    bool SyntheticMeshes::WriteFbx(const SyntheticMesh& mesh, const fs::path& path, bool compressArrays)
+    {
+        static constexpr int64_t geometryId = 1000;
+        static constexpr int64_t modelId = 2000;
+
+        std::vector<double> vertices, normals, uvs;
+        vertices.reserve(mesh.positions.size() * 3u);
+        normals.reserve(mesh.normals.size() * 3u);
+        uvs.reserve(mesh.uvs.size() * 2u);
+        // The reader scales from centimeters to meters
+        for (const auto& p : mesh.positions)
+            vertices.insert(vertices.end(), { p.x() * 100.0, p.y() * 100.0, p.z() * 100.0 });
+        for (const auto& n : mesh.normals)
+            normals.insert(normals.end(), { static_cast<double>(n.x()), static_cast<double>(n.y()), static_cast<double>(n.z()) });
+        for (const auto& uv : mesh.uvs)
+            uvs.insert(uvs.end(), { static_cast<double>(uv.x()), static_cast<double>(uv.y()) });
+
+        // The last index of every polygon is stored as its one's complement
+        std::vector<int32_t> polygonVertexIndex(mesh.indices.begin(), mesh.indices.end());
+        for (auto i = 2u; i < polygonVertexIndex.size(); i += 3u)
+            polygonVertexIndex[i] = ~polygonVertexIndex[i];
+
+        FbxWriter writer(compressArrays);
+        writer.BeginNode("Objects");
+        {
+            writer.BeginNode("Geometry");
+            writer.AddInt64(geometryId);
+            writer.AddString(mesh.name + std::string("\0\1Geometry", 10));
+            writer.AddString("Mesh");
+            {
+                writer.BeginNode("Vertices");
+                writer.AddDoubleArray(vertices);
+                writer.EndNode();
+
+                writer.BeginNode("PolygonVertexIndex");
+                writer.AddInt32Array(polygonVertexIndex);
+                writer.EndNode();
+
+                writer.BeginNode("LayerElementNormal");
+                writer.BeginNode("MappingInformationType"); writer.AddString("ByVertice"); writer.EndNode();
+                writer.BeginNode("ReferenceInformationType"); writer.AddString("Direct"); writer.EndNode();
+                writer.BeginNode("Normals"); writer.AddDoubleArray(normals); writer.EndNode();
+                writer.EndNode();
+
+                writer.BeginNode("LayerElementUV");
+                writer.BeginNode("MappingInformationType"); writer.AddString("ByVertice"); writer.EndNode();
+                writer.BeginNode("ReferenceInformationType"); writer.AddString("Direct"); writer.EndNode();
+                writer.BeginNode("UV"); writer.AddDoubleArray(uvs); writer.EndNode();
+                writer.EndNode();
+            }
+            writer.EndNode();
+
+            writer.BeginNode("Model");
+            writer.AddInt64(modelId);
+            writer.AddString(mesh.name + std::string("\0\1Model", 7));
+            writer.AddString("Mesh");
+            writer.EndNode();
+        }
+        writer.EndNode();
+
+        writer.BeginNode("Connections");
+        writer.BeginNode("C"); writer.AddString("OO"); writer.AddInt64(geometryId); writer.AddInt64(modelId); writer.EndNode();
+        writer.BeginNode("C"); writer.AddString("OO"); writer.AddInt64(modelId); writer.AddInt64(0); writer.EndNode();
+        writer.EndNode();
+
+        const auto& data = writer.Finish();
+        return WriteBytes(path, reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    bool SyntheticMeshes::WriteRorb(const SyntheticMesh& mesh, const fs::path& path)
+    {
+        const auto numMaterials = std::max<size_t>(mesh.indices.size() / (3u * 64u), 1u);
+        Random random(static_cast<uint32_t>(numMaterials));
+
+        std::string text = "# synthetic raw orb file\n";
+        char line[160];
+        for (auto i = 0u; i < numMaterials; ++i)
+        {
+            text.append(line, snprintf(line, sizeof(line), "new MATERIAL as \"materials/%s_%u\" {\n", mesh.name.c_str(), i));
+            text.append(line, snprintf(line, sizeof(line), "\tDIFFUSE_COLOR as (%.4f, %.4f, %.4f, 1.0);\n", random.NextFloat(), random.NextFloat(), random.NextFloat()));
+            text.append(line, snprintf(line, sizeof(line), "\tSPECULAR_COLOR as (%.4f, %.4f, %.4f, 1.0);\n", random.NextFloat(), random.NextFloat(), random.NextFloat()));
+            text.append(line, snprintf(line, sizeof(line), "\tROUGHNESS as %.4f;\n};\n", random.NextFloat()));
+        }
+        return WriteBytes(path, text.data(), text.size());
+    }
+
+}
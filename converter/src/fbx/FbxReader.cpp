@@ -1,11 +1,15 @@
 #include "fbx/FbxReader.hpp"
 #include "fbx/FbxTree.hpp"
 #include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
 
 #include <iostream>
 #include <numeric>
 #include <algorithm>
 #include <execution>
+#include <cassert>
+#include <array>
+#include <limits>
 
 namespace orbtool
 {
@@ -15,24 +19,76 @@ namespace orbtool
 		return 1.f / (1 + std::exp(-value));
 	}
 
+    // @method: strips the class suffix ("\0\1Model") from an object name
+    static std::string ObjectName(const std::string& name)
+    {
+        return name.substr(0, name.find('\0'));
+    }
+
+    // @method: evaluates a curve at a time. Keys are interpolated linearly, the ends are held
+    static double EvaluateCurve(const FBXAnimationCurve& curve, int64_t time)
+    {
+        const auto count = static_cast<std::ptrdiff_t>(std::min(curve.times.size(), curve.values.size()));
+        const auto begin = curve.times.begin();
+        const auto it = std::upper_bound(begin, begin + count, time);
+        if (it == begin)
+            return curve.values.front();
+        if (it == begin + count)
+            return curve.values[count - 1];
+
+        const auto i = it - begin;
+        const auto t = static_cast<double>(time - curve.times[i - 1]) / static_cast<double>(curve.times[i] - curve.times[i - 1]);
+        return curve.values[i - 1] + (curve.values[i] - curve.values[i - 1]) * t;
+    }
+
     bool FbxReader::ReadFile(const fs::path& filepath, OrbIntermediate* orb)
     {
+        // Map the file before OpenFile() changes the working directory
+        FbxTree tree(filepath);
         if (!OpenFile(filepath))
             return false;
 
-        FbxTree tree(&m_file);
+        // Inflate the geometry, skin and curve arrays up front so they can be read concurrently
+        if (auto objectsNode = tree.GetRootNode()->FindChild("Objects"))
+        {
+            std::vector<const FBXNode*> geometryNodes;
+            for (const auto& child : objectsNode->children)
+            {
+                if (child.name == "Geometry" || child.name == "Deformer" || child.name == "AnimationCurve")
+                    geometryNodes.push_back(&child);
+            }
+            tree.DecodeArrays(geometryNodes);
+        }
+
         FBXData data;
         LoadFBXData(tree.GetRootNode(), &data);
         FBXToIntermediate(&data);
+        // Geometries need the joint influences before they are loaded
+        BuildSkeleton(&data, orb);
 
+        // Build the vertex data of all geometries in parallel
+        std::vector<const FBXGeometry*> geometries;
+        for (const auto& model : m_fbx.models)
+        {
+            for (const auto& geometry : model.second->geometries)
+                geometries.push_back(geometry.get());
+        }
+        std::vector<OrbMesh> geometryMeshes(geometries.size());
+        ParallelFor(geometries.size(), [&](size_t i) {
+            LoadGeometry(geometries[i], &geometryMeshes[i]);
+        });
+
+        auto nextGeometry = 0u;
         for (auto model : m_fbx.models)
 		{
 			if (!model.second->geometries.empty())
 			{
                 OrbMesh mesh;
 				auto modelName = model.second->model->modelName;
-				for (auto geometry : model.second->geometries)
-					FBXGeometryAppendToMesh(geometry.get(), &mesh);
+				for (auto i = 0u; i < model.second->geometries.size(); ++i)
+					AppendGeometry(geometryMeshes[nextGeometry++], &mesh);
+				if (!mesh.skin.weights.empty())
+					mesh.skin.skeleton = m_skeletonName;
 
 				if (!model.second->materials.empty())
 				{
@@ -90,24 +146,39 @@ namespace orbtool
 			l._type = (LightType)(uint8_t)light->ltype;
 			//orb->AppendObject("", std::move(l));
 		}
-        
+
+        if (!m_joints.empty())
+            BuildAnimations(&data, orb);
         return true;
     }
 
-    void FbxReader::FBXGeometryAppendToMesh(const FBXGeometry* geometry, OrbMesh* mesh)
+    void FbxReader::LoadGeometry(const FBXGeometry* geometry, OrbMesh* tmpMesh) const
     {
-        OrbMesh tmpMesh;
-		LoadPositions(geometry, &tmpMesh);
-		LoadNormals(geometry, &tmpMesh);
-		LoadTangents(geometry, &tmpMesh);
-		LoadUVs(geometry, &tmpMesh);
-		CleanupGeometry(&tmpMesh);
+		LoadPositions(geometry, tmpMesh);
+		LoadNormals(geometry, tmpMesh);
+		LoadTangents(geometry, tmpMesh);
+		LoadUVs(geometry, tmpMesh);
+		CleanupGeometry(tmpMesh);
+    }
 
+    void FbxReader::AppendGeometry(const OrbMesh& tmpMesh, OrbMesh* mesh)
+    {
 		SubMesh submesh;
 		submesh.startIndex = static_cast<unsigned>(mesh->indices.size());
 		submesh.indexCount = static_cast<unsigned>(tmpMesh.indices.size());
 		submesh.startVertex = static_cast<unsigned>(mesh->vertices.size());
 		submesh.vertexCount = static_cast<unsigned>(tmpMesh.vertices.size());
+
+		// Geometries without a skin in a skinned mesh follow the first joint
+		if (!tmpMesh.skin.weights.empty() || !mesh->skin.weights.empty())
+		{
+			const auto rigid = orbit::SkinWeights{ { 0u, 0u, 0u, 0u }, { 255u, 0u, 0u, 0u } };
+			mesh->skin.weights.resize(mesh->vertices.size(), rigid);
+			if (tmpMesh.skin.weights.empty())
+				mesh->skin.weights.resize(mesh->vertices.size() + tmpMesh.vertices.size(), rigid);
+			else
+				mesh->skin.weights.insert(mesh->skin.weights.end(), tmpMesh.skin.weights.begin(), tmpMesh.skin.weights.end());
+		}
 		
 		mesh->indices.insert(
 			mesh->indices.end(),
@@ -122,7 +193,7 @@ namespace orbtool
 		mesh->submeshes.emplace_back(submesh);
     }
 
-    void FbxReader::LoadPositions(const FBXGeometry* geometry, OrbMesh* mesh)
+    void FbxReader::LoadPositions(const FBXGeometry* geometry, OrbMesh* mesh) const
     {
         const auto& vertices = geometry->vertices;
 
@@ -144,12 +215,12 @@ namespace orbtool
 
 		// vertex points are stored in positions
 		//std::vector<int32_t> indices;
-		auto indices = geometry->indices;
+		const auto& indices = geometry->indices;
 		std::vector<uint32_t> indices_;
 		if (indices.empty())
 		{
-			indices.resize(positions.size());
-			std::iota(indices.begin(), indices.end(), 0);
+			indices_.resize(positions.size());
+			std::iota(indices_.begin(), indices_.end(), 0u);
 		}
 		else
 		{
@@ -196,12 +267,15 @@ namespace orbtool
 		}
 
 		mesh->indices = std::move(indices_);
-		mesh->vertices.resize(positions.size());
+		// Eigen leaves vectors uninitialized, but tangents are accumulated and
+		//	checked for presence later on
+		mesh->vertices.resize(positions.size(), OrbVertex{ Vector3f::Zero(), Vector3f::Zero(), Vector3f::Zero(), Vector2f::Zero() });
 		for (auto i = 0u; i < positions.size(); ++i)
-			mesh->vertices[i].position = positions[i] * 0.01f;
+			mesh->vertices[i].position = positions[i] * static_cast<float>(sUnitScale);
+		mesh->skin.weights = geometry->skinWeights;
     }
 
-    void FbxReader::LoadNormals(const FBXGeometry* geometry, OrbMesh* mesh)
+    void FbxReader::LoadNormals(const FBXGeometry* geometry, OrbMesh* mesh) const
     {
         auto& indices = geometry->normals.normalIndices;
 		auto& normals = geometry->normals.normals;
@@ -237,7 +311,7 @@ namespace orbtool
 			v.normal.normalize();
     }
 
-    void FbxReader::LoadTangents(const FBXGeometry* geometry, OrbMesh* mesh)
+    void FbxReader::LoadTangents(const FBXGeometry* geometry, OrbMesh* mesh) const
     {
         auto& indices = geometry->tangents.tangentIndices;
 		auto& tangents = geometry->tangents.tangents;
@@ -273,7 +347,7 @@ namespace orbtool
 			v.tangent.normalize();
     }
 
-    void FbxReader::LoadUVs(const FBXGeometry* geometry, OrbMesh* mesh)
+    void FbxReader::LoadUVs(const FBXGeometry* geometry, OrbMesh* mesh) const
     {
 		/*
 		auto& indices = geometry->uvs.uvIndices;
@@ -311,6 +385,13 @@ namespace orbtool
 
 		for (auto i = 0u; i < mesh->indices.size(); ++i)
 			mesh->vertices[i] = tmpVertices[mesh->indices[i]];
+		if (!mesh->skin.weights.empty())
+		{
+			auto tmpWeights = mesh->skin.weights;
+			mesh->skin.weights.resize(mesh->indices.size());
+			for (auto i = 0u; i < mesh->indices.size(); ++i)
+				mesh->skin.weights[i] = tmpWeights[mesh->indices[i]];
+		}
 
 		std::iota(mesh->indices.begin(), mesh->indices.end(), 0);
 
@@ -330,18 +411,20 @@ namespace orbtool
 		auto itd = geometry->uvs.rit == ReferenceInformationType::REFERENCE_INDEX_TO_DIRECT;
 		auto mx = itd ? indices.size() : bakedUVs.size();
 
-		std::vector<int32_t> vv;
+		std::vector<bool> assigned(mesh->vertices.size(), false);
 		auto ApplyUV = [&](unsigned i, Vector2f uv)
 		{
-			if (std::find(vv.begin(), vv.end(), i) == vv.end())
+			if (!assigned[i])
 			{
 				mesh->vertices[i].textureCoords = uv;
-				vv.emplace_back(i);
+				assigned[i] = true;
 			}
 			else
 			{
 				mesh->vertices.emplace_back(mesh->vertices[i]);
 				mesh->vertices.back().textureCoords = uv;
+				if (!mesh->skin.weights.empty())
+					mesh->skin.weights.push_back(mesh->skin.weights[i]);
 			}
 		};
 
@@ -362,7 +445,7 @@ namespace orbtool
 		//*/
     }
 
-    void FbxReader::CleanupGeometry(OrbMesh* mesh)
+    void FbxReader::CleanupGeometry(OrbMesh* mesh) const
     {
 		return;
 		std::vector<uint32_t> indices;
@@ -398,6 +481,272 @@ namespace orbtool
 			AngleAxisd(euler.z(), Vector3d::UnitZ());
     }
 
+    Matrix4d FbxReader::LocalTransform(const FBXModel* model, const Vector3d& translation, const Vector3d& rotation, const Vector3d& scaling)
+    {
+        auto FromEuler = [](const Vector3d& degrees) -> Matrix3d
+		{
+			const Vector3d radians = degrees * (EIGEN_PI / 180.);
+			return (AngleAxisd(radians.z(), Vector3d::UnitZ()) *
+				AngleAxisd(radians.y(), Vector3d::UnitY()) *
+				AngleAxisd(radians.x(), Vector3d::UnitX())).toRotationMatrix();
+		};
+
+		// Rotation and scaling pivots and offsets are not supported, exporters rarely write them for joints
+		Matrix4d transform = Matrix4d::Identity();
+		transform.block<3, 3>(0, 0) = FromEuler(model->preRotation) * FromEuler(rotation) *
+			FromEuler(model->postRotation).transpose() * scaling.asDiagonal();
+		transform.block<3, 1>(0, 3) = translation;
+		return transform;
+    }
+
+    JointPose FbxReader::ToJointPose(const Matrix4d& transform)
+    {
+        const Matrix3d linear = transform.block<3, 3>(0, 0);
+		Vector3d scale = linear.colwise().norm().transpose();
+		// Mirrored transforms are kept with a negative scale
+		if (linear.determinant() < 0.)
+			scale.x() = -scale.x();
+		const Vector3d divisor = scale.unaryExpr([](double value) { return std::abs(value) > 1e-12 ? value : 1.; });
+		Quaterniond rotation(Matrix3d(linear * divisor.cwiseInverse().asDiagonal()));
+		rotation.normalize();
+
+		const Vector3d translation = transform.block<3, 1>(0, 3) * sUnitScale;
+		JointPose pose;
+		pose.rotation[0] = static_cast<float>(rotation.x());
+		pose.rotation[1] = static_cast<float>(rotation.y());
+		pose.rotation[2] = static_cast<float>(rotation.z());
+		pose.rotation[3] = static_cast<float>(rotation.w());
+		for (auto i = 0; i < 3; ++i)
+		{
+			pose.translation[i] = static_cast<float>(translation[i]);
+			pose.scale[i] = static_cast<float>(scale[i]);
+		}
+		return pose;
+    }
+
+    void FbxReader::LoadSkinWeights(FBXGeometry* geometry, const std::unordered_map<const FBXModel*, uint32_t>& jointIndices)
+    {
+        const auto numControlPoints = geometry->vertices.size() / 3;
+		std::vector<std::vector<std::pair<float, uint16_t>>> influences(numControlPoints);
+		for (const auto& cluster : geometry->skin->clusters)
+		{
+			auto it = cluster->bone ? jointIndices.find(cluster->bone.get()) : jointIndices.end();
+			if (it == jointIndices.end())
+				continue;
+			const auto count = std::min(cluster->indices.size(), cluster->weights.size());
+			for (auto i = 0u; i < count; ++i)
+			{
+				const auto index = cluster->indices[i];
+				if (index >= 0 && static_cast<size_t>(index) < numControlPoints && cluster->weights[i] > 0.)
+					influences[index].emplace_back(static_cast<float>(cluster->weights[i]), static_cast<uint16_t>(it->second));
+			}
+		}
+
+		// Keep the four largest influences and quantize them so they sum up to 255
+		auto numTruncated = 0u;
+		geometry->skinWeights.resize(numControlPoints);
+		for (auto i = 0u; i < numControlPoints; ++i)
+		{
+			auto& influence = influences[i];
+			auto& weights = geometry->skinWeights[i];
+			weights = orbit::SkinWeights{ { 0u, 0u, 0u, 0u }, { 255u, 0u, 0u, 0u } };
+			if (influence.empty())
+				continue;
+
+			std::sort(influence.begin(), influence.end(), std::greater<>());
+			if (influence.size() > 4u)
+			{
+				influence.resize(4u);
+				++numTruncated;
+			}
+			auto sum = 0.f;
+			for (const auto& joint : influence)
+				sum += joint.first;
+			auto total = 0;
+			for (auto j = 0u; j < influence.size(); ++j)
+			{
+				weights.joints[j] = influence[j].second;
+				weights.weights[j] = static_cast<uint8_t>(std::lround(influence[j].first / sum * 255.f));
+				total += weights.weights[j];
+			}
+			// The largest weight absorbs the rounding error
+			weights.weights[0] = static_cast<uint8_t>(weights.weights[0] + 255 - total);
+		}
+		if (numTruncated > 0u)
+			ORBIT_LOG("Dropped the smallest influences of %u control points of '%s' with more than 4 joints", numTruncated, ObjectName(geometry->name).c_str());
+    }
+
+    void FbxReader::BuildSkeleton(const FBXData* data, OrbIntermediate* orb)
+    {
+        std::vector<FBXGeometry*> skinnedGeometries;
+		std::unordered_map<const FBXModel*, const FBXCluster*> clusters;
+		for (const auto& node : data->nodes)
+		{
+			if (node.second->type != FBXType::TYPE_GEOMETRY)
+				continue;
+			auto geometry = static_cast<FBXGeometry*>(node.second.get());
+			if (!geometry->skin)
+				continue;
+			skinnedGeometries.push_back(geometry);
+			for (const auto& cluster : geometry->skin->clusters)
+			{
+				if (cluster->bone)
+					clusters.emplace(cluster->bone.get(), cluster.get());
+			}
+		}
+		if (clusters.empty())
+			return;
+
+		// The bones and all of their ancestors make up the skeleton. Sorting by
+		// depth puts parents first, the names keep the order deterministic
+		std::unordered_map<const FBXModel*, uint32_t> depths;
+		for (const auto& cluster : clusters)
+		{
+			for (auto model = cluster.first; model && depths.find(model) == depths.end(); model = model->parent)
+				depths.emplace(model, 0u);
+		}
+		for (auto& depth : depths)
+		{
+			for (auto model = depth.first->parent; model; model = model->parent)
+				++depth.second;
+		}
+		if (depths.size() > std::numeric_limits<uint16_t>::max())
+			ORBIT_THROW("Skeletons are limited to %u joints, this one has %zu", std::numeric_limits<uint16_t>::max(), depths.size());
+
+		m_joints.clear();
+		for (const auto& depth : depths)
+			m_joints.push_back(depth.first);
+		std::sort(m_joints.begin(), m_joints.end(), [&](const FBXModel* a, const FBXModel* b) {
+			const auto da = depths.at(a), db = depths.at(b);
+			return da != db ? da < db : a->modelName < b->modelName;
+		});
+		m_jointIndices.clear();
+		for (auto i = 0u; i < m_joints.size(); ++i)
+			m_jointIndices.emplace(m_joints[i], i);
+
+		// The file stores global bind transforms, the skeleton the ones relative to the parent
+		OrbSkeleton skeleton;
+		skeleton.joints.resize(m_joints.size());
+		std::vector<Matrix4d> globals(m_joints.size());
+		for (auto i = 0u; i < m_joints.size(); ++i)
+		{
+			const auto model = m_joints[i];
+			auto& joint = skeleton.joints[i];
+			joint.name = ObjectName(model->modelName);
+			joint.parent = model->parent ? static_cast<int32_t>(m_jointIndices.at(model->parent)) : -1;
+
+			const Matrix4d parentGlobal = joint.parent >= 0 ? globals[joint.parent] : Matrix4d::Identity();
+			Matrix4d inverseBindPose;
+			if (auto it = clusters.find(model); it != clusters.end())
+			{
+				globals[i] = it->second->transformLink;
+				inverseBindPose = it->second->transformLink.inverse() * it->second->transform;
+			}
+			else
+			{
+				globals[i] = parentGlobal * LocalTransform(model, model->localTranslation, model->localRotation, model->localScaling);
+				inverseBindPose = globals[i].inverse();
+			}
+			joint.bindPose = ToJointPose(parentGlobal.inverse() * globals[i]);
+
+			// Vertices are converted to meters, so are the transforms
+			inverseBindPose.block<3, 1>(0, 3) *= sUnitScale;
+			joint.inverseBindPose = inverseBindPose.cast<float>();
+		}
+
+		ParallelFor(skinnedGeometries.size(), [&](size_t i) {
+			LoadSkinWeights(skinnedGeometries[i], m_jointIndices);
+		});
+
+		m_skeletonName = m_filepath.stem().generic_string() + "/skeleton";
+		ORBIT_LOG("Built skeleton '%s' with %zu joints", m_skeletonName.c_str(), skeleton.joints.size());
+		orb->AppendObject(m_skeletonName, std::move(skeleton));
+    }
+
+    void FbxReader::BuildAnimations(const FBXData* data, OrbIntermediate* orb) const
+    {
+        for (const auto& node : data->nodes)
+		{
+			if (node.second->type != FBXType::TYPE_ANIMATION_STACK)
+				continue;
+			const auto stack = static_cast<const FBXAnimationStack*>(node.second.get());
+			if (stack->layers.empty())
+				continue;
+			if (stack->layers.size() > 1u)
+				ORBIT_LOG("Animation '%s' has %zu layers, only the first one is imported", stack->name.c_str(), stack->layers.size());
+
+			// Curve nodes of the translation, rotation and scaling of every joint
+			std::vector<std::array<const FBXAnimationCurveNode*, 3>> channels(m_joints.size(), { nullptr, nullptr, nullptr });
+			auto keysStart = std::numeric_limits<int64_t>::max();
+			auto keysStop = std::numeric_limits<int64_t>::min();
+			for (const auto& curveNode : stack->layers.front()->curveNodes)
+			{
+				auto it = curveNode->model ? m_jointIndices.find(curveNode->model.get()) : m_jointIndices.end();
+				if (it == m_jointIndices.end())
+					continue;
+				if (curveNode->property == "Lcl Translation")
+					channels[it->second][0] = curveNode.get();
+				else if (curveNode->property == "Lcl Rotation")
+					channels[it->second][1] = curveNode.get();
+				else if (curveNode->property == "Lcl Scaling")
+					channels[it->second][2] = curveNode.get();
+				else
+					continue;
+
+				for (const auto& curve : curveNode->curves)
+				{
+					if (curve && !curve->times.empty())
+					{
+						keysStart = std::min(keysStart, curve->times.front());
+						keysStop = std::max(keysStop, curve->times.back());
+					}
+				}
+			}
+
+			// Fall back to the range of the keys if the stack has no time span
+			auto start = stack->start;
+			auto stop = stack->stop;
+			if (stop <= start && keysStart <= keysStop)
+			{
+				start = keysStart;
+				stop = keysStop;
+			}
+			stop = std::max(start, stop);
+
+			OrbAnimationClip clip;
+			clip.skeleton = m_skeletonName;
+			clip.sampleRate = sAnimationSampleRate;
+			clip.numFrames = static_cast<uint32_t>(std::floor(static_cast<double>(stop - start) / sTicksPerSecond * sAnimationSampleRate + 0.5)) + 1u;
+			clip.samples.resize(static_cast<size_t>(clip.numFrames) * m_joints.size());
+			ParallelFor(clip.numFrames, [&](size_t frame) {
+				const auto time = std::min(stop, start + static_cast<int64_t>(static_cast<double>(frame) * sTicksPerSecond / sAnimationSampleRate));
+				auto Sample = [&](const FBXAnimationCurveNode* curveNode, Vector3d value)
+				{
+					for (auto axis = 0; curveNode && axis < 3; ++axis)
+					{
+						if (curveNode->curves[axis] && !curveNode->curves[axis]->times.empty())
+							value[axis] = EvaluateCurve(*curveNode->curves[axis], time);
+					}
+					return value;
+				};
+				for (auto joint = 0u; joint < m_joints.size(); ++joint)
+				{
+					const auto model = m_joints[joint];
+					const auto& channel = channels[joint];
+					const auto local = LocalTransform(model,
+						Sample(channel[0], model->localTranslation),
+						Sample(channel[1], model->localRotation),
+						Sample(channel[2], model->localScaling));
+					clip.samples[frame * m_joints.size() + joint] = ToJointPose(local);
+				}
+			});
+
+			auto name = m_filepath.stem().generic_string() + "/" + stack->name;
+			ORBIT_LOG("Sampled animation '%s' at %.0f fps, %u frames", name.c_str(), sAnimationSampleRate, clip.numFrames);
+			orb->AppendObject(name, std::move(clip));
+		}
+    }
+
     std::unordered_map<int64_t, std::shared_ptr<FBXInterModel>>::iterator FbxReader::TryInsert(std::shared_ptr<FBXModel> model)
     {
         auto it = m_fbx.models.find(model->id);
@@ -416,7 +765,7 @@ namespace orbtool
     {
         if (mitNode && mitNode->properties.size() == 1)
 		{
-			std::string mit = std::get<std::string>(mitNode->properties[0]);
+			std::string mit = std::string(mitNode->properties[0].GetString());
 			if (mit == "ByPolygonVertex")
 				return MappingInformationType::MAPPING_BY_POLYGON_VERTEX;
 			else if (mit == "ByVertex" || mit == "ByVertice")
@@ -432,7 +781,7 @@ namespace orbtool
     {
         if (ritNode && ritNode->properties.size() == 1)
 		{
-			std::string rit = std::get<std::string>(ritNode->properties[0]);
+			std::string rit = std::string(ritNode->properties[0].GetString());
 			if (rit == "Direct")
 				return ReferenceInformationType::REFERENCE_DIRECT;
 			else if (rit == "IndexToDirect")
@@ -452,23 +801,29 @@ namespace orbtool
 		LoadGeometries(objectsNode, data);
 		LoadMaterials(objectsNode, data);
 		LoadTextures(objectsNode, data);
+		LoadDeformers(objectsNode, data);
+		LoadAnimations(objectsNode, data);
 
 		LoadConnections(connectionsNode, data);
     }
 
     void FbxReader::LoadGeometries(const FBXNode* objectsNode, FBXData* data)
     {
-        const FBXNode* geometryNode;
-		auto idx = 0u;
-		while ((geometryNode = objectsNode->FindChild("Geometry", idx++)) != nullptr)
+        std::vector<const FBXNode*> geometryNodes;
+		for (const auto& child : objectsNode->children)
 		{
-			FBXGeometry fbx_geom;
-			fbx_geom.type = FBXType::TYPE_GEOMETRY;
-			GetFBXGeometry(&fbx_geom, geometryNode);
+			if (child.name == "Geometry")
+				geometryNodes.push_back(&child);
+		}
+
+		std::vector<FBXGeometry> geometries(geometryNodes.size());
+		ParallelFor(geometryNodes.size(), [&](size_t i) {
+			geometries[i].type = FBXType::TYPE_GEOMETRY;
+			GetFBXGeometry(&geometries[i], geometryNodes[i]);
+		});
 
+		for (auto& fbx_geom : geometries)
 			data->nodes.emplace(fbx_geom.id, std::make_shared<FBXGeometry>(std::move(fbx_geom)));
-		
-		}
     }
 
     void FbxReader::LoadMaterials(const FBXNode* objectsNode, FBXData* data)
@@ -507,12 +862,20 @@ namespace orbtool
     {
         auto Vec3FromNode = [](const FBXNode* node) -> Vector3d
 		{
-			auto x = std::get<double>(node->properties[4]);
-			auto y = std::get<double>(node->properties[4]);
-			auto z = std::get<double>(node->properties[4]);
+			auto x = node->properties[4].Get<double>();
+			auto y = node->properties[4].Get<double>();
+			auto z = node->properties[4].Get<double>();
 
 			return Vector3d{ x, y, z };
 		};
+		auto Vector3FromProperty = [](const FBXNode* node) -> Vector3d
+		{
+			return Vector3d{
+				node->properties[4].Get<double>(),
+				node->properties[5].Get<double>(),
+				node->properties[6].Get<double>()
+			};
+		};
 
 		const FBXNode* modelNode;
 		auto idx = 0u;
@@ -520,22 +883,35 @@ namespace orbtool
 		{
 			FBXModel model;
 			model.type = FBXType::TYPE_MODEL;
-			model.id = std::get<int64_t>(modelNode->properties[0]);
-			model.modelName = std::get<std::string>(modelNode->properties[1]);
-			model.modelType = std::get<std::string>(modelNode->properties[2]);
+			model.id = modelNode->properties[0].Get<int64_t>();
+			model.modelName = std::string(modelNode->properties[1].GetString());
+			model.modelType = std::string(modelNode->properties[2].GetString());
 			if (auto p70 = modelNode->FindChild("Properties70"); p70 != nullptr)
 			{
 				const FBXNode* pNode;
 				auto idx0 = 0u;
 				while ((pNode = p70->FindChild("P", idx0++)) != nullptr)
 				{
-					auto channel = std::get<std::string>(pNode->properties[0]);
+					auto channel = std::string(pNode->properties[0].GetString());
 					if (channel == "Lcl Translation")
 						model.transform.position = Vec3FromNode(pNode);
 					else if (channel == "Lcl Rotation")
 						model.transform.rotation = QuatFromEuler(Vec3FromNode(pNode));
 					else if (channel == "Lcl Scaling")
 						model.transform.scaling = Vec3FromNode(pNode);
+
+					if (pNode->properties.size() < 7)
+						continue;
+					if (channel == "Lcl Translation")
+						model.localTranslation = Vector3FromProperty(pNode);
+					else if (channel == "Lcl Rotation")
+						model.localRotation = Vector3FromProperty(pNode);
+					else if (channel == "Lcl Scaling")
+						model.localScaling = Vector3FromProperty(pNode);
+					else if (channel == "PreRotation")
+						model.preRotation = Vector3FromProperty(pNode);
+					else if (channel == "PostRotation")
+						model.postRotation = Vector3FromProperty(pNode);
 				}
 			}
 			data->nodes.emplace(model.id, std::make_shared<FBXModel>(std::move(model)));
@@ -549,11 +925,11 @@ namespace orbtool
 		while ((connectionNode = connectionsNode->FindChild("C", idx++)) != nullptr)
 		{
 			FBXConnection connection;
-			auto type = std::get<std::string>(connectionNode->properties[0]);
-			connection.id0 = std::get<int64_t>(connectionNode->properties[1]);
-			connection.id1 = std::get<int64_t>(connectionNode->properties[2]);
+			auto type = std::string(connectionNode->properties[0].GetString());
+			connection.id0 = connectionNode->properties[1].Get<int64_t>();
+			connection.id1 = connectionNode->properties[2].Get<int64_t>();
 			if (connectionNode->properties.size() > 3)
-				connection.propertyName = std::get<std::string>(connectionNode->properties[3]);
+				connection.propertyName = std::string(connectionNode->properties[3].GetString());
 
 			if (type == "OO")
 				connection.type = FBXConnectionType::CT_OBJECT_OBJECT;
@@ -576,11 +952,11 @@ namespace orbtool
 		{
 			FBXTexture texture;
 			texture.type = FBXType::TYPE_TEXTURE;
-			texture.id = std::get<int64_t>(textureNode->properties[0]);
-			texture.name = std::get<std::string>(textureNode->properties[1]);
+			texture.id = textureNode->properties[0].Get<int64_t>();
+			texture.name = std::string(textureNode->properties[1].GetString());
 
 			if (auto filenameNode = textureNode->FindChild("FileName"); filenameNode != nullptr)
-				texture.filepath = std::get<std::string>(filenameNode->properties[0]);
+				texture.filepath = std::string(filenameNode->properties[0].GetString());
 
 			std::shared_ptr<FBXTexture> t;
 			for (auto node : data->nodes)
@@ -610,9 +986,9 @@ namespace orbtool
 		{
 			FBXAttribute attribute;
 			attribute.type = FBXType::TYPE_ATTRIBUTE;
-			attribute.id = std::get<int64_t>(attributeNode->properties[0]);
-			attribute.nodeType = std::get<std::string>(attributeNode->properties[1]);
-			attribute.nodeName = std::get<std::string>(attributeNode->properties[2]);
+			attribute.id = attributeNode->properties[0].Get<int64_t>();
+			attribute.nodeType = std::string(attributeNode->properties[1].GetString());
+			attribute.nodeName = std::string(attributeNode->properties[2].GetString());
 			const FBXNode* p70;
 			if ((p70 = attributeNode->FindChild("Properties70")); p70 != nullptr)
 				attribute.attributes = p70;
@@ -621,6 +997,113 @@ namespace orbtool
 		}
     }
 
+    void FbxReader::LoadDeformers(const FBXNode* objectsNode, FBXData* data)
+    {
+        auto MatrixFromNode = [](const FBXNode* node) -> Matrix4d
+		{
+			// Stored column by column, the translation is in the last four values
+			auto values = node->properties[0].GetArray<double>();
+			if (values.size() != 16)
+				return Matrix4d::Identity();
+			return Map<const Matrix4d>(values.data());
+		};
+
+		const FBXNode* deformerNode;
+		auto idx = 0u;
+		while ((deformerNode = objectsNode->FindChild("Deformer", idx++)) != nullptr)
+		{
+			if (deformerNode->properties.size() < 3)
+				continue;
+			auto deformerType = std::string(deformerNode->properties[2].GetString());
+			if (deformerType == "Skin")
+			{
+				FBXSkin skin;
+				skin.type = FBXType::TYPE_SKIN;
+				skin.id = deformerNode->properties[0].Get<int64_t>();
+				data->nodes.emplace(skin.id, std::make_shared<FBXSkin>(std::move(skin)));
+			}
+			else if (deformerType == "Cluster")
+			{
+				FBXCluster cluster;
+				cluster.type = FBXType::TYPE_CLUSTER;
+				cluster.id = deformerNode->properties[0].Get<int64_t>();
+				if (auto node = deformerNode->FindChild("Indexes"); node && node->properties.size() == 1)
+					cluster.indices = node->properties[0].GetArray<int32_t>();
+				if (auto node = deformerNode->FindChild("Weights"); node && node->properties.size() == 1)
+					cluster.weights = node->properties[0].GetArray<double>();
+				if (auto node = deformerNode->FindChild("Transform"); node && node->properties.size() == 1)
+					cluster.transform = MatrixFromNode(node);
+				if (auto node = deformerNode->FindChild("TransformLink"); node && node->properties.size() == 1)
+					cluster.transformLink = MatrixFromNode(node);
+				data->nodes.emplace(cluster.id, std::make_shared<FBXCluster>(std::move(cluster)));
+			}
+		}
+    }
+
+    void FbxReader::LoadAnimations(const FBXNode* objectsNode, FBXData* data)
+    {
+        for (const auto& child : objectsNode->children)
+		{
+			if (child.properties.empty() || !child.properties[0].Is<int64_t>())
+				continue;
+			const auto id = child.properties[0].Get<int64_t>();
+
+			if (child.name == "AnimationStack")
+			{
+				FBXAnimationStack stack;
+				stack.type = FBXType::TYPE_ANIMATION_STACK;
+				stack.id = id;
+				if (child.properties.size() > 1)
+					stack.name = ObjectName(std::string(child.properties[1].GetString()));
+				if (auto p70 = child.FindChild("Properties70"); p70 != nullptr)
+				{
+					for (const auto& p : p70->children)
+					{
+						if (p.properties.size() < 5 || !p.properties[4].Is<int64_t>())
+							continue;
+						auto channel = std::string(p.properties[0].GetString());
+						if (channel == "LocalStart")
+							stack.start = p.properties[4].Get<int64_t>();
+						else if (channel == "LocalStop")
+							stack.stop = p.properties[4].Get<int64_t>();
+					}
+				}
+				data->nodes.emplace(stack.id, std::make_shared<FBXAnimationStack>(std::move(stack)));
+			}
+			else if (child.name == "AnimationLayer")
+			{
+				FBXAnimationLayer layer;
+				layer.type = FBXType::TYPE_ANIMATION_LAYER;
+				layer.id = id;
+				data->nodes.emplace(layer.id, std::make_shared<FBXAnimationLayer>(std::move(layer)));
+			}
+			else if (child.name == "AnimationCurveNode")
+			{
+				FBXAnimationCurveNode curveNode;
+				curveNode.type = FBXType::TYPE_ANIMATION_CURVE_NODE;
+				curveNode.id = id;
+				data->nodes.emplace(curveNode.id, std::make_shared<FBXAnimationCurveNode>(std::move(curveNode)));
+			}
+			else if (child.name == "AnimationCurve")
+			{
+				FBXAnimationCurve curve;
+				curve.type = FBXType::TYPE_ANIMATION_CURVE;
+				curve.id = id;
+				if (auto node = child.FindChild("KeyTime"); node && node->properties.size() == 1)
+					curve.times = node->properties[0].GetArray<int64_t>();
+				if (auto node = child.FindChild("KeyValueFloat"); node && node->properties.size() == 1)
+					curve.values = node->properties[0].GetArray<float>();
+				if (curve.times.size() != curve.values.size())
+				{
+					ORBIT_ERROR("Animation curve %lld has %zu key times but %zu values", curve.id, curve.times.size(), curve.values.size());
+					curve.times = {};
+					curve.values = {};
+				}
+				data->nodes.emplace(curve.id, std::make_shared<FBXAnimationCurve>(std::move(curve)));
+			}
+		}
+    }
+
     void FbxReader::GetFBXGeometry(FBXGeometry* geometry, const FBXNode* geometryNode)
     {
         const FBXNode
@@ -640,8 +1123,8 @@ namespace orbtool
 
 		if (geometryNode->properties.size() >= 2)
 		{
-			geometry->id = std::get<int64_t>(geometryNode->properties[0]);
-			geometry->name = std::get<std::string>(geometryNode->properties[1]);
+			geometry->id = geometryNode->properties[0].Get<int64_t>();
+			geometry->name = std::string(geometryNode->properties[1].GetString());
 		}
 
 		verticesNode = geometryNode->FindChild("Vertices");
@@ -651,10 +1134,10 @@ namespace orbtool
 		uvParent = geometryNode->FindChild("LayerElementUV");
 
 		if (verticesNode && verticesNode->properties.size() == 1)
-			geometry->vertices = std::get<std::vector<double>>(verticesNode->properties[0]);
+			geometry->vertices = verticesNode->properties[0].GetArray<double>();
 
 		if (indicesNode && indicesNode->properties.size() == 1)
-			geometry->indices = std::get<std::vector<int>>(indicesNode->properties[0]);
+			geometry->indices = indicesNode->properties[0].GetArray<int32_t>();
 
 		if (normalParent)
 		{
@@ -664,9 +1147,9 @@ namespace orbtool
 			ritNode = normalParent->FindChild("ReferenceInformationType");
 
 			if (normalsNode && normalsNode->properties.size() == 1)
-				geometry->normals.normals = std::get<std::vector<double>>(normalsNode->properties[0]);
+				geometry->normals.normals = normalsNode->properties[0].GetArray<double>();
 			if (normalIndexNode && normalIndexNode->properties.size() == 1)
-				geometry->normals.normalIndices = std::get<std::vector<int>>(normalIndexNode->properties[0]);
+				geometry->normals.normalIndices = normalIndexNode->properties[0].GetArray<int32_t>();
 
 			geometry->normals.mit = LoadMIT(mitNode);
 			geometry->normals.rit = LoadRIT(ritNode);
@@ -680,9 +1163,9 @@ namespace orbtool
 			ritNode = tangentParent->FindChild("ReferenceInformationType");
 
 			if (tangentNode && tangentNode->properties.size() == 1)
-				geometry->tangents.tangents = std::get<std::vector<double>>(tangentNode->properties[0]);
+				geometry->tangents.tangents = tangentNode->properties[0].GetArray<double>();
 			if (tangentIndexNode && tangentIndexNode->properties.size() == 1)
-				geometry->tangents.tangentIndices = std::get<std::vector<int>>(tangentIndexNode->properties[0]);
+				geometry->tangents.tangentIndices = tangentIndexNode->properties[0].GetArray<int32_t>();
 
 			geometry->tangents.mit = LoadMIT(mitNode);
 			geometry->tangents.rit = LoadRIT(ritNode);
@@ -696,9 +1179,9 @@ namespace orbtool
 			ritNode = uvParent->FindChild("ReferenceInformationType");
 
 			if (uvNode && uvNode->properties.size() == 1)
-				geometry->uvs.uvs = std::get<std::vector<double>>(uvNode->properties[0]);
+				geometry->uvs.uvs = uvNode->properties[0].GetArray<double>();
 			if (uvIndexNode && uvIndexNode->properties.size() == 1)
-				geometry->uvs.uvIndices = std::get<std::vector<int>>(uvIndexNode->properties[0]);
+				geometry->uvs.uvIndices = uvIndexNode->properties[0].GetArray<int32_t>();
 
 			geometry->uvs.mit = LoadMIT(mitNode);
 			geometry->uvs.rit = LoadRIT(ritNode);
@@ -709,25 +1192,25 @@ namespace orbtool
     {
         auto get_color = [](const FBXNode* node) -> Vector4f {
 			return Vector4f{
-				static_cast<float>(std::get<double>(node->properties[4])),
-				static_cast<float>(std::get<double>(node->properties[5])),
-				static_cast<float>(std::get<double>(node->properties[6])),
+				static_cast<float>(node->properties[4].Get<double>()),
+				static_cast<float>(node->properties[5].Get<double>()),
+				static_cast<float>(node->properties[6].Get<double>()),
 				1.f
 			};
 		};
 		auto get_string = [](const FBXNode* node) {
-			auto prop = std::get<std::string>(node->properties[0]);
+			auto prop = std::string(node->properties[0].GetString());
 			prop = prop.substr(0, prop.find('\0'));
 			return prop;
 		};
 
-		material->id = std::get<int64_t>(materialNode->properties[0]);
-		material->name = std::get<std::string>(materialNode->properties[1]);
+		material->id = materialNode->properties[0].Get<int64_t>();
+		material->name = std::string(materialNode->properties[1].GetString());
 
 		auto properties70 = materialNode->FindChild("Properties70");
 		if (!properties70) return;
 
-		for (auto p : properties70->children)
+		for (const auto& p : properties70->children)
 		{
 			auto channel = get_string(&p);
 			if (channel == "DiffuseColor")
@@ -735,15 +1218,15 @@ namespace orbtool
 			if (channel == "DiffuseColor" || channel == "Maya|baseColor")
 				material->diffuse.cwiseProduct(get_color(&p));
 			if (channel == "DiffuseFactor")
-				material->diffuse *= static_cast<float>(std::clamp(std::get<double>(p.properties[4]), 0., 1.));
+				material->diffuse *= static_cast<float>(std::clamp(p.properties[4].Get<double>(), 0., 1.));
 			if (channel == "Maya|base")
-				material->diffuse *= std::clamp(std::get<float>(p.properties[4]), 0.f, 1.f);
+				material->diffuse *= std::clamp(p.properties[4].Get<float>(), 0.f, 1.f);
 			if (channel == "Roughness")
-				material->roughness = Sigmoid(static_cast<float>(std::get<double>(p.properties[4])));
+				material->roughness = Sigmoid(static_cast<float>(p.properties[4].Get<double>()));
 			if (channel == "Maya|specularRoughness")
-				material->roughness = Sigmoid(std::get<float>(p.properties[4]));
+				material->roughness = Sigmoid(p.properties[4].Get<float>());
 			if (channel == "Shininess")
-				material->roughness = Sigmoid(1.f - static_cast<float>(std::get<double>(p.properties[4])));
+				material->roughness = Sigmoid(1.f - static_cast<float>(p.properties[4].Get<double>()));
 		}
     }
 
@@ -801,6 +1284,40 @@ namespace orbtool
 				ConnectMaterialTexture(
 					std::static_pointer_cast<FBXMaterial>(it1->second),
 					std::static_pointer_cast<FBXTexture>(it0->second), connection.propertyName);
+			else if (it0->second->type == FBXType::TYPE_CLUSTER
+				&& it1->second->type == FBXType::TYPE_SKIN)
+				std::static_pointer_cast<FBXSkin>(it1->second)->clusters.emplace_back(
+					std::static_pointer_cast<FBXCluster>(it0->second));
+			else if (it0->second->type == FBXType::TYPE_SKIN
+				&& it1->second->type == FBXType::TYPE_GEOMETRY)
+				std::static_pointer_cast<FBXGeometry>(it1->second)->skin = std::static_pointer_cast<FBXSkin>(it0->second);
+			else if (it0->second->type == FBXType::TYPE_MODEL
+				&& it1->second->type == FBXType::TYPE_CLUSTER)
+				std::static_pointer_cast<FBXCluster>(it1->second)->bone = std::static_pointer_cast<FBXModel>(it0->second);
+			else if (it0->second->type == FBXType::TYPE_ANIMATION_CURVE
+				&& it1->second->type == FBXType::TYPE_ANIMATION_CURVE_NODE)
+			{
+				// The property is the animated component, "d|X", "d|Y" or "d|Z"
+				const auto& channel = connection.propertyName;
+				if (channel.size() == 3 && channel[0] == 'd' && channel[2] >= 'X' && channel[2] <= 'Z')
+					std::static_pointer_cast<FBXAnimationCurveNode>(it1->second)->curves[channel[2] - 'X'] =
+						std::static_pointer_cast<FBXAnimationCurve>(it0->second);
+			}
+			else if (it0->second->type == FBXType::TYPE_ANIMATION_CURVE_NODE
+				&& it1->second->type == FBXType::TYPE_MODEL)
+			{
+				auto curveNode = std::static_pointer_cast<FBXAnimationCurveNode>(it0->second);
+				curveNode->model = std::static_pointer_cast<FBXModel>(it1->second);
+				curveNode->property = connection.propertyName;
+			}
+			else if (it0->second->type == FBXType::TYPE_ANIMATION_CURVE_NODE
+				&& it1->second->type == FBXType::TYPE_ANIMATION_LAYER)
+				std::static_pointer_cast<FBXAnimationLayer>(it1->second)->curveNodes.emplace_back(
+					std::static_pointer_cast<FBXAnimationCurveNode>(it0->second));
+			else if (it0->second->type == FBXType::TYPE_ANIMATION_LAYER
+				&& it1->second->type == FBXType::TYPE_ANIMATION_STACK)
+				std::static_pointer_cast<FBXAnimationStack>(it1->second)->layers.emplace_back(
+					std::static_pointer_cast<FBXAnimationLayer>(it0->second));
 		}
     }
 
@@ -810,6 +1327,8 @@ namespace orbtool
 		im->children.emplace_back(m1);
 
 		m1->transform.parent = &m0->transform;
+		// The first model of a connection is the child
+		m0->parent = m1.get();
     }
 
     void FbxReader::ConnectModelAttribute(std::shared_ptr<FBXModel> m0, std::shared_ptr<FBXAttribute> attr)
@@ -819,14 +1338,14 @@ namespace orbtool
 
 		auto attribute_name = [](const FBXNode& node)
 		{
-			return std::get<std::string>(node.properties[0]);
+			return std::string(node.properties[0].GetString());
 		};
 		auto get_color = [](const FBXNode& node) -> Vector4f
 		{
 			Vector4f color;
-			color.x() = static_cast<float>(std::get<double>(node.properties[4]));
-			color.y() = static_cast<float>(std::get<double>(node.properties[5]));
-			color.z() = static_cast<float>(std::get<double>(node.properties[6]));
+			color.x() = static_cast<float>(node.properties[4].Get<double>());
+			color.y() = static_cast<float>(node.properties[5].Get<double>());
+			color.z() = static_cast<float>(node.properties[6].Get<double>());
 			color.w() = 1.f;
 			return color;
 		};
@@ -839,7 +1358,7 @@ namespace orbtool
 				auto name = attribute_name(attribute);
 				if (name == "LightType")
 				{
-					auto light_type = std::get<int32_t>(attribute.properties[4]);
+					auto light_type = attribute.properties[4].Get<int32_t>();
 					if (light_type == 0)
 						light.ltype = FBXLightType::PointLight;
 					else if (light_type == 2)
@@ -851,11 +1370,11 @@ namespace orbtool
 					light.color = get_color(attribute);
 				else if (name == "DecayStart")
 				{
-					light.falloffBegin = static_cast<float>(std::get<double>(attribute.properties[4]));
+					light.falloffBegin = static_cast<float>(attribute.properties[4].Get<double>());
 					light.falloffEnd = light.falloffBegin * 1.2f;
 				}
 				else if (name == "OuterAngle")
-					light.spotAngle = static_cast<float>(std::get<double>(attribute.properties[4]));
+					light.spotAngle = static_cast<float>(attribute.properties[4].Get<double>());
 			}
 			auto p = m0->transform.GetCombinedPosition();
 			auto d = m0->transform.GetCombinedRotation()._transformVector(Vector3d::UnitX());
@@ -1,127 +1,315 @@
 #include "fbx/FbxTree.hpp"
 #include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#include "zlib.h"
 
 namespace orbtool
 {
 
-	template<typename T>
-	static std::ostream& operator<<(std::ostream& out, std::vector<T> vec)
+	static const char* PropertyTypeToString(FBXPropertyType type)
+	{
+		switch (type)
+		{
+		case FBXPropertyType::INT16: return "int16";
+		case FBXPropertyType::BOOL: return "bool";
+		case FBXPropertyType::INT32: return "int32";
+		case FBXPropertyType::FLOAT: return "float";
+		case FBXPropertyType::DOUBLE: return "double";
+		case FBXPropertyType::INT64: return "int64";
+		case FBXPropertyType::STRING: return "string";
+		case FBXPropertyType::RAW: return "raw";
+		case FBXPropertyType::ARRAY_FLOAT: return "float[]";
+		case FBXPropertyType::ARRAY_INT32: return "int32[]";
+		case FBXPropertyType::ARRAY_DOUBLE: return "double[]";
+		case FBXPropertyType::ARRAY_INT64: return "int64[]";
+		case FBXPropertyType::ARRAY_BOOL: return "bool[]";
+		case FBXPropertyType::ARRAY_UINT8: return "uint8[]";
+		default: return "unknown";
+		}
+	}
+
+	void FBXProperty::TypeMismatch(FBXPropertyType expected) const
+	{
+		ORBIT_THROW("FBX property type mismatch. Expected %s but got %s", PropertyTypeToString(expected), PropertyTypeToString(m_type));
+	}
+
+	size_t FBXProperty::ElementSize() const
 	{
-#ifdef _DEBUG
-		for (auto i = 0u; i < vec.size(); ++i)
+		switch (m_type)
 		{
-			out << vec[i];
-			if (i != vec.size() - 1)
-				out << ", ";
+		case FBXPropertyType::ARRAY_FLOAT: return sizeof(float);
+		case FBXPropertyType::ARRAY_INT32: return sizeof(int32_t);
+		case FBXPropertyType::ARRAY_DOUBLE: return sizeof(double);
+		case FBXPropertyType::ARRAY_INT64: return sizeof(int64_t);
+		case FBXPropertyType::ARRAY_BOOL: return sizeof(bool);
+		case FBXPropertyType::ARRAY_UINT8: return sizeof(uint8_t);
+		default: return 1u;
 		}
-		return out;
-#else
-		return out << "ARRAY<" << typeid(T).name() << ">";
-#endif
 	}
 
-    bool FbxTree::ReadNode(FBXNode* node)
+	uint8_t* FBXProperty::Reserve() const
+	{
+		const auto stride = ElementSize();
+		const auto byteLength = static_cast<size_t>(m_length) * stride;
+		if (m_encoding == 0)
+		{
+			if (m_storedLength != byteLength)
+				ORBIT_THROW("Corrupted fbx array. Expected %zu bytes but got %u", byteLength, m_storedLength);
+
+			// Uncompressed arrays are used in place unless they are misaligned
+			if (reinterpret_cast<uintptr_t>(m_data) % stride == 0)
+			{
+				m_decoded = m_data;
+				return nullptr;
+			}
+			return static_cast<uint8_t*>(m_arena->Allocate(byteLength, stride));
+		}
+		return static_cast<uint8_t*>(m_arena->Allocate(byteLength, alignof(std::max_align_t)));
+	}
+
+	void FBXProperty::DecodeInto(uint8_t* target) const
+	{
+		// Binary fbx files are little endian like all targets of orbtool, so both
+		// the copied and the inflated bytes are used as they are, without swapping
+		const auto byteLength = static_cast<size_t>(m_length) * ElementSize();
+		if (m_encoding == 0)
+		{
+			std::memcpy(target, m_data, byteLength);
+			m_decoded = target;
+			return;
+		}
+
+		uLongf destLen = static_cast<uLongf>(byteLength);
+		auto result = uncompress((Bytef*)target, &destLen, (const Bytef*)m_data, m_storedLength);
+		if (result != Z_OK || destLen != byteLength)
+			ORBIT_THROW("Failed to inflate fbx array (zlib error %d, %lu of %zu bytes)", result, static_cast<unsigned long>(destLen), byteLength);
+		m_decoded = target;
+	}
+
+	const uint8_t* FBXProperty::Decode() const
+	{
+		if (m_decoded)
+			return m_decoded;
+
+		if (auto target = Reserve())
+			DecodeInto(target);
+		return m_decoded;
+	}
+
+	std::string_view FBXProperty::GetString() const
+	{
+		if (!IsString())
+			TypeMismatch(FBXPropertyType::STRING);
+		return std::string_view(reinterpret_cast<const char*>(m_data), m_length);
+	}
+
+	void FbxTree::Require(size_t bytes) const
+	{
+		if (static_cast<size_t>(m_end - m_cursor) < bytes)
+			ORBIT_THROW("Corrupted fbx file. Unexpected end of file at offset %zu", Position());
+	}
+
+    const FBXNode* FbxTree::ReadNode()
     {
-        static constexpr auto sentinal_size = 13U;
-		static const char sentinal[sentinal_size] = { "\x00" };
+		const auto sentinal_size = m_version >= 7500u ? 25U : 13U;
 
-		auto offset = ReadPrimitive<uint32_t>();
+		auto offset = ReadOffset();
+		auto numProperties = ReadOffset();
+		/* propertyListLen */ ReadOffset();
+		auto nameLen = ReadPrimitive<uint8_t>();
 		if (offset == 0)
-			return false;
+			return nullptr; // Null record terminating a list of nodes
+		if (offset > static_cast<uint64_t>(m_end - m_begin))
+			ORBIT_THROW("Corrupted fbx file. Node end offset %llu is out of range", static_cast<unsigned long long>(offset));
 
-		node->properties.resize(ReadPrimitive<uint32_t>());
-		auto propertyListLen = ReadPrimitive<uint32_t>();
-		node->name.resize(static_cast<uint32_t>(ReadPrimitive<uint8_t>()));
-		node->name = ReadString(node->name.size());
+		auto node = m_arena.New<FBXNode>();
+		node->name = ReadString(nameLen);
 
-		for (auto i = 0u; i < node->properties.size(); ++i)
-			ReadProperty(&node->properties[i]);
+		auto properties = m_arena.NewArray<FBXProperty>(numProperties);
+		for (auto i = 0u; i < numProperties; ++i)
+			ReadProperty(&properties[i]);
+		node->properties = FBXView<FBXProperty>(properties, numProperties);
 
 		if (Position() < offset)
 		{
-			// There is a nested offset list
+			// There is a nested node list
+			const FBXNode* first = nullptr;
+			FBXNode* last = nullptr;
+			auto terminated = false;
 			while (Position() < (offset - sentinal_size))
 			{
-				node->children.push_back(FBXNode());
-				ReadNode(&node->children.back());
+				auto child = const_cast<FBXNode*>(ReadNode());
+				if (!child)
+				{
+					terminated = true;
+					break;
+				}
+				if (last)
+					last->next = child;
+				else
+					first = child;
+				last = child;
 			}
+			node->children = FBXNode::ChildList(first);
 
-			if (!ArrayCompare<sentinal_size>(ReadString(sentinal_size), sentinal))
-				throw "Corrupted file. Expected 13 zero bytes";
+			// The list is terminated by a null record
+			if (!terminated && !ReadNode())
+				terminated = true;
+			if (!terminated)
+				ORBIT_THROW("Corrupted fbx file. Expected %u zero bytes at offset %zu", sentinal_size, Position());
 		}
 
 		if (Position() != offset)
-			throw "Expected end of object data";
+			ORBIT_THROW("Corrupted fbx file. Expected end of node '%.*s' at offset %llu", static_cast<int>(node->name.size()), node->name.data(), static_cast<unsigned long long>(offset));
 
-		return true;
+		return node;
     }
 
     void FbxTree::ReadProperty(FBXProperty* property)
     {
-        auto data_type = ReadPrimitive<char>();
-		switch (data_type)
+		property->m_type = static_cast<FBXPropertyType>(ReadPrimitive<char>());
+		property->m_arena = &m_arena;
+		auto primitive = [&](size_t size) {
+			Require(size);
+			property->m_data = m_cursor;
+			m_cursor += size;
+		};
+
+		switch (property->m_type)
 		{
-		case 'Y': { using T = int16_t             ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'C': { using T = bool                ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'I': { using T = int32_t             ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'F': { using T = float               ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'D': { using T = double              ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'L': { using T = int64_t             ; InitVariant<T>(property); ReadPrimitive(&std::get<T>(*property)); break; }
-		case 'R': { using T = std::string         ; InitVariant<T>(property); ReadString   (&std::get<T>(*property)); break; }
-		case 'S': { using T = std::string         ; InitVariant<T>(property); ReadString   (&std::get<T>(*property)); break; }
-		case 'f': { using T = std::vector<float>  ; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
-		case 'i': { using T = std::vector<int32_t>; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
-		case 'd': { using T = std::vector<double> ; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
-		case 'l': { using T = std::vector<int64_t>; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
-		case 'b': { using T = std::vector<bool>   ; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
-		case 'c': { using T = std::vector<uint8_t>; InitVariant<T>(property); ReadArray    (&std::get<T>(*property)); break; }
+		case FBXPropertyType::INT16: primitive(sizeof(int16_t)); break;
+		case FBXPropertyType::BOOL: primitive(sizeof(bool)); break;
+		case FBXPropertyType::INT32: primitive(sizeof(int32_t)); break;
+		case FBXPropertyType::FLOAT: primitive(sizeof(float)); break;
+		case FBXPropertyType::DOUBLE: primitive(sizeof(double)); break;
+		case FBXPropertyType::INT64: primitive(sizeof(int64_t)); break;
+		case FBXPropertyType::STRING:
+			[[fallthrough]];
+		case FBXPropertyType::RAW:
+			property->m_length = ReadPrimitive<uint32_t>();
+			primitive(property->m_length);
+			break;
+		case FBXPropertyType::ARRAY_FLOAT:
+		case FBXPropertyType::ARRAY_INT32:
+		case FBXPropertyType::ARRAY_DOUBLE:
+		case FBXPropertyType::ARRAY_INT64:
+		case FBXPropertyType::ARRAY_BOOL:
+		case FBXPropertyType::ARRAY_UINT8:
+			property->m_length = ReadPrimitive<uint32_t>();
+			property->m_encoding = ReadPrimitive<uint32_t>();
+			property->m_storedLength = ReadPrimitive<uint32_t>();
+			primitive(property->m_storedLength);
+			break;
 		default:
-			throw "Invalid data type identifier";
+			ORBIT_THROW("Corrupted fbx file. Invalid data type identifier '%c' at offset %zu", static_cast<char>(property->m_type), Position());
 		}
     }
 
-    std::string FbxTree::ReadString(size_t length)
+    std::string_view FbxTree::ReadString(size_t length)
     {
-        std::string str;
-		str.resize(length);
-		m_stream->read(str.data(), length);
+		Require(length);
+		std::string_view str(reinterpret_cast<const char*>(m_cursor), length);
+		m_cursor += length;
 		return str;
     }
 
-    void FbxTree::ReadString(std::string* str)
-    {
-        *str = ReadString(ReadPrimitive<uint32_t>());
-    }
-
     void FbxTree::PrintProperty(std::ostream* stream, const FBXProperty* property)
     {
-        std::visit([&](const auto& value) { 
-				using T = std::decay_t<decltype(value)>;
-				if constexpr (std::is_same<T, std::string>::value)
-					*stream << '"' << value << '"';
-				else
-					(*stream) << "[" << typeid(T).name() << "] " << value;
-			}, 
-			*property);
+		switch (property->GetType())
+		{
+		case FBXPropertyType::INT16: *stream << property->Get<int16_t>(); break;
+		case FBXPropertyType::BOOL: *stream << property->Get<bool>(); break;
+		case FBXPropertyType::INT32: *stream << property->Get<int32_t>(); break;
+		case FBXPropertyType::FLOAT: *stream << property->Get<float>(); break;
+		case FBXPropertyType::DOUBLE: *stream << property->Get<double>(); break;
+		case FBXPropertyType::INT64: *stream << property->Get<int64_t>(); break;
+		case FBXPropertyType::STRING:
+			[[fallthrough]];
+		case FBXPropertyType::RAW: *stream << '"' << property->GetString() << '"'; break;
+		default:
+			// Printing must not inflate the arrays
+			*stream << "ARRAY<" << PropertyTypeToString(property->GetType()) << ">[" << property->Length() << "]";
+			break;
+		}
     }
 
-    FbxTree::FbxTree(std::istream* stream) : 
-        m_stream(stream)
+    FbxTree::FbxTree(const fs::path& filepath) :
+		m_arena(4u * 1024u * 1024u)
     {
         static constexpr auto header_size = 23U;
-		static char header[header_size] = "Kaydara FBX Binary\x20\x20\x00\x1a";
+		static const char header[header_size] = "Kaydara FBX Binary\x20\x20\x00\x1a";
+
+		if (!m_file.Open(filepath))
+		{
+			ORBIT_ERROR("Unable to map file '%s'", filepath.generic_string().c_str());
+			return;
+		}
+		m_begin = m_cursor = m_file.Data();
+		m_end = m_begin + m_file.Size();
 
-		if (!ArrayCompare<header_size>(ReadString(header_size), header))
+		if (m_file.Size() < header_size + sizeof(uint32_t) || std::memcmp(m_cursor, header, header_size) != 0)
 		{
             ORBIT_ERROR("FBX Header does not match!");
 			return;
 		}
+		m_cursor += header_size;
+		m_version = ReadPrimitive<uint32_t>();
 
-		auto version = ReadPrimitive<uint32_t>();
+		FBXNode* last = nullptr;
+		while (m_cursor < m_end)
+		{
+			auto node = const_cast<FBXNode*>(ReadNode());
+			if (!node)
+				break;
+			if (last)
+				last->next = node;
+			else
+				m_root.children = FBXNode::ChildList(node);
+			last = node;
+		}
+    }
+
+    static void CollectArrays(const FBXNode* node, std::vector<const FBXProperty*>* arrays)
+    {
+		for (const auto& property : node->properties)
+		{
+			if (property.IsArray() && !property.IsDecoded())
+				arrays->push_back(&property);
+		}
+		for (const auto& child : node->children)
+			CollectArrays(&child, arrays);
+    }
+
+    void FbxTree::DecodeArrays(const std::vector<const FBXNode*>& nodes)
+    {
+		// Phase one: record every pending array and reserve its destination.
+		// The arena is not thread safe, so this happens on the calling thread
+		std::vector<const FBXProperty*> arrays;
+		for (auto node : nodes)
+			CollectArrays(node, &arrays);
+
+		struct Job
+		{
+			const FBXProperty* property;
+			uint8_t* target;
+		};
+		std::vector<Job> jobs;
+		jobs.reserve(arrays.size());
+		for (auto property : arrays)
+		{
+			if (auto target = property->Reserve())
+				jobs.push_back(Job{ property, target });
+		}
 
-		FBXNode node;
-		while (ReadNode(&node))
-			m_root.children.emplace_back(node);
+		// Phase two: inflate the arrays concurrently, largest first so that
+		// a single big array doesn't end up last on one thread
+		std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+			return a.property->m_storedLength > b.property->m_storedLength;
+		});
+		ParallelForEach(jobs.begin(), jobs.end(), [](const Job& job) {
+			job.property->DecodeInto(job.target);
+		});
     }
 
     void FbxTree::PrintTree(std::ostream* stream, const FBXNode* node, unsigned offset)
@@ -1,5 +1,6 @@
 #include "implementation/misc/Logger.hpp"
 #include "orb/OrbFile.hpp"
+#include "mesh/MeshSimplifier.hpp"
 #include "ArgumentParser.hpp"
 #include "Helper.hpp"
 
@@ -24,12 +25,17 @@ int main(int argc, const char** argv)
 	parser.RegisterFlag("Writes a new file from an input file", "write", "w");
 	parser.RegisterFlag("Update a file to the most recent parser version", "update", "u");
 	parser.RegisterFlag("Automatically triangulate quads (naiv triangulation).", "triangulate", "t");
+	parser.RegisterArgument("Number of simplified levels of detail to generate for each mesh.", "lods", "l");
+	parser.RegisterFlag("Split meshes into clusters for cluster culling.", "clusters", "c");
+	parser.RegisterFlag("Generate mips and block compress textures into DDS payloads.", "textures", "x");
+	parser.RegisterArgument("Directory of the incremental build cache. Unchanged input files are not converted again.", "cache", "C");
+	parser.RegisterArgument("Load trace written by the engine. Payloads are stored in first-use order and bulk data is page aligned.", "layout", "L");
 	parser.RegisterValidConfigurations(
 		{ 
-			"011X00000", // Analyzing a file, CMD_ANALYZE
-			"10001100X", // Append a file, CMD_APPEND
-			"10000110X", // Write a new file, CMD_WRITE
-			"010000010", // Update an orb file to the newest version, CMD_UPDATE
+			"011X0000000000", // Analyzing a file, CMD_ANALYZE
+			"10001100XXXXXX", // Append a file, CMD_APPEND
+			"10000110XXXXXX", // Write a new file, CMD_WRITE
+			"01000001000000", // Update an orb file to the newest version, CMD_UPDATE
 		}
 	);
 	parser.WarnOnInvalid(true);
@@ -69,8 +75,17 @@ void Run(const ArgumentParser& parser)
 		auto orbfile = *parser.GetSwitch("output");
 		uint32_t numFiles = 0u;
 		auto externalFiles = parser.GetSwitch("external", &numFiles);
+		auto lodsStr = parser.GetSwitch("lods");
+		auto numLods = lodsStr ? strtoul(*lodsStr, nullptr, 10) : 0ul;
+		if (numLods > MeshSimplifier::sMaxLods)
+		{
+			ORBIT_LOG("Generating %u lods instead of %lu, the chain can not be longer.", MeshSimplifier::sMaxLods, numLods);
+			numLods = MeshSimplifier::sMaxLods;
+		}
+		auto cacheStr = parser.GetSwitch("cache");
+		auto layoutStr = parser.GetSwitch("layout");
 
-		Do_WriteAppend(externalFiles, numFiles, orbfile, config == CMD_APPEND, parser.GetSwitch("triangulate") != nullptr);
+		Do_WriteAppend(externalFiles, numFiles, orbfile, config == CMD_APPEND, parser.GetSwitch("triangulate") != nullptr, static_cast<uint32_t>(numLods), parser.GetSwitch("clusters") != nullptr, parser.GetSwitch("textures") != nullptr, cacheStr ? *cacheStr : nullptr, layoutStr ? *layoutStr : nullptr);
 	}
 	else if (config == CMD_UPDATE)
 	{
@@ -0,0 +1,189 @@
+#include "mesh/MeshClusterizer.hpp"
+#include "implementation/misc/Bounds.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+namespace orbtool
+{
+
+    MeshClusterizer::MeshClusterizer(const OrbVertex* vertices, size_t vertexCount, uint32_t maxVertices, uint32_t maxTriangles) :
+        m_vertices(vertices),
+        m_vertexCount(vertexCount),
+        m_maxVertices(maxVertices),
+        m_maxTriangles(maxTriangles)
+    {
+    }
+
+    orbit::MeshCluster MeshClusterizer::CalculateBounds(const uint32_t* indices, size_t indexCount) const
+    {
+        orbit::MeshCluster cluster{};
+
+        std::vector<Vector3f> positions;
+        positions.reserve(indexCount);
+        for (auto i = 0u; i < indexCount; ++i)
+            positions.push_back(m_vertices[indices[i]].position);
+        const auto sphere = orbit::BoundingSphere::FromPoints(positions.data(), positions.size());
+
+        std::vector<Vector3f> normals;
+        Vector3f axis = Vector3f::Zero();
+        for (auto i = 0u; i + 2u < indexCount; i += 3u)
+        {
+            const Vector3f normal = (positions[i + 1] - positions[i]).cross(positions[i + 2] - positions[i]);
+            const auto length = normal.norm();
+            if (length <= 0.f)
+                continue;
+            normals.push_back(normal / length);
+            axis += normals.back();
+        }
+
+        // The cone contains every triangle normal. If it opens wider than
+        // a half sphere some triangle is always visible
+        auto cutoff = 1.f;
+        if (axis.norm() > 0.f)
+        {
+            axis.normalize();
+            auto minDot = 1.f;
+            for (const auto& normal : normals)
+                minDot = std::min(minDot, axis.dot(normal));
+            if (minDot > 0.f)
+                cutoff = std::sqrt(1.f - minDot * minDot);
+        }
+
+        std::copy(sphere.center.data(), sphere.center.data() + 3, cluster.center);
+        std::copy(axis.data(), axis.data() + 3, cluster.coneAxis);
+        cluster.radius = sphere.radius;
+        cluster.coneCutoff = cutoff;
+        return cluster;
+    }
+
+    std::vector<orbit::MeshCluster> MeshClusterizer::Build(std::vector<uint32_t>& indices) const
+    {
+        const auto numTriangles = static_cast<uint32_t>(indices.size() / 3u);
+        std::vector<std::vector<uint32_t>> vertexTriangles(m_vertexCount);
+        for (auto t = 0u; t < numTriangles; ++t)
+            for (auto k = 0u; k < 3u; ++k)
+                vertexTriangles[indices[t * 3u + k]].push_back(t);
+
+        std::vector<bool> assigned(numTriangles, false);
+        // @note: a vertex is part of the current cluster if its stamp equals the cluster index
+        std::vector<uint32_t> vertexStamps(m_vertexCount, std::numeric_limits<uint32_t>::max());
+        std::vector<uint32_t> reordered;
+        reordered.reserve(indices.size());
+        std::vector<orbit::MeshCluster> clusters;
+
+        std::vector<uint32_t> frontier;
+        for (auto seed = 0u; seed < numTriangles; ++seed)
+        {
+            if (assigned[seed])
+                continue;
+
+            const auto clusterIndex = static_cast<uint32_t>(clusters.size());
+            const auto startIndex = static_cast<uint32_t>(reordered.size());
+            auto clusterVertices = 0u;
+            auto clusterTriangles = 0u;
+            auto newVertices = [&](uint32_t t) {
+                auto count = 0u;
+                for (auto k = 0u; k < 3u; ++k)
+                    count += vertexStamps[indices[t * 3u + k]] != clusterIndex ? 1u : 0u;
+                return count;
+            };
+
+            frontier.assign(1, seed);
+            while (clusterTriangles < m_maxTriangles)
+            {
+                // Grow the cluster with the adjacent triangle adding the fewest vertices
+                auto best = std::numeric_limits<uint32_t>::max();
+                auto bestCost = std::numeric_limits<uint32_t>::max();
+                auto write = 0u;
+                for (auto read = 0u; read < frontier.size(); ++read)
+                {
+                    const auto t = frontier[read];
+                    if (assigned[t])
+                        continue;
+                    frontier[write++] = t;
+                    const auto cost = newVertices(t);
+                    if (cost < bestCost && clusterVertices + cost <= m_maxVertices)
+                    {
+                        best = t;
+                        bestCost = cost;
+                    }
+                }
+                frontier.resize(write);
+                if (best == std::numeric_limits<uint32_t>::max())
+                    break;
+
+                assigned[best] = true;
+                ++clusterTriangles;
+                clusterVertices += bestCost;
+                for (auto k = 0u; k < 3u; ++k)
+                {
+                    const auto vertex = indices[best * 3u + k];
+                    reordered.push_back(vertex);
+                    if (vertexStamps[vertex] == clusterIndex)
+                        continue;
+                    vertexStamps[vertex] = clusterIndex;
+                    frontier.insert(frontier.end(), vertexTriangles[vertex].begin(), vertexTriangles[vertex].end());
+                }
+            }
+
+            const auto indexCount = static_cast<uint32_t>(reordered.size()) - startIndex;
+            auto cluster = CalculateBounds(reordered.data() + startIndex, indexCount);
+            cluster.startIndex = startIndex;
+            cluster.indexCount = indexCount;
+            clusters.push_back(cluster);
+        }
+
+        indices = std::move(reordered);
+        return clusters;
+    }
+
+    void MeshClusterizer::BuildClusters(OrbMesh* mesh)
+    {
+        mesh->clusters.clear();
+        if (mesh->vertices.empty())
+            return;
+
+        auto& submeshes = mesh->submeshes;
+        if (submeshes.empty())
+        {
+            SubMesh submesh;
+            submesh.vertexCount = mesh->vertices.size();
+            submesh.indexCount = mesh->indices.size();
+            submeshes.emplace_back(submesh);
+        }
+
+        // Clusters are index ranges, so the mesh has to be indexed
+        if (mesh->indices.empty())
+        {
+            for (auto& submesh : submeshes)
+            {
+                submesh.startIndex = mesh->indices.size();
+                submesh.indexCount = submesh.vertexCount;
+                mesh->indices.resize(submesh.startIndex + submesh.indexCount);
+                std::iota(mesh->indices.begin() + submesh.startIndex, mesh->indices.end(), 0u);
+            }
+        }
+
+        for (const auto& submesh : submeshes)
+        {
+            const auto begin = mesh->indices.begin() + submesh.startIndex;
+            std::vector<uint32_t> indices(begin, begin + submesh.indexCount);
+
+            MeshClusterizer clusterizer(mesh->vertices.data() + submesh.startVertex, submesh.vertexCount);
+            auto clusters = clusterizer.Build(indices);
+            std::copy(indices.begin(), indices.end(), begin);
+            for (auto& cluster : clusters)
+            {
+                cluster.startIndex += static_cast<uint32_t>(submesh.startIndex);
+                cluster.startVertex = static_cast<uint32_t>(submesh.startVertex);
+                mesh->clusters.push_back(cluster);
+            }
+        }
+
+        ORBIT_LOG("Split mesh into %zu clusters", mesh->clusters.size());
+    }
+
+}
@@ -0,0 +1,386 @@
+#include "mesh/MeshSimplifier.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <map>
+#include <tuple>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace orbtool
+{
+
+    MeshSimplifier::MeshSimplifier(const OrbVertex* vertices, size_t vertexCount) :
+        m_vertices(vertices),
+        m_vertexCount(vertexCount)
+    {
+        BuildGroups();
+    }
+
+    void MeshSimplifier::BuildGroups()
+    {
+        std::map<std::tuple<float, float, float>, uint32_t> positions;
+        m_groups.resize(m_vertexCount);
+        m_groupMembers.resize(m_vertexCount);
+        for (auto i = 0u; i < m_vertexCount; ++i)
+        {
+            const auto& p = m_vertices[i].position;
+            const auto it = positions.emplace(std::make_tuple(p.x(), p.y(), p.z()), i).first;
+            m_groups[i] = it->second;
+            m_groupMembers[it->second].push_back(i);
+        }
+    }
+
+    void MeshSimplifier::BuildQuadrics()
+    {
+        for (auto t = 0u; t < m_triangles.size(); ++t)
+        {
+            const auto& triangle = m_triangles[t];
+            const auto p0 = Position(Group(triangle.corners[0]));
+            const auto p1 = Position(Group(triangle.corners[1]));
+            const auto p2 = Position(Group(triangle.corners[2]));
+            Vector3d normal = (p1 - p0).cross(p2 - p0);
+            const auto area = normal.norm();
+            if (area <= 0.0)
+                continue;
+            normal /= area;
+
+            // Weighting by area keeps small slivers from dominating the error. The
+            // weights are divided out again when costs are computed, @see PushCollapse
+            const Vector4d plane(normal.x(), normal.y(), normal.z(), -normal.dot(p0));
+            const Quadric quadric = plane * plane.transpose() * (area * 0.5);
+            for (const auto corner : triangle.corners)
+            {
+                m_quadrics[Group(corner)] += quadric;
+                m_quadricWeights[Group(corner)] += area * 0.5;
+            }
+        }
+    }
+
+    void MeshSimplifier::LockBorders()
+    {
+        // An edge that is used by a single triangle lies on the border of
+        // the mesh. Moving its vertices would shrink holes and silhouettes.
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> edges;
+        for (const auto& triangle : m_triangles)
+        {
+            for (auto i = 0u; i < 3u; ++i)
+            {
+                auto a = Group(triangle.corners[i]);
+                auto b = Group(triangle.corners[(i + 1) % 3]);
+                if (a > b)
+                    std::swap(a, b);
+                ++edges[{ a, b }];
+            }
+        }
+
+        for (const auto& [edge, count] : edges)
+        {
+            if (count != 2u)
+            {
+                m_locked[edge.first] = true;
+                m_locked[edge.second] = true;
+            }
+        }
+    }
+
+    void MeshSimplifier::PushCollapse(uint32_t from, uint32_t to)
+    {
+        if (m_locked[from])
+            return;
+
+        const Quadric quadric = m_quadrics[from] + m_quadrics[to];
+        const auto weight = m_quadricWeights[from] + m_quadricWeights[to];
+        const auto p = Position(to);
+        const Vector4d target(p.x(), p.y(), p.z(), 1.0);
+        // Normalized by the area, the cost is a squared distance like maxError
+        const auto cost = weight > 0.0 ? target.dot(quadric * target) / weight : 0.0;
+        m_queue.push(Collapse{ std::max(cost, 0.0), from, to, m_stamps[from], m_stamps[to] });
+    }
+
+    void MeshSimplifier::PushCollapses(uint32_t group)
+    {
+        for (const auto t : m_groupTriangles[group])
+        {
+            const auto& triangle = m_triangles[t];
+            if (triangle.removed)
+                continue;
+            for (const auto corner : triangle.corners)
+            {
+                const auto other = Group(corner);
+                if (other == group)
+                    continue;
+                PushCollapse(group, other);
+                PushCollapse(other, group);
+            }
+        }
+    }
+
+    bool MeshSimplifier::IsCollapseValid(const Collapse& collapse) const
+    {
+        const auto from = collapse.from;
+        const auto to = collapse.to;
+        if (m_collapsed[from] || m_collapsed[to])
+            return false;
+        if (m_stamps[from] != collapse.fromStamp || m_stamps[to] != collapse.toStamp)
+            return false;
+
+        // Link condition: the two vertices may only share the neighbours of
+        // the triangles on the collapsed edge, otherwise the result is non-manifold
+        std::vector<uint32_t> fromNeighbours;
+        std::vector<uint32_t> toNeighbours;
+        auto sharedTriangles = 0u;
+        for (const auto t : m_groupTriangles[from])
+        {
+            const auto& triangle = m_triangles[t];
+            if (triangle.removed)
+                continue;
+            auto containsTo = false;
+            for (const auto corner : triangle.corners)
+            {
+                fromNeighbours.push_back(Group(corner));
+                containsTo |= Group(corner) == to;
+            }
+            sharedTriangles += containsTo ? 1u : 0u;
+        }
+        for (const auto t : m_groupTriangles[to])
+        {
+            const auto& triangle = m_triangles[t];
+            if (triangle.removed)
+                continue;
+            for (const auto corner : triangle.corners)
+                toNeighbours.push_back(Group(corner));
+        }
+        std::sort(fromNeighbours.begin(), fromNeighbours.end());
+        std::sort(toNeighbours.begin(), toNeighbours.end());
+        fromNeighbours.erase(std::unique(fromNeighbours.begin(), fromNeighbours.end()), fromNeighbours.end());
+        toNeighbours.erase(std::unique(toNeighbours.begin(), toNeighbours.end()), toNeighbours.end());
+
+        std::vector<uint32_t> common;
+        std::set_intersection(
+            fromNeighbours.begin(), fromNeighbours.end(),
+            toNeighbours.begin(), toNeighbours.end(),
+            std::back_inserter(common));
+        // common contains 'from' and 'to' themselves
+        if (common.size() > sharedTriangles + 2u)
+            return false;
+
+        // Reject collapses that would flip the orientation of a triangle
+        const auto target = Position(to);
+        for (const auto t : m_groupTriangles[from])
+        {
+            const auto& triangle = m_triangles[t];
+            if (triangle.removed)
+                continue;
+
+            Vector3d before[3];
+            Vector3d after[3];
+            auto containsTo = false;
+            for (auto i = 0u; i < 3u; ++i)
+            {
+                const auto group = Group(triangle.corners[i]);
+                containsTo |= group == to;
+                before[i] = Position(group);
+                after[i] = group == from ? target : before[i];
+            }
+            if (containsTo)
+                continue;
+
+            const Vector3d n0 = (before[1] - before[0]).cross(before[2] - before[0]);
+            const Vector3d n1 = (after[1] - after[0]).cross(after[2] - after[0]);
+            if (n0.dot(n1) <= 0.0)
+                return false;
+        }
+
+        return true;
+    }
+
+    uint32_t MeshSimplifier::FindWedge(uint32_t vertex, uint32_t group) const
+    {
+        // Pick the vertex of the target position whose attributes match the
+        // collapsed corner best so uv seams and hard edges survive
+        const auto& source = m_vertices[vertex];
+        auto best = group;
+        auto bestDistance = std::numeric_limits<float>::max();
+        for (const auto member : m_groupMembers[group])
+        {
+            const auto& candidate = m_vertices[member];
+            const auto distance =
+                (candidate.textureCoords - source.textureCoords).squaredNorm() +
+                (candidate.normal - source.normal).squaredNorm();
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                best = member;
+            }
+        }
+        return best;
+    }
+
+    void MeshSimplifier::PerformCollapse(uint32_t from, uint32_t to)
+    {
+        m_quadrics[to] += m_quadrics[from];
+        m_quadricWeights[to] += m_quadricWeights[from];
+        m_collapsed[from] = true;
+        ++m_stamps[to];
+
+        for (const auto t : m_groupTriangles[from])
+        {
+            auto& triangle = m_triangles[t];
+            if (triangle.removed)
+                continue;
+
+            const auto containsTo = std::any_of(
+                std::begin(triangle.corners), std::end(triangle.corners),
+                [&](uint32_t corner) { return Group(corner) == to; });
+            if (containsTo)
+            {
+                triangle.removed = true;
+                --m_liveTriangles;
+                continue;
+            }
+
+            for (auto& corner : triangle.corners)
+                if (Group(corner) == from)
+                    corner = FindWedge(corner, to);
+            m_groupTriangles[to].push_back(t);
+        }
+        m_groupTriangles[from].clear();
+
+        PushCollapses(to);
+    }
+
+    std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<uint32_t>& indices, size_t targetIndexCount, double maxError)
+    {
+        m_triangles.clear();
+        m_queue = {};
+        m_groupTriangles.assign(m_vertexCount, {});
+        m_quadrics.assign(m_vertexCount, Quadric::Zero());
+        m_quadricWeights.assign(m_vertexCount, 0.0);
+        m_stamps.assign(m_vertexCount, 0u);
+        m_locked.assign(m_vertexCount, false);
+        m_collapsed.assign(m_vertexCount, false);
+
+        for (auto i = 0u; i + 2u < indices.size(); i += 3u)
+        {
+            Triangle triangle{ { indices[i], indices[i + 1u], indices[i + 2u] } };
+            const auto g0 = Group(triangle.corners[0]);
+            const auto g1 = Group(triangle.corners[1]);
+            const auto g2 = Group(triangle.corners[2]);
+            if (g0 == g1 || g1 == g2 || g0 == g2)
+                continue;
+
+            const auto index = static_cast<uint32_t>(m_triangles.size());
+            m_groupTriangles[g0].push_back(index);
+            m_groupTriangles[g1].push_back(index);
+            m_groupTriangles[g2].push_back(index);
+            m_triangles.push_back(triangle);
+        }
+        m_liveTriangles = m_triangles.size();
+
+        BuildQuadrics();
+        LockBorders();
+        for (auto i = 0u; i < m_vertexCount; ++i)
+            if (Group(i) == i && !m_groupTriangles[i].empty())
+                PushCollapses(i);
+
+        while (m_liveTriangles * 3u > targetIndexCount && !m_queue.empty())
+        {
+            const auto collapse = m_queue.top();
+            m_queue.pop();
+            if (collapse.cost > maxError)
+                break;
+            if (!IsCollapseValid(collapse))
+                continue;
+            PerformCollapse(collapse.from, collapse.to);
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(m_liveTriangles * 3u);
+        for (const auto& triangle : m_triangles)
+        {
+            if (triangle.removed)
+                continue;
+            result.insert(result.end(), std::begin(triangle.corners), std::end(triangle.corners));
+        }
+        return result;
+    }
+
+    void MeshSimplifier::BuildLodChain(OrbMesh* mesh, uint32_t numLods)
+    {
+        mesh->lods.clear();
+        if (numLods == 0u || mesh->vertices.empty())
+            return;
+        numLods = std::min(numLods, sMaxLods);
+
+        auto submeshes = mesh->submeshes;
+        if (submeshes.empty())
+        {
+            SubMesh submesh;
+            submesh.vertexCount = mesh->vertices.size();
+            submesh.indexCount = mesh->indices.size();
+            submeshes.emplace_back(submesh);
+        }
+
+        // The error bound grows with every level and is relative to the size of the mesh
+        Vector3f min = mesh->vertices.front().position;
+        Vector3f max = min;
+        for (const auto& vertex : mesh->vertices)
+        {
+            min = min.cwiseMin(vertex.position);
+            max = max.cwiseMax(vertex.position);
+        }
+        const auto extent = static_cast<double>((max - min).norm());
+
+        // Current index list of every submesh (local to the submesh's vertices)
+        std::vector<std::vector<uint32_t>> current;
+        std::vector<MeshSimplifier> simplifiers;
+        for (const auto& submesh : submeshes)
+        {
+            std::vector<uint32_t> indices;
+            if (mesh->indices.empty())
+            {
+                indices.resize(submesh.vertexCount);
+                std::iota(indices.begin(), indices.end(), 0u);
+            }
+            else
+            {
+                const auto begin = mesh->indices.begin() + submesh.startIndex;
+                indices.assign(begin, begin + submesh.indexCount);
+            }
+            current.emplace_back(std::move(indices));
+            simplifiers.emplace_back(mesh->vertices.data() + submesh.startVertex, submesh.vertexCount);
+        }
+
+        for (auto lod = 1u; lod <= numLods; ++lod)
+        {
+            OrbMeshLod meshLod;
+            meshLod.screenSize = 0.5f / static_cast<float>(1u << lod);
+
+            const auto maxError = std::pow(0.005 * extent * static_cast<double>(1u << lod), 2.0);
+            size_t previousCount = 0u;
+            for (auto s = 0u; s < submeshes.size(); ++s)
+            {
+                previousCount += current[s].size();
+                auto simplified = simplifiers[s].Simplify(current[s], current[s].size() / 2u, maxError);
+                if (!simplified.empty())
+                    current[s] = std::move(simplified);
+
+                SubMesh submesh = submeshes[s];
+                submesh.startIndex = meshLod.indices.size();
+                submesh.indexCount = current[s].size();
+                meshLod.indices.insert(meshLod.indices.end(), current[s].begin(), current[s].end());
+                meshLod.submeshes.emplace_back(submesh);
+            }
+
+            // Further levels wouldn't save enough to justify the extra indices
+            if (meshLod.indices.size() * 10u > previousCount * 9u)
+                break;
+
+            ORBIT_LOG("Generated lod %u with %zu triangles", lod, meshLod.indices.size() / 3u);
+            mesh->lods.emplace_back(std::move(meshLod));
+        }
+    }
+
+}
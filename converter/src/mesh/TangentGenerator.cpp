@@ -0,0 +1,203 @@
+#include "mesh/TangentGenerator.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#include <numeric>
+#include <algorithm>
+#include <execution>
+#include <cmath>
+
+namespace orbtool
+{
+
+    // @brief: the contribution of a single triangle corner to its vertex
+    struct CornerTangent
+    {
+        Vector3f tangent;
+        // @member: corner angle used as weight. Negative for mirrored texture coordinates
+        float weight;
+    };
+
+    static bool VertexLess(const OrbVertex& v0, const OrbVertex& v1)
+    {
+        const float* a[] = { v0.position.data(), v0.normal.data(), v0.textureCoords.data() };
+        const float* b[] = { v1.position.data(), v1.normal.data(), v1.textureCoords.data() };
+        const int sizes[] = { 3, 3, 2 };
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            for (auto k = 0; k < sizes[i]; ++k)
+            {
+                if (a[i][k] != b[i][k])
+                    return a[i][k] < b[i][k];
+            }
+        }
+        return false;
+    }
+
+    static Vector3f Orthogonal(const Vector3f& normal)
+    {
+        // Any tangent is better than none if the texture coordinates are degenerate
+        const Vector3f axis = std::abs(normal.x()) < 0.9f ? Vector3f::UnitX() : Vector3f::UnitY();
+        const Vector3f tangent = axis - normal * normal.dot(axis);
+        return tangent.normalized();
+    }
+
+    TangentGenerator::TangentGenerator(OrbVertex* vertices, size_t vertexCount) :
+        m_vertices(vertices),
+        m_vertexCount(vertexCount)
+    {
+    }
+
+    uint32_t TangentGenerator::WeldVertices(std::vector<uint32_t>* groups) const
+    {
+        std::vector<uint32_t> order(m_vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(std::execution::par, order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return VertexLess(m_vertices[a], m_vertices[b]);
+        });
+
+        groups->resize(m_vertexCount);
+        auto numGroups = 0u;
+        for (auto i = 0u; i < order.size(); ++i)
+        {
+            if (i == 0u || VertexLess(m_vertices[order[i - 1]], m_vertices[order[i]]))
+                ++numGroups;
+            (*groups)[order[i]] = numGroups - 1u;
+        }
+        return numGroups;
+    }
+
+    void TangentGenerator::Generate(const uint32_t* indices, size_t indexCount)
+    {
+        const auto numTriangles = indexCount / 3u;
+        if (numTriangles == 0u)
+            return;
+
+        // Every corner writes its own slot, so triangles can run in parallel
+        std::vector<CornerTangent> corners(numTriangles * 3u);
+        ParallelFor(numTriangles, [&](size_t t) {
+            const auto& v0 = m_vertices[indices[t * 3u + 0u]];
+            const auto& v1 = m_vertices[indices[t * 3u + 1u]];
+            const auto& v2 = m_vertices[indices[t * 3u + 2u]];
+
+            const Vector3f d1 = v1.position - v0.position;
+            const Vector3f d2 = v2.position - v0.position;
+            const Vector2f t1 = v1.textureCoords - v0.textureCoords;
+            const Vector2f t2 = v2.textureCoords - v0.textureCoords;
+            const auto signedArea = t1.x() * t2.y() - t1.y() * t2.x();
+            const Vector3f faceTangent = (t2.y() * d1 - t1.y() * d2) * (signedArea < 0.f ? -1.f : 1.f);
+            const Vector3f faceNormal = d1.cross(d2).normalized();
+
+            const OrbVertex* triangle[] = { &v0, &v1, &v2 };
+            for (auto k = 0u; k < 3u; ++k)
+            {
+                auto& corner = corners[t * 3u + k];
+                corner.tangent = Vector3f::Zero();
+                corner.weight = 0.f;
+
+                const auto& vertex = *triangle[k];
+                Vector3f normal = vertex.normal.squaredNorm() > 0.f ? vertex.normal.normalized() : faceNormal;
+                auto project = [&](const Vector3f& v) -> Vector3f { return v - normal * normal.dot(v); };
+
+                // The weight is the corner angle inside of the tangent plane
+                const Vector3f e0 = project(triangle[(k + 1u) % 3u]->position - vertex.position);
+                const Vector3f e1 = project(triangle[(k + 2u) % 3u]->position - vertex.position);
+                if (e0.squaredNorm() <= 0.f || e1.squaredNorm() <= 0.f)
+                    continue;
+                const auto angle = std::acos(std::clamp(e0.normalized().dot(e1.normalized()), -1.f, 1.f));
+
+                const Vector3f tangent = project(faceTangent);
+                if (signedArea == 0.f || tangent.squaredNorm() <= 0.f)
+                    continue;
+                corner.tangent = tangent.normalized() * angle;
+                corner.weight = signedArea < 0.f ? -angle : angle;
+            }
+        });
+
+        // Partition the corners by vertex group so that every group is summed by one thread
+        std::vector<uint32_t> groups;
+        const auto numGroups = WeldVertices(&groups);
+        std::vector<uint32_t> offsets(numGroups + 1u, 0u);
+        for (auto c = 0u; c < corners.size(); ++c)
+            ++offsets[groups[indices[c]] + 1u];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<uint32_t> groupCorners(corners.size());
+        {
+            auto cursor = offsets;
+            for (auto c = 0u; c < corners.size(); ++c)
+                groupCorners[cursor[groups[indices[c]]]++] = c;
+        }
+
+        std::vector<Vector3f> groupTangents(numGroups, Vector3f::Zero());
+        ParallelFor(numGroups, [&](size_t g) {
+            // A vertex stores no bitangent sign. Where mirrored and unmirrored
+            // triangles meet, the orientation with the larger weight wins
+            Vector3f sums[2] = { Vector3f::Zero(), Vector3f::Zero() };
+            float weights[2] = { 0.f, 0.f };
+            for (auto i = offsets[g]; i < offsets[g + 1u]; ++i)
+            {
+                const auto& corner = corners[groupCorners[i]];
+                const auto side = corner.weight < 0.f ? 1u : 0u;
+                sums[side] += corner.tangent;
+                weights[side] += std::abs(corner.weight);
+            }
+            groupTangents[g] = weights[0] >= weights[1] ? sums[0] : sums[1];
+        });
+
+        ParallelFor(m_vertexCount, [&](size_t v) {
+            auto& vertex = m_vertices[v];
+            const Vector3f& tangent = groupTangents[groups[v]];
+            if (tangent.squaredNorm() > 0.f)
+                vertex.tangent = tangent.normalized();
+            else if (vertex.normal.squaredNorm() > 0.f)
+                vertex.tangent = Orthogonal(vertex.normal.normalized());
+        });
+    }
+
+    bool TangentGenerator::HasTangents(const OrbVertex* vertices, size_t vertexCount)
+    {
+        return std::any_of(vertices, vertices + vertexCount, [](const OrbVertex& v) {
+            return v.tangent.squaredNorm() > 0.f;
+        });
+    }
+
+    void TangentGenerator::GenerateTangents(OrbMesh* mesh)
+    {
+        std::vector<SubMesh> submeshes = mesh->submeshes;
+        if (submeshes.empty())
+        {
+            SubMesh submesh;
+            submesh.vertexCount = mesh->vertices.size();
+            submesh.indexCount = mesh->indices.size();
+            submeshes.emplace_back(submesh);
+        }
+
+        auto numGenerated = 0u;
+        std::vector<uint32_t> sequential;
+        for (const auto& submesh : submeshes)
+        {
+            auto vertices = mesh->vertices.data() + submesh.startVertex;
+            if (HasTangents(vertices, submesh.vertexCount))
+                continue;
+
+            const uint32_t* indices = mesh->indices.data() + submesh.startIndex;
+            auto indexCount = static_cast<size_t>(submesh.indexCount);
+            if (mesh->indices.empty())
+            {
+                // Non-indexed meshes form triangles from consecutive vertices
+                sequential.resize(submesh.vertexCount);
+                std::iota(sequential.begin(), sequential.end(), 0u);
+                indices = sequential.data();
+                indexCount = sequential.size();
+            }
+
+            TangentGenerator generator(vertices, submesh.vertexCount);
+            generator.Generate(indices, indexCount);
+            ++numGenerated;
+        }
+
+        if (numGenerated > 0u)
+            ORBIT_LOG("Generated tangents for %u of %zu submeshes", numGenerated, submeshes.size());
+    }
+
+}
@@ -1,6 +1,9 @@
 #include "orb/OrbFile.hpp"
 #include "orb/OrbIntermediate.hpp"
 #include "implementation/misc/Logger.hpp"
+#include "implementation/rendering/MeshChunk.hpp"
+#include <dxgiformat.h>
+#include "implementation/misc/DDS.h"
 
 #include <fstream>
 #include <d3dcompiler.h>
@@ -31,8 +34,12 @@ namespace orbtool
         case ResourceType::RASTERIZER_STATE: return "Rasterizer State";
         case ResourceType::BLEND_STATE: return "Blend State";
         case ResourceType::SAMPLER_STATE: return "Sampler State";
+        case ResourceType::SKELETON: return "Skeleton";
+        case ResourceType::ANIMATION_CLIP: return "Animation Clip";
+        case ResourceType::COLLISION_MESH: return "Collision Mesh";
 
         case ResourceType::CUSTOM: return "Custom";
+        case ResourceType::PADDING: return "Padding";
         default: return "Unknown"; 
         }
     }
@@ -72,8 +79,12 @@ namespace orbtool
             file.read(name.data(), nameLen);
             file.seekg(header.payloadSize, std::ios::cur);
             index.type = header.type;
+            index.payloadSize = header.payloadSize;
 
-            m_indices.emplace(header.id, index);
+            if (header.type == ResourceType::PADDING)
+                ++m_numPaddingRecords;
+            else
+                m_indices.emplace(header.id, index);
 
             if (file.bad())
                 return true;
@@ -127,6 +138,7 @@ namespace orbtool
         name.resize(nameLen);
         file.read(name.data(), nameLen);
         auto alloc = 30u;
+        auto payloadEnd = static_cast<size_t>(file.tellg()) + header.payloadSize;
         printf_s("  - %*s: %s\n", alloc, "Name", name.c_str());
 
         // Print resource details...
@@ -175,6 +187,49 @@ namespace orbtool
             printf_s("  - %*s: %lld\n", alloc, "Material", materialId + itemId);
             printf_s("  - %*s: %lld\n", alloc, "Number of vertices", numVertices);
             printf_s("  - %*s: %lld\n", alloc, "Number of indices", numIndices);
+
+            file.seekg(sizeof(uint32_t) * numIndices + sizeof(OrbVertex) * numVertices, std::ios::cur);
+            orbit::MeshChunkHeader chunk;
+            while (static_cast<size_t>(file.tellg()) + sizeof(orbit::MeshChunkHeader) <= payloadEnd)
+            {
+                file.read((char*)&chunk, sizeof(orbit::MeshChunkHeader));
+                auto chunkEnd = static_cast<size_t>(file.tellg()) + chunk.size;
+                printf_s("  - %*s: %s (%u bytes)\n", alloc, "Chunk", orbit::MeshChunkTypeToString(chunk.type), chunk.size);
+                if (chunk.type == orbit::MeshChunkType::CHUNK_LOD)
+                {
+                    uint32_t numLods = 0u;
+                    file.read((char*)&numLods, sizeof(uint32_t));
+                    for (auto lod = 0u; lod < numLods; ++lod)
+                    {
+                        float screenSize = 0.f;
+                        uint32_t numSubmeshes = 0u;
+                        uint64_t lodIndices = 0u;
+                        file.read((char*)&screenSize, sizeof(float));
+                        file.read((char*)&numSubmeshes, sizeof(uint32_t));
+                        for (auto s = 0u; s < numSubmeshes; ++s)
+                        {
+                            uint64_t range[3];
+                            file.read((char*)range, sizeof(range));
+                            file.seekg(sizeof(uint32_t) * range[2], std::ios::cur);
+                            lodIndices += range[2];
+                        }
+                        printf_s("  - %*s: %u, %llu indices below %f\n", alloc, "LOD", lod + 1u, static_cast<unsigned long long>(lodIndices), screenSize);
+                    }
+                }
+                else if (chunk.type == orbit::MeshChunkType::CHUNK_CLUSTER)
+                {
+                    uint32_t numClusters = 0u;
+                    file.read((char*)&numClusters, sizeof(uint32_t));
+                    printf_s("  - %*s: %d\n", alloc, "Number of clusters", numClusters);
+                }
+                else if (chunk.type == orbit::MeshChunkType::CHUNK_SKIN)
+                {
+                    ResourceId skeletonId;
+                    file.read((char*)&skeletonId, sizeof(ResourceId));
+                    printf_s("  - %*s: %lld\n", alloc, "Skeleton", skeletonId + itemId);
+                }
+                file.seekg(chunkEnd, std::ios::beg);
+            }
             break;
         }
         case ResourceType::INPUT_LAYOUT: {
@@ -305,13 +360,112 @@ namespace orbtool
             break;
         }
         case ResourceType::SPLINE: {
+            uint32_t
+                flags = 0u,
+                numSegments = 0u,
+                numSamples = 0u;
+            float length = 0.f;
+            file.read((char*)&flags, sizeof(uint32_t));
+            file.read((char*)&numSegments, sizeof(uint32_t));
+            file.read((char*)&numSamples, sizeof(uint32_t));
+            file.read((char*)&length, sizeof(float));
+            printf_s("  - %*s: %s\n", alloc, "Closed", flags & orbit::SPLINE_CLOSED ? "true" : "false");
+            printf_s("  - %*s: %d\n", alloc, "Number of segments", numSegments);
+            printf_s("  - %*s: %d\n", alloc, "Number of samples", numSamples);
+            printf_s("  - %*s: %f\n", alloc, "Length", length);
+            break;
+        }
+        case ResourceType::COLLISION_MESH: {
+            orbit::CollisionShape shape;
+            uint32_t physxVersion = 0u;
+            uint32_t numParts = 0u;
+            uint64_t cookedSize = 0u;
+            file.read((char*)&shape, sizeof(orbit::CollisionShape));
+            file.read((char*)&physxVersion, sizeof(uint32_t));
+            file.read((char*)&numParts, sizeof(uint32_t));
+            for (auto part = 0u; part < numParts; ++part)
+            {
+                uint64_t dataSize = 0u;
+                file.read((char*)&dataSize, sizeof(uint64_t));
+                file.seekg(dataSize, std::ios::cur);
+                cookedSize += dataSize;
+            }
+            const char* shapeName = "Triangle mesh";
+            if (shape == orbit::CollisionShape::CONVEX_MESH)
+                shapeName = "Convex mesh";
+            else if (shape == orbit::CollisionShape::CONVEX_DECOMPOSITION)
+                shapeName = "Convex decomposition";
+            printf_s("  - %*s: %s\n", alloc, "Shape", shapeName);
+            printf_s("  - %*s: %u.%u.%u\n", alloc, "PhysX version", physxVersion >> 24u, (physxVersion >> 16u) & 0xFFu, (physxVersion >> 8u) & 0xFFu);
+            printf_s("  - %*s: %d\n", alloc, "Number of parts", numParts);
+            printf_s("  - %*s: %lld\n", alloc, "Cooked size", cookedSize);
+            break;
+        }
+        case ResourceType::SKELETON: {
+            uint32_t numJoints = 0u;
+            file.read((char*)&numJoints, sizeof(uint32_t));
+            printf_s("  - %*s: %d\n", alloc, "Number of joints", numJoints);
+            for (auto joint = 0u; joint < numJoints; ++joint)
+            {
+                uint32_t jointNameLen = 0u;
+                std::string jointName;
+                int32_t parent = -1;
+                file.read((char*)&jointNameLen, sizeof(uint32_t));
+                jointName.resize(jointNameLen);
+                file.read(jointName.data(), jointNameLen);
+                file.read((char*)&parent, sizeof(int32_t));
+                file.seekg(sizeof(orbit::JointPose) + sizeof(float) * 16, std::ios::cur);
+                printf_s("  - %*s: %d %s (parent %d)\n", alloc, "Joint", joint, jointName.c_str(), parent);
+            }
+            break;
+        }
+        case ResourceType::ANIMATION_CLIP: {
+            ResourceId skeletonId;
+            float sampleRate = 0.f;
+            uint32_t
+                numFrames = 0u,
+                numTracks = 0u;
+            file.read((char*)&skeletonId, sizeof(ResourceId));
+            file.read((char*)&sampleRate, sizeof(float));
+            file.read((char*)&numFrames, sizeof(uint32_t));
+            file.read((char*)&numTracks, sizeof(uint32_t));
+            uint64_t numKeys[3] = { 0u, 0u, 0u };
+            for (auto track = 0u; track < numTracks; ++track)
+            {
+                orbit::AnimationTrackHeader header;
+                file.read((char*)&header, sizeof(orbit::AnimationTrackHeader));
+                numKeys[0] += header.numRotationKeys;
+                numKeys[1] += header.numTranslationKeys;
+                numKeys[2] += header.numScaleKeys;
+            }
 
+            printf_s("  - %*s: %lld\n", alloc, "Skeleton", skeletonId + itemId);
+            printf_s("  - %*s: %f\n", alloc, "Sample rate", sampleRate);
+            printf_s("  - %*s: %d\n", alloc, "Number of frames", numFrames);
+            printf_s("  - %*s: %d\n", alloc, "Number of tracks", numTracks);
+            printf_s("  - %*s: %lld\n", alloc, "Rotation keys", numKeys[0]);
+            printf_s("  - %*s: %lld\n", alloc, "Translation keys", numKeys[1]);
+            printf_s("  - %*s: %lld\n", alloc, "Scale keys", numKeys[2]);
             break;
         }
         case ResourceType::TEXTURE: {
             uint64_t binaryLen = 0u;
             file.read((char*)&binaryLen, sizeof(uint64_t));
             printf_s("  - %*s: %lld\n", alloc, "Texture size", binaryLen);
+
+            uint32_t magic = 0u;
+            file.read((char*)&magic, sizeof(uint32_t));
+            if (binaryLen >= sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER) + sizeof(DirectX::DDS_HEADER_DXT10) && magic == DirectX::DDS_MAGIC)
+            {
+                DirectX::DDS_HEADER dds;
+                DirectX::DDS_HEADER_DXT10 extension;
+                file.read((char*)&dds, sizeof(DirectX::DDS_HEADER));
+                file.read((char*)&extension, sizeof(DirectX::DDS_HEADER_DXT10));
+                printf_s("  - %*s: %ux%u\n", alloc, "Dimensions", dds.width, dds.height);
+                printf_s("  - %*s: %u\n", alloc, "Mip levels", dds.mipMapCount);
+                if (dds.ddspf.fourCC == DirectX::DDSPF_DX10.fourCC)
+                    printf_s("  - %*s: %u\n", alloc, "DXGI format", static_cast<uint32_t>(extension.dxgiFormat));
+            }
             break;
         }
         case ResourceType::TEXTURE_REFERENCE: {
@@ -418,6 +572,8 @@ namespace orbtool
             return WriteIntermediate(orb, m_filepath);
         
         orb.MakeUnique();
+        if (!m_loadOrder.empty())
+            orb.OrderBy(m_loadOrder);
 
         auto outputExists = fs::exists(target);
         if (!outputExists)
@@ -434,7 +590,7 @@ namespace orbtool
             return;
         }
 
-        uint32_t numObjects = m_indices.size() + orb.NumObjects();
+        uint32_t numObjects = m_indices.size() + m_numPaddingRecords + orb.NumObjects();
         if (outputExists)
         {
             orbit::Version fileVersion = 0;
@@ -458,15 +614,21 @@ namespace orbtool
         auto start_id = id;
         uint32_t dummy = 0u;
         auto objectsToBeWritten = orb.NumObjects();
+        auto numPaddingRecords = 0u;
         for (auto i = 0u; i < objectsToBeWritten; ++i)
         {
             ResourceType type = orb.GetObjectType(i);
+            auto name = orb.GetObjectName(i);
+            uint32_t nameLen = name.length();
+            // Bulk data starts on a page boundary, so loading it never touches a page of its neighbours
+            if (m_payloadAlignment > 1u && (type == ResourceType::MESH || type == ResourceType::TEXTURE) &&
+                WritePadding(&output, sizeof(ResourceId) + sizeof(ResourceType) + sizeof(uint32_t) * 2 + nameLen))
+                ++numPaddingRecords;
+
             output.write((const char*)&id, sizeof(ResourceId));
             output.write((const char*)&type, sizeof(ResourceType));
             auto prevPos = output.tellg();
             output.write((const char*)&dummy, sizeof(uint32_t));
-            auto name = orb.GetObjectName(i);
-            uint32_t nameLen = name.length();
             output.write((const char*)&nameLen, sizeof(uint32_t));
             output.write(name.data(), nameLen);
             switch (type)
@@ -507,6 +669,120 @@ namespace orbtool
                 output.write((const char*)&numVertices, sizeof(uint64_t));
                 output.write((const char*)mesh.indices.data(), sizeof(uint32_t) * numIndices);
                 output.write((const char*)mesh.vertices.data(), sizeof(OrbVertex) * numVertices);
+                if (!mesh.lods.empty())
+                {
+                    orbit::MeshChunkHeader chunk;
+                    chunk.type = orbit::MeshChunkType::CHUNK_LOD;
+                    chunk.size = sizeof(uint32_t);
+                    for (const auto& lod : mesh.lods)
+                        chunk.size += sizeof(float) + sizeof(uint32_t) + 
+                            lod.submeshes.size() * sizeof(uint64_t) * 3 + lod.indices.size() * sizeof(uint32_t);
+                    output.write((const char*)&chunk, sizeof(orbit::MeshChunkHeader));
+
+                    uint32_t numLods = mesh.lods.size();
+                    output.write((const char*)&numLods, sizeof(uint32_t));
+                    for (const auto& lod : mesh.lods)
+                    {
+                        uint32_t numSubmeshes = lod.submeshes.size();
+                        output.write((const char*)&lod.screenSize, sizeof(float));
+                        output.write((const char*)&numSubmeshes, sizeof(uint32_t));
+                        for (const auto& submesh : lod.submeshes)
+                        {
+                            uint64_t range[3] = { submesh.startVertex, submesh.vertexCount, submesh.indexCount };
+                            output.write((const char*)range, sizeof(range));
+                            output.write((const char*)(lod.indices.data() + submesh.startIndex), sizeof(uint32_t) * submesh.indexCount);
+                        }
+                    }
+                }
+                if (!mesh.clusters.empty())
+                {
+                    orbit::MeshChunkHeader chunk;
+                    chunk.type = orbit::MeshChunkType::CHUNK_CLUSTER;
+                    chunk.size = sizeof(uint32_t) + mesh.clusters.size() * sizeof(orbit::MeshCluster);
+                    output.write((const char*)&chunk, sizeof(orbit::MeshChunkHeader));
+
+                    uint32_t numClusters = mesh.clusters.size();
+                    output.write((const char*)&numClusters, sizeof(uint32_t));
+                    output.write((const char*)mesh.clusters.data(), sizeof(orbit::MeshCluster) * numClusters);
+                }
+                if (!mesh.skin.weights.empty())
+                {
+                    orbit::MeshChunkHeader chunk;
+                    chunk.type = orbit::MeshChunkType::CHUNK_SKIN;
+                    chunk.size = sizeof(int64_t) + sizeof(uint32_t) + mesh.skin.weights.size() * sizeof(orbit::SkinWeights);
+                    output.write((const char*)&chunk, sizeof(orbit::MeshChunkHeader));
+
+                    int64_t skeletonIdOffset = orb.GetOffsetFromName(mesh.skin.skeleton, i);
+                    uint32_t numWeights = mesh.skin.weights.size();
+                    output.write((const char*)&skeletonIdOffset, sizeof(int64_t));
+                    output.write((const char*)&numWeights, sizeof(uint32_t));
+                    output.write((const char*)mesh.skin.weights.data(), sizeof(orbit::SkinWeights) * numWeights);
+                }
+            }
+                break;
+            case ResourceType::SKELETON: {
+                const auto& skeleton = orb.GetObject<OrbSkeleton>(i);
+                uint32_t numJoints = skeleton.joints.size();
+                output.write((const char*)&numJoints, sizeof(uint32_t));
+                for (const auto& joint : skeleton.joints)
+                {
+                    uint32_t jointNameLen = joint.name.length();
+                    output.write((const char*)&jointNameLen, sizeof(uint32_t));
+                    output.write(joint.name.data(), jointNameLen);
+                    output.write((const char*)&joint.parent, sizeof(int32_t));
+                    output.write((const char*)&joint.bindPose, sizeof(orbit::JointPose));
+                    output.write((const char*)joint.inverseBindPose.data(), sizeof(float) * 16);
+                }
+            }
+                break;
+            case ResourceType::ANIMATION_CLIP: {
+                const auto& clip = orb.GetObject<OrbAnimationClip>(i);
+                if (!clip.IsCompressed())
+                    ORBIT_THROW("Animation clip '%s' has to be compressed before it is written", name.c_str());
+                int64_t skeletonIdOffset = orb.GetOffsetFromName(clip.skeleton, i);
+                uint32_t numTracks = clip.tracks.size();
+                output.write((const char*)&skeletonIdOffset, sizeof(int64_t));
+                output.write((const char*)&clip.sampleRate, sizeof(float));
+                output.write((const char*)&clip.numFrames, sizeof(uint32_t));
+                output.write((const char*)&numTracks, sizeof(uint32_t));
+                output.write((const char*)clip.tracks.data(), sizeof(orbit::AnimationTrackHeader) * numTracks);
+                output.write((const char*)clip.rotationFrames.data(), sizeof(uint16_t) * clip.rotationFrames.size());
+                output.write((const char*)clip.rotations.data(), sizeof(orbit::QuantizedQuaternion) * clip.rotations.size());
+                output.write((const char*)clip.translationFrames.data(), sizeof(uint16_t) * clip.translationFrames.size());
+                output.write((const char*)clip.translations.data(), sizeof(Vector3f) * clip.translations.size());
+                output.write((const char*)clip.scaleFrames.data(), sizeof(uint16_t) * clip.scaleFrames.size());
+                output.write((const char*)clip.scales.data(), sizeof(Vector3f) * clip.scales.size());
+            }
+                break;
+            case ResourceType::SPLINE: {
+                const auto& spline = orb.GetObject<OrbSpline>(i);
+                if (!spline.IsBaked())
+                    ORBIT_THROW("Spline '%s' has to be baked before it is written", name.c_str());
+                uint32_t flags = spline.closed ? orbit::SPLINE_CLOSED : orbit::SPLINE_NONE;
+                uint32_t numSegments = spline.NumSegments();
+                uint32_t numSamples = spline.samples.size() - 1u;
+                output.write((const char*)&flags, sizeof(uint32_t));
+                output.write((const char*)&numSegments, sizeof(uint32_t));
+                output.write((const char*)&numSamples, sizeof(uint32_t));
+                output.write((const char*)&spline.length, sizeof(float));
+                output.write((const char*)spline.controlPoints.data(), sizeof(Vector3f) * spline.controlPoints.size());
+                output.write((const char*)spline.samples.data(), sizeof(float) * spline.samples.size());
+            }
+                break;
+            case ResourceType::COLLISION_MESH: {
+                const auto& collisionMesh = orb.GetObject<OrbCollisionMesh>(i);
+                if (!collisionMesh.IsCooked())
+                    ORBIT_THROW("Collision mesh '%s' has to be cooked before it is written", name.c_str());
+                uint32_t numParts = collisionMesh.cookedParts.size();
+                output.write((const char*)&collisionMesh.shape, sizeof(CollisionShape));
+                output.write((const char*)&collisionMesh.physxVersion, sizeof(uint32_t));
+                output.write((const char*)&numParts, sizeof(uint32_t));
+                for (const auto& part : collisionMesh.cookedParts)
+                {
+                    uint64_t dataSize = part.size();
+                    output.write((const char*)&dataSize, sizeof(uint64_t));
+                    output.write((const char*)part.data(), dataSize);
+                }
             }
                 break;
             case ResourceType::INPUT_LAYOUT: {
@@ -656,6 +932,15 @@ namespace orbtool
                 break;
             }
             case ResourceType::TEXTURE: {
+                const auto& dds = orb.GetObject<OrbTexture>(i).ddsData;
+                if (!dds.empty())
+                {
+                    uint64_t ddsLen = dds.size();
+                    output.write((const char*)&ddsLen, sizeof(uint64_t));
+                    output.write((const char*)dds.data(), ddsLen);
+                    break;
+                }
+
                 std::ifstream file(orb.GetObject<OrbTexture>(i).texturePath, std::ios::binary | std::ios::in);
                 if (!file.is_open())
                     ORBIT_THROW("Cannot open file '%s'", orb.GetObject<OrbTexture>(i).texturePath.generic_string().c_str());
@@ -714,6 +999,35 @@ namespace orbtool
             output.seekg(0, std::ios::end);
             ++id;
         }
+
+        if (numPaddingRecords > 0u)
+        {
+            numObjects += numPaddingRecords;
+            output.seekp(sizeof(orbit::Version), std::ios::beg);
+            output.write((const char*)&numObjects, sizeof(uint32_t));
+            ORBIT_LOG("Laid out %u objects (%zu in load order), %u padding records", objectsToBeWritten, m_loadOrder.size(), numPaddingRecords);
+        }
+    }
+
+    bool OrbFile::WritePadding(std::ostream* output, size_t headerSize) const
+    {
+        static constexpr size_t paddingHeaderSize = sizeof(ResourceId) + sizeof(ResourceType) + sizeof(uint32_t) * 2;
+        const auto position = static_cast<size_t>(output->tellp());
+        if ((position + headerSize) % m_payloadAlignment == 0u)
+            return false;
+
+        // The padding record itself has a header, which has to be accounted for as well
+        const uint32_t paddingSize = static_cast<uint32_t>((m_payloadAlignment - (position + paddingHeaderSize + headerSize) % m_payloadAlignment) % m_payloadAlignment);
+        const ResourceId id = 0u;
+        const ResourceType type = ResourceType::PADDING;
+        const uint32_t nameLen = 0u;
+        output->write((const char*)&id, sizeof(ResourceId));
+        output->write((const char*)&type, sizeof(ResourceType));
+        output->write((const char*)&paddingSize, sizeof(uint32_t));
+        output->write((const char*)&nameLen, sizeof(uint32_t));
+        const std::vector<char> zeros(paddingSize, 0);
+        output->write(zeros.data(), paddingSize);
+        return true;
     }
 
     uint64_t OrbFile::NextIndex() const
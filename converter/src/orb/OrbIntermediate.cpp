@@ -1,6 +1,7 @@
 #include "orb/OrbIntermediate.hpp"
 #include "orb/OrbFile.hpp"
 
+#include <algorithm>
 #include <limits>
 
 namespace orbtool
@@ -24,6 +25,10 @@ namespace orbtool
 		case 7: return ResourceType::RASTERIZER_STATE;
 		case 8: return ResourceType::BLEND_STATE;
 		case 9: return ResourceType::SAMPLER_STATE;
+		case 10: return ResourceType::SKELETON;
+		case 11: return ResourceType::ANIMATION_CLIP;
+		case 12: return ResourceType::SPLINE;
+		case 13: return ResourceType::COLLISION_MESH;
 		}
 
 		return (ResourceType)std::numeric_limits<uint32_t>::max();
@@ -38,6 +43,25 @@ namespace orbtool
 		return it->second - static_cast<int64_t>(offsetId);
 	}
 
+	int64_t OrbIntermediate::FindObject(const std::string& name) const
+	{
+		auto it = m_objectIndices.find(name);
+		if (it == m_objectIndices.end())
+			return -1;
+		return it->second;
+	}
+
+	void OrbIntermediate::Append(OrbIntermediate&& other)
+	{
+		for (auto& object : other.m_objects)
+		{
+			m_objects.emplace_back(std::move(object));
+			m_objectIndices.emplace(m_objects.back().name, static_cast<uint32_t>(m_objects.size() - 1));
+		}
+		other.m_objects.clear();
+		other.m_objectIndices.clear();
+	}
+
 	void OrbIntermediate::MakeUnique() const
 	{
 		std::set<OrbObject> s(m_objects.begin(), m_objects.end());
@@ -48,4 +72,34 @@ namespace orbtool
 			m_objectIndices.emplace(object.name, idx++);
 	}
 
-}
\ No newline at end of file
+	void OrbIntermediate::OrderBy(const std::vector<std::string>& names) const
+	{
+		std::unordered_map<std::string, uint32_t> ranks;
+		for (const auto& name : names)
+			ranks.emplace(name, static_cast<uint32_t>(ranks.size()));
+
+		std::vector<std::pair<uint32_t, uint32_t>> order(m_objects.size());
+		for (auto i = 0u; i < m_objects.size(); ++i)
+		{
+			auto it = ranks.find(m_objects[i].name);
+			order[i] = { it != ranks.end() ? it->second : std::numeric_limits<uint32_t>::max(), i };
+		}
+		// Untraced objects share the last rank and follow in name order
+		std::sort(order.begin(), order.end(), [&](const auto& a, const auto& b) {
+			if (a.first != b.first)
+				return a.first < b.first;
+			return m_objects[a.second].name < m_objects[b.second].name;
+		});
+
+		std::vector<OrbObject> objects;
+		objects.reserve(m_objects.size());
+		m_objectIndices.clear();
+		for (const auto& [rank, index] : order)
+		{
+			m_objectIndices.emplace(m_objects[index].name, static_cast<uint32_t>(objects.size()));
+			objects.emplace_back(std::move(m_objects[index]));
+		}
+		m_objects = std::move(objects);
+	}
+
+}
@@ -0,0 +1,218 @@
+#include "physics/CollisionCooker.hpp"
+#include "physics/ConvexDecomposer.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#ifdef ORBTOOL_PHYSX
+#include <PxPhysicsVersion.h>
+#include <PxFoundation.h>
+#include <common/PxTolerancesScale.h>
+#include <cooking/PxCooking.h>
+#include <extensions/PxDefaultAllocator.h>
+#include <extensions/PxDefaultErrorCallback.h>
+#include <extensions/PxDefaultStreams.h>
+#endif
+
+namespace orbtool
+{
+
+#ifdef ORBTOOL_PHYSX
+    // @brief: the PhysX objects cooking needs, created on first use
+    class CookingContext
+    {
+    private:
+        physx::PxDefaultAllocator m_allocator;
+        physx::PxDefaultErrorCallback m_errorCallback;
+        physx::PxFoundation* m_foundation = nullptr;
+        physx::PxCooking* m_cooking = nullptr;
+    public:
+        CookingContext()
+        {
+            m_foundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_allocator, m_errorCallback);
+            if (!m_foundation)
+                return;
+
+            // Has to match the tolerances the engine creates its PxPhysics with
+            physx::PxTolerancesScale scale;
+            scale.length = 1.f;
+            scale.speed = 1.f;
+            m_cooking = PxCreateCooking(PX_PHYSICS_VERSION, *m_foundation, physx::PxCookingParams(scale));
+        }
+        ~CookingContext()
+        {
+            if (m_cooking)
+                m_cooking->release();
+            if (m_foundation)
+                m_foundation->release();
+        }
+
+        physx::PxCooking* GetCooking() const { return m_cooking; }
+
+        static CookingContext& Get()
+        {
+            static CookingContext context;
+            return context;
+        }
+    };
+
+    // @method: cooks the convex hull of the points
+    // @param vertexLimit: the hull is simplified to at most this many vertices
+    // @return: the cooked stream, empty if cooking failed
+    static std::vector<uint8_t> CookConvexMesh(physx::PxCooking* cooking, const std::vector<Vector3f>& points, uint32_t vertexLimit, const char* name)
+    {
+        using namespace physx;
+
+        // The hull only needs the points, it is computed by the cooking library
+        PxConvexMeshDesc desc;
+        desc.points.count = static_cast<PxU32>(points.size());
+        desc.points.stride = sizeof(Vector3f);
+        desc.points.data = points.data();
+        desc.flags = PxConvexFlag::eCOMPUTE_CONVEX | PxConvexFlag::eSHIFT_VERTICES;
+        desc.vertexLimit = static_cast<PxU16>(vertexLimit);
+
+        PxDefaultMemoryOutputStream output;
+        PxConvexMeshCookingResult::Enum result;
+        if (!cooking->cookConvexMesh(desc, output, &result) || result == PxConvexMeshCookingResult::eFAILURE)
+        {
+            ORBIT_ERROR("Failed to cook the convex hull of '%s'", name);
+            return {};
+        }
+        if (result == PxConvexMeshCookingResult::ePOLYGONS_LIMIT_REACHED)
+            ORBIT_LOG("The convex hull of '%s' was simplified to the polygon limit", name);
+        return std::vector<uint8_t>(output.getData(), output.getData() + output.getSize());
+    }
+#endif
+
+    void CollisionCooker::CollectTriangles(const OrbMesh& mesh, std::vector<Vector3f>* positions, std::vector<uint32_t>* indices)
+    {
+        // Vertices are split by normals and texture coordinates, the collision
+        // geometry only needs one per position
+        struct PositionHash
+        {
+            size_t operator()(const Vector3f& position) const
+            {
+                uint32_t bits[3];
+                std::memcpy(bits, position.data(), sizeof(bits));
+                return (static_cast<size_t>(bits[0]) * 73856093u) ^ (static_cast<size_t>(bits[1]) * 19349663u) ^ (static_cast<size_t>(bits[2]) * 83492791u);
+            }
+        };
+        std::unordered_map<Vector3f, uint32_t, PositionHash> welded;
+        std::vector<uint32_t> remap(mesh.vertices.size());
+        for (auto i = 0u; i < mesh.vertices.size(); ++i)
+        {
+            const auto& position = mesh.vertices[i].position;
+            auto [it, inserted] = welded.emplace(position, static_cast<uint32_t>(positions->size()));
+            if (inserted)
+                positions->push_back(position);
+            remap[i] = it->second;
+        }
+
+        // Indices are relative to the first vertex of their submesh
+        for (const auto& submesh : mesh.submeshes)
+        {
+            const auto count = mesh.indices.empty() ? submesh.vertexCount : submesh.indexCount;
+            for (auto i = 0u; i + 2u < count; i += 3u)
+            {
+                uint32_t triangle[3];
+                for (auto corner = 0u; corner < 3u; ++corner)
+                {
+                    const auto index = mesh.indices.empty() ? i + corner : mesh.indices[submesh.startIndex + i + corner];
+                    triangle[corner] = remap[submesh.startVertex + index];
+                }
+                // Welding can collapse triangles
+                if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[2] != triangle[0])
+                    indices->insert(indices->end(), triangle, triangle + 3);
+            }
+        }
+    }
+
+    bool CollisionCooker::Cook(const OrbMesh& mesh, OrbCollisionMesh* collisionMesh)
+    {
+        if (collisionMesh->IsCooked())
+            return true;
+
+#ifdef ORBTOOL_PHYSX
+        using namespace physx;
+
+        auto cooking = CookingContext::Get().GetCooking();
+        if (!cooking)
+        {
+            ORBIT_ERROR("Failed to initialize the PhysX cooking library");
+            return false;
+        }
+
+        std::vector<Vector3f> positions;
+        std::vector<uint32_t> indices;
+        CollectTriangles(mesh, &positions, &indices);
+        if (indices.empty())
+        {
+            ORBIT_ERROR("The mesh '%s' has no triangles to cook", collisionMesh->mesh.c_str());
+            return false;
+        }
+
+        const auto name = collisionMesh->mesh.c_str();
+        std::vector<std::vector<uint8_t>> parts;
+        if (collisionMesh->shape == CollisionShape::TRIANGLE_MESH)
+        {
+            PxTriangleMeshDesc desc;
+            desc.points.count = static_cast<PxU32>(positions.size());
+            desc.points.stride = sizeof(Vector3f);
+            desc.points.data = positions.data();
+            desc.triangles.count = static_cast<PxU32>(indices.size() / 3u);
+            desc.triangles.stride = 3u * sizeof(uint32_t);
+            desc.triangles.data = indices.data();
+
+            PxDefaultMemoryOutputStream output;
+            PxTriangleMeshCookingResult::Enum result;
+            if (!cooking->cookTriangleMesh(desc, output, &result) || result == PxTriangleMeshCookingResult::eFAILURE)
+            {
+                ORBIT_ERROR("Failed to cook the triangle mesh of '%s'", name);
+                return false;
+            }
+            if (result == PxTriangleMeshCookingResult::eLARGE_TRIANGLE)
+                ORBIT_LOG("The collision mesh of '%s' has large triangles, consider tessellating it", name);
+            parts.emplace_back(output.getData(), output.getData() + output.getSize());
+        }
+        else if (collisionMesh->shape == CollisionShape::CONVEX_MESH)
+        {
+            parts.push_back(CookConvexMesh(cooking, positions, collisionMesh->maxHullVertices, name));
+        }
+        else
+        {
+            ConvexDecomposer::Settings settings;
+            settings.maxHulls = collisionMesh->maxHulls;
+            settings.resolution = collisionMesh->resolution;
+            settings.maxConcavity = collisionMesh->maxConcavity;
+            const auto hulls = ConvexDecomposer::Decompose(positions, indices, settings);
+            if (hulls.empty())
+            {
+                ORBIT_ERROR("The decomposition of '%s' is empty, the mesh has to be closed", name);
+                return false;
+            }
+            for (const auto& hull : hulls)
+                parts.push_back(CookConvexMesh(cooking, hull, collisionMesh->maxHullVertices, name));
+        }
+        if (std::any_of(parts.begin(), parts.end(), [](const std::vector<uint8_t>& part) { return part.empty(); }))
+            return false;
+
+        size_t cookedSize = 0u;
+        for (const auto& part : parts)
+            cookedSize += part.size();
+        collisionMesh->cookedParts = std::move(parts);
+        collisionMesh->physxVersion = PX_PHYSICS_VERSION;
+        const char* shapeNames[] = { "triangle mesh", "convex hull", "convex decomposition" };
+        ORBIT_LOG("Cooked %s of '%s' from %zu positions and %zu triangles (%zu parts, %zu bytes)",
+            shapeNames[static_cast<uint32_t>(collisionMesh->shape)], name, positions.size(), indices.size() / 3u,
+            collisionMesh->cookedParts.size(), cookedSize);
+        return true;
+#else
+        (void)mesh;
+        ORBIT_ERROR("orbtool was built without PhysX (PHYSX_ROOT_PATH), the collision mesh of '%s' can't be cooked", collisionMesh->mesh.c_str());
+        return false;
+#endif
+    }
+
+}
@@ -0,0 +1,695 @@
+#include "physics/ConvexDecomposer.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace orbtool
+{
+
+    // @brief: number of split planes tried per axis
+    static constexpr int sCandidatesPerAxis = 8;
+    // @brief: number of split planes per axis tried when looking ahead
+    static constexpr int sLookaheadPerAxis = 2;
+    // @brief: the hull of a part is built from points this far from the voxel
+    //  centers (in voxels), so parts one voxel thin still have a volume
+    static constexpr double sHullPointOffset = 0.1;
+
+    // @brief: half open range of voxels [lo, hi)
+    struct VoxelBox
+    {
+        std::array<int, 3> lo;
+        std::array<int, 3> hi;
+
+        int Extent(int axis) const { return hi[axis] - lo[axis]; }
+    };
+
+    struct VoxelPart
+    {
+        VoxelBox box;
+        uint64_t count = 0u;
+        double concavity = 0.0;
+    };
+
+    // @brief: the solid voxels of the mesh. Voxels on the surface and the ones
+    //  not reachable from the outside are solid
+    class VoxelGrid
+    {
+    private:
+        std::array<int, 3> m_dims;
+        Vector3d m_origin;
+        double m_size;
+        std::vector<uint8_t> m_solid;
+        // @member: summed volume table of m_solid, (dims + 1)^3 entries
+        std::vector<uint32_t> m_sums;
+
+        size_t Index(int x, int y, int z) const { return (static_cast<size_t>(z) * m_dims[1] + y) * m_dims[0] + x; }
+        size_t SumIndex(int x, int y, int z) const { return (static_cast<size_t>(z) * (m_dims[1] + 1) + y) * (m_dims[0] + 1) + x; }
+    public:
+        VoxelGrid(const std::vector<Vector3f>& positions, const std::vector<uint32_t>& indices, uint32_t resolution)
+        {
+            AlignedBox3d bounds;
+            for (const auto& position : positions)
+                bounds.extend(position.cast<double>());
+            m_size = std::max(bounds.sizes().maxCoeff(), 1e-6) / resolution;
+            // One empty voxel on every side so the exterior is connected
+            m_origin = bounds.min() - Vector3d::Constant(m_size);
+            for (auto axis = 0; axis < 3; ++axis)
+                m_dims[axis] = static_cast<int>(std::ceil(bounds.sizes()[axis] / m_size)) + 2;
+
+            const auto numVoxels = static_cast<size_t>(m_dims[0]) * m_dims[1] * m_dims[2];
+            m_solid.assign(numVoxels, 0u);
+
+            // Points on the triangles no more than half a voxel apart
+            for (auto i = 0u; i + 2u < indices.size(); i += 3u)
+            {
+                const Vector3d a = positions[indices[i]].cast<double>();
+                const Vector3d b = positions[indices[i + 1]].cast<double>();
+                const Vector3d c = positions[indices[i + 2]].cast<double>();
+                const auto longest = std::max({ (b - a).norm(), (c - b).norm(), (a - c).norm() });
+                const auto steps = std::max(1, static_cast<int>(std::ceil(2.0 * longest / m_size)));
+                for (auto u = 0; u <= steps; ++u)
+                {
+                    for (auto v = 0; u + v <= steps; ++v)
+                    {
+                        const Vector3d point = a + (b - a) * (double(u) / steps) + (c - a) * (double(v) / steps);
+                        const auto voxel = VoxelOf(point);
+                        m_solid[Index(voxel[0], voxel[1], voxel[2])] = 1u;
+                    }
+                }
+            }
+
+            // Flood fill the exterior, everything else is solid
+            std::vector<uint8_t> exterior(numVoxels, 0u);
+            std::vector<std::array<int, 3>> stack = { { 0, 0, 0 } };
+            exterior[0] = 1u;
+            while (!stack.empty())
+            {
+                const auto voxel = stack.back();
+                stack.pop_back();
+                for (auto axis = 0; axis < 3; ++axis)
+                {
+                    for (auto step : { -1, 1 })
+                    {
+                        auto next = voxel;
+                        next[axis] += step;
+                        if (next[axis] < 0 || next[axis] >= m_dims[axis])
+                            continue;
+                        const auto index = Index(next[0], next[1], next[2]);
+                        if (m_solid[index] || exterior[index])
+                            continue;
+                        exterior[index] = 1u;
+                        stack.push_back(next);
+                    }
+                }
+            }
+            for (auto i = 0u; i < numVoxels; ++i)
+                m_solid[i] = !exterior[i];
+
+            m_sums.assign(static_cast<size_t>(m_dims[0] + 1) * (m_dims[1] + 1) * (m_dims[2] + 1), 0u);
+            for (auto z = 0; z < m_dims[2]; ++z)
+            {
+                for (auto y = 0; y < m_dims[1]; ++y)
+                {
+                    for (auto x = 0; x < m_dims[0]; ++x)
+                    {
+                        m_sums[SumIndex(x + 1, y + 1, z + 1)] = m_solid[Index(x, y, z)]
+                            + m_sums[SumIndex(x, y + 1, z + 1)] + m_sums[SumIndex(x + 1, y, z + 1)] + m_sums[SumIndex(x + 1, y + 1, z)]
+                            - m_sums[SumIndex(x, y, z + 1)] - m_sums[SumIndex(x, y + 1, z)] - m_sums[SumIndex(x + 1, y, z)]
+                            + m_sums[SumIndex(x, y, z)];
+                    }
+                }
+            }
+        }
+
+        std::array<int, 3> VoxelOf(const Vector3d& point) const
+        {
+            std::array<int, 3> voxel;
+            for (auto axis = 0; axis < 3; ++axis)
+                voxel[axis] = std::clamp(static_cast<int>((point[axis] - m_origin[axis]) / m_size), 0, m_dims[axis] - 1);
+            return voxel;
+        }
+
+        bool IsSolid(int x, int y, int z) const { return m_solid[Index(x, y, z)] != 0u; }
+
+        // @method: number of solid voxels in the box
+        uint64_t Count(const VoxelBox& box) const
+        {
+            const auto& l = box.lo;
+            const auto& h = box.hi;
+            return static_cast<int64_t>(m_sums[SumIndex(h[0], h[1], h[2])])
+                - m_sums[SumIndex(l[0], h[1], h[2])] - m_sums[SumIndex(h[0], l[1], h[2])] - m_sums[SumIndex(h[0], h[1], l[2])]
+                + m_sums[SumIndex(l[0], l[1], h[2])] + m_sums[SumIndex(l[0], h[1], l[2])] + m_sums[SumIndex(h[0], l[1], l[2])]
+                - m_sums[SumIndex(l[0], l[1], l[2])];
+        }
+
+        // @method: shrinks the box to the solid voxels inside of it
+        VoxelBox Tighten(VoxelBox box) const
+        {
+            for (auto axis = 0; axis < 3; ++axis)
+            {
+                auto slab = box;
+                while (box.lo[axis] < box.hi[axis])
+                {
+                    slab.lo[axis] = box.lo[axis];
+                    slab.hi[axis] = box.lo[axis] + 1;
+                    if (Count(slab) > 0u)
+                        break;
+                    ++box.lo[axis];
+                }
+                while (box.hi[axis] > box.lo[axis])
+                {
+                    slab.lo[axis] = box.hi[axis] - 1;
+                    slab.hi[axis] = box.hi[axis];
+                    if (Count(slab) > 0u)
+                        break;
+                    --box.hi[axis];
+                }
+            }
+            return box;
+        }
+
+        // @method: the points the hull of the solid voxels in the box is built from.
+        //  A voxel with solid voxels on both sides along any axis can't contribute
+        //  a hull vertex, so only the first and last voxel of every line are used
+        std::vector<Vector3d> HullPoints(const VoxelBox& box, double offset) const
+        {
+            const auto dx = box.Extent(0), dy = box.Extent(1), dz = box.Extent(2);
+            std::vector<int> xMin(dy * dz, std::numeric_limits<int>::max()), xMax(dy * dz, -1);
+            std::vector<int> yMin(dx * dz, std::numeric_limits<int>::max()), yMax(dx * dz, -1);
+            std::vector<int> zMin(dx * dy, std::numeric_limits<int>::max()), zMax(dx * dy, -1);
+            for (auto z = 0; z < dz; ++z)
+            {
+                for (auto y = 0; y < dy; ++y)
+                {
+                    for (auto x = 0; x < dx; ++x)
+                    {
+                        if (!IsSolid(box.lo[0] + x, box.lo[1] + y, box.lo[2] + z))
+                            continue;
+                        xMin[y * dz + z] = std::min(xMin[y * dz + z], x);
+                        xMax[y * dz + z] = std::max(xMax[y * dz + z], x);
+                        yMin[x * dz + z] = std::min(yMin[x * dz + z], y);
+                        yMax[x * dz + z] = std::max(yMax[x * dz + z], y);
+                        zMin[x * dy + y] = std::min(zMin[x * dy + y], z);
+                        zMax[x * dy + y] = std::max(zMax[x * dy + y], z);
+                    }
+                }
+            }
+
+            std::vector<Vector3d> points;
+            std::unordered_set<uint64_t> emitted;
+            auto emit = [&](int x, int y, int z) {
+                const auto isExtreme = [](int value, int min, int max) { return value == min || value == max; };
+                if (!isExtreme(y, yMin[x * dz + z], yMax[x * dz + z]) || !isExtreme(z, zMin[x * dy + y], zMax[x * dy + y]))
+                    return;
+                const auto key = (static_cast<uint64_t>(x) << 42u) | (static_cast<uint64_t>(y) << 21u) | static_cast<uint64_t>(z);
+                if (!emitted.insert(key).second)
+                    return;
+                const Vector3d center(box.lo[0] + x + 0.5, box.lo[1] + y + 0.5, box.lo[2] + z + 0.5);
+                for (auto corner = 0u; corner < 8u; ++corner)
+                {
+                    points.emplace_back(center.x() + (corner & 1u ? offset : -offset),
+                        center.y() + (corner & 2u ? offset : -offset),
+                        center.z() + (corner & 4u ? offset : -offset));
+                }
+            };
+            for (auto z = 0; z < dz; ++z)
+            {
+                for (auto y = 0; y < dy; ++y)
+                {
+                    if (xMax[y * dz + z] < 0)
+                        continue;
+                    emit(xMin[y * dz + z], y, z);
+                    emit(xMax[y * dz + z], y, z);
+                }
+            }
+            return points;
+        }
+
+        // @method: the box in mesh space
+        AlignedBox3d ToMesh(const VoxelBox& box) const
+        {
+            const Vector3d lo(box.lo[0], box.lo[1], box.lo[2]);
+            const Vector3d hi(box.hi[0], box.hi[1], box.hi[2]);
+            return AlignedBox3d(m_origin + lo * m_size, m_origin + hi * m_size);
+        }
+
+        double VoxelSize() const { return m_size; }
+        const Vector3d& Origin() const { return m_origin; }
+        VoxelBox Bounds() const { return { { 0, 0, 0 }, m_dims }; }
+    };
+
+    double ConvexDecomposer::ConvexHull(const std::vector<Vector3d>& points, std::vector<uint32_t>* triangles)
+    {
+        if (points.size() < 4u)
+            return 0.0;
+
+        AlignedBox3d bounds;
+        for (const auto& point : points)
+            bounds.extend(point);
+        const auto epsilon = std::max(bounds.diagonal().norm(), 1e-30) * 1e-10;
+
+        // Initial tetrahedron: the widest pair of extreme points, the point farthest
+        // from their line and the point farthest from the plane of those three
+        std::array<uint32_t, 4> simplex = { 0u, 0u, 0u, 0u };
+        auto widest = -1.0;
+        for (auto axis = 0; axis < 3; ++axis)
+        {
+            uint32_t min = 0u, max = 0u;
+            for (auto i = 1u; i < points.size(); ++i)
+            {
+                if (points[i][axis] < points[min][axis])
+                    min = i;
+                if (points[i][axis] > points[max][axis])
+                    max = i;
+            }
+            const auto distance = (points[max] - points[min]).squaredNorm();
+            if (distance > widest)
+            {
+                widest = distance;
+                simplex[0] = min;
+                simplex[1] = max;
+            }
+        }
+        const Vector3d axis = (points[simplex[1]] - points[simplex[0]]).normalized();
+        auto farthest = 0.0;
+        for (auto i = 0u; i < points.size(); ++i)
+        {
+            const auto distance = (points[i] - points[simplex[0]]).cross(axis).norm();
+            if (distance > farthest)
+            {
+                farthest = distance;
+                simplex[2] = i;
+            }
+        }
+        if (farthest <= epsilon)
+            return 0.0;
+        const Vector3d normal = (points[simplex[1]] - points[simplex[0]]).cross(points[simplex[2]] - points[simplex[0]]).normalized();
+        farthest = 0.0;
+        for (auto i = 0u; i < points.size(); ++i)
+        {
+            const auto distance = std::abs(normal.dot(points[i] - points[simplex[0]]));
+            if (distance > farthest)
+            {
+                farthest = distance;
+                simplex[3] = i;
+            }
+        }
+        if (farthest <= epsilon)
+            return 0.0;
+
+        struct Face
+        {
+            std::array<uint32_t, 3> v;
+            Vector3d normal;
+            double offset;
+            std::vector<uint32_t> outside;
+            bool alive = true;
+
+            double Distance(const Vector3d& point) const { return normal.dot(point) - offset; }
+        };
+        std::vector<Face> faces;
+        const Vector3d interior = (points[simplex[0]] + points[simplex[1]] + points[simplex[2]] + points[simplex[3]]) * 0.25;
+        auto makeFace = [&](uint32_t a, uint32_t b, uint32_t c) {
+            Face face;
+            face.v = { a, b, c };
+            face.normal = (points[b] - points[a]).cross(points[c] - points[a]).normalized();
+            // Faces are counter clockwise seen from the outside
+            if (face.normal.dot(interior - points[a]) > 0.0)
+            {
+                std::swap(face.v[1], face.v[2]);
+                face.normal = -face.normal;
+            }
+            face.offset = face.normal.dot(points[face.v[0]]);
+            return face;
+        };
+        faces.push_back(makeFace(simplex[0], simplex[1], simplex[2]));
+        faces.push_back(makeFace(simplex[0], simplex[1], simplex[3]));
+        faces.push_back(makeFace(simplex[0], simplex[2], simplex[3]));
+        faces.push_back(makeFace(simplex[1], simplex[2], simplex[3]));
+
+        // Every point outside of the hull is assigned to one face it can see
+        auto assign = [&](uint32_t point, size_t firstFace) {
+            for (auto f = firstFace; f < faces.size(); ++f)
+            {
+                if (faces[f].alive && faces[f].Distance(points[point]) > epsilon)
+                {
+                    faces[f].outside.push_back(point);
+                    return;
+                }
+            }
+        };
+        for (auto i = 0u; i < points.size(); ++i)
+        {
+            if (std::find(simplex.begin(), simplex.end(), i) == simplex.end())
+                assign(i, 0u);
+        }
+
+        std::vector<size_t> visible;
+        std::unordered_set<uint64_t> visibleEdges;
+        std::vector<std::pair<uint32_t, uint32_t>> horizon;
+        std::vector<uint32_t> orphans;
+        auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32u) | b; };
+        auto aliveFaces = faces.size();
+        for (;;)
+        {
+            auto current = std::find_if(faces.begin(), faces.end(), [](const Face& face) { return face.alive && !face.outside.empty(); });
+            if (current == faces.end())
+                break;
+
+            // The farthest point is a vertex of the final hull
+            const auto apex = *std::max_element(current->outside.begin(), current->outside.end(), [&](uint32_t a, uint32_t b) {
+                return current->Distance(points[a]) < current->Distance(points[b]);
+            });
+
+            visible.clear();
+            visibleEdges.clear();
+            for (auto f = 0u; f < faces.size(); ++f)
+            {
+                if (!faces[f].alive || faces[f].Distance(points[apex]) <= epsilon)
+                    continue;
+                visible.push_back(f);
+                for (auto corner = 0u; corner < 3u; ++corner)
+                    visibleEdges.insert(edgeKey(faces[f].v[corner], faces[f].v[(corner + 1u) % 3u]));
+            }
+
+            // Edges of the visible region that are not shared by two visible faces
+            horizon.clear();
+            orphans.clear();
+            for (auto f : visible)
+            {
+                auto& face = faces[f];
+                for (auto corner = 0u; corner < 3u; ++corner)
+                {
+                    const auto a = face.v[corner], b = face.v[(corner + 1u) % 3u];
+                    if (!visibleEdges.count(edgeKey(b, a)))
+                        horizon.emplace_back(a, b);
+                }
+                for (auto point : face.outside)
+                {
+                    if (point != apex)
+                        orphans.push_back(point);
+                }
+                face.outside.clear();
+                face.alive = false;
+            }
+
+            const auto firstNew = faces.size();
+            for (const auto& [a, b] : horizon)
+            {
+                Face face;
+                face.v = { a, b, apex };
+                face.normal = (points[b] - points[a]).cross(points[apex] - points[a]).normalized();
+                face.offset = face.normal.dot(points[a]);
+                faces.push_back(std::move(face));
+            }
+            for (auto point : orphans)
+                assign(point, firstNew);
+
+            aliveFaces += horizon.size() - visible.size();
+            if (faces.size() > 2u * aliveFaces + 64u)
+                faces.erase(std::remove_if(faces.begin(), faces.end(), [](const Face& face) { return !face.alive; }), faces.end());
+        }
+
+        auto volume = 0.0;
+        for (const auto& face : faces)
+        {
+            if (!face.alive)
+                continue;
+            const Vector3d a = points[face.v[0]] - interior;
+            const Vector3d b = points[face.v[1]] - interior;
+            const Vector3d c = points[face.v[2]] - interior;
+            volume += a.dot(b.cross(c)) / 6.0;
+            if (triangles)
+                triangles->insert(triangles->end(), face.v.begin(), face.v.end());
+        }
+        return std::max(volume, 0.0);
+    }
+
+    // @method: clips a convex polygon against the box (Sutherland-Hodgman)
+    static void ClipPolygon(std::vector<Vector3d>* polygon, const AlignedBox3d& box)
+    {
+        std::vector<Vector3d> clipped;
+        for (auto plane = 0u; plane < 6u && !polygon->empty(); ++plane)
+        {
+            const auto axis = plane % 3u;
+            const auto isMax = plane >= 3u;
+            const auto limit = isMax ? box.max()[axis] : box.min()[axis];
+            auto inside = [&](const Vector3d& point) { return isMax ? point[axis] <= limit : point[axis] >= limit; };
+
+            clipped.clear();
+            for (auto i = 0u; i < polygon->size(); ++i)
+            {
+                const auto& from = (*polygon)[i];
+                const auto& to = (*polygon)[(i + 1u) % polygon->size()];
+                if (inside(from))
+                    clipped.push_back(from);
+                if (inside(from) != inside(to))
+                {
+                    const auto t = (limit - from[axis]) / (to[axis] - from[axis]);
+                    clipped.push_back(from + (to - from) * t);
+                }
+            }
+            std::swap(*polygon, clipped);
+        }
+    }
+
+    // @method: counts the voxel centers of the box inside a convex hull. Every
+    //  slice of voxels is intersected with the hull, which leaves a convex
+    //  polygon, and every row of the slice with that polygon
+    // @param points, triangles: the hull in voxel coordinates, @see ConvexDecomposer::ConvexHull
+    static uint64_t CountInside(const VoxelBox& box, const std::vector<Vector3d>& points, const std::vector<uint32_t>& triangles)
+    {
+        constexpr double epsilon = 1e-7;
+        uint64_t count = 0u;
+        std::vector<Vector2d> section;
+        std::vector<Vector2d> polygon;
+        for (auto z = box.lo[2]; z < box.hi[2]; ++z)
+        {
+            const auto height = z + 0.5;
+            section.clear();
+            for (auto i = 0u; i < triangles.size(); ++i)
+            {
+                const auto& a = points[triangles[i]];
+                const auto& b = points[triangles[i % 3u == 2u ? i - 2u : i + 1u]];
+                const auto da = a.z() - height, db = b.z() - height;
+                if (std::abs(da) <= epsilon)
+                    section.emplace_back(a.x(), a.y());
+                else if ((da < -epsilon && db > epsilon) || (da > epsilon && db < -epsilon))
+                {
+                    const Vector3d point = a + (b - a) * (da / (da - db));
+                    section.emplace_back(point.x(), point.y());
+                }
+            }
+            if (section.empty())
+                continue;
+
+            // Andrew's monotone chain, the polygon is closed
+            std::sort(section.begin(), section.end(), [](const Vector2d& a, const Vector2d& b) {
+                return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+            });
+            auto cross = [](const Vector2d& o, const Vector2d& a, const Vector2d& b) {
+                return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+            };
+            polygon.assign(2u * section.size(), Vector2d::Zero());
+            size_t size = 0u;
+            for (size_t i = 0u; i < section.size(); ++i)
+            {
+                while (size >= 2u && cross(polygon[size - 2u], polygon[size - 1u], section[i]) <= 0.0)
+                    --size;
+                polygon[size++] = section[i];
+            }
+            for (size_t i = section.size() - 1u, lower = size + 1u; i-- > 0u;)
+            {
+                while (size >= lower && cross(polygon[size - 2u], polygon[size - 1u], section[i]) <= 0.0)
+                    --size;
+                polygon[size++] = section[i];
+            }
+            polygon.resize(std::max<size_t>(size - 1u, 1u));
+
+            for (auto y = box.lo[1]; y < box.hi[1]; ++y)
+            {
+                const auto row = y + 0.5;
+                auto xMin = std::numeric_limits<double>::max(), xMax = std::numeric_limits<double>::lowest();
+                for (auto i = 0u; i < polygon.size(); ++i)
+                {
+                    const auto& a = polygon[i];
+                    const auto& b = polygon[(i + 1u) % polygon.size()];
+                    if (std::abs(a.y() - row) <= epsilon)
+                    {
+                        xMin = std::min(xMin, a.x());
+                        xMax = std::max(xMax, a.x());
+                    }
+                    if ((a.y() < row - epsilon && b.y() > row + epsilon) || (a.y() > row + epsilon && b.y() < row - epsilon))
+                    {
+                        const auto x = a.x() + (b.x() - a.x()) * ((row - a.y()) / (b.y() - a.y()));
+                        xMin = std::min(xMin, x);
+                        xMax = std::max(xMax, x);
+                    }
+                }
+                // Centers at x + 0.5 in [xMin, xMax]
+                const auto first = std::max(box.lo[0], static_cast<int>(std::ceil(xMin - 0.5 - epsilon)));
+                const auto last = std::min(box.hi[0] - 1, static_cast<int>(std::floor(xMax - 0.5 + epsilon)));
+                if (first <= last)
+                    count += static_cast<uint64_t>(last - first + 1);
+            }
+        }
+        return count;
+    }
+
+    std::vector<std::vector<Vector3f>> ConvexDecomposer::Decompose(const std::vector<Vector3f>& positions,
+        const std::vector<uint32_t>& indices, const Settings& settings)
+    {
+        const VoxelGrid grid(positions, indices, std::max(settings.resolution, 8u));
+        const auto totalCount = static_cast<double>(grid.Count(grid.Bounds()));
+        if (totalCount <= 0.0)
+            return {};
+
+        auto makePart = [&](const VoxelBox& box) {
+            VoxelPart part;
+            part.box = grid.Tighten(box);
+            part.count = grid.Count(part.box);
+            const auto points = grid.HullPoints(part.box, sHullPointOffset);
+            std::vector<uint32_t> triangles;
+            if (ConvexHull(points, &triangles) > 0.0)
+            {
+                const auto missing = static_cast<double>(CountInside(part.box, points, triangles)) - static_cast<double>(part.count);
+                part.concavity = std::max(missing, 0.0) / totalCount;
+            }
+            return part;
+        };
+
+        // Planes are an axis and the first voxel above the plane
+        using Plane = std::pair<int, int>;
+        auto splitPlanes = [](const VoxelBox& box, int perAxis) {
+            std::vector<Plane> planes;
+            for (auto axis = 0; axis < 3; ++axis)
+            {
+                const auto extent = box.Extent(axis);
+                const auto count = std::min(extent - 1, perAxis);
+                for (auto i = 1; i <= count; ++i)
+                    planes.emplace_back(axis, box.lo[axis] + (extent * i) / (count + 1));
+            }
+            return planes;
+        };
+        auto splitAt = [&](const VoxelBox& box, const Plane& plane) {
+            auto lower = box, upper = box;
+            lower.hi[plane.first] = upper.lo[plane.first] = plane.second;
+            return std::make_pair(makePart(lower), makePart(upper));
+        };
+
+        // The concavity a second split of the part removes. A split is judged
+        // by the concavity left after it and the best second split. Without
+        // looking ahead a ring is cut into flat rings, which lowers the concavity
+        // more than cutting it in half, but never gets rid of the hole
+        auto secondSplitGain = [&](const VoxelPart& part) {
+            if (part.concavity <= settings.maxConcavity)
+                return 0.0;
+            auto best = part.concavity;
+            for (const auto& plane : splitPlanes(part.box, sLookaheadPerAxis))
+            {
+                const auto [lower, upper] = splitAt(part.box, plane);
+                best = std::min(best, lower.concavity + upper.concavity);
+            }
+            return part.concavity - best;
+        };
+
+        struct Split
+        {
+            Plane plane;
+            VoxelPart lower;
+            VoxelPart upper;
+            // @member: concavity left after this split and the best second split
+            double score = std::numeric_limits<double>::max();
+
+            bool operator<(const Split& other) const
+            {
+                constexpr double tolerance = 1e-6;
+                if (std::abs(score - other.score) > tolerance)
+                    return score < other.score;
+                // Prefer the split that is better on its own
+                return lower.concavity + upper.concavity < other.lower.concavity + other.upper.concavity;
+            }
+        };
+        auto bestSplit = [&](const VoxelBox& box, const std::vector<Plane>& planes) {
+            std::vector<Split> splits(planes.size());
+            ParallelFor(planes.size(), [&](size_t i) {
+                auto& split = splits[i];
+                split.plane = planes[i];
+                std::tie(split.lower, split.upper) = splitAt(box, planes[i]);
+                if (split.lower.count && split.upper.count)
+                    split.score = split.lower.concavity + split.upper.concavity - std::max(secondSplitGain(split.lower), secondSplitGain(split.upper));
+            });
+            const auto best = std::min_element(splits.begin(), splits.end());
+            return best == splits.end() ? Split() : *best;
+        };
+
+        std::vector<VoxelPart> parts = { makePart(grid.Bounds()) };
+        while (parts.size() < std::max(settings.maxHulls, 1u))
+        {
+            // Split the most concave part
+            auto part = std::max_element(parts.begin(), parts.end(), [](const VoxelPart& a, const VoxelPart& b) {
+                return a.concavity < b.concavity;
+            });
+            if (part->concavity <= settings.maxConcavity)
+                break;
+
+            // Coarse planes first, then every plane between the neighbours of the best one
+            auto best = bestSplit(part->box, splitPlanes(part->box, sCandidatesPerAxis));
+            if (best.score == std::numeric_limits<double>::max())
+            {
+                // Nothing left to split
+                part->concavity = 0.0;
+                continue;
+            }
+            const auto [axis, position] = best.plane;
+            const auto spacing = part->box.Extent(axis) / (sCandidatesPerAxis + 1) + 1;
+            std::vector<Plane> refined;
+            for (auto p = std::max(position - spacing, part->box.lo[axis]) + 1; p < std::min(position + spacing, part->box.hi[axis]); ++p)
+            {
+                if (p != position)
+                    refined.emplace_back(axis, p);
+            }
+            best = std::min(best, bestSplit(part->box, refined));
+            *part = best.lower;
+            parts.push_back(best.upper);
+        }
+
+        // The hulls are built from the triangles inside of every part, which is
+        // tighter than the voxels. The voxels are the fallback for parts without
+        // enough surface, e.g. a slab cut from the inside of the mesh
+        std::vector<std::vector<Vector3f>> hulls(parts.size());
+        ParallelFor(parts.size(), [&](size_t p) {
+            const auto box = grid.ToMesh(parts[p].box);
+            std::vector<Vector3d> points;
+            std::vector<Vector3d> polygon;
+            for (auto i = 0u; i + 2u < indices.size(); i += 3u)
+            {
+                polygon = { positions[indices[i]].cast<double>(), positions[indices[i + 1]].cast<double>(), positions[indices[i + 2]].cast<double>() };
+                ClipPolygon(&polygon, box);
+                points.insert(points.end(), polygon.begin(), polygon.end());
+            }
+
+            std::vector<uint32_t> triangles;
+            if (ConvexHull(points, &triangles) <= 0.0)
+            {
+                points = grid.HullPoints(parts[p].box, 0.5);
+                for (auto& point : points)
+                    point = grid.Origin() + point * grid.VoxelSize();
+                triangles.clear();
+                ConvexHull(points, &triangles);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+            for (auto vertex : triangles)
+                hulls[p].push_back(points[vertex].cast<float>());
+        });
+
+        hulls.erase(std::remove_if(hulls.begin(), hulls.end(), [](const std::vector<Vector3f>& hull) { return hull.size() < 4u; }), hulls.end());
+        return hulls;
+    }
+
+}
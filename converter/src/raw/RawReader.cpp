@@ -93,6 +93,17 @@ namespace orbtool
             texture.referencePath = Expect(TokenType::TOKEN_STRING).lexeme;
             Expect(TokenType::TOKEN_RPAREN);
         }
+        // Optional format used by -textures, otherwise it depends on the material slot
+        else if (MatchLiteral("NONE"))
+            texture.compression = TextureCompression::NONE;
+        else if (MatchLiteral("BC1"))
+            texture.compression = TextureCompression::BC1;
+        else if (MatchLiteral("BC3"))
+            texture.compression = TextureCompression::BC3;
+        else if (MatchLiteral("BC5"))
+            texture.compression = TextureCompression::BC5;
+        else if (MatchLiteral("BC7"))
+            texture.compression = TextureCompression::BC7;
         
         m_orb->AppendObject(name, texture);
     }   
@@ -170,6 +181,10 @@ namespace orbtool
             m_orb->AppendObject(name, Read_BlendState());
         else if (resourceType == "SAMPLER_STATE")
             m_orb->AppendObject(name, Read_SamplerState());
+        else if (resourceType == "SPLINE")
+            m_orb->AppendObject(name, Read_Spline());
+        else if (resourceType == "COLLISION_MESH")
+            m_orb->AppendObject(name, Read_CollisionMesh());
         else
         {
             Error("Expected Resource identifier got '%s'", resourceType.c_str());
@@ -558,6 +573,94 @@ namespace orbtool
         return material;
     }
 
+    OrbSpline RawReader::Read_Spline()
+    {
+        OrbSpline spline;
+        while(!Match(TokenType::TOKEN_RCURLY))
+        {
+            auto identifier = Expect(TokenType::TOKEN_LITERAL).lexeme;
+            ExpectLiteral("as");
+            if (identifier == "TYPE")
+            {
+                auto type = Expect(TokenType::TOKEN_LITERAL).lexeme;
+                if (type == "CATMULL_ROM")
+                    spline.type = SplineType::CATMULL_ROM;
+                else if (type == "BEZIER")
+                    spline.type = SplineType::BEZIER;
+                else Error("Unknown spline type: '%s'", type.c_str());
+            }
+            else if (identifier == "CLOSED")
+                spline.closed = ExpectBoolean();
+            else if (identifier == "SAMPLES")
+                spline.numSamples = strtoul(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr, 10);
+            else if (identifier == "POINTS")
+            {
+                // [ (x, y, z), (x, y, z), ... ]
+                Expect(TokenType::TOKEN_LBRACKET);
+                if (!Match(TokenType::TOKEN_RBRACKET))
+                {
+                    do {
+                        Vector3f point;
+                        Expect(TokenType::TOKEN_LPAREN);
+                        point.x() = strtod(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr);
+                        Expect(TokenType::TOKEN_COMMA);
+                        point.y() = strtod(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr);
+                        Expect(TokenType::TOKEN_COMMA);
+                        point.z() = strtod(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr);
+                        Expect(TokenType::TOKEN_RPAREN);
+                        spline.points.push_back(point);
+                    } while(Match(TokenType::TOKEN_COMMA));
+                    Expect(TokenType::TOKEN_RBRACKET);
+                }
+            }
+            else 
+                Error("Unknown spline property '%s'", identifier.c_str());
+
+            Expect(TokenType::TOKEN_SEMICOLON);
+        }
+        return spline;
+    }
+
+    OrbCollisionMesh RawReader::Read_CollisionMesh()
+    {
+        OrbCollisionMesh collisionMesh;
+        while(!Match(TokenType::TOKEN_RCURLY))
+        {
+            auto identifier = Expect(TokenType::TOKEN_LITERAL).lexeme;
+            ExpectLiteral("as");
+            if (identifier == "MESH")
+                collisionMesh.mesh = Expect(TokenType::TOKEN_STRING).lexeme;
+            else if (identifier == "SHAPE")
+            {
+                auto shape = Expect(TokenType::TOKEN_LITERAL).lexeme;
+                if (shape == "TRIANGLE_MESH")
+                    collisionMesh.shape = CollisionShape::TRIANGLE_MESH;
+                else if (shape == "CONVEX_MESH")
+                    collisionMesh.shape = CollisionShape::CONVEX_MESH;
+                else if (shape == "CONVEX_DECOMPOSITION")
+                    collisionMesh.shape = CollisionShape::CONVEX_DECOMPOSITION;
+                else Error("Unknown collision shape: '%s'", shape.c_str());
+            }
+            else if (identifier == "MAX_HULLS")
+                collisionMesh.maxHulls = strtoul(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr, 10);
+            else if (identifier == "MAX_HULL_VERTICES")
+                collisionMesh.maxHullVertices = strtoul(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr, 10);
+            else if (identifier == "RESOLUTION")
+                collisionMesh.resolution = strtoul(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr, 10);
+            else if (identifier == "CONCAVITY")
+                collisionMesh.maxConcavity = strtof(Expect(TokenType::TOKEN_NUMBER).lexeme.c_str(), nullptr);
+            else 
+                Error("Unknown collision mesh property '%s'", identifier.c_str());
+
+            Expect(TokenType::TOKEN_SEMICOLON);
+        }
+        if (collisionMesh.mesh.empty())
+            Error("Collision mesh without a MESH");
+        if (collisionMesh.maxHulls == 0u || collisionMesh.maxHullVertices < 4u || collisionMesh.maxHullVertices > 255u)
+            Error("Collision mesh needs MAX_HULLS > 0 and MAX_HULL_VERTICES in [4, 255]");
+        return collisionMesh;
+    }
+
     bool RawReader::ReadFile(const fs::path& filepath, OrbIntermediate* orb)
     {
         if (!OpenFile(filepath))
@@ -0,0 +1,218 @@
+#include "spline/SplineBaker.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace orbtool
+{
+
+    // @brief: exact arc lengths of a chain of cubic Bezier segments
+    class ArcLength
+    {
+    private:
+        // @member: 5 point Gauss-Legendre quadrature on [-1, 1]
+        static constexpr double sNodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+        static constexpr double sWeights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+        // @member: number of intervals per segment the dense table is integrated in
+        static constexpr uint32_t sSubdivisions = 16u;
+
+        std::vector<Vector3d> m_points;
+        uint32_t m_numSegments;
+        // @member: distance at the start of every interval, followed by the total length
+        std::vector<double> m_table;
+    public:
+        explicit ArcLength(const std::vector<Vector3f>& controlPoints)
+        {
+            for (const auto& point : controlPoints)
+                m_points.push_back(point.cast<double>());
+            m_numSegments = static_cast<uint32_t>(m_points.size() - 1u) / 3u;
+
+            m_table.push_back(0.0);
+            for (auto segment = 0u; segment < m_numSegments; ++segment)
+            {
+                for (auto i = 0u; i < sSubdivisions; ++i)
+                {
+                    const auto length = Integrate(segment, static_cast<double>(i) / sSubdivisions, static_cast<double>(i + 1u) / sSubdivisions);
+                    m_table.push_back(m_table.back() + length);
+                }
+            }
+        }
+
+        double Length() const { return m_table.back(); }
+
+        Vector3d Derivative(uint32_t segment, double t) const
+        {
+            const auto* p = &m_points[segment * 3u];
+            const auto s = 1.0 - t;
+            return 3.0 * (s * s * (p[1] - p[0]) + 2.0 * s * t * (p[2] - p[1]) + t * t * (p[3] - p[2]));
+        }
+
+        // @method: returns the length of a segment between two positions on it
+        double Integrate(uint32_t segment, double t0, double t1) const
+        {
+            const auto half = 0.5 * (t1 - t0);
+            const auto center = 0.5 * (t1 + t0);
+            auto sum = 0.0;
+            for (auto i = 0u; i < 5u; ++i)
+                sum += sWeights[i] * Derivative(segment, center + half * sNodes[i]).norm();
+            return sum * half;
+        }
+
+        // @method: returns the distance along the curve at a parameter (segment + position)
+        double DistanceAt(double parameter) const
+        {
+            const auto segment = std::min(static_cast<uint32_t>(std::max(parameter, 0.0)), m_numSegments - 1u);
+            const auto t = std::clamp(parameter - segment, 0.0, 1.0);
+            const auto interval = std::min(static_cast<uint32_t>(t * sSubdivisions), sSubdivisions - 1u);
+            return m_table[segment * sSubdivisions + interval] + Integrate(segment, static_cast<double>(interval) / sSubdivisions, t);
+        }
+
+        // @method: returns the parameter (segment + position) at a distance along the curve
+        double ParameterAt(double distance) const
+        {
+            distance = std::clamp(distance, 0.0, Length());
+            const auto numIntervals = static_cast<std::ptrdiff_t>(m_table.size() - 1u);
+            const auto it = std::upper_bound(m_table.begin(), m_table.end(), distance);
+            const auto index = static_cast<uint32_t>(std::clamp<std::ptrdiff_t>((it - m_table.begin()) - 1, 0, numIntervals - 1));
+            const auto segment = index / sSubdivisions;
+            const auto start = m_table[index];
+            const auto span = m_table[index + 1u] - start;
+
+            // Safeguarded Newton iteration, the interval always brackets the solution
+            auto low = static_cast<double>(index % sSubdivisions) / sSubdivisions;
+            auto high = low + 1.0 / sSubdivisions;
+            const auto intervalStart = low;
+            auto t = span > 0.0 ? low + (high - low) * (distance - start) / span : low;
+            for (auto iteration = 0u; iteration < 16u; ++iteration)
+            {
+                const auto error = start + Integrate(segment, intervalStart, t) - distance;
+                if (std::abs(error) < 1e-9 * std::max(Length(), 1.0))
+                    break;
+                if (error > 0.0)
+                    high = t;
+                else
+                    low = t;
+                const auto speed = Derivative(segment, t).norm();
+                const auto next = speed > 0.0 ? t - error / speed : low;
+                t = next > low && next < high ? next : 0.5 * (low + high);
+            }
+            return segment + t;
+        }
+    };
+
+    bool SplineBaker::BuildSegments(OrbSpline* spline)
+    {
+        const auto& points = spline->points;
+        const auto numPoints = static_cast<uint32_t>(points.size());
+        auto& controlPoints = spline->controlPoints;
+        controlPoints.clear();
+
+        if (spline->type == SplineType::BEZIER)
+        {
+            // Open: anchor (control control anchor)*, closed: (anchor control control)*
+            const auto valid = spline->closed ? numPoints >= 3u && numPoints % 3u == 0u : numPoints >= 4u && numPoints % 3u == 1u;
+            if (!valid)
+            {
+                ORBIT_ERROR("A %s Bezier spline needs %s points, got %u", spline->closed ? "closed" : "open",
+                    spline->closed ? "a multiple of 3" : "a multiple of 3 plus 1", numPoints);
+                return false;
+            }
+            controlPoints = points;
+            if (spline->closed)
+                controlPoints.push_back(points.front());
+            return true;
+        }
+
+        if (numPoints < (spline->closed ? 3u : 2u))
+        {
+            ORBIT_ERROR("A %s Catmull-Rom spline needs at least %u points, got %u", spline->closed ? "closed" : "open",
+                spline->closed ? 3u : 2u, numPoints);
+            return false;
+        }
+
+        // Open splines are extended by mirroring their second and second to last point
+        auto point = [&](int32_t i) -> Vector3f {
+            const auto n = static_cast<int32_t>(numPoints);
+            if (spline->closed)
+                return points[((i % n) + n) % n];
+            if (i < 0)
+                return 2.f * points[0] - points[1];
+            if (i >= n)
+                return 2.f * points[n - 1] - points[n - 2];
+            return points[i];
+        };
+        // Centripetal knot spacing: the square root of the distance
+        auto knot = [](const Vector3f& a, const Vector3f& b) {
+            return std::max(std::sqrt((b - a).norm()), 1e-4f);
+        };
+
+        const auto numSegments = spline->closed ? numPoints : numPoints - 1u;
+        controlPoints.push_back(points[0]);
+        for (auto segment = 0u; segment < numSegments; ++segment)
+        {
+            const auto i = static_cast<int32_t>(segment);
+            const Vector3f p0 = point(i - 1), p1 = point(i), p2 = point(i + 1), p3 = point(i + 2);
+            const auto t01 = knot(p0, p1), t12 = knot(p1, p2), t23 = knot(p2, p3);
+
+            // Hermite tangents of the non-uniform segment, scaled to a unit parameter range
+            const Vector3f m1 = ((p1 - p0) / t01 - (p2 - p0) / (t01 + t12) + (p2 - p1) / t12) * t12;
+            const Vector3f m2 = ((p2 - p1) / t12 - (p3 - p1) / (t12 + t23) + (p3 - p2) / t23) * t12;
+            controlPoints.push_back(p1 + m1 / 3.f);
+            controlPoints.push_back(p2 - m2 / 3.f);
+            controlPoints.push_back(p2);
+        }
+        return true;
+    }
+
+    bool SplineBaker::Bake(OrbSpline* spline)
+    {
+        if (spline->IsBaked())
+            return true;
+        if (!BuildSegments(spline))
+            return false;
+
+        const ArcLength arcLength(spline->controlPoints);
+        const auto length = arcLength.Length();
+        if (!(length > 0.0))
+        {
+            ORBIT_ERROR("The spline has no length");
+            return false;
+        }
+
+        // The table is refined until the interpolated parameters halfway
+        // between two samples are within the tolerance of the exact ones
+        const auto numSegments = spline->NumSegments();
+        auto numSamples = spline->numSamples > 0u ? spline->numSamples : std::max(sMinSamples, numSegments * 8u);
+        std::vector<double> parameters;
+        auto maxError = 0.0;
+        while (true)
+        {
+            const auto spacing = length / numSamples;
+            parameters.resize(numSamples + 1u);
+            ParallelFor(numSamples + 1u, [&](size_t i) {
+                parameters[i] = arcLength.ParameterAt(spacing * i);
+            });
+            parameters.back() = numSegments;
+
+            std::vector<double> errors(numSamples);
+            ParallelFor(numSamples, [&](size_t i) {
+                const auto middle = 0.5 * (parameters[i] + parameters[i + 1u]);
+                errors[i] = std::abs(arcLength.DistanceAt(middle) - spacing * (i + 0.5));
+            });
+            maxError = *std::max_element(errors.begin(), errors.end());
+
+            if (spline->numSamples > 0u || maxError <= sDistanceTolerance || numSamples * 2u > sMaxSamples)
+                break;
+            numSamples *= 2u;
+        }
+
+        spline->length = static_cast<float>(length);
+        spline->samples.assign(parameters.begin(), parameters.end());
+        ORBIT_LOG("Baked %u spline segments of length %f into %u samples (max error %f)",
+            numSegments, spline->length, numSamples, maxError);
+        return true;
+    }
+
+}
@@ -0,0 +1,409 @@
+#include "texture/BlockCompressor.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace orbtool
+{
+
+    static constexpr uint32_t sBlockPixels = 16u;
+
+    // @brief: appends bits to a block, least significant bit first
+    struct BitWriter
+    {
+        uint8_t* data;
+        uint32_t position = 0u;
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            for (auto b = 0u; b < bits; ++b, ++position)
+            {
+                if ((value >> b) & 1u)
+                    data[position >> 3u] |= static_cast<uint8_t>(1u << (position & 7u));
+            }
+        }
+    };
+
+    // @method: calculates the mean and the direction of largest variance
+    //  of the first numChannels channels using power iteration
+    static void PrincipalAxis(const float (*colors)[4], uint32_t numChannels, float* mean, float* axis)
+    {
+        for (auto c = 0u; c < 4u; ++c)
+        {
+            mean[c] = 0.f;
+            axis[c] = 0.f;
+        }
+        for (auto i = 0u; i < sBlockPixels; ++i)
+            for (auto c = 0u; c < numChannels; ++c)
+                mean[c] += colors[i][c] / sBlockPixels;
+
+        float covariance[4][4] = {};
+        for (auto i = 0u; i < sBlockPixels; ++i)
+            for (auto a = 0u; a < numChannels; ++a)
+                for (auto b = 0u; b < numChannels; ++b)
+                    covariance[a][b] += (colors[i][a] - mean[a]) * (colors[i][b] - mean[b]);
+
+        float v[4] = { 1.f, 1.f, 1.f, 1.f };
+        for (auto iteration = 0u; iteration < 8u; ++iteration)
+        {
+            float next[4] = {};
+            auto length = 0.f;
+            for (auto a = 0u; a < numChannels; ++a)
+            {
+                for (auto b = 0u; b < numChannels; ++b)
+                    next[a] += covariance[a][b] * v[b];
+                length = std::max(length, std::abs(next[a]));
+            }
+            if (length <= 0.f)
+                break;
+            for (auto a = 0u; a < numChannels; ++a)
+                v[a] = next[a] / length;
+        }
+
+        auto length = 0.f;
+        for (auto c = 0u; c < numChannels; ++c)
+            length += v[c] * v[c];
+        length = std::sqrt(length);
+        for (auto c = 0u; c < numChannels; ++c)
+            axis[c] = length > 0.f ? v[c] / length : 0.f;
+    }
+
+    static void Project(const float (*colors)[4], uint32_t numChannels, const float* mean, const float* axis, float* minT, float* maxT)
+    {
+        *minT = std::numeric_limits<float>::max();
+        *maxT = -std::numeric_limits<float>::max();
+        for (auto i = 0u; i < sBlockPixels; ++i)
+        {
+            auto t = 0.f;
+            for (auto c = 0u; c < numChannels; ++c)
+                t += (colors[i][c] - mean[c]) * axis[c];
+            *minT = std::min(*minT, t);
+            *maxT = std::max(*maxT, t);
+        }
+    }
+
+    static uint16_t To565(const float* color)
+    {
+        auto quantize = [](float value, uint32_t max) {
+            return static_cast<uint32_t>(std::lround(std::clamp(value, 0.f, 255.f) * max / 255.f));
+        };
+        return static_cast<uint16_t>((quantize(color[0], 31u) << 11u) | (quantize(color[1], 63u) << 5u) | quantize(color[2], 31u));
+    }
+
+    static void From565(uint16_t value, float* color)
+    {
+        const auto r = (value >> 11u) & 31u;
+        const auto g = (value >> 5u) & 63u;
+        const auto b = value & 31u;
+        color[0] = static_cast<float>((r << 3u) | (r >> 2u));
+        color[1] = static_cast<float>((g << 2u) | (g >> 4u));
+        color[2] = static_cast<float>((b << 3u) | (b >> 2u));
+    }
+
+    // @method: chooses the nearest palette entry for every pixel
+    // @return: the squared error of the block
+    static float FitBC1(const float (*colors)[4], uint16_t c0, uint16_t c1, uint32_t* indices)
+    {
+        float palette[4][3];
+        From565(c0, palette[0]);
+        From565(c1, palette[1]);
+        for (auto c = 0u; c < 3u; ++c)
+        {
+            palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+            palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+        }
+
+        auto error = 0.f;
+        *indices = 0u;
+        for (auto i = 0u; i < sBlockPixels; ++i)
+        {
+            auto best = 0u;
+            auto bestError = std::numeric_limits<float>::max();
+            for (auto p = 0u; p < (c0 == c1 ? 1u : 4u); ++p)
+            {
+                auto e = 0.f;
+                for (auto c = 0u; c < 3u; ++c)
+                    e += (colors[i][c] - palette[p][c]) * (colors[i][c] - palette[p][c]);
+                if (e < bestError)
+                {
+                    best = p;
+                    bestError = e;
+                }
+            }
+            *indices |= best << (2u * i);
+            error += bestError;
+        }
+        return error;
+    }
+
+    static void OrderBC1(uint16_t* c0, uint16_t* c1)
+    {
+        // c0 > c1 selects the 4 color mode
+        if (*c0 < *c1)
+            std::swap(*c0, *c1);
+    }
+
+    void BlockCompressor::EncodeBC1(const uint8_t* pixels, uint8_t* block)
+    {
+        float colors[sBlockPixels][4];
+        for (auto i = 0u; i < sBlockPixels; ++i)
+            for (auto c = 0u; c < 4u; ++c)
+                colors[i][c] = pixels[i * 4u + c];
+
+        float mean[4], axis[4], minT, maxT;
+        PrincipalAxis(colors, 3u, mean, axis);
+        Project(colors, 3u, mean, axis, &minT, &maxT);
+
+        // Insetting the endpoints reduces the error of the interpolated colors
+        const auto inset = (maxT - minT) / 16.f;
+        float e0[3], e1[3];
+        for (auto c = 0u; c < 3u; ++c)
+        {
+            e0[c] = mean[c] + axis[c] * (maxT - inset);
+            e1[c] = mean[c] + axis[c] * (minT + inset);
+        }
+        auto c0 = To565(e0);
+        auto c1 = To565(e1);
+        OrderBC1(&c0, &c1);
+        uint32_t indices;
+        auto error = FitBC1(colors, c0, c1, &indices);
+
+        // One least squares step moves the endpoints towards the chosen indices
+        if (c0 != c1)
+        {
+            static constexpr float weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+            float aa = 0.f, ab = 0.f, bb = 0.f, ax[3] = {}, bx[3] = {};
+            for (auto i = 0u; i < sBlockPixels; ++i)
+            {
+                const auto a = weights[(indices >> (2u * i)) & 3u];
+                const auto b = 1.f - a;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for (auto c = 0u; c < 3u; ++c)
+                {
+                    ax[c] += a * colors[i][c];
+                    bx[c] += b * colors[i][c];
+                }
+            }
+            const auto det = aa * bb - ab * ab;
+            if (std::abs(det) > 1e-6f)
+            {
+                for (auto c = 0u; c < 3u; ++c)
+                {
+                    e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+                    e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+                }
+                auto r0 = To565(e0);
+                auto r1 = To565(e1);
+                OrderBC1(&r0, &r1);
+                uint32_t refinedIndices;
+                if (FitBC1(colors, r0, r1, &refinedIndices) < error)
+                {
+                    c0 = r0;
+                    c1 = r1;
+                    indices = refinedIndices;
+                }
+            }
+        }
+
+        std::memcpy(block + 0, &c0, sizeof(uint16_t));
+        std::memcpy(block + 2, &c1, sizeof(uint16_t));
+        std::memcpy(block + 4, &indices, sizeof(uint32_t));
+    }
+
+    void BlockCompressor::EncodeBC4(const uint8_t* pixels, uint32_t channel, uint8_t* block)
+    {
+        auto minValue = 255u;
+        auto maxValue = 0u;
+        for (auto i = 0u; i < sBlockPixels; ++i)
+        {
+            minValue = std::min<uint32_t>(minValue, pixels[i * 4u + channel]);
+            maxValue = std::max<uint32_t>(maxValue, pixels[i * 4u + channel]);
+        }
+
+        // a0 > a1 selects 6 interpolated values between the endpoints
+        block[0] = static_cast<uint8_t>(maxValue);
+        block[1] = static_cast<uint8_t>(minValue);
+        uint64_t bits = 0u;
+        if (maxValue != minValue)
+        {
+            int palette[8] = { static_cast<int>(maxValue), static_cast<int>(minValue) };
+            for (auto p = 2; p < 8; ++p)
+                palette[p] = ((8 - p) * palette[0] + (p - 1) * palette[1] + 3) / 7;
+
+            for (auto i = 0u; i < sBlockPixels; ++i)
+            {
+                const int value = pixels[i * 4u + channel];
+                auto best = 0u;
+                for (auto p = 1u; p < 8u; ++p)
+                {
+                    if (std::abs(value - palette[p]) < std::abs(value - palette[best]))
+                        best = p;
+                }
+                bits |= static_cast<uint64_t>(best) << (3u * i);
+            }
+        }
+        for (auto b = 0u; b < 6u; ++b)
+            block[2 + b] = static_cast<uint8_t>(bits >> (8u * b));
+    }
+
+    void BlockCompressor::EncodeBC3(const uint8_t* pixels, uint8_t* block)
+    {
+        EncodeBC4(pixels, 3u, block);
+        EncodeBC1(pixels, block + 8);
+    }
+
+    void BlockCompressor::EncodeBC5(const uint8_t* pixels, uint8_t* block)
+    {
+        EncodeBC4(pixels, 0u, block);
+        EncodeBC4(pixels, 1u, block + 8);
+    }
+
+    void BlockCompressor::EncodeBC7(const uint8_t* pixels, uint8_t* block)
+    {
+        static constexpr int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        float colors[sBlockPixels][4];
+        for (auto i = 0u; i < sBlockPixels; ++i)
+            for (auto c = 0u; c < 4u; ++c)
+                colors[i][c] = pixels[i * 4u + c];
+
+        float mean[4], axis[4], minT, maxT;
+        PrincipalAxis(colors, 4u, mean, axis);
+        Project(colors, 4u, mean, axis, &minT, &maxT);
+
+        // Mode 6: a single subset with 7 bit rgba endpoints, a p-bit per endpoint and 4 bit indices
+        uint32_t bestQ[2][4] = {}, bestP[2] = {}, bestIndices[sBlockPixels] = {};
+        auto bestError = std::numeric_limits<int>::max();
+        for (auto pbits = 0u; pbits < 4u; ++pbits)
+        {
+            const uint32_t p[2] = { pbits & 1u, pbits >> 1u };
+            uint32_t q[2][4];
+            int endpoints[2][4];
+            for (auto e = 0u; e < 2u; ++e)
+            {
+                const auto t = e == 0u ? minT : maxT;
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    const auto value = mean[c] + axis[c] * t;
+                    q[e][c] = static_cast<uint32_t>(std::clamp(std::lround((value - p[e]) / 2.f), 0l, 127l));
+                    endpoints[e][c] = static_cast<int>((q[e][c] << 1u) | p[e]);
+                }
+            }
+
+            int palette[16][4];
+            for (auto w = 0u; w < 16u; ++w)
+                for (auto c = 0u; c < 4u; ++c)
+                    palette[w][c] = ((64 - weights[w]) * endpoints[0][c] + weights[w] * endpoints[1][c] + 32) >> 6;
+
+            auto error = 0;
+            uint32_t indices[sBlockPixels];
+            for (auto i = 0u; i < sBlockPixels; ++i)
+            {
+                auto best = 0u;
+                auto bestPixelError = std::numeric_limits<int>::max();
+                for (auto w = 0u; w < 16u; ++w)
+                {
+                    auto e = 0;
+                    for (auto c = 0u; c < 4u; ++c)
+                    {
+                        const auto d = pixels[i * 4u + c] - palette[w][c];
+                        e += d * d;
+                    }
+                    if (e < bestPixelError)
+                    {
+                        best = w;
+                        bestPixelError = e;
+                    }
+                }
+                indices[i] = best;
+                error += bestPixelError;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                std::memcpy(bestQ, q, sizeof(q));
+                std::memcpy(bestP, p, sizeof(p));
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+        }
+
+        // The most significant bit of the first index is implicitly zero
+        if (bestIndices[0] & 8u)
+        {
+            std::swap(bestQ[0], bestQ[1]);
+            std::swap(bestP[0], bestP[1]);
+            for (auto& index : bestIndices)
+                index = 15u - index;
+        }
+
+        std::memset(block, 0, 16);
+        BitWriter writer{ block };
+        writer.Write(1u << 6u, 7u);
+        for (auto c = 0u; c < 4u; ++c)
+        {
+            writer.Write(bestQ[0][c], 7u);
+            writer.Write(bestQ[1][c], 7u);
+        }
+        writer.Write(bestP[0], 1u);
+        writer.Write(bestP[1], 1u);
+        for (auto i = 0u; i < sBlockPixels; ++i)
+            writer.Write(bestIndices[i], i == 0u ? 3u : 4u);
+    }
+
+    uint32_t BlockCompressor::BlockSize(TextureCompression compression)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1: return 8u;
+        case TextureCompression::BC3: return 16u;
+        case TextureCompression::BC5: return 16u;
+        case TextureCompression::BC7: return 16u;
+        default: return 0u;
+        }
+    }
+
+    std::vector<uint8_t> BlockCompressor::Compress(const uint8_t* rgba, uint32_t width, uint32_t height, TextureCompression compression)
+    {
+        const auto blockSize = BlockSize(compression);
+        if (blockSize == 0u)
+            ORBIT_THROW("Cannot block compress a texture without a BC format");
+
+        const auto blocksX = (width + sBlockDim - 1u) / sBlockDim;
+        const auto blocksY = (height + sBlockDim - 1u) / sBlockDim;
+        std::vector<uint8_t> output(static_cast<size_t>(blocksX) * blocksY * blockSize);
+        ParallelFor(blocksY, [&](size_t by) {
+            uint8_t pixels[sBlockPixels * 4u];
+            for (auto bx = 0u; bx < blocksX; ++bx)
+            {
+                for (auto y = 0u; y < sBlockDim; ++y)
+                {
+                    const auto sy = std::min<uint32_t>(static_cast<uint32_t>(by) * sBlockDim + y, height - 1u);
+                    for (auto x = 0u; x < sBlockDim; ++x)
+                    {
+                        const auto sx = std::min<uint32_t>(bx * sBlockDim + x, width - 1u);
+                        std::memcpy(pixels + (y * sBlockDim + x) * 4u, rgba + (static_cast<size_t>(sy) * width + sx) * 4u, 4u);
+                    }
+                }
+
+                auto block = output.data() + (by * blocksX + bx) * blockSize;
+                switch (compression)
+                {
+                case TextureCompression::BC1: EncodeBC1(pixels, block); break;
+                case TextureCompression::BC3: EncodeBC3(pixels, block); break;
+                case TextureCompression::BC5: EncodeBC5(pixels, block); break;
+                case TextureCompression::BC7: EncodeBC7(pixels, block); break;
+                default: break;
+                }
+            }
+        });
+        return output;
+    }
+
+}
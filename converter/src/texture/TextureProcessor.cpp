@@ -0,0 +1,270 @@
+#include "texture/TextureProcessor.hpp"
+#include "texture/BlockCompressor.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "Parallel.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+#endif
+#include <dxgiformat.h>
+#include "implementation/misc/DDS.h"
+
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace orbtool
+{
+
+    // @brief: a level of the mip chain while it is being filtered
+    struct FloatImage
+    {
+        uint32_t width = 0u;
+        uint32_t height = 0u;
+        std::vector<float> pixels;
+    };
+
+    struct SrgbTables
+    {
+        float toLinear[256];
+        // @member: indexed by the linear value scaled to [0, 4095]
+        uint8_t toSrgb[4096];
+
+        SrgbTables()
+        {
+            for (auto i = 0u; i < 256u; ++i)
+            {
+                const auto c = i / 255.f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (auto i = 0u; i < 4096u; ++i)
+            {
+                const auto l = i / 4095.f;
+                const auto s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - 0.055f;
+                toSrgb[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.f, 1.f) * 255.f));
+            }
+        }
+    };
+
+    static const SrgbTables& GetSrgbTables()
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    static FloatImage ToFloat(const TextureImage& image, bool srgb, bool normalMap)
+    {
+        const auto& tables = GetSrgbTables();
+        FloatImage result{ image.width, image.height };
+        result.pixels.resize(image.pixels.size());
+        ParallelFor(image.height, [&](size_t y) {
+            const auto begin = y * image.width * 4u;
+            for (auto i = begin; i < begin + image.width * 4u; ++i)
+            {
+                const auto value = image.pixels[i];
+                if ((i & 3u) == 3u)
+                    result.pixels[i] = value / 255.f;
+                else if (normalMap)
+                    result.pixels[i] = value / 255.f * 2.f - 1.f;
+                else
+                    result.pixels[i] = srgb ? tables.toLinear[value] : value / 255.f;
+            }
+        });
+        return result;
+    }
+
+    static TextureImage ToBytes(const FloatImage& image, bool srgb, bool normalMap)
+    {
+        const auto& tables = GetSrgbTables();
+        TextureImage result{ image.width, image.height };
+        result.pixels.resize(image.pixels.size());
+        ParallelFor(image.height, [&](size_t y) {
+            const auto begin = y * image.width * 4u;
+            for (auto i = begin; i < begin + image.width * 4u; ++i)
+            {
+                auto value = image.pixels[i];
+                if ((i & 3u) != 3u && normalMap)
+                    value = value * 0.5f + 0.5f;
+                value = std::clamp(value, 0.f, 1.f);
+                if ((i & 3u) != 3u && srgb && !normalMap)
+                    result.pixels[i] = tables.toSrgb[static_cast<uint32_t>(value * 4095.f + 0.5f)];
+                else
+                    result.pixels[i] = static_cast<uint8_t>(value * 255.f + 0.5f);
+            }
+        });
+        return result;
+    }
+
+    // @method: halves the image with a 2x2 box filter. Odd sizes repeat the last row/column
+    static FloatImage Downsample(const FloatImage& source, bool normalMap)
+    {
+        FloatImage result{ std::max(source.width / 2u, 1u), std::max(source.height / 2u, 1u) };
+        result.pixels.resize(static_cast<size_t>(result.width) * result.height * 4u);
+        ParallelFor(result.height, [&](size_t y) {
+            const auto y0 = std::min<size_t>(y * 2u, source.height - 1u);
+            const auto y1 = std::min<size_t>(y * 2u + 1u, source.height - 1u);
+            const auto row0 = source.pixels.data() + y0 * source.width * 4u;
+            const auto row1 = source.pixels.data() + y1 * source.width * 4u;
+            auto out = result.pixels.data() + y * result.width * 4u;
+
+            const auto quarter = _mm_set1_ps(0.25f);
+            for (auto x = 0u; x < result.width; ++x)
+            {
+                const auto x0 = std::min(x * 2u, source.width - 1u) * 4u;
+                const auto x1 = std::min(x * 2u + 1u, source.width - 1u) * 4u;
+                const auto top = _mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1));
+                const auto bottom = _mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1));
+                auto sum = _mm_mul_ps(_mm_add_ps(top, bottom), quarter);
+
+                if (normalMap)
+                {
+                    // Averaged normals get shorter, keep xyz unit length
+                    float v[4];
+                    _mm_storeu_ps(v, sum);
+                    const auto length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+                    if (length > 0.f)
+                        sum = _mm_mul_ps(sum, _mm_setr_ps(1.f / length, 1.f / length, 1.f / length, 1.f));
+                }
+                _mm_storeu_ps(out + x * 4u, sum);
+            }
+        });
+        return result;
+    }
+
+    bool TextureProcessor::Decode(const fs::path& path, TextureImage* image)
+    {
+#ifdef _WIN32
+        using Microsoft::WRL::ComPtr;
+
+        // COM has to be initialized on every thread, this is a no-op if it already is
+        CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+        ComPtr<IWICImagingFactory> factory;
+        auto result = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(factory.GetAddressOf()));
+        if (FAILED(result))
+        {
+            ORBIT_ERROR_HR(result, "Unable to create the WIC imaging factory");
+            return false;
+        }
+
+        ComPtr<IWICBitmapDecoder> decoder;
+        ComPtr<IWICBitmapFrameDecode> frame;
+        ComPtr<IWICFormatConverter> converter;
+        result = factory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+        if (SUCCEEDED(result))
+            result = decoder->GetFrame(0, frame.GetAddressOf());
+        if (SUCCEEDED(result))
+            result = factory->CreateFormatConverter(converter.GetAddressOf());
+        if (SUCCEEDED(result))
+            result = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+        if (SUCCEEDED(result))
+            result = converter->GetSize(&image->width, &image->height);
+        if (SUCCEEDED(result))
+        {
+            image->pixels.resize(static_cast<size_t>(image->width) * image->height * 4u);
+            result = converter->CopyPixels(nullptr, image->width * 4u, static_cast<UINT>(image->pixels.size()), image->pixels.data());
+        }
+        if (FAILED(result))
+        {
+            ORBIT_ERROR_HR(result, "Unable to decode image '%s'", path.generic_string().c_str());
+            return false;
+        }
+        return true;
+#else
+        ORBIT_ERROR("Unable to decode image '%s'. Image decoding requires WIC", path.generic_string().c_str());
+        return false;
+#endif
+    }
+
+    std::vector<TextureImage> TextureProcessor::GenerateMips(const TextureImage& image, bool srgb, bool normalMap)
+    {
+        std::vector<TextureImage> mips;
+        mips.push_back(image);
+
+        // Filtering happens on floats so that no level accumulates rounding errors
+        auto level = ToFloat(image, srgb, normalMap);
+        while (level.width > 1u || level.height > 1u)
+        {
+            level = Downsample(level, normalMap);
+            mips.push_back(ToBytes(level, srgb, normalMap));
+        }
+        return mips;
+    }
+
+    std::vector<uint8_t> TextureProcessor::WriteDds(const std::vector<TextureImage>& mips, TextureCompression compression)
+    {
+        using namespace DirectX;
+
+        DXGI_FORMAT format;
+        switch (compression)
+        {
+        case TextureCompression::BC1: format = DXGI_FORMAT_BC1_UNORM; break;
+        case TextureCompression::BC3: format = DXGI_FORMAT_BC3_UNORM; break;
+        case TextureCompression::BC5: format = DXGI_FORMAT_BC5_UNORM; break;
+        case TextureCompression::BC7: format = DXGI_FORMAT_BC7_UNORM; break;
+        default: format = DXGI_FORMAT_R8G8B8A8_UNORM; break;
+        }
+        const auto compressed = BlockCompressor::BlockSize(compression) != 0u;
+
+        std::vector<std::vector<uint8_t>> levels;
+        for (const auto& mip : mips)
+        {
+            if (compressed)
+                levels.push_back(BlockCompressor::Compress(mip.pixels.data(), mip.width, mip.height, compression));
+            else
+                levels.push_back(mip.pixels);
+        }
+
+        DDS_HEADER header{};
+        header.size = sizeof(DDS_HEADER);
+        header.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP | (compressed ? DDS_HEADER_FLAGS_LINEARSIZE : DDS_HEADER_FLAGS_PITCH);
+        header.width = mips.front().width;
+        header.height = mips.front().height;
+        header.pitchOrLinearSize = compressed ? static_cast<uint32_t>(levels.front().size()) : header.width * 4u;
+        header.mipMapCount = static_cast<uint32_t>(mips.size());
+        header.ddspf = DDSPF_DX10;
+        header.caps = DDS_SURFACE_FLAGS_TEXTURE | (mips.size() > 1u ? DDS_SURFACE_FLAGS_MIPMAP : 0u);
+
+        DDS_HEADER_DXT10 extension{};
+        extension.dxgiFormat = format;
+        extension.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        extension.arraySize = 1u;
+
+        std::vector<uint8_t> dds(sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10));
+        auto cursor = dds.data();
+        std::memcpy(cursor, &DDS_MAGIC, sizeof(uint32_t));
+        cursor += sizeof(uint32_t);
+        std::memcpy(cursor, &header, sizeof(DDS_HEADER));
+        cursor += sizeof(DDS_HEADER);
+        std::memcpy(cursor, &extension, sizeof(DDS_HEADER_DXT10));
+        for (const auto& level : levels)
+            dds.insert(dds.end(), level.begin(), level.end());
+        return dds;
+    }
+
+    bool TextureProcessor::Process(OrbTexture* texture, TextureCompression compression, bool srgb, bool normalMap)
+    {
+        TextureImage image;
+        if (!Decode(texture->texturePath, &image))
+            return false;
+
+        // D3D11 only accepts block compressed textures whose top level is made of whole blocks
+        if (BlockCompressor::BlockSize(compression) != 0u &&
+            (image.width % BlockCompressor::sBlockDim != 0u || image.height % BlockCompressor::sBlockDim != 0u))
+        {
+            ORBIT_LOG("Texture '%s' is %ux%u, which is not a multiple of 4. Storing it uncompressed",
+                texture->texturePath.generic_string().c_str(), image.width, image.height);
+            compression = TextureCompression::NONE;
+        }
+
+        const auto mips = GenerateMips(image, srgb, normalMap);
+        texture->ddsData = WriteDds(mips, compression);
+        ORBIT_LOG("Processed texture '%s' (%ux%u, %zu mips, %zu bytes)",
+            texture->texturePath.generic_string().c_str(), image.width, image.height, mips.size(), texture->ddsData.size());
+        return true;
+    }
+
+}
@@ -107,7 +107,7 @@ namespace orbtool
 
                 for (auto idx : tris)
                 {
-                    vertices.emplace_back(OrbVertex{ m_positions[pIndices[idx] - 1], m_normals[nIndices[idx] - 1], Vector3f{}, m_textures[tIndices[idx] - 1] });
+                    vertices.emplace_back(OrbVertex{ m_positions[pIndices[idx] - 1], m_normals[nIndices[idx] - 1], Vector3f::Zero(), m_textures[tIndices[idx] - 1] });
                 }
             }
             else if (MatchLiteral("usemtl"))
@@ -11,6 +11,7 @@ namespace orbit
     {
     public:
         void UpdateBuffer() override;
+        void UpdateRange(uint32_t first, uint32_t count) override;
         void Bind(uint32_t offset) const override;
     };
 
@@ -0,0 +1,50 @@
+#pragma once
+#ifdef ORBIT_DIRECTX_11
+#include "implementation/Common.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include "interfaces/rendering/InstanceBuffer.hpp"
+
+namespace orbit
+{
+
+    template<typename InstanceType>
+    class DirectX11InstanceBuffer : public IInstanceBufferBase<ComPtr<ID3D11Buffer>, InstanceType>
+    {
+    protected:
+        void CreateBuffer() override
+        {
+            D3D11_BUFFER_DESC desc;
+            ZeroMemory(&desc, sizeof(D3D11_BUFFER_DESC));
+            desc.Usage = D3D11_USAGE_DEFAULT;
+            desc.ByteWidth = static_cast<UINT>(this->m_instances.size() * sizeof(InstanceType));
+            desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+            desc.StructureByteStride = sizeof(InstanceType);
+
+            D3D11_SUBRESOURCE_DATA instanceData;
+            ZeroMemory(&instanceData, sizeof(D3D11_SUBRESOURCE_DATA));
+            instanceData.pSysMem = this->m_instances.data();
+
+            if (FAILED(Engine::Get()->Device()->CreateBuffer(&desc, &instanceData, this->m_buffer.ReleaseAndGetAddressOf())))
+                ORBIT_ERROR("Failed to create instance buffer");
+        }
+        void UploadRange(uint32_t first, uint32_t count) override
+        {
+            D3D11_BOX box;
+            box.left = first * sizeof(InstanceType);
+            box.right = (first + count) * sizeof(InstanceType);
+            box.top = 0u;
+            box.bottom = 1u;
+            box.front = 0u;
+            box.back = 1u;
+            Engine::Get()->Context()->UpdateSubresource(this->m_buffer.Get(), 0, &box, &this->m_instances[first], 0, 0);
+        }
+    public:
+        void Bind(uint32_t slot, uint32_t stride, uint32_t offset) const override
+        {
+            Engine::Get()->Context()->IASetVertexBuffers(slot, 1, this->m_buffer.GetAddressOf(), &stride, &offset);
+        }
+    };
+
+}
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 #ifdef ORBIT_DIRECTX_11
 #include "interfaces/rendering/Renderer.hpp"
+#include "implementation/backends/impl/InstanceBufferImpl.hpp"
 
 namespace orbit
 {
@@ -10,6 +11,8 @@ namespace orbit
     private:
         mutable ResourceId m_currentPipelineState;
         mutable ResourceId m_currentMaterial;
+        // @member: instances of the merged draws, @see IRenderer::SetInstances
+        InstanceBuffer<InstanceChunk> m_mergedInstances;
     protected:
         void BindTextureImpl(ResourceId id, uint32_t slot) const override;
         void BindMaterialImpl(ResourceId id) const override;
@@ -18,8 +21,8 @@ namespace orbit
         void BindGeometryShaderImpl(ResourceId id) const override;
         void BindDomainShaderImpl(ResourceId id) const override;
         void BindHullShaderImpl(ResourceId id) const override;
-    public:
-        void Draw(const Submesh& submesh, uint32_t instanceCount) const override;
+        void DrawImpl(const Submesh& submesh, uint32_t instanceCount, uint32_t startInstance) const override;
+        const InstanceBindable* UpdateMergedInstancesImpl(const std::vector<InstanceChunk>& instances) override;
     };
 
 }
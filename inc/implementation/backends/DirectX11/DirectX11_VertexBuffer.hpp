@@ -28,6 +28,17 @@ namespace orbit
             if (FAILED(Engine::Get()->Device()->CreateBuffer(&desc, &vertexData, m_buffer.ReleaseAndGetAddressOf())))
                 ORBIT_ERROR("Failed to create buffer");
         }
+        void UpdateRange(uint32_t first, uint32_t count) override
+        {
+            D3D11_BOX box;
+            box.left = first * sizeof(VertexType);
+            box.right = (first + count) * sizeof(VertexType);
+            box.top = 0u;
+            box.bottom = 1u;
+            box.front = 0u;
+            box.back = 1u;
+            Engine::Get()->Context()->UpdateSubresource(m_buffer.Get(), 0, &box, &m_vertices[first], 0, 0);
+        }
         void Bind(uint32_t slot, uint32_t stride, uint32_t offset) const override
         {
             Engine::Get()->Context()->IASetVertexBuffers(slot, 1, m_buffer.GetAddressOf(), &stride, &offset);
@@ -5,6 +5,7 @@
 #include "implementation/backends/impl/EngineImpl.hpp"
 #include "implementation/backends/impl/IndexBufferImpl.hpp"
 #include "implementation/backends/impl/InputLayoutImpl.hpp"
+#include "implementation/backends/impl/InstanceBufferImpl.hpp"
 #include "implementation/backends/impl/PixelShaderImpl.hpp"
 #include "implementation/backends/impl/TextureImpl.hpp"
 #include "implementation/backends/impl/VertexBufferImpl.hpp"
@@ -0,0 +1,12 @@
+#pragma once
+#ifdef ORBIT_DIRECTX_11
+#include "implementation/backends/DirectX11/DirectX11_InstanceBuffer.hpp"
+namespace orbit {
+    template<typename Instance>
+    using InstanceBuffer = DirectX11InstanceBuffer<Instance>;
+}
+#elif defined ORBIT_DIRECTX_12
+
+#elif defined ORBIT_OPENGL
+
+#endif
@@ -0,0 +1,167 @@
+#pragma once
+#include "implementation/misc/Bounds.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: handle of a box inserted into a BoundingVolumeTree
+    using ProxyId = int32_t;
+    static constexpr ProxyId sNullProxy = -1;
+
+    // Dynamic bounding volume hierarchy over axis aligned boxes.
+    // Leaves store the inserted box grown by a margin (the "fat" box). Moving a proxy
+    // within its fat box costs nothing, otherwise only the leaf and the ancestors that
+    // no longer contain it are enlarged. Refit() shrinks all nodes to their children
+    // once per frame and rebuilds the tree top down when the enlarged nodes made it
+    // noticeably worse than after the last build. Insert and Remove keep the tree
+    // valid in between, so objects can be added and removed at any time.
+    // @note: Queries are const and can run in parallel, modifications can not
+    class BoundingVolumeTree
+    {
+    private:
+        struct Node
+        {
+            BoundingBox box;
+            int32_t parent = -1;
+            // @member: both children are -1 for leaves
+            int32_t children[2] = { -1, -1 };
+            void* userData = nullptr;
+
+            bool IsLeaf() const { return children[0] < 0; }
+        };
+
+        std::vector<Node> m_nodes;
+        // @member: nodes that can be reused, linked through their parent index
+        int32_t m_freeList = -1;
+        int32_t m_root = -1;
+        uint32_t m_numProxies = 0u;
+        float m_margin;
+        // @member: cost of the tree after the last rebuild, @see Cost()
+        float m_builtCost = 0.f;
+        // @member: scratch buffer of Refit and Rebuild
+        std::vector<int32_t> m_scratch;
+    private:
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Build(int32_t* leaves, uint32_t count, int32_t parent);
+
+        // @brief: visits every leaf whose ancestors and box pass the overlap test.
+        //  The callback returns false to stop the traversal
+        template<typename Overlaps, typename Callback>
+        void Traverse(const Overlaps& overlaps, const Callback& callback) const
+        {
+            if (m_root < 0)
+                return;
+
+            // The tree is rebuilt when it degenerates, but deep trees spill into the heap
+            int32_t stack[64];
+            std::vector<int32_t> spill;
+            auto size = 0u;
+            stack[size++] = m_root;
+            while (size > 0u || !spill.empty())
+            {
+                int32_t node;
+                if (!spill.empty())
+                {
+                    node = spill.back();
+                    spill.pop_back();
+                }
+                else
+                    node = stack[--size];
+
+                const auto& current = m_nodes[node];
+                if (!overlaps(current.box))
+                    continue;
+                if (current.IsLeaf())
+                {
+                    if (!callback(node))
+                        return;
+                    continue;
+                }
+                for (auto child : current.children)
+                {
+                    if (size < 64u)
+                        stack[size++] = child;
+                    else
+                        spill.push_back(child);
+                }
+            }
+        }
+    public:
+        // @member: a rebuild is triggered by Refit() when the cost grew by this factor
+        static constexpr float sRebuildCostRatio = 1.5f;
+
+        // @param margin: the inserted boxes are grown by the margin in every direction
+        explicit BoundingVolumeTree(float margin = 1.f);
+
+        // @method: inserts a box into the tree
+        // @param userData: returned by GetUserData for the proxy
+        // @return: the proxy handle, stays valid until it is removed
+        ProxyId Insert(const BoundingBox& box, void* userData);
+        // @method: removes a proxy, the handle may be reused by the next insertion
+        void Remove(ProxyId proxy);
+        // @method: updates the box of a proxy
+        // @return: true if the box left the fat box of the proxy and the tree changed
+        bool Move(ProxyId proxy, const BoundingBox& box);
+        // @method: shrinks every node to its children in one bottom up pass and
+        //  rebuilds the tree when its cost exceeds sRebuildCostRatio times the built cost
+        void Refit();
+        // @method: builds the tree top down over all proxies with a binned surface
+        //  area heuristic. Use it after inserting many proxies at once
+        void Rebuild();
+        // @method: removes all proxies
+        void Clear();
+
+        // @return: the sum of the surface areas of the inner nodes relative to the root,
+        //  the expected number of nodes a random ray has to visit
+        float Cost() const;
+        // @return: the height of the tree, 0 for an empty tree
+        uint32_t Height() const;
+        uint32_t NumProxies() const { return m_numProxies; }
+
+        void* GetUserData(ProxyId proxy) const { return m_nodes[proxy].userData; }
+        // @return: the box of the proxy including the margin
+        const BoundingBox& GetFatBox(ProxyId proxy) const { return m_nodes[proxy].box; }
+
+        // @method: calls callback(ProxyId) for every proxy whose fat box overlaps the box.
+        //  The traversal stops when the callback returns false
+        template<typename Callback>
+        void QueryBox(const BoundingBox& box, const Callback& callback) const
+        {
+            Traverse([&](const BoundingBox& node) { return node.Intersects(box); }, callback);
+        }
+
+        // @method: calls callback(ProxyId) for every proxy whose fat box overlaps the sphere
+        template<typename Callback>
+        void QuerySphere(const BoundingSphere& sphere, const Callback& callback) const
+        {
+            Traverse([&](const BoundingBox& node) { return node.Intersects(sphere); }, callback);
+        }
+
+        // @method: calls callback(ProxyId) for every proxy whose fat box is (partially) inside of the frustum
+        template<typename Callback>
+        void QueryFrustum(const Frustum& frustum, const Callback& callback) const
+        {
+            Traverse([&](const BoundingBox& node) { return frustum.Intersects(node); }, callback);
+        }
+
+        // @method: calls callback(ProxyId, float entryDistance) for every proxy whose fat box
+        //  is hit by the ray. The callback returns the distance up to which the search
+        //  continues: maxDistance to keep going, the exact hit distance to find the closest
+        //  hit, or a negative value to stop
+        template<typename Callback>
+        void Raycast(const Ray& ray, float maxDistance, const Callback& callback) const
+        {
+            auto distance = 0.f;
+            Traverse([&](const BoundingBox& node) { return ray.Intersects(node, maxDistance, &distance); }, [&](ProxyId proxy) {
+                maxDistance = callback(proxy, distance);
+                return maxDistance >= 0.f;
+            });
+        }
+    };
+
+}
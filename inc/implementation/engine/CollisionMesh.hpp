@@ -0,0 +1,42 @@
+#pragma once
+#include "implementation/engine/CollisionMeshFormat.hpp"
+#include "interfaces/misc/UnLoadable.hpp"
+
+#include <geometry/PxGeometryHelpers.h>
+#include <geometry/PxTriangleMesh.h>
+#include <geometry/PxConvexMesh.h>
+
+#include <vector>
+
+namespace orbit
+{
+
+    using namespace physx;
+
+    // Collision geometry cooked by orbtool, @see CollisionMeshFormat.hpp.
+    // Loaded through the resource manager it is created once per resource id
+    // and shared by every component that references it
+    class CollisionMesh : public UnLoadable
+    {
+    private:
+        CollisionShape m_shape = CollisionShape::TRIANGLE_MESH;
+        PxTriangleMesh* m_triangleMesh = nullptr;
+        // @member: one mesh for CONVEX_MESH, the parts of CONVEX_DECOMPOSITION
+        std::vector<PxConvexMesh*> m_convexMeshes;
+    public:
+        ~CollisionMesh();
+        bool LoadImpl(std::ifstream* stream) override;
+        void UnloadImpl() override;
+
+        // @method: returns the geometry of one shape using this mesh. Bodies
+        //  need one shape per part
+        // @param scale: scaling of the mesh, applied by PhysX without copying the mesh
+        // @param part: index of the part, less than NumParts()
+        PxGeometryHolder GetGeometry(const Vector3f& scale, uint32_t part = 0u) const;
+        uint32_t NumParts() const { return m_triangleMesh ? 1u : static_cast<uint32_t>(m_convexMeshes.size()); }
+        CollisionShape GetShape() const { return m_shape; }
+        // @method: triangle meshes can't be simulated on dynamic bodies
+        bool IsSimulated() const { return m_shape != CollisionShape::TRIANGLE_MESH; }
+    };
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+namespace orbit
+{
+
+    // Payload layout of collision meshes (ResourceType::COLLISION_MESH), shared
+    // by orbtool and the engine. The geometry is cooked by orbtool, the engine
+    // only deserializes it:
+    //  uint32_t       shape (CollisionShape)
+    //  uint32_t       physxVersion (PX_PHYSICS_VERSION of the cooking library)
+    //  uint32_t       numParts (1 unless the shape is CONVEX_DECOMPOSITION)
+    //  numParts times:
+    //      uint64_t   dataSize
+    //      uint8_t    data[dataSize] (the stream written by PxCooking)
+    // Cooked data is only readable by the PhysX version that wrote it.
+
+    enum class CollisionShape : uint32_t
+    {
+        // @note: the triangles of the mesh. Only usable by static, kinematic
+        //  or scene query shapes
+        TRIANGLE_MESH = 0,
+        // @note: the convex hull of the mesh (at most 255 vertices)
+        CONVEX_MESH   = 1,
+        // @note: a compound of convex hulls approximating the mesh, every
+        //  part is a convex mesh
+        CONVEX_DECOMPOSITION = 2
+    };
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "interfaces/engine/GameComponent.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: a registered component and the object it belongs to
+    template<typename Component>
+    struct ComponentEntry
+    {
+        Component* component;
+        GameObject* object;
+    };
+
+    // Flat arrays of the components of all objects in a scene, one per
+    // component flag. The scene iterates them instead of visiting every
+    // object and its component map. Objects register their components when
+    // they are added to a scene and whenever a component is added or removed.
+    // @note: Components must not be added or removed while the scene updates
+    //  objects in parallel
+    class ComponentRegistry
+    {
+    private:
+        std::vector<ComponentEntry<Renderable>> m_renderables;
+        std::vector<ComponentEntry<Updatable>> m_updatables;
+        std::vector<ComponentEntry<Physically>> m_physicals;
+    public:
+        // @method: adds the component to the arrays of its flags
+        void Register(GameObject* object, IComponent* component);
+        // @method: removes the component from all arrays, keeping the order of the others
+        void Unregister(IComponent* component);
+
+        const std::vector<ComponentEntry<Renderable>>& Renderables() const { return m_renderables; }
+        const std::vector<ComponentEntry<Updatable>>& Updatables() const { return m_updatables; }
+        const std::vector<ComponentEntry<Physically>>& Physicals() const { return m_physicals; }
+    };
+
+}
@@ -0,0 +1,249 @@
+#pragma once
+#include "interfaces/engine/GameComponent.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace orbit
+{
+
+    using ComponentType = uint32_t;
+
+    // @brief: handle of an entity in an EntityRegistry. The generation tells
+    //  destroyed entities apart from newer ones reusing their index
+    struct Entity
+    {
+        uint32_t index = ~0u;
+        uint32_t generation = 0u;
+
+        bool IsValid() const { return index != ~0u; }
+        bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const Entity& other) const { return !(*this == other); }
+    };
+
+    // @brief: how the registry moves and destroys components of a type it only knows by id
+    struct ComponentTypeInfo
+    {
+        size_t size;
+        size_t alignment;
+        // @member: move constructs *src into the uninitialized dst
+        void (*moveConstruct)(void* dst, void* src);
+        void (*destroy)(void* component);
+    };
+
+    // @method: registers a component type, @see ComponentTypeOf
+    ComponentType RegisterComponentType(const ComponentTypeInfo& info);
+    // @method: returns the info of a registered component type
+    const ComponentTypeInfo& GetComponentTypeInfo(ComponentType type);
+
+    // @method: returns the id of a component type. Any movable type can be a component
+    template<typename Component>
+    ComponentType ComponentTypeOf()
+    {
+        static_assert(std::is_move_constructible_v<Component>, "Components have to be movable");
+        static const ComponentType type = RegisterComponentType(ComponentTypeInfo{
+            sizeof(Component),
+            alignof(Component),
+            [](void* dst, void* src) { new (dst) Component(std::move(*static_cast<Component*>(src))); },
+            [](void* component) { static_cast<Component*>(component)->~Component(); }
+        });
+        return type;
+    }
+
+    // Contiguous, type erased array of one component type
+    class ComponentColumn
+    {
+    private:
+        const ComponentTypeInfo* m_info;
+        uint8_t* m_data = nullptr;
+        size_t m_size = 0u;
+        size_t m_capacity = 0u;
+    public:
+        explicit ComponentColumn(ComponentType type);
+        ComponentColumn(ComponentColumn&& other) noexcept;
+        ComponentColumn(const ComponentColumn&) = delete;
+        ~ComponentColumn();
+
+        void* At(size_t row) const { return m_data + row * m_info->size; }
+        void* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+
+        // @method: moves the element into an uninitialized element at the end
+        void PushMoved(void* component);
+        // @method: destroys the element, the last one takes its place
+        void SwapRemove(size_t row);
+    };
+
+    // All entities with exactly the same set of components. Every component
+    // type is one column, the components of an entity share their row
+    struct Archetype
+    {
+        // @member: sorted component types
+        std::vector<ComponentType> signature;
+        std::vector<ComponentColumn> columns;
+        std::vector<Entity> entities;
+        // @member: archetype reached by adding or removing a component type
+        std::unordered_map<ComponentType, uint32_t> addEdges;
+        std::unordered_map<ComponentType, uint32_t> removeEdges;
+
+        // @return: the column of the type or -1
+        int32_t FindColumn(ComponentType type) const
+        {
+            auto it = std::lower_bound(signature.begin(), signature.end(), type);
+            return it != signature.end() && *it == type ? static_cast<int32_t>(it - signature.begin()) : -1;
+        }
+    };
+
+    // Bridge for the components of GameObjects: hosted components are updated
+    // by the scene like the ones of objects, @see EntityRegistry::HostComponent
+    struct HostedRenderable { std::shared_ptr<Renderable> component; };
+    struct HostedUpdatable  { std::shared_ptr<Updatable> component; };
+    struct HostedPhysically { std::shared_ptr<Physically> component; };
+
+    // Archetype based entity storage. Entities with the same component types
+    // are stored together and every component type is a contiguous column,
+    // so systems iterate plain arrays instead of visiting objects.
+    // Adding or removing a component moves the entity to another archetype.
+    // @note: Entities and components must not be created, added or removed
+    //  while the registry is iterated
+    class EntityRegistry
+    {
+    private:
+        struct EntityRecord
+        {
+            uint32_t archetype;
+            uint32_t row;
+            uint32_t generation;
+        };
+
+        std::vector<Archetype> m_archetypes;
+        std::map<std::vector<ComponentType>, uint32_t> m_archetypeLookup;
+        std::vector<EntityRecord> m_records;
+        std::vector<uint32_t> m_freeIndices;
+        size_t m_numEntities = 0u;
+    private:
+        uint32_t GetArchetype(const std::vector<ComponentType>& signature);
+        uint32_t AddEdge(uint32_t archetype, ComponentType type);
+        uint32_t RemoveEdge(uint32_t archetype, ComponentType type);
+        // @method: moves the entity into the other archetype. Components the target
+        //  doesn't have are destroyed, new columns are left for the caller to fill
+        void MoveEntity(Entity entity, uint32_t target);
+        // @method: removes the row from the archetype and fixes the moved entity's record
+        void RemoveRow(uint32_t archetype, uint32_t row);
+        const EntityRecord* FindRecord(Entity entity) const;
+
+        template<typename...Components, typename Function, size_t...I>
+        void EachChunkImpl(Function& function, std::index_sequence<I...>)
+        {
+            const ComponentType types[] = { ComponentTypeOf<Components>()... };
+            for (auto& archetype : m_archetypes)
+            {
+                if (archetype.entities.empty())
+                    continue;
+                int32_t columns[sizeof...(Components)];
+                auto matches = true;
+                for (auto i = 0u; i < sizeof...(Components) && matches; ++i)
+                    matches = (columns[i] = archetype.FindColumn(types[i])) >= 0;
+                if (matches)
+                    function(archetype.entities.size(), archetype.entities.data(),
+                        static_cast<Components*>(archetype.columns[columns[I]].Data())...);
+            }
+        }
+    public:
+        EntityRegistry();
+        ~EntityRegistry();
+
+        // @method: creates an entity without components
+        Entity Create();
+        // @method: destroys the entity and all of its components
+        void Destroy(Entity entity);
+        bool IsAlive(Entity entity) const { return FindRecord(entity) != nullptr; }
+        size_t NumEntities() const { return m_numEntities; }
+        size_t NumArchetypes() const { return m_archetypes.size(); }
+
+        // @method: adds a component or replaces the existing one of the same type
+        // @return: the component, valid until the next structural change
+        template<typename Component, typename...Params>
+        Component& Add(Entity entity, Params&&...params)
+        {
+            const auto type = ComponentTypeOf<Component>();
+            Component component{ std::forward<Params>(params)... };
+            if (auto existing = Get<Component>(entity))
+            {
+                existing->~Component();
+                return *new (existing) Component(std::move(component));
+            }
+
+            const auto record = FindRecord(entity);
+            if (!record)
+                ORBIT_THROW("Adding a component to a destroyed entity");
+            MoveEntity(entity, AddEdge(record->archetype, type));
+
+            const auto& moved = m_records[entity.index];
+            auto& column = m_archetypes[moved.archetype].columns[m_archetypes[moved.archetype].FindColumn(type)];
+            column.PushMoved(&component);
+            return *static_cast<Component*>(column.At(moved.row));
+        }
+        // @method: removes a component, does nothing if the entity doesn't have one
+        template<typename Component>
+        void Remove(Entity entity)
+        {
+            const auto record = FindRecord(entity);
+            if (record && m_archetypes[record->archetype].FindColumn(ComponentTypeOf<Component>()) >= 0)
+                MoveEntity(entity, RemoveEdge(record->archetype, ComponentTypeOf<Component>()));
+        }
+        // @return: the component or nullptr, valid until the next structural change
+        template<typename Component>
+        Component* Get(Entity entity) const
+        {
+            const auto record = FindRecord(entity);
+            if (!record)
+                return nullptr;
+            const auto& archetype = m_archetypes[record->archetype];
+            const auto column = archetype.FindColumn(ComponentTypeOf<Component>());
+            return column >= 0 ? static_cast<Component*>(archetype.columns[column].At(record->row)) : nullptr;
+        }
+        template<typename Component>
+        bool Has(Entity entity) const { return Get<Component>(entity) != nullptr; }
+
+        // @method: calls function(count, entities, components...) once per archetype
+        //  that has all the components. The components are arrays of count elements
+        template<typename...Components, typename Function>
+        void EachChunk(Function&& function)
+        {
+            EachChunkImpl<Components...>(function, std::index_sequence_for<Components...>{});
+        }
+        // @method: calls function(entity, components&...) for every entity that has all the components
+        template<typename...Components, typename Function>
+        void Each(Function&& function)
+        {
+            EachChunk<Components...>([&](size_t count, const Entity* entities, Components*...components) {
+                for (size_t i = 0u; i < count; ++i)
+                    function(entities[i], components[i]...);
+            });
+        }
+
+        // @method: hosts an existing component. It is added as HostedRenderable,
+        //  HostedUpdatable and/or HostedPhysically depending on its flags, so an
+        //  entity can host one component of each kind
+        void HostComponent(Entity entity, std::shared_ptr<IComponent> component);
+        // @method: creates a component like GameObject::AddComponent and hosts it.
+        //  Hosted components don't belong to a GameObject
+        template<typename Component, typename...Params>
+        std::shared_ptr<Component> AddHosted(Entity entity, Params...params)
+        {
+            auto component = std::make_shared<Component>(nullptr, params...);
+            HostComponent(entity, component);
+            return component;
+        }
+    };
+
+}
@@ -2,6 +2,7 @@
 #include "implementation/misc/Time.hpp"
 #include "interfaces/misc/UnLoadable.hpp"
 #include "interfaces/engine/GameComponent.hpp"
+#include "implementation/engine/ComponentRegistry.hpp"
 
 #include <unordered_map>
 #include <memory>
@@ -16,23 +17,32 @@ namespace orbit
     {
     protected:
         friend class EngineBase;
+        friend class ISceneBase;
         // @member: identifier in the scene
         std::string m_identifier;
         // @member: true if this object is active
         bool m_isActive = true;
+        // @member: true if Update and PhysicsUpdate have to run on the main thread
+        bool m_updateOnMainThread = false;
         // @member: set of components of this game object
         std::unordered_map<std::string, std::shared_ptr<IComponent>> m_components;
-        //<-- Maybe cache components of certain types (updatable, physically and renderable)
-        //<-- so that they can be accessed faster when needed
+        // @member: component registry of the scene this object is in, nullptr outside of scenes
+        ComponentRegistry* m_registry = nullptr;
+    protected:
+        // @method: registers all components with the scene's registry (nullptr to unregister)
+        // @internal
+        void SetRegistry(ComponentRegistry* registry);
     public:
-        virtual ~GameObject() {}
-        // @method: called once per frame to perform update calculations
+        virtual ~GameObject();
+        // @method: called once per frame to perform update calculations. In a scene
+        //  the components are updated by the scene before, otherwise by this method
         // @param dt: time elapsed since the frame began
         virtual void Update(const Time& dt);
-        // @method: Make updates that depend on physics here. 
+        // @method: Make updates that depend on physics here. Components are updated
+        //  like in Update
         // @param millis: milliseconds elapsed since the physics update began
         virtual void PhysicsUpdate(size_t millis);
-        // @method: Draws this object to the screen
+        // @method: Draws this object to the screen. Components are drawn like in Update
         virtual void Draw() const;
         // @method: initializes an object
         virtual void Init() {}
@@ -42,6 +52,12 @@ namespace orbit
         // @method: Updates the active state of this object
         // @param activeState: the new active state of the object (true means the object is active)
         void Activate(bool activeState = true) { m_isActive = activeState; }
+        // @method: Returns true if this object is updated on the main thread
+        bool IsUpdatedOnMainThread() const { return m_updateOnMainThread; }
+        // @method: Objects are updated in parallel by the job system. Objects that call
+        //  APIs which are not thread safe (the window, PhysX writes) have to opt out
+        // @param mainThread: true to update this object on the main thread
+        void UpdateOnMainThread(bool mainThread = true) { m_updateOnMainThread = mainThread; }
 
         // @method: Sets the objects identifier
         // @param identifier: The object's identifier
@@ -53,9 +69,13 @@ namespace orbit
         std::shared_ptr<Component> AddComponent(const std::string& identifier, Params...params)
         {
             auto com = std::make_shared<Component>(this, params...);
-            m_components.emplace(identifier, com);
+            if (m_components.emplace(identifier, com).second && m_registry)
+                m_registry->Register(this, com.get());
             return com;
         }
+        // @method: Removes a component by its identifier
+        // @return: the removed component or nullptr
+        std::shared_ptr<IComponent> RemoveComponent(const std::string& identifier);
         // @method: Returns a component by its identifier
         // @return: nullptr if the component is not of type <Component> or
         //  if the identifier does not belong to any known component
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: tracks the unfinished jobs of one ParallelFor, @see JobSystem::WaitForJobs
+    class JobCounter
+    {
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> m_pending{ 0u };
+        std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    public:
+        bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0u; }
+    };
+
+    // @brief: profiling counters of the job system, summed over all workers
+    struct JobStats
+    {
+        // @member: number of ranges executed (every split creates one)
+        uint64_t jobs = 0u;
+        // @member: number of jobs taken from the deque of another worker
+        uint64_t steals = 0u;
+        // @member: number of steal attempts that found every other deque empty
+        uint64_t failedSteals = 0u;
+        // @member: time the workers spent waiting for work
+        uint64_t idleMicroseconds = 0u;
+    };
+
+    // Work stealing job system. Every worker owns a deque, it pushes and pops
+    // jobs at the back while idle workers steal from the front, so they take
+    // the largest ranges. The thread that starts the workers is worker 0 and
+    // helps executing jobs while it waits for them.
+    // Ranges are split lazily: a worker only splits off the upper half of its
+    // range when its own deque is empty, i.e. when all previously split work
+    // has been stolen. The number of jobs adapts to the number of idle
+    // workers instead of being fixed up front
+    class JobSystem
+    {
+    private:
+        struct Job
+        {
+            void (*function)(const void* context, size_t begin, size_t end);
+            const void* context;
+            size_t begin;
+            size_t end;
+            // @member: the range is not split below this size
+            size_t grain;
+            JobCounter* counter;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+            std::atomic<uint32_t> nextVictim{ 0u };
+            std::atomic<uint64_t> executed{ 0u };
+            std::atomic<uint64_t> steals{ 0u };
+            std::atomic<uint64_t> failedSteals{ 0u };
+            std::atomic<uint64_t> idleMicroseconds{ 0u };
+        };
+
+        // @member: number of failed steal rounds before a worker goes to sleep
+        static constexpr uint32_t sSpinsBeforeSleep = 64u;
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<bool> m_running{ false };
+        // @member: number of jobs in all deques, sleeping workers wait for it to be non zero
+        std::atomic<uint32_t> m_queuedJobs{ 0u };
+        std::atomic<uint32_t> m_sleepingWorkers{ 0u };
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeCondition;
+    private:
+        // @method: index of the calling thread's worker, threads that are not
+        //  workers share the deque of worker 0
+        uint32_t CurrentWorker() const;
+        void Push(uint32_t worker, const Job& job);
+        bool Pop(uint32_t worker, Job* job);
+        bool Steal(uint32_t worker, Job* job);
+        // @method: runs a job, splitting it while other workers are hungry
+        void Execute(uint32_t worker, Job job);
+        void WorkerLoop(uint32_t worker);
+
+        template<typename Function>
+        static void Invoke(const void* context, size_t begin, size_t end)
+        {
+            (*static_cast<const Function*>(context))(begin, end);
+        }
+    public:
+        JobSystem() = default;
+        virtual ~JobSystem();
+
+        // @method: starts the worker threads, the calling thread becomes worker 0
+        // @param numWorkers: total number of workers including the calling thread.
+        //  With one worker every job runs on the caller
+        void StartJobWorkers(uint32_t numWorkers);
+        // @method: stops and joins the worker threads
+        void StopJobWorkers();
+        uint32_t NumJobWorkers() const { return static_cast<uint32_t>(m_threads.size()) + 1u; }
+
+        // @method: calls function(begin, end) for disjoint ranges covering [0, count)
+        //  and returns when all of them are done. The caller executes jobs meanwhile
+        // @param grain: ranges are not split below this number of elements
+        // @note: exceptions thrown by the function are rethrown on the caller
+        template<typename Function>
+        void ParallelFor(size_t count, size_t grain, const Function& function)
+        {
+            if (count == 0u)
+                return;
+            if (m_threads.empty() || count <= grain)
+            {
+                function(size_t(0u), count);
+                return;
+            }
+
+            JobCounter counter;
+            counter.m_pending.store(1u, std::memory_order_relaxed);
+            Push(CurrentWorker(), Job{ &Invoke<Function>, &function, 0u, count, std::max(grain, size_t(1u)), &counter });
+            WaitForJobs(counter);
+        }
+        // @method: ParallelFor with a grain that leaves a few ranges per worker
+        template<typename Function>
+        void ParallelFor(size_t count, const Function& function)
+        {
+            ParallelFor(count, std::max(size_t(1u), count / (8u * NumJobWorkers())), function);
+        }
+        // @method: executes jobs until every job of the counter is finished
+        void WaitForJobs(JobCounter& counter);
+
+        // @method: returns the profiling counters since the last reset
+        JobStats GetJobStats() const;
+        void ResetJobStats();
+    };
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <map>
+
+namespace orbit
+{
+
+    // Best fit allocator for ranges of a buffer that it does not own, e.g. vertices
+    // of a large vertex buffer. The free blocks are kept like in AllocatorPage: one map
+    // by offset to merge neighbours when a range is freed and one by size to find the
+    // smallest block that fits. Sizes and offsets are in elements, not bytes
+    // @note: not thread safe
+    class RangeAllocator
+    {
+    private:
+        using OffsetType = size_t;
+        using SizeType = size_t;
+        struct FreeBlockInfo;
+        using FreeListByOffset = std::map<OffsetType, FreeBlockInfo>;
+        using FreeListBySize = std::multimap<SizeType, FreeListByOffset::iterator>;
+
+        struct FreeBlockInfo
+        {
+            FreeBlockInfo(SizeType size)
+                : size(size)
+            {}
+
+            SizeType size;
+            FreeListBySize::iterator freeListBySizeIt;
+        };
+
+        FreeListByOffset m_freeListByOffset;
+        FreeListBySize m_freeListBySize;
+        SizeType m_size = 0u;
+        SizeType m_numFree = 0u;
+    private:
+        void AddNewBlock(OffsetType offset, SizeType size);
+    public:
+        static constexpr OffsetType sInvalidOffset = ~OffsetType(0);
+
+        explicit RangeAllocator(SizeType size = 0u);
+
+        // @method: finds the smallest free block that can hold the range
+        // @return: the offset of the range, sInvalidOffset if no block is large enough
+        OffsetType Allocate(SizeType size);
+        // @method: returns a range, merging it with the free blocks next to it
+        void Free(OffsetType offset, SizeType size);
+        // @method: appends free space at the end, the buffer has to grow accordingly
+        void Grow(SizeType size);
+
+        SizeType Size() const { return m_size; }
+        SizeType NumFree() const { return m_numFree; }
+    };
+
+}
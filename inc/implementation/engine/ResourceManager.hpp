@@ -17,8 +17,10 @@
 #include "interfaces/misc/UnLoadable.hpp"
 
 #include <istream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace orbit
 {
@@ -33,14 +35,23 @@ namespace orbit
         {
             size_t       fileIndex;
             size_t       offset;
+            size_t       payloadSize;
             ResourceType type;
         };
         std::vector<fs::path> m_parsedFiles;
         std::unordered_map<ResourceId, Index> m_index;
         std::unordered_map<std::string, ResourceId> m_resourceNames;
         std::unordered_map<ResourceId, SPtr<UnLoadable>> m_resources;
+        // @member: resources are loaded from the job workers too. Recursive, since loading
+        //  a resource loads its dependencies and falls back to the default resources
+        mutable std::recursive_mutex m_resourceMutex;
         static constexpr Version sVersion = Version{ 0, 0, 1 };
         mutable ResourceId m_currentId = 1u;
+        // @member: ids in the order their payloads were read first, see RMBeginLoadTrace()
+        mutable std::vector<ResourceId> m_loadTrace;
+        mutable std::unordered_set<ResourceId> m_tracedIds;
+        bool m_traceLoads = false;
+        mutable std::mutex m_traceMutex;
     protected:
         void                  RMInit();
     public:
@@ -48,11 +59,19 @@ namespace orbit
         ResourceId            RMGetIdFromName(const std::string& name) const;
         bool                  RMParseFile(const fs::path& path);
         bool                  RMGetStream(ResourceId id, std::ifstream* stream) const;
+        size_t                RMGetPayloadSize(ResourceId id) const;
         bool                  RMRegisterResourceName(const std::string& name, ResourceId id);
         ResourceType          RMGetResourceType(ResourceId id) const;
+        // @method: starts recording the order in which resource payloads are read
+        void                  RMBeginLoadTrace();
+        // @method: writes the names of the resources read since RMBeginLoadTrace() in
+        //  first-use order, one per line. Pass it to 'orbtool -layout' to store the
+        //  payloads of a pack in that order
+        bool                  RMWriteLoadTrace(const fs::path& path) const;
         template<typename ResourceType>
         SPtr<ResourceType> RMLoadResource(ResourceId id)
         {
+            std::lock_guard<std::recursive_mutex> lock(m_resourceMutex);
             auto rIt = m_resources.find(id);
             if (rIt == m_resources.end()) {
                 auto it = m_index.find(id);
@@ -18,9 +18,16 @@ namespace orbit
         RASTERIZER_STATE     = 9,
         BLEND_STATE          = 10,
         SAMPLER_STATE        = 11,
+        SKELETON             = 12,
+        ANIMATION_CLIP       = 13,
+        COLLISION_MESH       = 14,
 
         CUSTOM               = 1 << 7,
 
+        // Alignment filler between two resources. It has no name, isn't
+        // assigned an id and its payload is skipped
+        PADDING              = 254,
+
         UNDEFINED            = 255
     };
 
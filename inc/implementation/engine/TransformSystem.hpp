@@ -0,0 +1,126 @@
+#pragma once
+#include "implementation/misc/TransformMatrices.hpp"
+
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace orbit
+{
+
+    using namespace Eigen;
+
+    // @brief: handle of a transform in the TransformSystem, stays valid until it is released
+    using TransformHandle = uint32_t;
+    static constexpr TransformHandle sNullTransform = std::numeric_limits<TransformHandle>::max();
+
+    // Stores all transforms of the engine. The local parts and the cached matrices live
+    // in slots, every parent is stored in a lower slot than its children. Changing a
+    // transform marks it and all of its descendants dirty, Update() then recomputes the
+    // local matrices of the dirty slots and combines them with their parents' world
+    // matrices in one pass over the slots. Reading a dirty transform in between only
+    // recomputes it and its dirty ancestors.
+    // Handles index the hierarchy links and map to the slots, which move when a
+    // transform is attached to a parent in a higher slot.
+    // @note: Every method locks the system, transforms can be changed and read from
+    //  the parallel updates of the scene. Reading a dirty transform writes the cached
+    //  matrices of its dirty ancestors and changing one marks its descendants, both
+    //  touch transforms of other threads. The world parts are returned by value as
+    //  the slots can move or reallocate whenever another thread creates a transform
+    class TransformSystem
+    {
+    private:
+        static constexpr uint32_t sNullSlot = std::numeric_limits<uint32_t>::max();
+
+        // @member: per slot data, free slots have no handle and are never dirty
+        TransformArrays m_local;
+        std::vector<Matrix4f> m_localMatrices;
+        // @member: the transposed local to world matrices
+        std::vector<Matrix4f> m_worldMatrices;
+        std::vector<Quaternionf> m_worldRotations;
+        std::vector<Vector3f> m_worldScalings;
+        std::vector<uint32_t> m_parentSlots;
+        std::vector<TransformHandle> m_handles;
+        std::vector<uint8_t> m_dirty;
+        std::vector<uint32_t> m_freeSlots;
+        // @member: per handle data
+        std::vector<uint32_t> m_slots;
+        std::vector<TransformHandle> m_parents;
+        std::vector<TransformHandle> m_firstChildren;
+        std::vector<TransformHandle> m_nextSiblings;
+        std::vector<TransformHandle> m_freeHandles;
+        // @member: scratch buffer of the hierarchy traversals
+        std::vector<TransformHandle> m_scratch;
+        uint32_t m_numTransforms = 0u;
+        mutable std::mutex m_mutex;
+    private:
+        TransformSystem() = default;
+
+        // The private methods expect the mutex to be held
+
+        uint32_t AppendSlot();
+        void FreeSlot(uint32_t slot);
+        void Link(TransformHandle handle, TransformHandle parent);
+        void Unlink(TransformHandle handle);
+        // @method: moves a transform and its descendants behind all used slots
+        void Relocate(TransformHandle handle);
+        // @method: removes the free slots, Update() calls it when most slots are free
+        void Compact();
+        // @method: marks a transform and all of its descendants dirty
+        void MarkDirty(TransformHandle handle);
+        void ComputeLocalMatrix(uint32_t slot);
+        void ComputeWorld(uint32_t slot);
+        // @method: recomputes a dirty slot and its dirty ancestors
+        void UpdateChain(uint32_t slot);
+        uint32_t CleanSlot(TransformHandle handle)
+        {
+            const auto slot = m_slots[handle];
+            if (m_dirty[slot])
+                UpdateChain(slot);
+            return slot;
+        }
+    public:
+        // @method: the system is never destroyed, transforms can be released during shutdown
+        static TransformSystem& Get()
+        {
+            static auto* sSystem = new TransformSystem();
+            return *sSystem;
+        }
+
+        // @method: adds an identity transform without a parent
+        TransformHandle Create();
+        // @method: removes a transform, its children are detached
+        void Release(TransformHandle handle);
+        // @method: attaches a transform to a parent
+        // @param parent: the new parent, sNullTransform to detach the transform
+        // @return: false if the parent is the transform itself or one of its descendants
+        bool SetParent(TransformHandle handle, TransformHandle parent);
+        // @method: recomputes the matrices of all dirty transforms, once per frame
+        void Update();
+
+        Vector3f GetLocation(TransformHandle handle) const;
+        Quaternionf GetRotation(TransformHandle handle) const;
+        Vector3f GetScaling(TransformHandle handle) const;
+        Vector3f GetPivot(TransformHandle handle) const;
+        void SetLocation(TransformHandle handle, const Vector3f& location);
+        void SetRotation(TransformHandle handle, const Quaternionf& rotation);
+        void SetScaling(TransformHandle handle, const Vector3f& scaling);
+        void SetPivot(TransformHandle handle, const Vector3f& pivot);
+
+        // @return: the transposed local to world matrix
+        Matrix4f GetWorldMatrix(TransformHandle handle);
+        // @return: the rotation of the transform and all of its parents
+        Quaternionf GetWorldRotation(TransformHandle handle);
+        // @return: the scaling of the transform and all of its parents
+        Vector3f GetWorldScaling(TransformHandle handle);
+        // @return: the location of the transform in the space of the world
+        Vector3f GetWorldLocation(TransformHandle handle);
+
+        TransformHandle GetParent(TransformHandle handle) const;
+        bool IsDirty(TransformHandle handle) const;
+        uint32_t NumTransforms() const;
+        // @return: the number of slots including the free ones
+        uint32_t NumSlots() const;
+    };
+
+}
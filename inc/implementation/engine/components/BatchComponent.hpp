@@ -1,4 +1,7 @@
 #pragma once
+#include "implementation/backends/impl/InstanceBufferImpl.hpp"
+#include "implementation/engine/BoundingVolumeTree.hpp"
+#include "implementation/misc/FrustumCulling.hpp"
 #include "implementation/misc/Transform.hpp"
 #include "implementation/rendering/Mesh.hpp"
 #include "implementation/rendering/Vertex.hpp"
@@ -14,9 +17,51 @@ namespace orbit
     protected:
         SPtr<Mesh<Vertex>> m_mesh;
         std::vector<TransformPtr> m_transforms;
+        // @member: level of detail each instance was drawn with in the last frame
+        mutable std::vector<uint32_t> m_instanceLods;
+        // @member: number of instances per level of detail
+        mutable std::vector<uint32_t> m_lodInstanceCounts;
+        // @member: instance transforms of the last frame, they are drawn after Draw returns
+        mutable InstanceBuffer<Matrix4f> m_instanceBuffer;
+        // @member: world space bounds of the instances in the last frame
+        mutable BoundingSphereArrays m_instanceBounds;
+        // @member: indices of the instances inside of the view frustum, in ascending order
+        mutable std::vector<uint32_t> m_visibleInstances;
+        mutable std::vector<uint32_t> m_previousVisibleInstances;
+        // @member: the spatial index of the scene the instances are registered in
+        mutable std::weak_ptr<BoundingVolumeTree> m_spatialIndex;
+        // @member: one proxy per instance, the user data is the instance's Transform
+        mutable std::vector<ProxyId> m_proxies;
+    protected:
+        // @method: calculates the world space bounds of every instance and moves
+        //  their proxies in the spatial index of the current scene
+        void UpdateBounds() const;
+        // @method: removes the proxies from the spatial index they are registered in
+        void RemoveProxies() const;
+        // @method: culls the instances against the camera's frustum and selects the
+        //  level of detail of the visible ones based on their projected size
+        // @return: true if the visible instances or the lod of any of them changed
+        bool SelectInstances() const;
+        // @method: writes the transforms of the visible instances into the buffer, grouped by their lod
+        void FillInstanceBuffer(InstanceBuffer<Matrix4f>& buffer) const;
+        // @method: issues one instanced draw call per level of detail
+        void DrawLods() const;
+        // @method: draws the full resolution instances one by one with cluster culling
+        // @param numInstances: number of instances using lod 0 (the first in the instance buffer)
+        void DrawClusters(uint32_t numInstances) const;
     public:
+        // @member: cluster culling is only worth the extra draw calls for a few (large) instances
+        static constexpr uint32_t sMaxClusterCulledInstances = 4u;
+
         BatchComponent(GameObject* object, ResourceId meshId);
+        ~BatchComponent();
         TransformPtr AddTransform(TransformPtr transform);
+        // @method: removes an instance, the last instance takes its place
+        // @return: false if the transform is not part of the batch
+        // @note: changes the scene's spatial index, only call it from objects that are
+        //  updated on the main thread, @see GameObject::UpdateOnMainThread
+        bool RemoveTransform(const TransformPtr& transform);
+        uint32_t NumTransforms() const { return static_cast<uint32_t>(m_transforms.size()); }
         virtual void Draw() const override;
         SPtr<Mesh<Vertex>> GetMesh() const { return m_mesh; }
         void SetMesh(SPtr<Mesh<Vertex>> mesh) { m_mesh = mesh; }
@@ -2,6 +2,7 @@
 #include "interfaces/engine/GameComponent.hpp"
 #include "implementation/rendering/Mesh.hpp"
 #include "implementation/rendering/Vertex.hpp"
+#include "implementation/engine/CollisionMesh.hpp"
 
 #include <PxActor.h>
 #include <PxShape.h>
@@ -9,6 +10,7 @@
 #include <PxRigidDynamic.h>
 
 #include <unordered_map>
+#include <vector>
 #include <memory>
 
 namespace orbit
@@ -21,11 +23,15 @@ namespace orbit
     private:
         std::unordered_map<unsigned, std::unique_ptr<PxRigidDynamic, PxDelete<PxRigidDynamic>>> m_bodies;
         std::unordered_map<unsigned, std::shared_ptr<Transform>> m_transforms;
-        PxTriangleMeshGeometry m_geometry;
-        std::unique_ptr<PxShape, PxDelete<PxShape>> m_shape;
+        // @member: one shape per part of the collision mesh, shared by all bodies
+        std::vector<std::unique_ptr<PxShape, PxDelete<PxShape>>> m_shapes;
 
+        // @member: the collision mesh cooked by orbtool, otherwise the mesh is cooked at runtime
+        std::shared_ptr<CollisionMesh> m_collisionMesh;
         std::shared_ptr<Mesh<Vertex>> m_mesh;
         unsigned m_nextId;
+    private:
+        void CreateShape(PxMaterial& material, const PxGeometry& geometry);
     public:
         RigidDynamicComponent(GameObject* boundObject, ResourceId meshId);
         ~RigidDynamicComponent();
@@ -33,7 +39,7 @@ namespace orbit
         virtual void Update(size_t millis) override;
         // @brief: Creates a new rigid static component
         // @param boundObject: the object that is referenced by this component
-        // @param mesh: the mesh for this rigid static body
+        // @param meshId: a collision mesh, or a mesh that is cooked when the body is created
         static std::shared_ptr<RigidDynamicComponent> create(GameObject* boundObject, ResourceId meshId);
 
         void CookBody(MaterialProperties material_p, Vector3f meshScale, size_t vertexPositionOffset);
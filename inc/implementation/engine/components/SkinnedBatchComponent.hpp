@@ -0,0 +1,71 @@
+#pragma once
+#include "implementation/misc/Transform.hpp"
+#include "implementation/rendering/AnimationClip.hpp"
+#include "implementation/rendering/Mesh.hpp"
+#include "implementation/rendering/Skeleton.hpp"
+#include "implementation/rendering/Vertex.hpp"
+#include "interfaces/engine/GameComponent.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // Draws many instances of a skinned mesh, each playing its own clip.
+    // Vertices are skinned on the CPU, instances are split into jobs of at
+    // least sInstancesPerJob that run on the engine's job workers.
+    // The instances are skinned straight into world space and share one vertex
+    // buffer, so a frame uploads it once and draws every submesh of the batch once
+    class SkinnedBatchComponent : public Renderable
+    {
+    protected:
+        // @brief: binds the indices and the skinned vertices of all instances
+        struct BatchGeometry : public IBindable<>
+        {
+            const IndexBuffer* indices = nullptr;
+            const VertexBuffer<Vertex>* vertices = nullptr;
+            void Bind() const override;
+        };
+        struct Instance
+        {
+            TransformPtr transform;
+            SPtr<AnimationClip> clip;
+            // @member: playback speed and start time (in seconds) of the clip
+            float speed;
+            float offset;
+        };
+        SPtr<Mesh<Vertex>> m_mesh;
+        SPtr<Skeleton> m_skeleton;
+        std::vector<Instance> m_instances;
+        // @member: the world space vertices of all instances, instance i starts at i * NumVertices() of the mesh
+        mutable VertexBuffer<Vertex> m_vertices;
+        // @member: the indices of every submesh repeated for all instances, @see BuildBatch()
+        mutable IndexBuffer m_indices;
+        mutable std::vector<Submesh> m_submeshes;
+        mutable BatchGeometry m_geometry;
+        // @member: the number of instances the buffers were built for
+        mutable size_t m_batchSize = 0u;
+        // @member: a single identity transform, the vertices are already in world space
+        mutable VertexBuffer<Matrix4f> m_transformBuffer;
+        mutable std::vector<Matrix4f> m_worldMatrices;
+        Clock m_clock;
+    protected:
+        // @method: resizes the vertices and rebuilds the indices after instances were added
+        // @return: whether the buffers were rebuilt and the vertices have to be uploaded as a whole
+        bool BuildBatch() const;
+        // @method: samples the clips and skins the vertices of all instances into world space
+        void SkinInstances() const;
+    public:
+        // @member: fewest instances skinned by one job. The instances of a job share their scratch buffers
+        static constexpr uint32_t sInstancesPerJob = 16u;
+
+        SkinnedBatchComponent(GameObject* object, ResourceId meshId);
+        // @method: adds an instance playing a clip in a loop
+        // @param clipId: an animation clip of the mesh's skeleton
+        TransformPtr AddInstance(TransformPtr transform, ResourceId clipId, float speed = 1.f, float offset = 0.f);
+        virtual void Draw() const override;
+        SPtr<Mesh<Vertex>> GetMesh() const { return m_mesh; }
+        SPtr<Skeleton> GetSkeleton() const { return m_skeleton; }
+    };
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "implementation/misc/Spline.hpp"
+#include "implementation/misc/Transform.hpp"
+#include "interfaces/engine/GameComponent.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // Moves transforms along a spline at constant speed, e.g. a camera on a
+    // rail or the asteroids of a lane. All followers are evaluated in one
+    // batch per update, split into jobs of at least sFollowersPerJob that run on
+    // the engine's job workers
+    class SplineFollowerComponent : public Updatable
+    {
+    protected:
+        SPtr<Spline> m_spline;
+        // @member: per follower data, stored by field so the batch evaluation reads it linearly
+        std::vector<TransformPtr> m_transforms;
+        std::vector<float> m_distances;
+        std::vector<float> m_speeds;
+        std::vector<Vector3f> m_offsets;
+        // @member: scratch buffers of the batch evaluation
+        std::vector<Vector3f> m_positions;
+        std::vector<Vector3f> m_directions;
+        // @member: whether the forward direction of the followers is turned along the spline
+        bool m_orient;
+    public:
+        static constexpr uint32_t sFollowersPerJob = 256u;
+
+        SplineFollowerComponent(GameObject* object, ResourceId splineId, bool orient = true);
+        // @method: adds a follower
+        // @param distance: the distance along the spline the follower starts at
+        // @param speed: in units per second, negative speeds move backwards
+        // @param offset: added to the position on the spline, in the frame of the spline
+        //  (x to the right, y along the spline, z up). Spreads the asteroids of a lane for example
+        TransformPtr AddFollower(TransformPtr transform, float distance, float speed, const Vector3f& offset = Vector3f::Zero());
+        virtual void Update(const Time& dTime) override;
+
+        SPtr<Spline> GetSpline() const { return m_spline; }
+        uint32_t NumFollowers() const { return static_cast<uint32_t>(m_transforms.size()); }
+        float GetDistance(uint32_t follower) const { return m_distances[follower]; }
+        void SetSpeed(uint32_t follower, float speed) { m_speeds[follower] = speed; }
+    };
+
+}
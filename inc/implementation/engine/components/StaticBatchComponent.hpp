@@ -7,7 +7,7 @@ namespace orbit
     class StaticBatchComponent : public BatchComponent
     {
     private:
-        mutable VertexBuffer<Eigen::Matrix4f> m_transformBuffer;
+        mutable InstanceBuffer<Eigen::Matrix4f> m_transformBuffer;
         mutable bool m_recacheNeccessary = true;
     public:
         StaticBatchComponent(GameObject* object, ResourceId meshId);
@@ -0,0 +1,222 @@
+#pragma once
+#include "implementation/Common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace orbit
+{
+
+    using namespace Eigen;
+
+    // @brief: sphere enclosing a set of points
+    struct BoundingSphere
+    {
+        Vector3f center = Vector3f::Zero();
+        float radius = 0.f;
+
+        // @method: calculates a sphere enclosing all points (not necessarily the smallest one)
+        // @param points: pointer to the first point
+        // @param numPoints: number of points
+        // @param stride: distance in bytes between two consecutive points
+        static BoundingSphere FromPoints(const Vector3f* points, size_t numPoints, size_t stride = sizeof(Vector3f))
+        {
+            BoundingSphere sphere;
+            if (numPoints == 0)
+                return sphere;
+
+            auto at = [&](size_t i) -> const Vector3f& {
+                return *reinterpret_cast<const Vector3f*>(reinterpret_cast<const uint8_t*>(points) + i * stride);
+            };
+            Vector3f min = at(0);
+            Vector3f max = at(0);
+            for (auto i = 1u; i < numPoints; ++i)
+            {
+                min = min.cwiseMin(at(i));
+                max = max.cwiseMax(at(i));
+            }
+            sphere.center = (min + max) * 0.5f;
+            for (auto i = 0u; i < numPoints; ++i)
+                sphere.radius = std::max(sphere.radius, (at(i) - sphere.center).squaredNorm());
+            sphere.radius = std::sqrt(sphere.radius);
+            return sphere;
+        }
+
+        // @method: transforms the sphere into world space
+        // @param matrix: the (transposed) matrix as returned by Transform::LocalToWorldMatrix()
+        BoundingSphere Transformed(const Matrix4f& matrix) const
+        {
+            BoundingSphere sphere;
+            sphere.center = (center.homogeneous().transpose() * matrix).head<3>().transpose();
+            const auto scale = std::max({
+                matrix.block<1, 3>(0, 0).norm(),
+                matrix.block<1, 3>(1, 0).norm(),
+                matrix.block<1, 3>(2, 0).norm() });
+            sphere.radius = radius * scale;
+            return sphere;
+        }
+
+        // @method: calculates the projected diameter of the (world space) sphere
+        // @param view: the camera's view matrix
+        // @param projection: the camera's projection matrix
+        // @return: the size relative to the screen height (1 covers the whole screen)
+        float ProjectedSize(const Matrix4f& view, const Matrix4f& projection) const
+        {
+            const auto depth = center.homogeneous().dot(view.col(2));
+            if (depth <= radius)
+                return std::numeric_limits<float>::max();
+            return radius * projection(1, 1) / depth;
+        }
+    };
+
+    // @brief: axis aligned box, empty (min > max) when default constructed
+    struct BoundingBox
+    {
+        Vector3f min = Vector3f::Constant(std::numeric_limits<float>::max());
+        Vector3f max = Vector3f::Constant(-std::numeric_limits<float>::max());
+
+        static BoundingBox FromSphere(const BoundingSphere& sphere)
+        {
+            return { sphere.center.array() - sphere.radius, sphere.center.array() + sphere.radius };
+        }
+
+        Vector3f Center() const { return (min + max) * 0.5f; }
+        Vector3f Extents() const { return (max - min) * 0.5f; }
+        // @method: half the surface area, the cost metric of bounding volume hierarchies
+        float HalfArea() const
+        {
+            const Vector3f size = (max - min).cwiseMax(0.f);
+            return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+        }
+
+        BoundingBox Merged(const BoundingBox& other) const { return { min.cwiseMin(other.min), max.cwiseMax(other.max) }; }
+        BoundingBox Expanded(float margin) const { return { min.array() - margin, max.array() + margin }; }
+
+        bool Contains(const BoundingBox& other) const
+        {
+            return (min.array() <= other.min.array()).all() && (max.array() >= other.max.array()).all();
+        }
+        bool Intersects(const BoundingBox& other) const
+        {
+            return (min.array() <= other.max.array()).all() && (max.array() >= other.min.array()).all();
+        }
+        bool Intersects(const BoundingSphere& sphere) const
+        {
+            const Vector3f closest = sphere.center.cwiseMax(min).cwiseMin(max);
+            return (closest - sphere.center).squaredNorm() <= sphere.radius * sphere.radius;
+        }
+    };
+
+    // @brief: half line starting at origin. The inverse direction is cached for slab tests
+    struct Ray
+    {
+        Vector3f origin;
+        Vector3f direction;
+        Vector3f inverseDirection;
+
+        Ray() :
+            Ray(Vector3f::Zero(), Vector3f::UnitZ())
+        {
+        }
+        // @param direction: normalized direction, distances are measured along it
+        Ray(const Vector3f& origin, const Vector3f& direction) :
+            origin(origin),
+            direction(direction),
+            inverseDirection(direction.cwiseInverse())
+        {
+        }
+
+        Vector3f At(float distance) const { return origin + direction * distance; }
+
+        // @method: slab test against the box
+        // @param maxDistance: intersections further away are ignored
+        // @param distance: receives the distance at which the ray enters the box (0 if it starts inside)
+        bool Intersects(const BoundingBox& box, float maxDistance, float* distance = nullptr) const
+        {
+            auto entry = 0.f;
+            auto exit = maxDistance;
+            for (auto axis = 0; axis < 3; ++axis)
+            {
+                // Rays parallel to the slab would compute 0 * inf on its planes
+                if (direction[axis] == 0.f)
+                {
+                    if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis])
+                        return false;
+                    continue;
+                }
+                const auto t0 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+                const auto t1 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+                entry = std::max(entry, std::min(t0, t1));
+                exit = std::min(exit, std::max(t0, t1));
+            }
+            if (distance)
+                *distance = entry;
+            return entry <= exit;
+        }
+
+        // @method: intersects the ray with the sphere
+        // @param distance: receives the distance of the first intersection (0 if it starts inside)
+        bool Intersects(const BoundingSphere& sphere, float maxDistance, float* distance = nullptr) const
+        {
+            const Vector3f offset = origin - sphere.center;
+            const auto b = offset.dot(direction);
+            const auto c = offset.squaredNorm() - sphere.radius * sphere.radius;
+            if (c > 0.f && b > 0.f)
+                return false;
+            const auto discriminant = b * b - c;
+            if (discriminant < 0.f)
+                return false;
+            const auto entry = std::max(-b - std::sqrt(discriminant), 0.f);
+            if (distance)
+                *distance = entry;
+            return entry <= maxDistance;
+        }
+    };
+
+    // @brief: the six planes of a view frustum. The plane normals point inwards
+    struct Frustum
+    {
+        // @member: left, right, bottom, top, near and far plane as (normal, distance)
+        Vector4f planes[6];
+
+        // @method: extracts the frustum planes from a (view-)projection matrix
+        // @param viewProjection: the matrix as returned by ICamera::GetViewProjectionMatrix()
+        //  the planes are in the space the matrix transforms from
+        static Frustum FromMatrix(const Matrix4f& viewProjection)
+        {
+            Frustum frustum;
+            frustum.planes[0] = viewProjection.col(3) + viewProjection.col(0);
+            frustum.planes[1] = viewProjection.col(3) - viewProjection.col(0);
+            frustum.planes[2] = viewProjection.col(3) + viewProjection.col(1);
+            frustum.planes[3] = viewProjection.col(3) - viewProjection.col(1);
+            frustum.planes[4] = viewProjection.col(2);
+            frustum.planes[5] = viewProjection.col(3) - viewProjection.col(2);
+            for (auto& plane : frustum.planes)
+                plane /= plane.head<3>().norm();
+            return frustum;
+        }
+
+        // @method: checks whether the sphere is (partially) inside of the frustum
+        bool Intersects(const BoundingSphere& sphere) const
+        {
+            for (const auto& plane : planes)
+                if (plane.head<3>().dot(sphere.center) + plane.w() < -sphere.radius)
+                    return false;
+            return true;
+        }
+
+        // @method: checks whether the box is (partially) inside of the frustum. Boxes close to
+        //  the frustum's corners might be reported as visible
+        bool Intersects(const BoundingBox& box) const
+        {
+            const Vector3f center = box.Center();
+            const Vector3f extents = box.Extents();
+            for (const auto& plane : planes)
+                if (plane.head<3>().dot(center) + plane.w() < -plane.head<3>().cwiseAbs().dot(extents))
+                    return false;
+            return true;
+        }
+    };
+
+}
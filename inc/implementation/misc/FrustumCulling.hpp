@@ -0,0 +1,57 @@
+#pragma once
+#include "implementation/misc/Bounds.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: bounding spheres stored as one array per component, the layout the
+    //  culling kernels load 8 spheres at a time from
+    struct BoundingSphereArrays
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        void Resize(size_t size)
+        {
+            x.resize(size);
+            y.resize(size);
+            z.resize(size);
+            radius.resize(size);
+        }
+        void Set(size_t i, const BoundingSphere& sphere)
+        {
+            x[i] = sphere.center.x();
+            y[i] = sphere.center.y();
+            z[i] = sphere.center.z();
+            radius[i] = sphere.radius;
+        }
+        BoundingSphere Get(size_t i) const
+        {
+            BoundingSphere sphere;
+            sphere.center = { x[i], y[i], z[i] };
+            sphere.radius = radius[i];
+            return sphere;
+        }
+        size_t Size() const { return x.size(); }
+    };
+
+    class FrustumCulling
+    {
+    public:
+        // @method: tests the spheres against the six planes of the frustum. Uses AVX2
+        //  when the CPU supports it and SSE otherwise, both test 8 spheres per iteration
+        // @param visible: receives the indices of the (partially) visible spheres in
+        //  ascending order, has to hold spheres.Size() indices
+        // @return: the number of visible spheres
+        static uint32_t CullSpheres(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible);
+        // @method: the SSE path of CullSpheres, available on every x64 CPU
+        static uint32_t CullSpheresSse(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible);
+        // @method: the AVX2 path of CullSpheres, @see CpuSupportsAvx2()
+        static uint32_t CullSpheresAvx2(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible);
+    };
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+
+// Kernels that use AVX2 and FMA are compiled for them with this attribute, while the
+// rest of the engine keeps its baseline instruction set. Only call them when
+// orbit::CpuSupportsAvx2() returned true. MSVC allows the intrinsics without it
+#ifdef _MSC_VER
+#define ORBIT_TARGET_AVX2
+#else
+#define ORBIT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace orbit
+{
+
+    // @brief: checks once whether the CPU and the operating system support AVX2 and FMA
+    inline bool CpuSupportsAvx2()
+    {
+        static const bool sSupported = []() {
+#ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuid(info, 1);
+            const auto fma = (info[2] & (1 << 12)) != 0;
+            const auto osxsave = (info[2] & (1 << 27)) != 0;
+            const auto avx = (info[2] & (1 << 28)) != 0;
+            // The OS has to save the upper halves of the ymm registers
+            if (!fma || !osxsave || !avx || (_xgetbv(0) & 6u) != 6u)
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }();
+        return sSupported;
+    }
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "implementation/Common.hpp"
+#include "implementation/misc/SplineFormat.hpp"
+#include "interfaces/misc/UnLoadable.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    using namespace Eigen;
+
+    // A chain of cubic Bezier segments with a precomputed arc length table,
+    // @see SplineFormat.hpp. Positions at a distance along the spline are
+    // found in constant time, so followers move at constant speed no matter
+    // how unevenly the control points are spaced
+    class Spline : public UnLoadable
+    {
+    private:
+        std::vector<Vector3f> m_controlPoints;
+        std::vector<float> m_samples;
+        uint32_t m_numSegments = 0u;
+        uint32_t m_numSamples = 0u;
+        float m_length = 0.f;
+        // @member: number of samples per unit of length
+        float m_sampleScale = 0.f;
+        bool m_closed = false;
+    public:
+        bool LoadImpl(std::ifstream* stream) override;
+        void UnloadImpl() override;
+
+        // @method: returns the curve parameter (segment + position on it) at a distance
+        //  along the spline. Closed splines wrap the distance around, open ones clamp it
+        float ParameterAt(float distance) const;
+        // @method: returns the position at a curve parameter
+        Vector3f Evaluate(float parameter) const;
+        // @method: returns the derivative at a curve parameter, it points along the spline
+        Vector3f Derivative(float parameter) const;
+        Vector3f PositionAt(float distance) const { return Evaluate(ParameterAt(distance)); }
+
+        // @method: evaluates many followers at once
+        // @param distances: the distance along the spline of every follower
+        // @param positions: receives the position of every follower
+        // @param directions: receives the normalized direction of every follower, may be nullptr
+        void Evaluate(const float* distances, uint32_t count, Vector3f* positions, Vector3f* directions = nullptr) const;
+
+        // @method: returns the distance wrapped around (closed) or clamped to the spline
+        float WrapDistance(float distance) const;
+
+        float GetLength() const { return m_length; }
+        bool IsClosed() const { return m_closed; }
+        uint32_t NumSegments() const { return m_numSegments; }
+    };
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+namespace orbit
+{
+
+    // Payload layout of splines (ResourceType::SPLINE), shared by orbtool and
+    // the engine. Catmull-Rom splines are converted to Bezier curves when they
+    // are baked, so every spline is stored as a chain of cubic Bezier segments
+    // that share their end points:
+    //  uint32_t flags (SplineFlag)
+    //  uint32_t numSegments
+    //  uint32_t numSamples
+    //  float    length
+    //  float    controlPoints[3 * numSegments + 1][3]
+    //  float    samples[numSamples + 1]
+    // Sample i is the curve parameter at the distance length * i / numSamples
+    // along the spline. A parameter is the index of a segment plus the position
+    // on that segment in [0, 1], between two samples it is interpolated linearly.
+    // The last control point of a closed spline is equal to its first one.
+
+    enum SplineFlag : uint32_t
+    {
+        SPLINE_NONE = 0u,
+        // @note: the last segment ends at the start of the first one
+        SPLINE_CLOSED = 1u << 0u
+    };
+
+}
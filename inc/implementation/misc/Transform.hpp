@@ -1,5 +1,6 @@
 #pragma once
 #include "implementation/Common.hpp"
+#include "implementation/engine/TransformSystem.hpp"
 
 #include <memory>
 
@@ -12,38 +13,20 @@ namespace orbit
 	//	and offers useful helper functions
 	class Transform
 	{
-	protected:
-		// @member: the location part of the affine transformation
-		Vector3f m_location = Vector3f::Zero();
-		// @member: pivot point for the scaling and rotation
-		Vector3f m_pivot = Vector3f::Zero();
-		// @member: the rotation part of the affine transformation
-		Quaternionf m_rotation = Quaternionf::Identity();
-		// @member: the scaling part of the affine transformation
-		Vector3f m_scaling = Vector3f::Ones();
+	private:
+		// @member: the location, rotation around the pivot and scaling around the
+		//	pivot are stored in the TransformSystem
+		TransformHandle m_handle;
 		// @member: parent of the transform
 		std::shared_ptr<Transform> m_parent;
-		// @member: cached rotation matrix
-		mutable std::shared_ptr<Matrix3f> m_cachedRotation;
-	private:
-		// @member: remembers whether the transformation matrix needs to be
-		//	recalculated
-		mutable bool m_isDirty;
-		mutable bool m_isRotationDirty;
-		// @member: cached transformation matrix
-		//	contains the affine transformation of
-		//	translation,
-		//	rotation around the pivot
-		//	and scaling around the pivot
-		mutable Matrix4f _matrix;
-	protected:
-		// @method: recalculates the cached matrix
-		void RecalculateMatrix() const;
 	public:
 		Transform();
+		Transform(const Transform& other);
+		~Transform();
+		Transform& operator=(const Transform& other);
 		// @method: returns a transformation matrix
 		// @return: returns the affine transformation from local space to world space
-		const Matrix4f& LocalToWorldMatrix() const;
+		Matrix4f LocalToWorldMatrix() const;
 		// @method: returns a transformation matrix
 		// @return: returns the affine transformation from world space to local space
 		Matrix4f WorldToLocalMatrix() const;
@@ -51,24 +34,25 @@ namespace orbit
 		// @return: parent transformation, nullptr if not available
 		std::shared_ptr<Transform> GetParent() const { return m_parent; }
 
+		// @method: returns the handle of the transform in the TransformSystem
+		TransformHandle GetHandle() const { return m_handle; }
+
 		// @method: returns the rotation part of the affine transformation
-		const Matrix3f& GetRotation() const;
-		Matrix3f& GetRotation();
+		Matrix3f GetRotation() const;
+		// @method: returns the rotation part of the affine transformation as quaternion
+		Quaternionf GetRotationQuaternion() const;
 		// @method: returns the rotation of this transform and all of its parents
 		Matrix3f GetCombinedRotation() const;
 		// @method: returns the translation part of the affine transformation
-		const Vector3f& GetTranslation() const { return m_location; }
-		Vector3f& GetTranslation() { return m_location; }
-		// @method: returns the translation of this transform and all of its parents
+		Vector3f GetTranslation() const;
+		// @method: returns the translation transformed by all of the parents
 		Vector3f GetCombinedTranslation() const;
 		// @method: returns the scaling part of the affine transformation
-		const Vector3f& GetScaling() const { return m_scaling; }
-		Vector3f& GetScaling() { return m_scaling; }
+		Vector3f GetScaling() const;
 		// @method: returns the scaling of this transform and all of its parents
 		Vector3f GetCombinedScaling() const;
 		// @method: returns the scaling and rotation origin
-		const Vector3f& GetOrigin() const { return m_pivot; }
-		Vector3f& GetOrigin() { return m_pivot; }
+		Vector3f GetOrigin() const;
 
 		// @method: transforms a vector
 		// @param vector: the vector to be transformed
@@ -0,0 +1,66 @@
+#pragma once
+#include "implementation/Common.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    using namespace Eigen;
+
+    // @brief: local translation, rotation, scaling and pivot of transforms stored as
+    //  one array per component, the layout batch kernels load several transforms from
+    struct TransformArrays
+    {
+        std::vector<float> location[3];
+        // @member: quaternion components in the order x, y, z, w
+        std::vector<float> rotation[4];
+        std::vector<float> scaling[3];
+        std::vector<float> pivot[3];
+
+        void Resize(size_t size)
+        {
+            for (auto& component : location) component.resize(size);
+            for (auto& component : rotation) component.resize(size);
+            for (auto& component : scaling) component.resize(size);
+            for (auto& component : pivot) component.resize(size);
+        }
+        size_t Size() const { return location[0].size(); }
+
+        Vector3f GetLocation(size_t i) const { return { location[0][i], location[1][i], location[2][i] }; }
+        Quaternionf GetRotation(size_t i) const { return { rotation[3][i], rotation[0][i], rotation[1][i], rotation[2][i] }; }
+        Vector3f GetScaling(size_t i) const { return { scaling[0][i], scaling[1][i], scaling[2][i] }; }
+        Vector3f GetPivot(size_t i) const { return { pivot[0][i], pivot[1][i], pivot[2][i] }; }
+        void SetLocation(size_t i, const Vector3f& value) { for (auto c = 0u; c < 3u; ++c) location[c][i] = value[c]; }
+        void SetRotation(size_t i, const Quaternionf& value) { for (auto c = 0u; c < 4u; ++c) rotation[c][i] = value.coeffs()[c]; }
+        void SetScaling(size_t i, const Vector3f& value) { for (auto c = 0u; c < 3u; ++c) scaling[c][i] = value[c]; }
+        void SetPivot(size_t i, const Vector3f& value) { for (auto c = 0u; c < 3u; ++c) pivot[c][i] = value[c]; }
+        void Copy(size_t from, size_t to)
+        {
+            SetLocation(to, GetLocation(from));
+            SetRotation(to, GetRotation(from));
+            SetScaling(to, GetScaling(from));
+            SetPivot(to, GetPivot(from));
+        }
+    };
+
+    // @brief: computes the matrices of transforms given by their location, rotation
+    //  around the pivot and scaling around the pivot. The matrices are transposed like
+    //  the ones returned by Transform::LocalToWorldMatrix()
+    class TransformMatrices
+    {
+    public:
+        // @method: computes the matrices of count transforms. Uses AVX2 when the CPU
+        //  supports it and SSE otherwise, both compute 8 matrices per iteration
+        // @param first: index of the first transform in the arrays
+        // @param matrices: receives the matrix of transform first + i at index i
+        static void Compute(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices);
+        // @method: the SSE path of Compute, available on every x64 CPU
+        static void ComputeSse(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices);
+        // @method: the AVX2 path of Compute, @see CpuSupportsAvx2()
+        static void ComputeAvx2(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices);
+        // @method: computes the matrix of a single transform without SIMD
+        static void ComputeOne(const TransformArrays& transforms, uint32_t index, Matrix4f& matrix);
+    };
+
+}
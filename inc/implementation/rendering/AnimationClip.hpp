@@ -0,0 +1,52 @@
+#pragma once
+#include "implementation/rendering/AnimationFormat.hpp"
+#include "interfaces/misc/UnLoadable.hpp"
+
+#include <vector>
+
+namespace orbit
+{
+
+    // A compressed animation of all joints of a skeleton, @see AnimationFormat.hpp.
+    // The keys stay quantized in memory and are decoded while sampling
+    class AnimationClip : public UnLoadable
+    {
+    private:
+        // @brief: the keys of one joint, offsets into the key arrays below
+        struct Track
+        {
+            uint32_t firstRotation;
+            uint32_t numRotations;
+            uint32_t firstTranslation;
+            uint32_t numTranslations;
+            uint32_t firstScale;
+            uint32_t numScales;
+        };
+        ResourceId m_skeletonId = 0;
+        float m_sampleRate = 30.f;
+        uint32_t m_numFrames = 0u;
+        std::vector<Track> m_tracks;
+        std::vector<uint16_t> m_rotationFrames;
+        std::vector<QuantizedQuaternion> m_rotations;
+        std::vector<uint16_t> m_translationFrames;
+        // @member: three floats per key
+        std::vector<float> m_translations;
+        std::vector<uint16_t> m_scaleFrames;
+        std::vector<float> m_scales;
+    public:
+        bool LoadImpl(std::ifstream* stream) override;
+        void UnloadImpl() override;
+
+        // @method: evaluates the local pose of every joint
+        // @param time: in seconds
+        // @param poses: receives one pose per track (joint of the skeleton)
+        // @param loop: wraps the time around at the end of the clip, otherwise the last frame is held
+        void Sample(float time, JointPose* poses, bool loop = true) const;
+
+        ResourceId GetSkeletonId() const { return m_skeletonId; }
+        uint32_t NumTracks() const { return static_cast<uint32_t>(m_tracks.size()); }
+        // @method: returns the length of the clip in seconds
+        float GetDuration() const { return m_numFrames > 1u ? (m_numFrames - 1u) / m_sampleRate : 0.f; }
+    };
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace orbit
+{
+
+    // Payload layouts of skeletons and animation clips, shared by orbtool and
+    // the engine.
+    //
+    // Skeleton (ResourceType::SKELETON). Parents are stored before their children.
+    //  uint32_t numJoints
+    //  per joint:
+    //      uint32_t  nameLen
+    //      char      name[nameLen]
+    //      int32_t   parent (-1 for roots)
+    //      JointPose bindPose (relative to the parent)
+    //      float     inverseBindPose[16] (column major, model space to joint space)
+    //
+    // Animation clip (ResourceType::ANIMATION_CLIP). One track per joint of the
+    // skeleton. Keys are stored per channel and type for all tracks, track after track:
+    //  int64_t              skeleton (id of the skeleton relative to the clip)
+    //  float                sampleRate (frames per second)
+    //  uint32_t             numFrames
+    //  uint32_t             numTracks
+    //  AnimationTrackHeader tracks[numTracks]
+    //  uint16_t             rotationFrames[sum of numRotationKeys]
+    //  QuantizedQuaternion  rotations[sum of numRotationKeys]
+    //  uint16_t             translationFrames[sum of numTranslationKeys]
+    //  float                translations[sum of numTranslationKeys][3]
+    //  uint16_t             scaleFrames[sum of numScaleKeys]
+    //  float                scales[sum of numScaleKeys][3]
+    // Every channel has at least one key. The first key is at frame 0, the last
+    // one at numFrames - 1 unless the channel is constant. Values in between
+    // keys are interpolated linearly (rotations with normalized lerp).
+
+    // @brief: local transform of a joint
+    struct JointPose
+    {
+        // @member: x, y, z, w
+        float rotation[4];
+        float translation[3];
+        float scale[3];
+    };
+
+    struct AnimationTrackHeader
+    {
+        uint32_t numRotationKeys;
+        uint32_t numTranslationKeys;
+        uint32_t numScaleKeys;
+    };
+
+    // @brief: unit quaternion in 48 bits ("smallest three"). The largest
+    //  component is dropped and restored from the unit length, the other three
+    //  are stored with 15 bits each. The index of the dropped component is
+    //  stored in the top bits of the first two values
+    struct QuantizedQuaternion
+    {
+        uint16_t data[3];
+
+        static constexpr float sRange = 0.70710678f; // 1 / sqrt(2)
+        static constexpr float sMaxValue = 32767.f;
+
+        // @param q: x, y, z, w. Doesn't have to be normalized
+        static QuantizedQuaternion Encode(const float* q)
+        {
+            auto largest = 0u;
+            for (auto i = 1u; i < 4u; ++i)
+                if (std::abs(q[i]) > std::abs(q[largest]))
+                    largest = i;
+
+            // q and -q are the same rotation, the dropped component is always positive
+            const auto norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            const auto sign = (q[largest] < 0.f ? -1.f : 1.f) / (norm > 0.f ? norm : 1.f);
+
+            QuantizedQuaternion result{};
+            for (auto i = 0u, j = 0u; i < 4u; ++i)
+            {
+                if (i == largest)
+                    continue;
+                const auto value = std::clamp(q[i] * sign, -sRange, sRange);
+                result.data[j++] = static_cast<uint16_t>(std::lround((value / sRange * 0.5f + 0.5f) * sMaxValue));
+            }
+            result.data[0] |= static_cast<uint16_t>((largest >> 1u) << 15u);
+            result.data[1] |= static_cast<uint16_t>((largest & 1u) << 15u);
+            return result;
+        }
+
+        // @param q: receives x, y, z, w
+        void Decode(float* q) const
+        {
+            const auto largest = static_cast<uint32_t>(((data[0] >> 15u) << 1u) | (data[1] >> 15u));
+            auto sum = 0.f;
+            for (auto i = 0u, j = 0u; i < 4u; ++i)
+            {
+                if (i == largest)
+                    continue;
+                q[i] = ((data[j++] & 0x7FFFu) / sMaxValue * 2.f - 1.f) * sRange;
+                sum += q[i] * q[i];
+            }
+            q[largest] = std::sqrt(std::max(1.f - sum, 0.f));
+        }
+    };
+
+}
@@ -1,10 +1,14 @@
 #pragma once
 #include "implementation/backends/Platform.hpp"
 #include "implementation/rendering/Submesh.hpp"
+#include "implementation/rendering/MeshChunk.hpp"
+#include "implementation/rendering/MeshPool.hpp"
+#include "implementation/misc/Bounds.hpp"
 #include "interfaces/misc/Bindable.hpp"
 #include "interfaces/misc/UnLoadable.hpp"
 
 #include <memory>
+#include <mutex>
 
 namespace orbit
 {
@@ -13,19 +17,153 @@ namespace orbit
     class Mesh : public IBindable<>, public UnLoadable
     {
     private:
-        UPtr<IndexBuffer> m_indexBuffer;
-        UPtr<VertexBuffer<VertexType>> m_vertexBuffer;
+        struct MeshLod
+        {
+            // @member: projected size (relative to the screen height) below which this lod is used
+            float screenSize;
+            std::vector<Submesh> submeshes;
+        };
+        mutable UPtr<IndexBuffer> m_indexBuffer;
+        mutable UPtr<VertexBuffer<VertexType>> m_vertexBuffer;
         std::vector<Submesh> m_submeshes;
+        // @member: simplified versions of m_submeshes. Their indices are stored
+        //  after the indices of the full resolution mesh in m_indexBuffer
+        std::vector<MeshLod> m_lods;
+        // @member: clusters of the full resolution mesh, @see DrawClusters()
+        std::vector<MeshCluster> m_clusters;
+        // @member: joint influences of every vertex, empty if the mesh isn't skinned
+        std::vector<SkinWeights> m_skinWeights;
+        ResourceId m_skeletonId = 0;
+        BoundingSphere m_bounds;
         ResourceId m_id;
+        // @member: the range of the mesh in the MeshPool, invalid if it draws from its own buffers
+        mutable MeshPoolRange m_poolRange;
+        // @member: static meshes move to the pool when they are drawn the first time
+        bool m_poolable = false;
+        mutable std::mutex m_poolMutex;
+    private:
+        // @brief: moves a range of the mesh to its range in the pool. The submeshes, lods
+        //  and clusters stay relative to the mesh, so they don't change when it is pooled
+        Submesh ToGeometry(Submesh submesh) const
+        {
+            if (m_poolRange.IsValid())
+            {
+                submesh.startVertex += m_poolRange.firstVertex;
+                submesh.startIndex += m_poolRange.firstIndex;
+            }
+            return submesh;
+        }
+        // @brief: the number of indices of the full resolution mesh, the lods follow them
+        size_t NumFullIndices() const
+        {
+            size_t numIndices = 0u;
+            for (const auto& submesh : m_submeshes)
+                numIndices = std::max(numIndices, submesh.startIndex + submesh.indexCount);
+            return numIndices;
+        }
+        void ReadLodChunk(std::ifstream* stream, const Submesh& base, std::vector<int32_t>* indices)
+        {
+            uint32_t numLods = 0u;
+            stream->read((char*)&numLods, sizeof(uint32_t));
+            m_lods.resize(numLods);
+            for (auto& lod : m_lods)
+            {
+                uint32_t numSubmeshes = 0u;
+                stream->read((char*)&lod.screenSize, sizeof(float));
+                stream->read((char*)&numSubmeshes, sizeof(uint32_t));
+                lod.submeshes.resize(numSubmeshes, base);
+                for (auto& submesh : lod.submeshes)
+                {
+                    uint64_t range[3];
+                    stream->read((char*)range, sizeof(range));
+                    submesh.startVertex = range[0];
+                    submesh.vertexCount = range[1];
+                    submesh.indexCount = range[2];
+                    submesh.startIndex = indices->size();
+                    indices->resize(indices->size() + submesh.indexCount);
+                    stream->read((char*)(indices->data() + submesh.startIndex), sizeof(int32_t) * submesh.indexCount);
+                }
+            }
+        }
+        void ReadClusterChunk(std::ifstream* stream)
+        {
+            uint32_t numClusters = 0u;
+            stream->read((char*)&numClusters, sizeof(uint32_t));
+            m_clusters.resize(numClusters);
+            stream->read((char*)m_clusters.data(), sizeof(MeshCluster) * numClusters);
+        }
+        void ReadSkinChunk(std::ifstream* stream)
+        {
+            uint32_t numVertices = 0u;
+            m_skeletonId = ReadReferenceId(stream);
+            stream->read((char*)&numVertices, sizeof(uint32_t));
+            m_skinWeights.resize(numVertices);
+            stream->read((char*)m_skinWeights.data(), sizeof(SkinWeights) * numVertices);
+        }
     public:
+        // @member: relative margin around the lod thresholds. Prevents instances
+        //  close to a threshold from switching their lod every frame
+        static constexpr float sLodHysteresis = 0.1f;
+
+        ~Mesh()
+        {
+            MeshPool<VertexType>::Get().Free(m_poolRange);
+        }
+
         virtual void Bind() const override
         {
+            if (m_poolable)
+            {
+                GetGeometry()->Bind();
+                return;
+            }
             if (m_indexBuffer)
                 m_indexBuffer->Bind(0);
             if (m_vertexBuffer)
                 m_vertexBuffer->Bind(0, sizeof(VertexType), 0);
         }
 
+        // @method: returns what has to be bound to draw the mesh, @see IRenderer::SetGeometry.
+        //  All pooled meshes return the pool, so switching between them binds nothing.
+        //  Static meshes are copied to the pool and drop their own copy on the first call,
+        //  meshes that are only used for physics never take space in the pool
+        const IBindable<>* GetGeometry() const
+        {
+            if (!m_poolable)
+                return this;
+
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            if (!m_poolRange.IsValid() && m_vertexBuffer && m_indexBuffer)
+            {
+                m_poolRange = MeshPool<VertexType>::Get().Allocate(m_vertexBuffer->GetVertices(), m_indexBuffer->GetIndices());
+                m_vertexBuffer = nullptr;
+                m_indexBuffer = nullptr;
+            }
+            return &MeshPool<VertexType>::Get();
+        }
+
+        // @method: copies the vertices and the indices of the full resolution mesh, e.g.
+        //  for physics cooking. Pooled meshes read them from the pool
+        void CopyGeometry(std::vector<VertexType>* vertices, std::vector<int32_t>* indices) const
+        {
+            std::lock_guard<std::mutex> lock(m_poolMutex);
+            const auto numIndices = NumFullIndices();
+            if (m_poolRange.IsValid())
+            {
+                MeshPool<VertexType>::Get().Read(m_poolRange, numIndices, vertices, indices);
+                return;
+            }
+            vertices->clear();
+            indices->clear();
+            if (m_vertexBuffer)
+                *vertices = m_vertexBuffer->GetVertices();
+            if (m_indexBuffer)
+                indices->assign(m_indexBuffer->GetIndices().begin(), m_indexBuffer->GetIndices().begin() + std::min<size_t>(numIndices, m_indexBuffer->NumIndices()));
+        }
+
+        // @method: returns whether the mesh draws from the shared MeshPool
+        bool IsPooled() const { return m_poolRange.IsValid(); }
+
         // @param submesh: The submesh to be drawn.
         //  Use 0xFFFFFFFF to draw all submeshes
         void Draw(uint32_t instanceCount, uint32_t submesh = 0xFFFFFFFF) const
@@ -33,16 +171,111 @@ namespace orbit
             if (submesh == std::numeric_limits<uint32_t>::max())
             {
                 for (const auto& submesh : m_submeshes)
-                    ENGINE->Renderer()->Draw(submesh, instanceCount);
+                    ENGINE->Renderer()->Draw(ToGeometry(submesh), instanceCount);
             }
             else
             {
-                ENGINE->Renderer()->Draw(m_submeshes.at(submesh), instanceCount);
+                ENGINE->Renderer()->Draw(ToGeometry(m_submeshes.at(submesh)), instanceCount);
             }
         }
 
+        // @method: draws all submeshes of a level of detail
+        // @param lod: 0 is the full resolution mesh, @see NumLods()
+        // @param startInstance: first instance in the bound instance buffer
+        void DrawLod(uint32_t lod, uint32_t instanceCount, uint32_t startInstance = 0u) const
+        {
+            const auto& submeshes = lod == 0u ? m_submeshes : m_lods.at(lod - 1).submeshes;
+            for (const auto& submesh : submeshes)
+                ENGINE->Renderer()->Draw(ToGeometry(submesh), instanceCount, startInstance);
+        }
+
+        // @method: draws the full resolution mesh, skipping clusters that are
+        //  outside of the frustum or facing away from the camera.
+        //  Neighbouring visible clusters are merged into a single draw call
+        // @param world: the instance's (transposed) local to world matrix
+        // @param frustum: the camera frustum in world space
+        // @param cameraPosition: the camera position in world space
+        // @param startInstance: the instance in the bound instance buffer
+        // @return: the number of clusters drawn
+        uint32_t DrawClusters(const Matrix4f& world, const Frustum& frustum, const Vector3f& cameraPosition, uint32_t startInstance = 0u) const
+        {
+            if (m_clusters.empty() || m_submeshes.empty())
+            {
+                DrawLod(0u, 1u, startInstance);
+                return 0u;
+            }
+
+            const Matrix3f rotation = world.topLeftCorner<3, 3>();
+            auto range = m_submeshes.front();
+            range.indexCount = 0u;
+            auto drawn = 0u;
+            for (const auto& cluster : m_clusters)
+            {
+                BoundingSphere sphere;
+                sphere.center = Vector3f(cluster.center[0], cluster.center[1], cluster.center[2]);
+                sphere.radius = cluster.radius;
+                sphere = sphere.Transformed(world);
+                if (!frustum.Intersects(sphere))
+                    continue;
+
+                if (cluster.coneCutoff < 1.f)
+                {
+                    const Vector3f axis = (Vector3f(cluster.coneAxis[0], cluster.coneAxis[1], cluster.coneAxis[2]).transpose() * rotation).normalized();
+                    const Vector3f view = sphere.center - cameraPosition;
+                    if (view.dot(axis) >= cluster.coneCutoff * view.norm() + sphere.radius)
+                        continue;
+                }
+
+                ++drawn;
+                if (range.indexCount > 0u &&
+                    range.startVertex == cluster.startVertex &&
+                    range.startIndex + range.indexCount == cluster.startIndex)
+                {
+                    range.indexCount += cluster.indexCount;
+                    continue;
+                }
+                if (range.indexCount > 0u)
+                    ENGINE->Renderer()->Draw(ToGeometry(range), 1u, startInstance);
+                range.startVertex = cluster.startVertex;
+                range.startIndex = cluster.startIndex;
+                range.indexCount = cluster.indexCount;
+            }
+            if (range.indexCount > 0u)
+                ENGINE->Renderer()->Draw(ToGeometry(range), 1u, startInstance);
+            return drawn;
+        }
+
+        // @method: returns whether the mesh was split into clusters by orbtool
+        bool HasClusters() const { return !m_clusters.empty(); }
+
+        // @method: returns the number of levels of detail including the full resolution mesh
+        uint32_t NumLods() const { return static_cast<uint32_t>(m_lods.size()) + 1u; }
+
+        // @method: picks the level of detail for a given projected size
+        // @param screenSize: projected size of the mesh relative to the screen height
+        // @param currentLod: the lod used in the previous frame
+        // @return: the lod to be used
+        uint32_t SelectLod(float screenSize, uint32_t currentLod = 0u) const
+        {
+            auto lod = std::min(currentLod, NumLods() - 1u);
+            while (lod + 1u < NumLods() && screenSize < m_lods[lod].screenSize * (1.f - sLodHysteresis))
+                ++lod;
+            while (lod > 0u && screenSize > m_lods[lod - 1u].screenSize * (1.f + sLodHysteresis))
+                --lod;
+            return lod;
+        }
+
+        // @method: returns whether the mesh is deformed by a skeleton, @see SkinnedBatchComponent
+        bool IsSkinned() const { return !m_skinWeights.empty(); }
+        ResourceId GetSkeletonId() const { return m_skeletonId; }
+        const std::vector<SkinWeights>& GetSkinWeights() const { return m_skinWeights; }
+
+        // @method: returns the sphere enclosing all vertices in model space
+        const BoundingSphere& GetBoundingSphere() const { return m_bounds; }
+
         bool LoadImpl(std::ifstream* stream) override
         {
+            const auto payloadEnd = static_cast<size_t>(stream->tellg()) + ENGINE->RMGetPayloadSize(GetId());
             m_indexBuffer = std::make_unique<IndexBuffer>();
             m_vertexBuffer = std::make_unique<VertexBuffer<VertexType>>();
 
@@ -67,21 +300,52 @@ namespace orbit
             stream->read((char*)indices.data(), sizeof(int32_t) * mesh.indexCount);
             stream->read((char*)vertices.data(), sizeof(VertexType) * mesh.vertexCount);
 
-            m_vertexBuffer->SetVertices(std::move(vertices));
-            m_indexBuffer->SetIndices(std::move(indices));
-            m_vertexBuffer->UpdateBuffer();
-            m_indexBuffer->UpdateBuffer();
+            // Optional chunks following the vertex data
+            MeshChunkHeader chunk;
+            while (static_cast<size_t>(stream->tellg()) + sizeof(MeshChunkHeader) <= payloadEnd)
+            {
+                stream->read((char*)&chunk, sizeof(MeshChunkHeader));
+                const auto chunkEnd = static_cast<size_t>(stream->tellg()) + chunk.size;
+                if (chunk.type == MeshChunkType::CHUNK_LOD)
+                    ReadLodChunk(stream, mesh, &indices);
+                else if (chunk.type == MeshChunkType::CHUNK_CLUSTER)
+                    ReadClusterChunk(stream);
+                else if (chunk.type == MeshChunkType::CHUNK_SKIN)
+                    ReadSkinChunk(stream);
+                stream->seekg(chunkEnd, std::ios::beg);
+            }
 
+            m_bounds = BoundingSphere::FromPoints(&vertices.data()->position, vertices.size(), sizeof(VertexType));
             m_submeshes.emplace_back(mesh);
+
+            // Static meshes keep their data on the CPU until they are drawn from the pool,
+            // @see GetGeometry. Skinned meshes are deformed into buffers of their own
+            m_poolable = !IsSkinned();
+            m_vertexBuffer->SetVertices(std::move(vertices));
+            m_indexBuffer->SetIndices(std::move(indices));
+            if (!m_poolable)
+            {
+                m_vertexBuffer->UpdateBuffer();
+                m_indexBuffer->UpdateBuffer();
+            }
             return true;
         }
 
         void UnloadImpl() override
         {
+            {
+                std::lock_guard<std::mutex> lock(m_poolMutex);
+                MeshPool<VertexType>::Get().Free(m_poolRange);
+                m_poolRange = MeshPoolRange{};
+                m_poolable = false;
+            }
             m_indexBuffer = nullptr;
             m_vertexBuffer = nullptr;
 
             m_submeshes.clear();
+            m_lods.clear();
+            m_clusters.clear();
+            m_skinWeights.clear();
         }
 
         const IndexBuffer* GetIndexBuffer() const { return m_indexBuffer.get(); }
@@ -89,6 +353,8 @@ namespace orbit
         void SetVertexBuffer(VertexBuffer<VertexType>& buffer) { m_vertexBuffer = std::make_unique<VertexBuffer<VertexType>>(buffer); }
         void SetIndexBuffer(IndexBuffer& buffer) { m_indexBuffer = std::make_unique<IndexBuffer>(buffer); }
 
+        // @method: the submeshes of the full resolution mesh, relative to its own buffers
+        const std::vector<Submesh>& GetSubmeshes() const { return m_submeshes; }
         void AddSubmesh(const Submesh& submesh)
         {
             m_submeshes.emplace_back(submesh);
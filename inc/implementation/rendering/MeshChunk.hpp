@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+
+namespace orbit
+{
+
+    // Optional data blocks that follow the vertex data of a mesh payload.
+    // Every chunk starts with a MeshChunkHeader. Readers skip chunks they
+    // don't know, so new chunk types can be added without breaking old files.
+    enum class MeshChunkType : uint32_t
+    {
+        // Level of detail chain.
+        //  uint32_t numLods
+        //  per lod:
+        //      float    screenSize (use this lod when the projected size drops below)
+        //      uint32_t numSubmeshes
+        //      per submesh:
+        //          uint64_t startVertex
+        //          uint64_t vertexCount
+        //          uint64_t indexCount
+        //          uint32_t indices[indexCount]
+        CHUNK_LOD = 1,
+        // Clusters of the full resolution mesh for cluster culling.
+        //  uint32_t    numClusters
+        //  MeshCluster clusters[numClusters]
+        // The triangles of a cluster are stored contiguously in the index buffer.
+        CHUNK_CLUSTER = 2,
+        // Joint influences of every vertex for skinning.
+        //  int64_t     skeleton (id of the skeleton relative to the mesh)
+        //  uint32_t    numVertices
+        //  SkinWeights weights[numVertices]
+        CHUNK_SKIN = 3,
+    };
+
+    // @brief: the (at most) four joints influencing a vertex
+    struct SkinWeights
+    {
+        uint16_t joints[4];
+        // @member: weights in 1/255 steps. They sum up to 255, unused slots are 0
+        uint8_t weights[4];
+    };
+
+    // @brief: a small group of neighbouring triangles (at most 64 vertices and 124 triangles)
+    struct MeshCluster
+    {
+        // @member: first index of the cluster in the mesh's index buffer
+        uint32_t startIndex;
+        uint32_t indexCount;
+        // @member: base vertex of the submesh the cluster belongs to
+        uint32_t startVertex;
+        // @member: bounding sphere of the cluster in model space
+        float center[3];
+        float radius;
+        // @member: average normal of the cluster's triangles
+        float coneAxis[3];
+        // @member: sine of the angle between the axis and the normal deviating the most from it.
+        //  1 if the cluster can't be back-face culled
+        float coneCutoff;
+    };
+
+    struct MeshChunkHeader
+    {
+        MeshChunkType type;
+        // @member: size of the chunk data in bytes (excluding this header)
+        uint32_t size;
+    };
+
+    static const char* MeshChunkTypeToString(MeshChunkType type)
+    {
+        switch (type)
+        {
+        case MeshChunkType::CHUNK_LOD: return "Levels of detail";
+        case MeshChunkType::CHUNK_CLUSTER: return "Clusters";
+        case MeshChunkType::CHUNK_SKIN: return "Skin";
+        default: return "Unknown";
+        }
+    }
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "implementation/backends/Platform.hpp"
+#include "implementation/engine/RangeAllocator.hpp"
+#include "interfaces/misc/Bindable.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: the vertices and indices of one mesh in a MeshPool
+    struct MeshPoolRange
+    {
+        size_t firstVertex = RangeAllocator::sInvalidOffset;
+        size_t numVertices = 0u;
+        size_t firstIndex = RangeAllocator::sInvalidOffset;
+        size_t numIndices = 0u;
+
+        bool IsValid() const { return firstVertex != RangeAllocator::sInvalidOffset; }
+    };
+
+    // Shares one vertex and one index buffer between all static meshes of a vertex type.
+    // Meshes draw with their ranges' offsets (startVertex is the base vertex), so
+    // consecutive draws of different meshes don't have to bind any buffers.
+    // The ranges of new meshes are uploaded the next time the pool is bound. The
+    // buffers double their size when a mesh doesn't fit, only then they are recreated
+    // with all of their contents. The pool keeps the only CPU copy of its meshes
+    template<typename VertexType>
+    class MeshPool : public IBindable<>
+    {
+    private:
+        mutable VertexBuffer<VertexType> m_vertexBuffer;
+        mutable IndexBuffer m_indexBuffer;
+        RangeAllocator m_vertexRanges;
+        RangeAllocator m_indexRanges;
+        // @member: ranges allocated since the last Bind
+        mutable std::vector<MeshPoolRange> m_pendingRanges;
+        // @member: the sizes of the GPU buffers, they are recreated when the pool grew
+        mutable size_t m_uploadedVertices = 0u;
+        mutable size_t m_uploadedIndices = 0u;
+        mutable std::mutex m_mutex;
+    private:
+        MeshPool() = default;
+
+        // @brief: allocates a range, growing the buffer if needed
+        template<typename Buffer>
+        static size_t AllocateRange(RangeAllocator& ranges, Buffer& buffer, size_t size, size_t minSize)
+        {
+            auto offset = ranges.Allocate(size);
+            if (offset == RangeAllocator::sInvalidOffset)
+            {
+                ranges.Grow(std::max({ ranges.Size() * 2u, ranges.Size() + size, minSize }));
+                buffer.ResizeBuffer(static_cast<uint32_t>(ranges.Size()));
+                offset = ranges.Allocate(size);
+            }
+            return offset;
+        }
+    public:
+        static constexpr size_t sMinVertices = 1u << 16u;
+        static constexpr size_t sMinIndices = 1u << 18u;
+
+        static MeshPool& Get()
+        {
+            static MeshPool sPool;
+            return sPool;
+        }
+
+        // @method: copies a mesh into the pool
+        // @return: the range of the mesh, its vertices and indices are uploaded with the next Bind
+        MeshPoolRange Allocate(const std::vector<VertexType>& vertices, const std::vector<int32_t>& indices)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            MeshPoolRange range;
+            range.numVertices = vertices.size();
+            range.numIndices = indices.size();
+            range.firstVertex = AllocateRange(m_vertexRanges, m_vertexBuffer, std::max<size_t>(range.numVertices, 1u), sMinVertices);
+            range.firstIndex = AllocateRange(m_indexRanges, m_indexBuffer, std::max<size_t>(range.numIndices, 1u), sMinIndices);
+
+            // Indices stay relative to the mesh, the draws pass firstVertex as base vertex
+            std::copy(vertices.begin(), vertices.end(), m_vertexBuffer.GetVertices().begin() + range.firstVertex);
+            for (auto i = 0u; i < indices.size(); ++i)
+                m_indexBuffer.SetIndex(static_cast<uint32_t>(range.firstIndex + i), indices[i]);
+            m_pendingRanges.push_back(range);
+            return range;
+        }
+
+        // @method: copies the vertices and the first numIndices indices of a range
+        void Read(const MeshPoolRange& range, size_t numIndices, std::vector<VertexType>* vertices, std::vector<int32_t>* indices) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto& poolVertices = m_vertexBuffer.GetVertices();
+            const auto& poolIndices = m_indexBuffer.GetIndices();
+            vertices->assign(poolVertices.begin() + range.firstVertex, poolVertices.begin() + range.firstVertex + range.numVertices);
+            indices->assign(poolIndices.begin() + range.firstIndex, poolIndices.begin() + range.firstIndex + std::min(numIndices, range.numIndices));
+        }
+
+        // @method: returns the range of a mesh to the pool
+        void Free(const MeshPoolRange& range)
+        {
+            if (!range.IsValid())
+                return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_vertexRanges.Free(range.firstVertex, std::max<size_t>(range.numVertices, 1u));
+            m_indexRanges.Free(range.firstIndex, std::max<size_t>(range.numIndices, 1u));
+        }
+
+        void Bind() const override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto vertexBufferGrew = m_uploadedVertices != m_vertexRanges.Size();
+            const auto indexBufferGrew = m_uploadedIndices != m_indexRanges.Size();
+            if (vertexBufferGrew)
+            {
+                m_vertexBuffer.UpdateBuffer();
+                m_uploadedVertices = m_vertexRanges.Size();
+            }
+            if (indexBufferGrew)
+            {
+                m_indexBuffer.UpdateBuffer();
+                m_uploadedIndices = m_indexRanges.Size();
+            }
+            for (const auto& range : m_pendingRanges)
+            {
+                if (!vertexBufferGrew && range.numVertices > 0u)
+                    m_vertexBuffer.UpdateRange(static_cast<uint32_t>(range.firstVertex), static_cast<uint32_t>(range.numVertices));
+                if (!indexBufferGrew && range.numIndices > 0u)
+                    m_indexBuffer.UpdateRange(static_cast<uint32_t>(range.firstIndex), static_cast<uint32_t>(range.numIndices));
+            }
+            m_pendingRanges.clear();
+            m_indexBuffer.Bind(0);
+            m_vertexBuffer.Bind(0, sizeof(VertexType), 0);
+        }
+
+        size_t NumVertices() const { return m_vertexRanges.Size() - m_vertexRanges.NumFree(); }
+        size_t NumIndices() const { return m_indexRanges.Size() - m_indexRanges.NumFree(); }
+    };
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include "implementation/rendering/Submesh.hpp"
+#include "interfaces/misc/Bindable.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace orbit
+{
+
+    using GeometryBindable = IBindable<>;
+    using InstanceBindable = IBindable<uint32_t, uint32_t, uint32_t>;
+
+    // @brief: passes are drawn in order. Opaque draws are sorted by state and then
+    //  front to back, transparent draws back to front
+    enum class RenderPass : uint8_t
+    {
+        OPAQUE_PASS = 0,
+        TRANSPARENT_PASS = 1,
+    };
+
+    // @brief: everything a deferred draw call needs. The geometry and instance
+    //  buffers have to stay alive until the queue is executed
+    struct DrawPacket
+    {
+        Submesh submesh;
+        uint32_t instanceCount;
+        uint32_t startInstance;
+        // @member: binds the vertex and index buffers
+        const GeometryBindable* geometry;
+        // @member: bound to slot 1 with instanceStride, may be nullptr
+        const InstanceBindable* instances;
+        uint32_t instanceStride;
+        // @member: view space depth used to order draws with the same state
+        float depth;
+        RenderPass pass;
+        // @member: CPU copy of the bound instances (the first instance, not startInstance).
+        //  Packets that have one can be merged with packets of other objects, may be nullptr
+        const void* instanceData = nullptr;
+    };
+
+    // @brief: instance data of merged draws is stored in 16 byte chunks
+    struct InstanceChunk
+    {
+        float values[4];
+    };
+
+    // @brief: state changes of one executed queue, in submission order and after sorting
+    struct RenderQueueStats
+    {
+        uint32_t numPackets = 0u;
+        uint32_t pipelineChanges = 0u;
+        uint32_t materialChanges = 0u;
+        uint32_t geometryChanges = 0u;
+        uint32_t instanceChanges = 0u;
+        uint32_t unsortedPipelineChanges = 0u;
+        uint32_t unsortedMaterialChanges = 0u;
+        uint32_t unsortedGeometryChanges = 0u;
+        uint32_t unsortedInstanceChanges = 0u;
+        // @member: draw calls issued after merging
+        uint32_t numDraws = 0u;
+        // @member: packets that were merged into instanced draws and the draws they became
+        uint32_t mergedPackets = 0u;
+        uint32_t mergedDraws = 0u;
+    };
+
+    // Collects the draw packets of a frame and orders them with a 64 bit sort key:
+    //  opaque:      | pass 4 | pipeline 12 | material 12 | geometry 12 | depth 24 |
+    //  transparent: | pass 4 | inverted depth 24 | pipeline 12 | material 12 | geometry 12 |
+    // Resource ids are mapped to 12 bit indices in order of their first submission.
+    // The keys are radix sorted, which is stable, so packets with the same key keep
+    // their submission order.
+    // Opaque packets with the same state and index range are merged into one instanced
+    // draw when they provide their instance data, e.g. objects that each have their own
+    // batch of the same mesh. Their instances are copied into one buffer per frame and
+    // drawn where the first packet of the group was sorted to
+    class RenderQueue
+    {
+    private:
+        // @brief: the state and index range of mergeable packets, packets with the
+        //  same key are drawn with one instanced draw
+        struct MergeKey
+        {
+            const GeometryBindable* geometry;
+            ResourceId pipelineStateId;
+            ResourceId materialId;
+            size_t startVertex;
+            size_t vertexCount;
+            size_t startIndex;
+            size_t indexCount;
+            uint32_t instanceStride;
+
+            bool operator==(const MergeKey& other) const;
+        };
+        struct MergeKeyHash
+        {
+            size_t operator()(const MergeKey& key) const;
+        };
+
+        std::vector<DrawPacket> m_packets;
+        std::vector<uint64_t> m_keys;
+        // @member: scratch buffers of the radix sort
+        std::vector<uint64_t> m_sortKeys;
+        std::vector<uint64_t> m_sortedKeys;
+        std::vector<uint32_t> m_order;
+        std::vector<uint32_t> m_sortedOrder;
+        std::vector<const DrawPacket*> m_sortedPackets;
+        // @member: the draws after merging, either sorted or merged packets
+        std::vector<const DrawPacket*> m_executedPackets;
+        std::vector<DrawPacket> m_mergedPackets;
+        std::vector<InstanceChunk> m_mergedInstances;
+        // @member: scratch buffers of the merge. The members of a group are linked in
+        //  sorted order, from its head to its tail
+        std::unordered_map<MergeKey, uint32_t, MergeKeyHash> m_groupIds;
+        std::vector<uint32_t> m_groupHeads;
+        std::vector<uint32_t> m_groupTails;
+        std::vector<uint32_t> m_groupMembers;
+        std::vector<uint32_t> m_groupInstances;
+        std::vector<uint32_t> m_groupOf;
+        std::vector<uint32_t> m_nextMember;
+        std::vector<int32_t> m_executedMerges;
+        uint32_t m_numMergedPackets = 0u;
+        // @member: small indices for pipeline states, materials and geometry
+        std::unordered_map<uint64_t, uint32_t> m_sortIds[3];
+        RenderQueueStats m_stats;
+    private:
+        uint64_t SortIndex(uint32_t field, uint64_t id);
+        uint64_t ComputeKey(const DrawPacket& packet);
+        void MergeGroup(const std::vector<const DrawPacket*>& sorted, uint32_t group);
+    public:
+        void Submit(const DrawPacket& packet);
+        // @method: sorts the packets by their key
+        // @return: the packets in draw order, valid until the next Submit or Clear
+        const std::vector<const DrawPacket*>& Sort();
+        // @method: merges sorted opaque packets with the same state and index range
+        //  whose instance data is known, @see DrawPacket::instanceData
+        // @return: the packets to draw, valid until the next Submit or Clear. The merged
+        //  ones draw from the instances returned by GetMergedInstances()
+        const std::vector<const DrawPacket*>& MergeInstances(const std::vector<const DrawPacket*>& sorted);
+        // @method: sets the instance buffer the merged packets are drawn with
+        void SetMergedInstanceBuffer(const InstanceBindable* instances);
+        // @method: counts the state changes of the executed and the submitted order
+        void UpdateStats(const std::vector<const DrawPacket*>& executed);
+        void Clear();
+
+        bool IsEmpty() const { return m_packets.empty(); }
+        const std::vector<InstanceChunk>& GetMergedInstances() const { return m_mergedInstances; }
+        const RenderQueueStats& GetStats() const { return m_stats; }
+    };
+
+}
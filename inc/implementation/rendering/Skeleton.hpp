@@ -0,0 +1,39 @@
+#pragma once
+#include "implementation/rendering/AnimationFormat.hpp"
+#include "interfaces/misc/UnLoadable.hpp"
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+namespace orbit
+{
+
+    using namespace Eigen;
+
+    // The joint hierarchy skinned meshes and animation clips refer to.
+    // Parents are always stored before their children
+    class Skeleton : public UnLoadable
+    {
+    private:
+        std::vector<std::string> m_names;
+        std::vector<int32_t> m_parents;
+        // @member: local transforms of the joints in the bind pose
+        std::vector<JointPose> m_bindPose;
+        // @member: transform model space to the space of each joint in the bind pose
+        std::vector<Matrix4f> m_inverseBindPoses;
+    public:
+        bool LoadImpl(std::ifstream* stream) override;
+        void UnloadImpl() override;
+
+        uint32_t NumJoints() const { return static_cast<uint32_t>(m_parents.size()); }
+        // @method: returns the index of a joint or -1 if there is no joint with that name
+        int32_t FindJoint(const std::string& name) const;
+        const std::string& GetName(uint32_t joint) const { return m_names.at(joint); }
+        // @method: returns the parent indices of all joints, -1 for roots
+        const std::vector<int32_t>& GetParents() const { return m_parents; }
+        const std::vector<JointPose>& GetBindPose() const { return m_bindPose; }
+        const std::vector<Matrix4f>& GetInverseBindPoses() const { return m_inverseBindPoses; }
+    };
+
+}
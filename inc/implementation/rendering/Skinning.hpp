@@ -0,0 +1,30 @@
+#pragma once
+#include "implementation/rendering/AnimationFormat.hpp"
+#include "implementation/rendering/MeshChunk.hpp"
+#include "implementation/rendering/Skeleton.hpp"
+#include "implementation/rendering/Vertex.hpp"
+
+namespace orbit
+{
+
+    // Linear blend skinning on the CPU
+    class Skinning
+    {
+    public:
+        // @method: converts a local joint pose to a matrix
+        static Matrix4f PoseToMatrix(const JointPose& pose);
+
+        // @method: computes the skinning matrix of every joint
+        // @param poses: local pose of every joint, e.g. sampled from an AnimationClip
+        // @param modelTransforms: receives the model space transform of every joint
+        // @param palette: receives the model space transform times the inverse bind pose of every joint
+        static void ComputePalette(const Skeleton& skeleton, const JointPose* poses, Matrix4f* modelTransforms, Matrix4f* palette);
+
+        // @method: transforms the vertices by the weighted sum of their joints' matrices.
+        //  Normals and tangents are transformed without translation and normalized
+        // @param source: the vertices in the bind pose
+        // @param target: receives the skinned vertices, must not overlap with source
+        static void SkinVertices(const Vertex* source, const SkinWeights* weights, uint32_t numVertices, const Matrix4f* palette, Vertex* target);
+    };
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "implementation/engine/Allocator.hpp"
+#include "implementation/engine/JobSystem.hpp"
 #include "implementation/engine/SceneManager.hpp"
 #include "implementation/engine/ResourceManager.hpp"
 #include "implementation/engine/PhysxEngine.hpp"
@@ -7,19 +8,21 @@
 
 #include "interfaces/rendering/Renderer.hpp"
 
+#include <mutex>
 #include <string>
 #include <random>
 
 namespace orbit
 {
 
-    class IEngineBase : public ResourceManager, public SceneManager, public Allocator, public PhysxEngine
+    class IEngineBase : public ResourceManager, public SceneManager, public Allocator, public PhysxEngine, public JobSystem
     {
     private:
         Clock m_frameClock;
         Time m_lastFrametime;
         bool m_vsyncEnabled = false;
         std::mt19937 m_randomEngine;
+        std::mutex m_randomMutex;
     protected:
         uint32_t m_numThreads = 0;
         std::shared_ptr<IRenderer> m_renderer;
@@ -36,9 +39,12 @@ namespace orbit
         bool IsVsynced() const { return m_vsyncEnabled; }
 
         std::shared_ptr<IRenderer> Renderer() const { return m_renderer; }
+        // @method: draws a value from the engine's random engine, can be called from
+        //  the job workers. Distributions are not synchronized, share them with care
         template<class Type, class Distribution>
         Type NextRandomValue(Distribution& dist)
         {
+            std::lock_guard<std::mutex> lock(m_randomMutex);
             return dist(m_randomEngine);
         }
     };
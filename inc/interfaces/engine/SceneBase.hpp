@@ -1,10 +1,13 @@
 #pragma once
 #include "interfaces/misc/UnLoadable.hpp"
 #include "implementation/engine/GameObject.hpp"
+#include "implementation/engine/BoundingVolumeTree.hpp"
+#include "implementation/engine/EntityRegistry.hpp"
 #include "implementation/rendering/Light.hpp"
 #include "interfaces/rendering/Camera.hpp"
 #include "interfaces/misc/ConstantBuffer.hpp"
 
+#include <functional>
 #include <future>
 #include <vector>
 #include <algorithm>
@@ -20,6 +23,9 @@ namespace orbit
         float    gameTime;
     };
 
+    // @brief: updates the entities of a scene once per frame, @see ISceneBase::AddSystem
+    using SceneSystem = std::function<void(EntityRegistry& entities, const Time& dt)>;
+
     // Interface for scenes in the game engine
     // A scene is an area in the game, that the player can interact
     // with. All entities are registered in the scene
@@ -30,10 +36,17 @@ namespace orbit
         std::unordered_map<std::string, std::shared_ptr<GameObject>>               m_objectsMap;
         SPtr<IConstantBufferBase<Matrix4f, Matrix4f, SceneShaderInfo, Light[100]>> m_sceneBuffer;
         CameraPtr                                                                  m_camera;
+        ComponentRegistry                                                          m_componentRegistry;
+        EntityRegistry                                                             m_entities;
+        std::vector<SceneSystem>                                                   m_systems;
+        std::shared_ptr<BoundingVolumeTree>                                        m_spatialIndex = std::make_shared<BoundingVolumeTree>();
         bool                                                                       m_loaded = false;
         uint32_t                                                                   m_numLights = 0u;
         uint32_t                                                                   m_numDisabledLights = 0u;
     public:
+        // @method: Detaches the objects from the component registry, which is destroyed
+        //  before them. Objects that are still referenced elsewhere outlive the scene
+        virtual ~ISceneBase();
         virtual bool Load();
         virtual void Unload();
         // @method: Called whenever this scene is entered
@@ -50,12 +63,23 @@ namespace orbit
         // @method: Removes an object from the scene
         // @return: The removed Game Object
         GObjectPtr RemoveObject(const std::string& identifier);
+        // @return: The scene's entities. Entities are an alternative to game objects
+        //  for large numbers of similar things, @see EntityRegistry
+        EntityRegistry& GetEntities() { return m_entities; }
+        // @return: Bounds of the scene's batched instances, refitted after they are drawn.
+        //  Use it to find things by position, e.g. everything around the player. The user
+        //  data of the proxies is up to the component that inserted them
+        std::shared_ptr<BoundingVolumeTree> GetSpatialIndex() const { return m_spatialIndex; }
+        // @method: Adds a system that is run after the objects and hosted components are updated
+        void AddSystem(SceneSystem system) { m_systems.emplace_back(std::move(system)); }
         // @method: Sets the scene's camera
         void SetCamera(CameraPtr camera) { m_camera = camera; }
         // @return: Returns the scene's camera
         CameraPtr GetCamera() const { return m_camera; }
         // @return: True when the scene is loaded
         bool IsLoaded() const { return m_loaded; }
+        // @return: True if the object and its components take part in the frame
+        static bool IsUpdated(const GameObject& object) { return object.IsLoaded() && object.IsActive(); }
         // @brief: Adds a new light to the scene
         Light* AddLight(LightPtr light);
         // @brief: Removes a light from the scene
@@ -25,6 +25,8 @@ namespace orbit
         void SetIndices(const std::vector<int32_t>& indices) { m_indices = indices; }
 
         virtual void UpdateBuffer() = 0;
+        // @method: copies count indices starting at first into the existing GPU buffer
+        virtual void UpdateRange(uint32_t first, uint32_t count) = 0;
     };
 
 }
\ No newline at end of file
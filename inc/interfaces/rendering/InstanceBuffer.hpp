@@ -0,0 +1,137 @@
+#pragma once
+#include "interfaces/misc/Bindable.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace orbit
+{
+
+    // @brief: what the last UpdateBuffer call sent to the GPU
+    struct InstanceUploadStats
+    {
+        uint32_t uploadedInstances = 0u;
+        uint32_t uploadRanges = 0u;
+        bool reallocated = false;
+    };
+
+    // Instance data that lives as long as its owner. The buffer grows by doubling its
+    // capacity and never shrinks, so the number of instances can change every frame
+    // without reallocations. SetInstance only marks an instance as dirty when its
+    // value changed, UpdateBuffer uploads the dirty instances as a few ranges.
+    // @note: Instances are compared bytewise, they must not contain padding or pointers
+    template<typename BufferType, typename Instance>
+    class IInstanceBufferBase : public IBindable<uint32_t, uint32_t, uint32_t>
+    {
+    public:
+        using instance_type = Instance;
+
+        static constexpr uint32_t sMinCapacity = 64u;
+        // @member: clean instances between two dirty ranges are uploaded with them when
+        //  there are at most this many, one upload per range costs more than a few instances
+        static constexpr uint32_t sMaxUploadGap = 16u;
+    protected:
+        // @member: the instances of the whole capacity, the GPU buffer has the same size
+        std::vector<Instance> m_instances;
+        // @member: one bit per instance
+        std::vector<uint64_t> m_dirty;
+        uint32_t m_size = 0u;
+        uint32_t m_bufferCapacity = 0u;
+        BufferType m_buffer;
+        InstanceUploadStats m_stats;
+    protected:
+        // @method: (re)creates the GPU buffer with all instances of the capacity
+        virtual void CreateBuffer() = 0;
+        // @method: copies count instances starting at first into the GPU buffer
+        virtual void UploadRange(uint32_t first, uint32_t count) = 0;
+
+        bool IsDirty(uint32_t index) const { return (m_dirty[index / 64u] >> (index % 64u)) & 1u; }
+    public:
+        uint32_t NumInstances() const { return m_size; }
+        uint32_t Capacity() const { return static_cast<uint32_t>(m_instances.size()); }
+        BufferType GetBuffer() const { return m_buffer; }
+        const Instance& GetInstance(uint32_t index) const { return m_instances[index]; }
+        // @return: the CPU copy of the instances, @see IRenderer::SetInstances
+        const Instance* GetInstances() const { return m_instances.data(); }
+        const InstanceUploadStats& GetUploadStats() const { return m_stats; }
+
+        // @method: changes the number of instances, growing the capacity if needed.
+        //  Instances beyond the new size keep their value until they are set again
+        void Resize(uint32_t size)
+        {
+            if (size > m_instances.size())
+            {
+                const auto capacity = std::max({ size, sMinCapacity, static_cast<uint32_t>(m_instances.size()) * 2u });
+                m_instances.resize(capacity);
+                m_dirty.resize((capacity + 63u) / 64u, 0u);
+            }
+            m_size = size;
+        }
+
+        void SetInstance(uint32_t index, const Instance& instance)
+        {
+            if (std::memcmp(&m_instances[index], &instance, sizeof(Instance)) == 0)
+                return;
+            m_instances[index] = instance;
+            m_dirty[index / 64u] |= 1ull << (index % 64u);
+        }
+
+        // @method: marks every instance as dirty, e.g. after the GPU buffer was lost
+        void Invalidate() { std::fill(m_dirty.begin(), m_dirty.end(), ~0ull); }
+
+        // @method: uploads the dirty instances, or the whole buffer if it had to grow
+        void UpdateBuffer()
+        {
+            m_stats = InstanceUploadStats{};
+            if (m_instances.empty())
+                return;
+
+            if (m_bufferCapacity != m_instances.size())
+            {
+                CreateBuffer();
+                m_bufferCapacity = static_cast<uint32_t>(m_instances.size());
+                std::fill(m_dirty.begin(), m_dirty.end(), 0ull);
+                m_stats = { m_bufferCapacity, 1u, true };
+                return;
+            }
+
+            // Walk the set bits word by word and merge runs separated by small gaps
+            auto first = 0u;
+            auto last = 0u;
+            auto hasRange = false;
+            for (auto word = 0u; word < m_dirty.size(); ++word)
+            {
+                auto bits = m_dirty[word];
+                m_dirty[word] = 0ull;
+                for (auto bit = 0u; bits; ++bit, bits >>= 1u)
+                {
+                    if ((bits & 1u) == 0u)
+                        continue;
+                    const auto index = word * 64u + bit;
+                    if (hasRange && index <= last + sMaxUploadGap + 1u)
+                    {
+                        last = index;
+                        continue;
+                    }
+                    if (hasRange)
+                    {
+                        UploadRange(first, last - first + 1u);
+                        m_stats.uploadedInstances += last - first + 1u;
+                        ++m_stats.uploadRanges;
+                    }
+                    first = last = index;
+                    hasRange = true;
+                }
+            }
+            if (hasRange)
+            {
+                UploadRange(first, last - first + 1u);
+                m_stats.uploadedInstances += last - first + 1u;
+                ++m_stats.uploadRanges;
+            }
+        }
+    };
+
+}
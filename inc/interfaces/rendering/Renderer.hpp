@@ -1,5 +1,6 @@
 #pragma once
 #include "implementation/rendering/Submesh.hpp"
+#include "implementation/rendering/RenderQueue.hpp"
 
 #include <unordered_map>
 
@@ -18,6 +19,17 @@ namespace orbit
         ResourceId m_gsId = 0;
         ResourceId m_dsId = 0;
         ResourceId m_hsId = 0;
+        // @member: draws are recorded into the queue between BeginQueue and ExecuteQueue
+        RenderQueue m_queue;
+        bool m_recording = false;
+        // @member: state the next recorded draws use, @see SetGeometry
+        const GeometryBindable* m_geometry = nullptr;
+        const InstanceBindable* m_instances = nullptr;
+        uint32_t m_instanceStride = 0u;
+        const void* m_instanceData = nullptr;
+        float m_depth = 0.f;
+        RenderPass m_pass = RenderPass::OPAQUE_PASS;
+        bool m_mergeInstances = true;
     protected:
         virtual void BindTextureImpl(ResourceId id, uint32_t slot) const = 0;
         virtual void BindMaterialImpl(ResourceId id) const = 0;
@@ -26,6 +38,12 @@ namespace orbit
         virtual void BindGeometryShaderImpl(ResourceId id) const = 0;
         virtual void BindDomainShaderImpl(ResourceId id) const = 0;
         virtual void BindHullShaderImpl(ResourceId id) const = 0;
+        // @method: binds the pipeline state and material of the submesh and issues the draw call
+        virtual void DrawImpl(const Submesh& submesh, uint32_t instanceCount, uint32_t startInstance) const = 0;
+        // @method: uploads the instances of the merged draws of the queue into a buffer
+        //  that is reused every frame
+        // @return: the buffer the merged draws are drawn with
+        virtual const InstanceBindable* UpdateMergedInstancesImpl(const std::vector<InstanceChunk>& instances) = 0;
     public:
         void BindTexture(ResourceId id, uint32_t slot);
         void BindMaterial(ResourceId id);
@@ -34,7 +52,32 @@ namespace orbit
         void BindGeometryShader(ResourceId id);
         void BindDomainShader(ResourceId id);
         void BindHullShader(ResourceId id);
-        virtual void Draw(const Submesh& submesh, uint32_t instanceCount) const = 0;
+
+        // @method: sets the vertex and index buffers of the following draws and resets
+        //  the depth. Outside of a queue they are bound right away
+        void SetGeometry(const GeometryBindable* geometry);
+        // @method: sets the instance buffer of the following draws (slot 1)
+        // @param data: CPU copy of the buffer's instances. Recorded draws that have
+        //  one are merged with draws of the same mesh from other objects. It has to
+        //  stay valid until ExecuteQueue
+        void SetInstances(const InstanceBindable* instances, uint32_t stride, const void* data = nullptr);
+        // @method: sets the view space depth and pass of the following recorded draws
+        void SetDepth(float depth) { m_depth = depth; }
+        void SetPass(RenderPass pass) { m_pass = pass; }
+
+        // @method: draws a submesh with the current geometry and instances. Between
+        //  BeginQueue and ExecuteQueue the draw is recorded instead
+        // @param startInstance: offset into the bound instance buffer(s)
+        void Draw(const Submesh& submesh, uint32_t instanceCount, uint32_t startInstance = 0u);
+        // @method: starts recording draws. Geometry and instance buffers set while
+        //  recording have to stay alive until ExecuteQueue
+        void BeginQueue();
+        // @method: sorts and merges the recorded draws, draws them and stops recording
+        void ExecuteQueue();
+        // @method: enables merging draws of the same mesh into instanced draws (on by default)
+        void SetInstanceMerging(bool enabled) { m_mergeInstances = enabled; }
+        // @return: the state changes and merged draws of the last executed queue
+        const RenderQueueStats& GetQueueStats() const { return m_queue.GetStats(); }
     };
     
 }
\ No newline at end of file
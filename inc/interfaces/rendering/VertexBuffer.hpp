@@ -28,6 +28,8 @@ namespace orbit
         void SetVertices(const std::vector<Vertex>& vertices) { m_vertices = vertices; }
 
         virtual void UpdateBuffer() = 0;
+        // @method: copies count vertices starting at first into the existing GPU buffer
+        virtual void UpdateRange(uint32_t first, uint32_t count) = 0;
     };
 
 }
\ No newline at end of file
@@ -50,6 +50,8 @@ public:
 	{
 		AddComponent<MyComponent>("my_component");
 		m_camera = std::make_shared<orbit::ThirdPersonCamera>();
+		// Toggles the window and moves the character controller
+		UpdateOnMainThread();
 		m_kCom = AddComponent<orbit::KeyboardComponent>("keyboard");
 		m_mCom = AddComponent<orbit::MouseComponent>("mouse");
 		auto s = AddComponent<orbit::StateComponent<>>("state", m_kCom, m_mCom);
@@ -4,7 +4,12 @@
 void AsteroidController::Init()
 {
     m_batch  = AddComponent<orbit::StaticBatchComponent>("batch" , ENGINE->RMGetIdFromName("Asteroid"));
-	m_body   = AddComponent<orbit::RigidDynamicComponent>("body", ENGINE->RMGetIdFromName("Asteroid"));
+	// Use the collision mesh cooked by orbtool if the pack has one, all asteroid controllers share it.
+	// Cooked as a CONVEX_DECOMPOSITION the asteroids also collide with each other
+	auto colliderId = ENGINE->RMGetIdFromName("collision/Asteroid");
+	if (ENGINE->RMGetResourceType(colliderId) != orbit::ResourceType::COLLISION_MESH)
+		colliderId = ENGINE->RMGetIdFromName("Asteroid");
+	m_body   = AddComponent<orbit::RigidDynamicComponent>("body", colliderId);
 	m_body->CookBody(orbit::MaterialProperties::DefaultMaterial(), { 3.f, 3.f, 3.f }, 0);
 
 	auto device = std::random_device{};
@@ -16,6 +16,8 @@ void SpaceShip::Init()
     m_kCom = AddComponent<orbit::KeyboardComponent>("keyboard");
     m_mCom = AddComponent<orbit::MouseComponent>("mouse");
     m_batch  = AddComponent<orbit::StaticBatchComponent>("batch" , ENGINE->RMGetIdFromName("SpaceShip"));
+    // Moves the character controller, PhysX writes are not thread safe
+    UpdateOnMainThread();
 
     m_player = m_batch->AddTransform(std::make_shared<orbit::Transform>());
     m_camera->SetTarget(m_player);
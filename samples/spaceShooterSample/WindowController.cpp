@@ -3,6 +3,8 @@
 void WindowController::Init()
 {
     m_kCom = AddComponent<orbit::KeyboardComponent>("keyboard");
+    // Toggles the window, which has to happen on the thread that owns it
+    UpdateOnMainThread();
 }
 
 void WindowController::Update(const orbit::Time& dt)
@@ -10,7 +10,7 @@ int main()
 	{
 		orbit::EngineInitDesc desc;
 		desc.msaa = 8;
-		desc.numThreads = 1;
+		desc.numThreads = std::thread::hardware_concurrency();
 
 		auto window = orbit::Window::Create({ 1080, 720 }, L"Simple Sample");
 		ENGINE->Init(window, desc);
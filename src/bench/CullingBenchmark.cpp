@@ -0,0 +1,86 @@
+#include "implementation/misc/FrustumCulling.hpp"
+#include "implementation/misc/Logger.hpp"
+#include "implementation/misc/Simd.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+
+using namespace orbit;
+
+// @method: runs the pass repeatedly and returns the fastest run in milliseconds
+static double Measure(uint32_t repeat, const std::function<void()>& pass)
+{
+	auto best = -1.0;
+	for (auto i = 0u; i < repeat; ++i)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		pass();
+		const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		if (best < 0.0 || milliseconds < best)
+			best = milliseconds;
+	}
+	return best;
+}
+
+// @method: benchmarks all paths on count random spheres around a camera at the origin
+// @return: false if a kernel does not find the same spheres as the scalar loop
+static bool RunSize(const Frustum& frustum, uint32_t count, uint32_t repeat)
+{
+	std::mt19937 generator(count);
+	std::uniform_real_distribution<float> distribution(-400.f, 400.f);
+	BoundingSphereArrays spheres;
+	spheres.Resize(count);
+	for (auto i = 0u; i < count; ++i)
+	{
+		BoundingSphere sphere;
+		sphere.center = { distribution(generator), distribution(generator), distribution(generator) };
+		sphere.radius = 3.f;
+		spheres.Set(i, sphere);
+	}
+
+	std::vector<uint32_t> reference(count);
+	std::vector<uint32_t> visible(count);
+	auto numReference = 0u;
+	auto numVisible = 0u;
+	const auto scalar = Measure(repeat, [&]() {
+		numReference = 0u;
+		for (auto i = 0u; i < count; ++i)
+		{
+			if (frustum.Intersects(spheres.Get(i)))
+				reference[numReference++] = i;
+		}
+	});
+	const auto matches = [&]() { return numVisible == numReference && std::equal(visible.begin(), visible.begin() + numVisible, reference.begin()); };
+
+	const auto sse = Measure(repeat, [&]() { numVisible = FrustumCulling::CullSpheresSse(frustum, spheres, visible.data()); });
+	auto correct = matches();
+	ORBIT_LOG("%7u spheres (%u visible)  scalar %8.3f ms  SSE %8.3f ms (%5.2fx)",
+		count, numReference, scalar, sse, scalar / sse);
+	if (CpuSupportsAvx2())
+	{
+		const auto avx2 = Measure(repeat, [&]() { numVisible = FrustumCulling::CullSpheresAvx2(frustum, spheres, visible.data()); });
+		correct &= matches();
+		ORBIT_LOG("%7u spheres  AVX2 %8.3f ms (%5.2fx)", count, avx2, scalar / avx2);
+	}
+	else
+		ORBIT_LOG("AVX2 is not supported, only the SSE path was measured");
+
+	if (!correct)
+		ORBIT_ERROR("The kernels found different spheres than the scalar loop for %u spheres", count);
+	return correct;
+}
+
+int main(int argc, const char** argv)
+{
+	// @param argv[1]: number of runs per path, the fastest run is reported (default 10)
+	const auto repeat = argc > 1 ? std::max(static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)), 1u) : 10u;
+
+	// A camera at the origin looking along z, about a third of the spheres is visible
+	const auto frustum = Frustum::FromMatrix(Math<float>::Perspective(1.f, 1.6f, 0.1f, 1000.f));
+	auto matches = true;
+	for (auto count : { 1000u, 10000u, 100000u })
+		matches &= RunSize(frustum, count, repeat);
+	return matches ? 0 : 1;
+}
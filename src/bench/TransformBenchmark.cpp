@@ -0,0 +1,126 @@
+#include "implementation/misc/Logger.hpp"
+#include "implementation/misc/Simd.hpp"
+#include "implementation/misc/TransformMatrices.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+
+using namespace orbit;
+
+// @brief: the parts of a transform as the per object path stores them
+struct EigenTransform
+{
+	Vector3f location;
+	Vector3f pivot;
+	Quaternionf rotation;
+	Vector3f scaling;
+};
+
+// @method: the per object path, three affine products around the pivot and a transpose
+static void ComputeEigen(const EigenTransform& transform, Matrix4f& matrix)
+{
+	auto S = Translation3f(transform.pivot);
+	auto S_ = Translation3f(-transform.pivot);
+
+	auto aS = S * Scaling(transform.scaling) * S_;
+	auto aT = Translation3f(transform.location);
+	auto aR = S * transform.rotation * S_;
+
+	auto a = aT * aR * aS;
+	matrix = a.matrix().transpose();
+}
+
+// @method: runs the pass repeatedly and returns the fastest run in milliseconds
+static double Measure(uint32_t repeat, const std::function<void()>& pass)
+{
+	auto best = -1.0;
+	for (auto i = 0u; i < repeat; ++i)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		pass();
+		const auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		if (best < 0.0 || milliseconds < best)
+			best = milliseconds;
+	}
+	return best;
+}
+
+static float MaxDifference(const std::vector<Matrix4f>& a, const std::vector<Matrix4f>& b)
+{
+	auto difference = 0.f;
+	for (auto i = 0u; i < a.size(); ++i)
+		difference = std::max(difference, (a[i] - b[i]).cwiseAbs().maxCoeff());
+	return difference;
+}
+
+// @method: benchmarks all paths on count random transforms
+// @return: false if a kernel does not match the per object path
+static bool RunSize(uint32_t count, uint32_t repeat)
+{
+	std::mt19937 generator(count);
+	std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+	const auto random = [&]() { return distribution(generator); };
+
+	std::vector<EigenTransform> objects(count);
+	TransformArrays arrays;
+	arrays.Resize(count);
+	for (auto i = 0u; i < count; ++i)
+	{
+		auto& object = objects[i];
+		object.location = 100.f * Vector3f{ random(), random(), random() };
+		object.pivot = Vector3f{ random(), random(), random() };
+		object.rotation = Quaternionf(random(), random(), random(), random()).normalized();
+		object.scaling = Vector3f{ 1.5f + random(), 1.5f + random(), 1.5f + random() };
+		arrays.SetLocation(i, object.location);
+		arrays.SetPivot(i, object.pivot);
+		arrays.SetRotation(i, object.rotation);
+		arrays.SetScaling(i, object.scaling);
+	}
+
+	std::vector<Matrix4f> reference(count);
+	std::vector<Matrix4f> matrices(count);
+	const auto eigen = Measure(repeat, [&]() {
+		for (auto i = 0u; i < count; ++i)
+			ComputeEigen(objects[i], reference[i]);
+	});
+	const auto scalar = Measure(repeat, [&]() {
+		for (auto i = 0u; i < count; ++i)
+			TransformMatrices::ComputeOne(arrays, i, matrices[i]);
+	});
+	auto difference = MaxDifference(reference, matrices);
+	const auto sse = Measure(repeat, [&]() { TransformMatrices::ComputeSse(arrays, 0u, count, matrices.data()); });
+	difference = std::max(difference, MaxDifference(reference, matrices));
+
+	ORBIT_LOG("%7u transforms  Eigen %8.3f ms  scalar %8.3f ms (%5.2fx)  SSE %8.3f ms (%5.2fx)",
+		count, eigen, scalar, eigen / scalar, sse, eigen / sse);
+	if (CpuSupportsAvx2())
+	{
+		const auto avx2 = Measure(repeat, [&]() { TransformMatrices::ComputeAvx2(arrays, 0u, count, matrices.data()); });
+		difference = std::max(difference, MaxDifference(reference, matrices));
+		ORBIT_LOG("%7u transforms  AVX2 %8.3f ms (%5.2fx)", count, avx2, eigen / avx2);
+	}
+	else
+		ORBIT_LOG("AVX2 is not supported, only the SSE path was measured");
+
+	// The translations are up to 100, the products differ in the last bits
+	const auto tolerance = 1e-4f;
+	if (difference > tolerance)
+	{
+		ORBIT_ERROR("The kernels differ from the per object path by %g", difference);
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, const char** argv)
+{
+	// @param argv[1]: number of runs per path, the fastest run is reported (default 10)
+	const auto repeat = argc > 1 ? std::max(static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)), 1u) : 10u;
+
+	auto matches = true;
+	for (auto count : { 1000u, 10000u, 100000u })
+		matches &= RunSize(count, repeat);
+	return matches ? 0 : 1;
+}
@@ -200,6 +200,7 @@ namespace orbit
             );
         }
         m_numThreads = std::min(desc.numThreads, std::thread::hardware_concurrency());
+        StartJobWorkers(m_numThreads);
         m_renderer = std::make_shared<DirectX11Renderer>();
 
         DXGI_SWAP_CHAIN_DESC scDesc;
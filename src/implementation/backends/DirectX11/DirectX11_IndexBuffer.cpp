@@ -21,6 +21,18 @@ namespace orbit
             ORBIT_ERROR("Failed to create buffer");
     }
 
+    void DirectX11IndexBuffer::UpdateRange(uint32_t first, uint32_t count)
+    {
+        D3D11_BOX box;
+        box.left = first * sizeof(uint32_t);
+        box.right = (first + count) * sizeof(uint32_t);
+        box.top = 0u;
+        box.bottom = 1u;
+        box.front = 0u;
+        box.back = 1u;
+        ENGINE->Context()->UpdateSubresource(m_buffer.Get(), 0, &box, &m_indices[first], 0, 0);
+    }
+
     void DirectX11IndexBuffer::Bind(uint32_t offset) const
     {
         ENGINE->Context()->IASetIndexBuffer(m_buffer.Get(), DXGI_FORMAT_R32_UINT, offset);
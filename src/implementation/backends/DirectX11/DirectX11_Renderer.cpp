@@ -8,7 +8,7 @@
 namespace orbit
 {
 
-    void DirectX11Renderer::Draw(const Submesh& submesh, uint32_t instanceCount) const
+    void DirectX11Renderer::DrawImpl(const Submesh& submesh, uint32_t instanceCount, uint32_t startInstance) const
     {
         if (submesh.pipelineStateId != m_currentPipelineState)
         {
@@ -22,9 +22,19 @@ namespace orbit
         }
 
         if (submesh.indexCount > 0)
-            ENGINE->Context()->DrawIndexedInstanced(submesh.indexCount, instanceCount, submesh.startIndex, submesh.startVertex, 0);
+            ENGINE->Context()->DrawIndexedInstanced(submesh.indexCount, instanceCount, submesh.startIndex, submesh.startVertex, startInstance);
         else
-            ENGINE->Context()->DrawInstanced(submesh.vertexCount, instanceCount, submesh.startVertex, 0);
+            ENGINE->Context()->DrawInstanced(submesh.vertexCount, instanceCount, submesh.startVertex, startInstance);
+    }
+
+    const InstanceBindable* DirectX11Renderer::UpdateMergedInstancesImpl(const std::vector<InstanceChunk>& instances)
+    {
+        // Unchanged chunks are not uploaded again, which keeps static scenes cheap
+        m_mergedInstances.Resize(static_cast<uint32_t>(instances.size()));
+        for (auto i = 0u; i < instances.size(); ++i)
+            m_mergedInstances.SetInstance(i, instances[i]);
+        m_mergedInstances.UpdateBuffer();
+        return &m_mergedInstances;
     }
 
     void DirectX11Renderer::BindTextureImpl(ResourceId id, uint32_t slot) const
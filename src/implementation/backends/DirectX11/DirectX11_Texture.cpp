@@ -1,6 +1,7 @@
 #ifdef ORBIT_DIRECTX_11
 #include "implementation/backends/DirectX11/DirectX11_Texture.hpp"
 #include "implementation/misc/DDSTextureLoader.h"
+#include "implementation/misc/DDS.h"
 #include "implementation/misc/WICTextureLoader.h"
 #include "implementation/engine/Engine.hpp"
 
@@ -29,6 +30,24 @@ namespace orbit
             stream->read((char*)&textureSize, sizeof(uint64_t));
             binary.resize(textureSize);
             stream->read((char*)binary.data(), textureSize);
+            // Textures processed by orbtool are DDS files with prebuilt mips and skip WIC
+            uint32_t magic = 0u;
+            if (binary.size() >= sizeof(uint32_t))
+                std::memcpy(&magic, binary.data(), sizeof(uint32_t));
+            if (magic == DirectX::DDS_MAGIC)
+            {
+                auto result = DirectX::CreateDDSTextureFromMemory(
+                    ENGINE->Device().Get(),
+                    binary.data(),
+                    binary.size(),
+                    nullptr,
+                    m_srv.ReleaseAndGetAddressOf()
+                );
+                if (FAILED(result))
+                    ORBIT_ERROR_HR(result, "Unable to load texture %lld", GetId());
+                return true;
+            }
+
             auto result = DirectX::CreateWICTextureFromMemory(
                 ENGINE->Device().Get(),
                 ENGINE->Context().Get(),
@@ -0,0 +1,330 @@
+#include "implementation/engine/BoundingVolumeTree.hpp"
+
+#include <algorithm>
+
+namespace orbit
+{
+
+    static constexpr uint32_t sNumBins = 16u;
+    // @brief: ranges of up to this many leaves are split at the median without binning
+    static constexpr uint32_t sMinBinnedLeaves = 4u;
+
+    BoundingVolumeTree::BoundingVolumeTree(float margin) :
+        m_margin(margin)
+    {
+    }
+
+    int32_t BoundingVolumeTree::AllocateNode()
+    {
+        if (m_freeList < 0)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size() - 1u);
+        }
+        const auto node = m_freeList;
+        m_freeList = m_nodes[node].parent;
+        m_nodes[node] = Node{};
+        return node;
+    }
+
+    void BoundingVolumeTree::FreeNode(int32_t node)
+    {
+        m_nodes[node].parent = m_freeList;
+        m_nodes[node].userData = nullptr;
+        m_freeList = node;
+    }
+
+    void BoundingVolumeTree::InsertLeaf(int32_t leaf)
+    {
+        if (m_root < 0)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = -1;
+            return;
+        }
+
+        // Descend towards the sibling that increases the surface area of the tree the least.
+        // Every ancestor of the new leaf grows, that cost is inherited by both children
+        const auto box = m_nodes[leaf].box;
+        auto sibling = m_root;
+        while (!m_nodes[sibling].IsLeaf())
+        {
+            const auto& node = m_nodes[sibling];
+            const auto area = node.box.HalfArea();
+            const auto combinedArea = node.box.Merged(box).HalfArea();
+            const auto cost = 2.f * combinedArea;
+            const auto inheritedCost = 2.f * (combinedArea - area);
+
+            float childCosts[2];
+            for (auto i = 0u; i < 2u; ++i)
+            {
+                const auto& child = m_nodes[node.children[i]];
+                childCosts[i] = child.box.Merged(box).HalfArea() + inheritedCost;
+                if (!child.IsLeaf())
+                    childCosts[i] -= child.box.HalfArea();
+            }
+            if (cost < childCosts[0] && cost < childCosts[1])
+                break;
+            sibling = node.children[childCosts[0] < childCosts[1] ? 0 : 1];
+        }
+
+        const auto oldParent = m_nodes[sibling].parent;
+        const auto newParent = AllocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].box = m_nodes[sibling].box.Merged(box);
+        m_nodes[newParent].children[0] = sibling;
+        m_nodes[newParent].children[1] = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+        if (oldParent < 0)
+            m_root = newParent;
+        else
+            m_nodes[oldParent].children[m_nodes[oldParent].children[0] == sibling ? 0 : 1] = newParent;
+
+        for (auto node = oldParent; node >= 0; node = m_nodes[node].parent)
+            m_nodes[node].box = m_nodes[m_nodes[node].children[0]].box.Merged(m_nodes[m_nodes[node].children[1]].box);
+    }
+
+    void BoundingVolumeTree::RemoveLeaf(int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = -1;
+            return;
+        }
+
+        // The sibling takes the place of the parent
+        const auto parent = m_nodes[leaf].parent;
+        const auto grandParent = m_nodes[parent].parent;
+        const auto sibling = m_nodes[parent].children[m_nodes[parent].children[0] == leaf ? 1 : 0];
+        m_nodes[sibling].parent = grandParent;
+        if (grandParent < 0)
+            m_root = sibling;
+        else
+            m_nodes[grandParent].children[m_nodes[grandParent].children[0] == parent ? 0 : 1] = sibling;
+        FreeNode(parent);
+
+        for (auto node = grandParent; node >= 0; node = m_nodes[node].parent)
+            m_nodes[node].box = m_nodes[m_nodes[node].children[0]].box.Merged(m_nodes[m_nodes[node].children[1]].box);
+    }
+
+    ProxyId BoundingVolumeTree::Insert(const BoundingBox& box, void* userData)
+    {
+        const auto proxy = AllocateNode();
+        m_nodes[proxy].box = box.Expanded(m_margin);
+        m_nodes[proxy].userData = userData;
+        InsertLeaf(proxy);
+        ++m_numProxies;
+        return proxy;
+    }
+
+    void BoundingVolumeTree::Remove(ProxyId proxy)
+    {
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        --m_numProxies;
+    }
+
+    bool BoundingVolumeTree::Move(ProxyId proxy, const BoundingBox& box)
+    {
+        auto& leaf = m_nodes[proxy];
+        if (leaf.box.Contains(box))
+            return false;
+
+        // The ancestors are only enlarged, Refit shrinks them again
+        leaf.box = box.Expanded(m_margin);
+        for (auto node = leaf.parent; node >= 0 && !m_nodes[node].box.Contains(m_nodes[proxy].box); node = m_nodes[node].parent)
+            m_nodes[node].box = m_nodes[node].box.Merged(m_nodes[proxy].box);
+        return true;
+    }
+
+    void BoundingVolumeTree::Refit()
+    {
+        if (m_root < 0)
+            return;
+
+        // Parents are listed before their children, so the reversed order is bottom up
+        m_scratch.clear();
+        m_scratch.push_back(m_root);
+        for (auto i = 0u; i < m_scratch.size(); ++i)
+        {
+            const auto& node = m_nodes[m_scratch[i]];
+            if (!node.IsLeaf())
+            {
+                m_scratch.push_back(node.children[0]);
+                m_scratch.push_back(node.children[1]);
+            }
+        }
+        for (auto it = m_scratch.rbegin(); it != m_scratch.rend(); ++it)
+        {
+            auto& node = m_nodes[*it];
+            if (!node.IsLeaf())
+                node.box = m_nodes[node.children[0]].box.Merged(m_nodes[node.children[1]].box);
+        }
+
+        if (Cost() > m_builtCost * sRebuildCostRatio)
+            Rebuild();
+    }
+
+    int32_t BoundingVolumeTree::Build(int32_t* leaves, uint32_t count, int32_t parent)
+    {
+        if (count == 1u)
+        {
+            m_nodes[leaves[0]].parent = parent;
+            return leaves[0];
+        }
+
+        BoundingBox centroidBounds;
+        for (auto i = 0u; i < count; ++i)
+        {
+            const Vector3f center = m_nodes[leaves[i]].box.Center();
+            centroidBounds = centroidBounds.Merged({ center, center });
+        }
+        Vector3f::Index axis;
+        const Vector3f size = centroidBounds.max - centroidBounds.min;
+        size.maxCoeff(&axis);
+        const auto centroid = [&](int32_t leaf) { return m_nodes[leaf].box.Center()[axis]; };
+
+        auto split = count / 2u;
+        if (count > sMinBinnedLeaves && size[axis] > 0.f)
+        {
+            // Sweep the bins from both sides and take the split with the smallest
+            // surface area heuristic cost: area(left) * n(left) + area(right) * n(right)
+            BoundingBox binBoxes[sNumBins];
+            uint32_t binCounts[sNumBins] = {};
+            const auto scale = sNumBins / size[axis];
+            const auto binOf = [&](int32_t leaf) {
+                const auto bin = static_cast<uint32_t>((centroid(leaf) - centroidBounds.min[axis]) * scale);
+                return std::min(bin, sNumBins - 1u);
+            };
+            for (auto i = 0u; i < count; ++i)
+            {
+                const auto bin = binOf(leaves[i]);
+                binBoxes[bin] = binBoxes[bin].Merged(m_nodes[leaves[i]].box);
+                ++binCounts[bin];
+            }
+
+            float rightCosts[sNumBins] = {};
+            BoundingBox right;
+            auto rightCount = 0u;
+            for (auto bin = sNumBins - 1u; bin > 0u; --bin)
+            {
+                right = right.Merged(binBoxes[bin]);
+                rightCount += binCounts[bin];
+                rightCosts[bin] = right.HalfArea() * rightCount;
+            }
+
+            BoundingBox left;
+            auto leftCount = 0u;
+            auto bestCost = std::numeric_limits<float>::max();
+            auto bestBin = 0u;
+            for (auto bin = 1u; bin < sNumBins; ++bin)
+            {
+                left = left.Merged(binBoxes[bin - 1u]);
+                leftCount += binCounts[bin - 1u];
+                const auto cost = left.HalfArea() * leftCount + rightCosts[bin];
+                if (leftCount > 0u && leftCount < count && cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestBin = bin;
+                }
+            }
+            if (bestBin > 0u)
+                split = static_cast<uint32_t>(std::partition(leaves, leaves + count, [&](int32_t leaf) { return binOf(leaf) < bestBin; }) - leaves);
+            else
+                std::nth_element(leaves, leaves + split, leaves + count, [&](int32_t a, int32_t b) { return centroid(a) < centroid(b); });
+        }
+        else
+        {
+            std::nth_element(leaves, leaves + split, leaves + count, [&](int32_t a, int32_t b) { return centroid(a) < centroid(b); });
+        }
+
+        // The children are built first, m_nodes might grow in between
+        const auto node = AllocateNode();
+        const auto left = Build(leaves, split, node);
+        const auto right = Build(leaves + split, count - split, node);
+        m_nodes[node].parent = parent;
+        m_nodes[node].children[0] = left;
+        m_nodes[node].children[1] = right;
+        m_nodes[node].box = m_nodes[left].box.Merged(m_nodes[right].box);
+        return node;
+    }
+
+    void BoundingVolumeTree::Rebuild()
+    {
+        if (m_root < 0)
+            return;
+
+        // Leaves keep their index, so the proxy handles stay valid. Inner nodes are rebuilt
+        m_scratch.clear();
+        std::vector<int32_t> pending{ m_root };
+        while (!pending.empty())
+        {
+            const auto node = pending.back();
+            pending.pop_back();
+            if (m_nodes[node].IsLeaf())
+            {
+                m_scratch.push_back(node);
+                continue;
+            }
+            pending.push_back(m_nodes[node].children[0]);
+            pending.push_back(m_nodes[node].children[1]);
+            FreeNode(node);
+        }
+
+        m_root = Build(m_scratch.data(), static_cast<uint32_t>(m_scratch.size()), -1);
+        m_builtCost = Cost();
+    }
+
+    void BoundingVolumeTree::Clear()
+    {
+        m_nodes.clear();
+        m_freeList = -1;
+        m_root = -1;
+        m_numProxies = 0u;
+        m_builtCost = 0.f;
+    }
+
+    float BoundingVolumeTree::Cost() const
+    {
+        if (m_root < 0 || m_nodes[m_root].IsLeaf())
+            return 0.f;
+
+        auto area = 0.f;
+        std::vector<int32_t> pending{ m_root };
+        while (!pending.empty())
+        {
+            const auto& node = m_nodes[pending.back()];
+            pending.pop_back();
+            if (node.IsLeaf())
+                continue;
+            area += node.box.HalfArea();
+            pending.push_back(node.children[0]);
+            pending.push_back(node.children[1]);
+        }
+        const auto rootArea = m_nodes[m_root].box.HalfArea();
+        return rootArea > 0.f ? area / rootArea : 0.f;
+    }
+
+    uint32_t BoundingVolumeTree::Height() const
+    {
+        if (m_root < 0)
+            return 0u;
+
+        auto height = 0u;
+        std::vector<std::pair<int32_t, uint32_t>> pending{ { m_root, 1u } };
+        while (!pending.empty())
+        {
+            const auto [node, depth] = pending.back();
+            pending.pop_back();
+            height = std::max(height, depth);
+            if (!m_nodes[node].IsLeaf())
+            {
+                pending.emplace_back(m_nodes[node].children[0], depth + 1u);
+                pending.emplace_back(m_nodes[node].children[1], depth + 1u);
+            }
+        }
+        return height;
+    }
+
+}
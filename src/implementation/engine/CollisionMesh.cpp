@@ -0,0 +1,81 @@
+#include "implementation/engine/CollisionMesh.hpp"
+#include "implementation/engine/Engine.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <extensions/PxDefaultStreams.h>
+
+#include <vector>
+
+#define PX_RELEASE(x) if(x) { x->release(); x = nullptr; }
+
+namespace orbit
+{
+
+    CollisionMesh::~CollisionMesh()
+    {
+        UnloadImpl();
+    }
+
+    bool CollisionMesh::LoadImpl(std::ifstream* stream)
+    {
+        uint32_t physxVersion = 0u;
+        uint32_t numParts = 0u;
+        stream->read((char*)&m_shape, sizeof(CollisionShape));
+        stream->read((char*)&physxVersion, sizeof(uint32_t));
+        stream->read((char*)&numParts, sizeof(uint32_t));
+        if (physxVersion != PX_PHYSICS_VERSION)
+        {
+            ORBIT_ERROR("Collision mesh %lld was cooked with PhysX %u.%u, the engine uses %u.%u. Rebuild the resource file", GetId(),
+                physxVersion >> 24u, (physxVersion >> 16u) & 0xFFu, PX_PHYSICS_VERSION_MAJOR, PX_PHYSICS_VERSION_MINOR);
+            return false;
+        }
+
+        std::vector<uint8_t> data;
+        for (auto part = 0u; part < numParts; ++part)
+        {
+            uint64_t dataSize = 0u;
+            stream->read((char*)&dataSize, sizeof(uint64_t));
+            data.resize(dataSize);
+            stream->read((char*)data.data(), dataSize);
+            PxDefaultMemoryInputData input(data.data(), static_cast<PxU32>(dataSize));
+            if (m_shape == CollisionShape::TRIANGLE_MESH)
+            {
+                m_triangleMesh = ENGINE->GetPhysics()->createTriangleMesh(input);
+                if (!m_triangleMesh)
+                    break;
+            }
+            else
+            {
+                auto convexMesh = ENGINE->GetPhysics()->createConvexMesh(input);
+                if (!convexMesh)
+                    break;
+                m_convexMeshes.push_back(convexMesh);
+            }
+        }
+
+        if (NumParts() != numParts || numParts == 0u)
+        {
+            ORBIT_ERROR("Failed to create collision mesh %lld", GetId());
+            UnloadImpl();
+            return false;
+        }
+        return true;
+    }
+
+    void CollisionMesh::UnloadImpl()
+    {
+        PX_RELEASE(m_triangleMesh);
+        for (auto& convexMesh : m_convexMeshes)
+            PX_RELEASE(convexMesh);
+        m_convexMeshes.clear();
+    }
+
+    PxGeometryHolder CollisionMesh::GetGeometry(const Vector3f& scale, uint32_t part) const
+    {
+        const PxMeshScale meshScale(Math<float>::EigenToPx3(scale));
+        if (m_triangleMesh)
+            return PxGeometryHolder(PxTriangleMeshGeometry(m_triangleMesh, meshScale));
+        return PxGeometryHolder(PxConvexMeshGeometry(m_convexMeshes[part], meshScale));
+    }
+
+}
@@ -0,0 +1,38 @@
+#include "implementation/engine/ComponentRegistry.hpp"
+
+#include <algorithm>
+
+namespace orbit
+{
+
+    template<typename Component>
+    static void EraseEntry(std::vector<ComponentEntry<Component>>& entries, IComponent* component)
+    {
+        auto it = std::find_if(entries.begin(), entries.end(), [&](const ComponentEntry<Component>& entry) {
+            return static_cast<IComponent*>(entry.component) == component;
+        });
+        if (it != entries.end())
+            entries.erase(it);
+    }
+
+    void ComponentRegistry::Register(GameObject* object, IComponent* component)
+    {
+        if (component->test(ComponentFlags::F_RENDERABLE))
+            m_renderables.push_back({ static_cast<Renderable*>(component), object });
+        if (component->test(ComponentFlags::F_UPDATABLE))
+            m_updatables.push_back({ static_cast<Updatable*>(component), object });
+        if (component->test(ComponentFlags::F_PHYSICS))
+            m_physicals.push_back({ static_cast<Physically*>(component), object });
+    }
+
+    void ComponentRegistry::Unregister(IComponent* component)
+    {
+        if (component->test(ComponentFlags::F_RENDERABLE))
+            EraseEntry(m_renderables, component);
+        if (component->test(ComponentFlags::F_UPDATABLE))
+            EraseEntry(m_updatables, component);
+        if (component->test(ComponentFlags::F_PHYSICS))
+            EraseEntry(m_physicals, component);
+    }
+
+}
@@ -0,0 +1,229 @@
+#include "implementation/engine/EntityRegistry.hpp"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace orbit
+{
+
+    // Infos are never moved once registered, columns keep pointers to them
+    static std::deque<ComponentTypeInfo> gComponentTypes;
+    static std::mutex gComponentTypesMutex;
+
+    ComponentType RegisterComponentType(const ComponentTypeInfo& info)
+    {
+        std::lock_guard<std::mutex> lock(gComponentTypesMutex);
+        gComponentTypes.push_back(info);
+        return static_cast<ComponentType>(gComponentTypes.size() - 1u);
+    }
+
+    const ComponentTypeInfo& GetComponentTypeInfo(ComponentType type)
+    {
+        std::lock_guard<std::mutex> lock(gComponentTypesMutex);
+        return gComponentTypes[type];
+    }
+
+    ComponentColumn::ComponentColumn(ComponentType type) :
+        m_info(&GetComponentTypeInfo(type))
+    {
+    }
+
+    ComponentColumn::ComponentColumn(ComponentColumn&& other) noexcept :
+        m_info(other.m_info),
+        m_data(other.m_data),
+        m_size(other.m_size),
+        m_capacity(other.m_capacity)
+    {
+        other.m_data = nullptr;
+        other.m_size = 0u;
+        other.m_capacity = 0u;
+    }
+
+    ComponentColumn::~ComponentColumn()
+    {
+        for (auto row = 0u; row < m_size; ++row)
+            m_info->destroy(At(row));
+        ::operator delete(m_data, std::align_val_t(m_info->alignment));
+    }
+
+    void ComponentColumn::PushMoved(void* component)
+    {
+        if (m_size == m_capacity)
+        {
+            const auto capacity = std::max<size_t>(16u, m_capacity * 2u);
+            auto data = static_cast<uint8_t*>(::operator new(capacity * m_info->size, std::align_val_t(m_info->alignment)));
+            for (auto row = 0u; row < m_size; ++row)
+            {
+                m_info->moveConstruct(data + row * m_info->size, At(row));
+                m_info->destroy(At(row));
+            }
+            ::operator delete(m_data, std::align_val_t(m_info->alignment));
+            m_data = data;
+            m_capacity = capacity;
+        }
+        m_info->moveConstruct(At(m_size), component);
+        ++m_size;
+    }
+
+    void ComponentColumn::SwapRemove(size_t row)
+    {
+        const auto last = m_size - 1u;
+        m_info->destroy(At(row));
+        if (row != last)
+        {
+            m_info->moveConstruct(At(row), At(last));
+            m_info->destroy(At(last));
+        }
+        --m_size;
+    }
+
+    EntityRegistry::EntityRegistry()
+    {
+        // Archetype 0 holds the entities without components
+        GetArchetype({});
+    }
+
+    EntityRegistry::~EntityRegistry()
+    {
+    }
+
+    uint32_t EntityRegistry::GetArchetype(const std::vector<ComponentType>& signature)
+    {
+        auto it = m_archetypeLookup.find(signature);
+        if (it != m_archetypeLookup.end())
+            return it->second;
+
+        Archetype archetype;
+        archetype.signature = signature;
+        archetype.columns.reserve(signature.size());
+        for (auto type : signature)
+            archetype.columns.emplace_back(type);
+
+        const auto index = static_cast<uint32_t>(m_archetypes.size());
+        m_archetypes.push_back(std::move(archetype));
+        m_archetypeLookup.emplace(signature, index);
+        return index;
+    }
+
+    uint32_t EntityRegistry::AddEdge(uint32_t archetype, ComponentType type)
+    {
+        auto it = m_archetypes[archetype].addEdges.find(type);
+        if (it != m_archetypes[archetype].addEdges.end())
+            return it->second;
+
+        auto signature = m_archetypes[archetype].signature;
+        signature.insert(std::lower_bound(signature.begin(), signature.end(), type), type);
+        const auto target = GetArchetype(signature);
+        m_archetypes[archetype].addEdges.emplace(type, target);
+        m_archetypes[target].removeEdges.emplace(type, archetype);
+        return target;
+    }
+
+    uint32_t EntityRegistry::RemoveEdge(uint32_t archetype, ComponentType type)
+    {
+        auto it = m_archetypes[archetype].removeEdges.find(type);
+        if (it != m_archetypes[archetype].removeEdges.end())
+            return it->second;
+
+        auto signature = m_archetypes[archetype].signature;
+        signature.erase(std::lower_bound(signature.begin(), signature.end(), type));
+        const auto target = GetArchetype(signature);
+        m_archetypes[archetype].removeEdges.emplace(type, target);
+        m_archetypes[target].addEdges.emplace(type, archetype);
+        return target;
+    }
+
+    const EntityRegistry::EntityRecord* EntityRegistry::FindRecord(Entity entity) const
+    {
+        if (entity.index >= m_records.size() || m_records[entity.index].generation != entity.generation ||
+            m_records[entity.index].archetype == ~0u)
+            return nullptr;
+        return &m_records[entity.index];
+    }
+
+    void EntityRegistry::RemoveRow(uint32_t archetype, uint32_t row)
+    {
+        auto& entities = m_archetypes[archetype].entities;
+        if (row + 1u != entities.size())
+        {
+            entities[row] = entities.back();
+            m_records[entities[row].index].row = row;
+        }
+        entities.pop_back();
+    }
+
+    void EntityRegistry::MoveEntity(Entity entity, uint32_t target)
+    {
+        auto& record = m_records[entity.index];
+        auto& source = m_archetypes[record.archetype];
+        auto& destination = m_archetypes[target];
+
+        // Both signatures are sorted, so the shared columns are found in one pass
+        auto column = 0u;
+        for (auto i = 0u; i < source.signature.size(); ++i)
+        {
+            while (column < destination.signature.size() && destination.signature[column] < source.signature[i])
+                ++column;
+            if (column < destination.signature.size() && destination.signature[column] == source.signature[i])
+                destination.columns[column].PushMoved(source.columns[i].At(record.row));
+            source.columns[i].SwapRemove(record.row);
+        }
+        RemoveRow(record.archetype, record.row);
+
+        destination.entities.push_back(entity);
+        record.archetype = target;
+        record.row = static_cast<uint32_t>(destination.entities.size() - 1u);
+    }
+
+    Entity EntityRegistry::Create()
+    {
+        Entity entity;
+        if (!m_freeIndices.empty())
+        {
+            entity.index = m_freeIndices.back();
+            m_freeIndices.pop_back();
+        }
+        else
+        {
+            entity.index = static_cast<uint32_t>(m_records.size());
+            m_records.push_back(EntityRecord{ ~0u, 0u, 0u });
+        }
+        entity.generation = m_records[entity.index].generation;
+
+        auto& empty = m_archetypes[0];
+        empty.entities.push_back(entity);
+        m_records[entity.index].archetype = 0u;
+        m_records[entity.index].row = static_cast<uint32_t>(empty.entities.size() - 1u);
+        ++m_numEntities;
+        return entity;
+    }
+
+    void EntityRegistry::Destroy(Entity entity)
+    {
+        if (!FindRecord(entity))
+            return;
+
+        auto& record = m_records[entity.index];
+        for (auto& column : m_archetypes[record.archetype].columns)
+            column.SwapRemove(record.row);
+        RemoveRow(record.archetype, record.row);
+
+        record.archetype = ~0u;
+        ++record.generation;
+        m_freeIndices.push_back(entity.index);
+        --m_numEntities;
+    }
+
+    void EntityRegistry::HostComponent(Entity entity, std::shared_ptr<IComponent> component)
+    {
+        // The flags tell which interface the component implements
+        if (component->test(ComponentFlags::F_RENDERABLE))
+            Add<HostedRenderable>(entity, std::static_pointer_cast<Renderable>(component));
+        if (component->test(ComponentFlags::F_UPDATABLE))
+            Add<HostedUpdatable>(entity, std::static_pointer_cast<Updatable>(component));
+        if (component->test(ComponentFlags::F_PHYSICS))
+            Add<HostedPhysically>(entity, std::static_pointer_cast<Physically>(component));
+    }
+
+}
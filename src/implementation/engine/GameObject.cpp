@@ -3,8 +3,43 @@
 namespace orbit
 {
 
+    GameObject::~GameObject()
+    {
+        SetRegistry(nullptr);
+    }
+
+    void GameObject::SetRegistry(ComponentRegistry* registry)
+    {
+        if (registry == m_registry)
+            return;
+
+        for (auto& component : m_components)
+        {
+            if (m_registry)
+                m_registry->Unregister(component.second.get());
+            if (registry)
+                registry->Register(this, component.second.get());
+        }
+        m_registry = registry;
+    }
+
+    std::shared_ptr<IComponent> GameObject::RemoveComponent(const std::string& identifier)
+    {
+        auto it = m_components.find(identifier);
+        if (it == m_components.end())
+            return nullptr;
+
+        auto component = it->second;
+        m_components.erase(it);
+        if (m_registry)
+            m_registry->Unregister(component.get());
+        return component;
+    }
+
     void GameObject::Update(const Time& dt)
     {
+        if (m_registry)
+            return;
         for (auto& component : m_components)
         {
             if (component.second->test(ComponentFlags::F_UPDATABLE))
@@ -14,6 +49,8 @@ namespace orbit
     
     void GameObject::PhysicsUpdate(size_t millis)
     {
+        if (m_registry)
+            return;
         for (auto& component : m_components)
         {
             if (component.second->test(ComponentFlags::F_PHYSICS))
@@ -23,6 +60,8 @@ namespace orbit
 
     void GameObject::Draw() const
     {
+        if (m_registry)
+            return;
         for (auto& component : m_components)
         {
             if (component.second->test(ComponentFlags::F_RENDERABLE))
@@ -30,4 +69,4 @@ namespace orbit
         }
     }
 
-}
\ No newline at end of file
+}
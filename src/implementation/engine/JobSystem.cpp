@@ -0,0 +1,239 @@
+#include "implementation/engine/JobSystem.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <chrono>
+
+namespace orbit
+{
+
+    // Workers of the job system running on this thread, a thread can only
+    // belong to one job system
+    static thread_local const JobSystem* tJobSystem = nullptr;
+    static thread_local uint32_t tWorkerIndex = 0u;
+
+    JobSystem::~JobSystem()
+    {
+        StopJobWorkers();
+    }
+
+    void JobSystem::StartJobWorkers(uint32_t numWorkers)
+    {
+        StopJobWorkers();
+        numWorkers = std::max(numWorkers, 1u);
+        ORBIT_INFO_LEVEL(ORBIT_LEVEL_DEBUG, "Starting job system with %u workers", numWorkers);
+
+        m_workers.clear();
+        for (auto i = 0u; i < numWorkers; ++i)
+        {
+            m_workers.emplace_back(std::make_unique<Worker>());
+            m_workers.back()->nextVictim = (i + 1u) % numWorkers;
+        }
+
+        tJobSystem = this;
+        tWorkerIndex = 0u;
+        m_running = true;
+        for (auto i = 1u; i < numWorkers; ++i)
+            m_threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    void JobSystem::StopJobWorkers()
+    {
+        if (m_threads.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_running = false;
+        }
+        m_wakeCondition.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+        m_threads.clear();
+    }
+
+    uint32_t JobSystem::CurrentWorker() const
+    {
+        return tJobSystem == this ? tWorkerIndex : 0u;
+    }
+
+    void JobSystem::Push(uint32_t worker, const Job& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_workers[worker]->mutex);
+            m_workers[worker]->jobs.push_back(job);
+        }
+        // A worker going to sleep increments the sleeping count before it checks
+        // the queued jobs, so one of both sides sees the other
+        m_queuedJobs.fetch_add(1u);
+        if (m_sleepingWorkers.load() > 0u)
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_wakeCondition.notify_one();
+        }
+    }
+
+    bool JobSystem::Pop(uint32_t worker, Job* job)
+    {
+        std::lock_guard<std::mutex> lock(m_workers[worker]->mutex);
+        auto& jobs = m_workers[worker]->jobs;
+        if (jobs.empty())
+            return false;
+
+        *job = jobs.back();
+        jobs.pop_back();
+        m_queuedJobs.fetch_sub(1u);
+        return true;
+    }
+
+    bool JobSystem::Steal(uint32_t worker, Job* job)
+    {
+        auto& self = *m_workers[worker];
+        const auto numWorkers = static_cast<uint32_t>(m_workers.size());
+        for (auto attempt = 0u; attempt < numWorkers; ++attempt)
+        {
+            // Victims are visited round robin, starting after the last successful one
+            const auto victim = self.nextVictim.load(std::memory_order_relaxed) % numWorkers;
+            self.nextVictim.store(victim + 1u, std::memory_order_relaxed);
+            if (victim == worker)
+                continue;
+
+            auto& other = *m_workers[victim];
+            std::unique_lock<std::mutex> lock(other.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || other.jobs.empty())
+                continue;
+
+            *job = other.jobs.front();
+            other.jobs.pop_front();
+            m_queuedJobs.fetch_sub(1u);
+            self.nextVictim.store(victim, std::memory_order_relaxed);
+            self.steals.fetch_add(1u, std::memory_order_relaxed);
+            return true;
+        }
+        self.failedSteals.fetch_add(1u, std::memory_order_relaxed);
+        return false;
+    }
+
+    void JobSystem::Execute(uint32_t worker, Job job)
+    {
+        auto& self = *m_workers[worker];
+        self.executed.fetch_add(1u, std::memory_order_relaxed);
+        try
+        {
+            while (job.begin < job.end)
+            {
+                if (job.end - job.begin > job.grain)
+                {
+                    bool hungry;
+                    {
+                        std::lock_guard<std::mutex> lock(self.mutex);
+                        hungry = self.jobs.empty();
+                    }
+                    if (hungry)
+                    {
+                        auto upper = job;
+                        upper.begin = job.begin + (job.end - job.begin) / 2u;
+                        job.end = upper.begin;
+                        job.counter->m_pending.fetch_add(1u, std::memory_order_relaxed);
+                        Push(worker, upper);
+                    }
+                }
+
+                const auto end = std::min(job.end, job.begin + job.grain);
+                job.function(job.context, job.begin, end);
+                job.begin = end;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(job.counter->m_errorMutex);
+            if (!job.counter->m_error)
+                job.counter->m_error = std::current_exception();
+        }
+        job.counter->m_pending.fetch_sub(1u, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::WorkerLoop(uint32_t worker)
+    {
+        tJobSystem = this;
+        tWorkerIndex = worker;
+
+        auto& self = *m_workers[worker];
+        while (m_running)
+        {
+            Job job;
+            if (Pop(worker, &job) || Steal(worker, &job))
+            {
+                Execute(worker, job);
+                continue;
+            }
+
+            const auto idleBegin = std::chrono::steady_clock::now();
+            auto found = false;
+            for (auto spin = 0u; spin < sSpinsBeforeSleep && !found; ++spin)
+            {
+                std::this_thread::yield();
+                found = Steal(worker, &job);
+            }
+            if (!found)
+            {
+                std::unique_lock<std::mutex> lock(m_sleepMutex);
+                m_sleepingWorkers.fetch_add(1u);
+                m_wakeCondition.wait(lock, [this]() { return m_queuedJobs.load() > 0u || !m_running; });
+                m_sleepingWorkers.fetch_sub(1u);
+            }
+            self.idleMicroseconds.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - idleBegin).count(), std::memory_order_relaxed);
+            if (found)
+                Execute(worker, job);
+        }
+    }
+
+    void JobSystem::WaitForJobs(JobCounter& counter)
+    {
+        const auto worker = CurrentWorker();
+        auto& self = *m_workers[worker];
+        while (!counter.IsDone())
+        {
+            // Help instead of blocking, the jobs waited for are most likely in the own deque
+            Job job;
+            if (Pop(worker, &job) || Steal(worker, &job))
+            {
+                Execute(worker, job);
+                continue;
+            }
+
+            const auto idleBegin = std::chrono::steady_clock::now();
+            std::this_thread::yield();
+            self.idleMicroseconds.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - idleBegin).count(), std::memory_order_relaxed);
+        }
+
+        if (counter.m_error)
+            std::rethrow_exception(counter.m_error);
+    }
+
+    JobStats JobSystem::GetJobStats() const
+    {
+        JobStats stats;
+        for (const auto& worker : m_workers)
+        {
+            stats.jobs += worker->executed.load(std::memory_order_relaxed);
+            stats.steals += worker->steals.load(std::memory_order_relaxed);
+            stats.failedSteals += worker->failedSteals.load(std::memory_order_relaxed);
+            stats.idleMicroseconds += worker->idleMicroseconds.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void JobSystem::ResetJobStats()
+    {
+        for (auto& worker : m_workers)
+        {
+            worker->executed.store(0u, std::memory_order_relaxed);
+            worker->steals.store(0u, std::memory_order_relaxed);
+            worker->failedSteals.store(0u, std::memory_order_relaxed);
+            worker->idleMicroseconds.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+}
@@ -0,0 +1,85 @@
+#include "implementation/engine/RangeAllocator.hpp"
+
+namespace orbit
+{
+
+    RangeAllocator::RangeAllocator(SizeType size)
+    {
+        Grow(size);
+    }
+
+    void RangeAllocator::AddNewBlock(OffsetType offset, SizeType size)
+    {
+        auto offsetIt = m_freeListByOffset.emplace(offset, size);
+        auto sizeIt = m_freeListBySize.emplace(size, offsetIt.first);
+        offsetIt.first->second.freeListBySizeIt = sizeIt;
+    }
+
+    RangeAllocator::OffsetType RangeAllocator::Allocate(SizeType size)
+    {
+        if (size == 0u || size > m_numFree)
+            return sInvalidOffset;
+
+        auto smallestBlockIt = m_freeListBySize.lower_bound(size);
+        if (smallestBlockIt == m_freeListBySize.end())
+            return sInvalidOffset;
+
+        const auto blockSize = smallestBlockIt->first;
+        const auto offsetIt = smallestBlockIt->second;
+        const auto offset = offsetIt->first;
+        m_freeListBySize.erase(smallestBlockIt);
+        m_freeListByOffset.erase(offsetIt);
+
+        // The rest of the block stays free
+        if (blockSize > size)
+            AddNewBlock(offset + size, blockSize - size);
+        m_numFree -= size;
+        return offset;
+    }
+
+    void RangeAllocator::Free(OffsetType offset, SizeType size)
+    {
+        if (size == 0u)
+            return;
+
+        auto nextBlockIt = m_freeListByOffset.upper_bound(offset);
+        auto prevBlockIt = nextBlockIt;
+        if (prevBlockIt != m_freeListByOffset.begin())
+            --prevBlockIt;
+        else
+            prevBlockIt = m_freeListByOffset.end();
+
+        m_numFree += size;
+
+        // Merge with the blocks directly before and after the freed range
+        if (prevBlockIt != m_freeListByOffset.end() &&
+            offset == prevBlockIt->first + prevBlockIt->second.size)
+        {
+            offset = prevBlockIt->first;
+            size += prevBlockIt->second.size;
+            m_freeListBySize.erase(prevBlockIt->second.freeListBySizeIt);
+            m_freeListByOffset.erase(prevBlockIt);
+        }
+        if (nextBlockIt != m_freeListByOffset.end() &&
+            offset + size == nextBlockIt->first)
+        {
+            size += nextBlockIt->second.size;
+            m_freeListBySize.erase(nextBlockIt->second.freeListBySizeIt);
+            m_freeListByOffset.erase(nextBlockIt);
+        }
+
+        AddNewBlock(offset, size);
+    }
+
+    void RangeAllocator::Grow(SizeType size)
+    {
+        if (size <= m_size)
+            return;
+
+        // Free merges the new space with a free block at the old end
+        const auto offset = m_size;
+        m_size = size;
+        Free(offset, size - offset);
+    }
+
+}
@@ -62,8 +62,11 @@ namespace orbit
             header.name.resize(nameLen);
             file.read(header.name.data(), nameLen);
             index.offset = file.tellg();
+            index.payloadSize = header.payloadSize;
             file.seekg(header.payloadSize, std::ios::cur);
             index.type = header.type;
+            if (header.type == ResourceType::PADDING)
+                continue;
             
             auto id = RMGetNextResourceId();
             RMRegisterResourceName(header.name, id);
@@ -84,12 +87,26 @@ namespace orbit
             ORBIT_ERROR("Unable to load resource %lld", id);
             return false;
         }
+        {
+            std::lock_guard<std::mutex> lock(m_traceMutex);
+            if (m_traceLoads && m_tracedIds.insert(id).second)
+                m_loadTrace.push_back(id);
+        }
+
         const auto& filepath = m_parsedFiles.at(headerIt->second.fileIndex);
         stream->open(filepath, std::ios::binary | std::ios::in);
         stream->seekg(headerIt->second.offset, std::ios::beg);
         return stream->good();
     }
 
+    size_t ResourceManager::RMGetPayloadSize(ResourceId id) const
+    {
+        auto headerIt = m_index.find(id);
+        if (headerIt == m_index.end())
+            return 0u;
+        return headerIt->second.payloadSize;
+    }
+
     bool ResourceManager::RMRegisterResourceName(const std::string& name, ResourceId id)
     {
 #ifdef _DEBUG
@@ -130,6 +147,37 @@ namespace orbit
         return it->second.type;
     }
 
+    void ResourceManager::RMBeginLoadTrace()
+    {
+        std::lock_guard<std::mutex> lock(m_traceMutex);
+        m_traceLoads = true;
+        m_loadTrace.clear();
+        m_tracedIds.clear();
+    }
+
+    bool ResourceManager::RMWriteLoadTrace(const fs::path& path) const
+    {
+        std::unordered_map<ResourceId, const std::string*> names;
+        for (const auto& [name, id] : m_resourceNames)
+            names.emplace(id, &name);
+
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            ORBIT_ERROR("Unable to write load trace '%s'", path.generic_string().c_str());
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_traceMutex);
+        for (auto id : m_loadTrace)
+        {
+            auto it = names.find(id);
+            if (it != names.end())
+                file << *it->second << '\n';
+        }
+        ORBIT_INFO_LEVEL(ORBIT_LEVEL_DEBUG, "Wrote load trace of %zu resources to '%s'", m_loadTrace.size(), path.generic_string().c_str());
+        return file.good();
+    }
+
     void ResourceManager::RMDrawDebug() const
     {
         static uint32_t numFrames = 0;
@@ -161,15 +209,26 @@ namespace orbit
 		ImGui::SetNextWindowBgAlpha(0.35f);
 		ImGui::Begin("Resources", nullptr, window_flags);
         ImGui::Text("FPS: %d", fps);
+        const auto& queue = ENGINE->Renderer()->GetQueueStats();
+        ImGui::Text("Draws: %u (%u submitted)", queue.numDraws, queue.numPackets);
+        ImGui::Text("Merged: %u draws into %u", queue.mergedPackets, queue.mergedDraws);
+        ImGui::Text("State changes (submitted -> sorted)");
+        ImGui::Text("  pipeline: %u -> %u", queue.unsortedPipelineChanges, queue.pipelineChanges);
+        ImGui::Text("  material: %u -> %u", queue.unsortedMaterialChanges, queue.materialChanges);
+        ImGui::Text("  geometry: %u -> %u", queue.unsortedGeometryChanges, queue.geometryChanges);
+        ImGui::Text("  instances: %u -> %u", queue.unsortedInstanceChanges, queue.instanceChanges);
         for (const auto& resource : m_resourceNames)
         {
             if (ImGui::TreeNode(resource.first.c_str()))
             {
                 const auto& index = m_index.find(resource.second);
                 bool t = false;
-                auto it = m_resources.find(resource.second);
-                if (it != m_resources.end())
-                    t = it->second->IsLoaded();
+                {
+                    std::lock_guard<std::recursive_mutex> lock(m_resourceMutex);
+                    auto it = m_resources.find(resource.second);
+                    if (it != m_resources.end())
+                        t = it->second->IsLoaded();
+                }
                 
                 ImGui::Checkbox("Loaded: ", &t);
                 ImGui::TreePop();
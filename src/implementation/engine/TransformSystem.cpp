@@ -0,0 +1,433 @@
+#include "implementation/engine/TransformSystem.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+
+namespace orbit
+{
+
+    // @brief: slots the update checks for dirty ones at a time, the batch size of the kernels
+    static constexpr uint32_t sBatchSize = 8u;
+
+    uint32_t TransformSystem::AppendSlot()
+    {
+        const auto slot = static_cast<uint32_t>(m_handles.size());
+        const auto size = slot + 1u;
+        m_local.Resize(size);
+        m_localMatrices.resize(size);
+        m_worldMatrices.resize(size);
+        m_worldRotations.resize(size);
+        m_worldScalings.resize(size);
+        m_parentSlots.resize(size, sNullSlot);
+        m_handles.resize(size, sNullTransform);
+        m_dirty.resize(size, 0u);
+        return slot;
+    }
+
+    void TransformSystem::FreeSlot(uint32_t slot)
+    {
+        m_handles[slot] = sNullTransform;
+        m_parentSlots[slot] = sNullSlot;
+        m_dirty[slot] = 0u;
+        m_freeSlots.push_back(slot);
+    }
+
+    void TransformSystem::Link(TransformHandle handle, TransformHandle parent)
+    {
+        m_parents[handle] = parent;
+        if (parent == sNullTransform)
+        {
+            m_parentSlots[m_slots[handle]] = sNullSlot;
+            return;
+        }
+        m_nextSiblings[handle] = m_firstChildren[parent];
+        m_firstChildren[parent] = handle;
+        m_parentSlots[m_slots[handle]] = m_slots[parent];
+    }
+
+    void TransformSystem::Unlink(TransformHandle handle)
+    {
+        const auto parent = m_parents[handle];
+        if (parent == sNullTransform)
+            return;
+
+        auto* link = &m_firstChildren[parent];
+        while (*link != handle)
+            link = &m_nextSiblings[*link];
+        *link = m_nextSiblings[handle];
+        m_nextSiblings[handle] = sNullTransform;
+        m_parents[handle] = sNullTransform;
+        m_parentSlots[m_slots[handle]] = sNullSlot;
+    }
+
+    void TransformSystem::Relocate(TransformHandle handle)
+    {
+        // Breadth first, every transform is appended after its parent
+        m_scratch.clear();
+        m_scratch.push_back(handle);
+        for (auto i = 0u; i < m_scratch.size(); ++i)
+        {
+            for (auto child = m_firstChildren[m_scratch[i]]; child != sNullTransform; child = m_nextSiblings[child])
+                m_scratch.push_back(child);
+        }
+
+        for (auto moved : m_scratch)
+        {
+            const auto from = m_slots[moved];
+            const auto to = AppendSlot();
+            m_local.Copy(from, to);
+            m_localMatrices[to] = m_localMatrices[from];
+            m_worldMatrices[to] = m_worldMatrices[from];
+            m_worldRotations[to] = m_worldRotations[from];
+            m_worldScalings[to] = m_worldScalings[from];
+            m_dirty[to] = m_dirty[from];
+            m_handles[to] = moved;
+            m_slots[moved] = to;
+            const auto parent = m_parents[moved];
+            m_parentSlots[to] = parent == sNullTransform ? sNullSlot : m_slots[parent];
+            FreeSlot(from);
+        }
+    }
+
+    void TransformSystem::Compact()
+    {
+        // Moving the used slots down keeps their order, parents stay in front
+        auto count = 0u;
+        for (auto slot = 0u; slot < m_handles.size(); ++slot)
+        {
+            const auto handle = m_handles[slot];
+            if (handle == sNullTransform)
+                continue;
+            if (slot != count)
+            {
+                m_local.Copy(slot, count);
+                m_localMatrices[count] = m_localMatrices[slot];
+                m_worldMatrices[count] = m_worldMatrices[slot];
+                m_worldRotations[count] = m_worldRotations[slot];
+                m_worldScalings[count] = m_worldScalings[slot];
+                m_dirty[count] = m_dirty[slot];
+                m_handles[count] = handle;
+                m_slots[handle] = count;
+            }
+            const auto parent = m_parents[handle];
+            m_parentSlots[count] = parent == sNullTransform ? sNullSlot : m_slots[parent];
+            ++count;
+        }
+
+        m_local.Resize(count);
+        m_localMatrices.resize(count);
+        m_worldMatrices.resize(count);
+        m_worldRotations.resize(count);
+        m_worldScalings.resize(count);
+        m_parentSlots.resize(count);
+        m_handles.resize(count);
+        m_dirty.resize(count);
+        m_freeSlots.clear();
+    }
+
+    void TransformSystem::MarkDirty(TransformHandle handle)
+    {
+        // Descendants of dirty transforms are dirty already
+        if (m_dirty[m_slots[handle]])
+            return;
+
+        TransformHandle stack[64];
+        std::vector<TransformHandle> spill;
+        auto size = 0u;
+        stack[size++] = handle;
+        while (size > 0u || !spill.empty())
+        {
+            TransformHandle current;
+            if (!spill.empty())
+            {
+                current = spill.back();
+                spill.pop_back();
+            }
+            else
+                current = stack[--size];
+
+            m_dirty[m_slots[current]] = 1u;
+            for (auto child = m_firstChildren[current]; child != sNullTransform; child = m_nextSiblings[child])
+            {
+                if (m_dirty[m_slots[child]])
+                    continue;
+                if (size < 64u)
+                    stack[size++] = child;
+                else
+                    spill.push_back(child);
+            }
+        }
+    }
+
+    void TransformSystem::ComputeLocalMatrix(uint32_t slot)
+    {
+        TransformMatrices::ComputeOne(m_local, slot, m_localMatrices[slot]);
+    }
+
+    void TransformSystem::ComputeWorld(uint32_t slot)
+    {
+        // (parent * local)^T = local^T * parent^T
+        const auto parent = m_parentSlots[slot];
+        if (parent == sNullSlot)
+        {
+            m_worldMatrices[slot] = m_localMatrices[slot];
+            m_worldRotations[slot] = m_local.GetRotation(slot);
+            m_worldScalings[slot] = m_local.GetScaling(slot);
+        }
+        else
+        {
+            m_worldMatrices[slot] = m_localMatrices[slot] * m_worldMatrices[parent];
+            m_worldRotations[slot] = m_worldRotations[parent] * m_local.GetRotation(slot);
+            m_worldScalings[slot] = m_local.GetScaling(slot).cwiseProduct(m_worldScalings[parent]);
+        }
+        m_dirty[slot] = 0u;
+    }
+
+    void TransformSystem::UpdateChain(uint32_t slot)
+    {
+        // Ancestors of clean transforms are clean
+        auto top = slot;
+        while (m_parentSlots[top] != sNullSlot && m_dirty[m_parentSlots[top]])
+            top = m_parentSlots[top];
+
+        uint32_t stack[64];
+        std::vector<uint32_t> spill;
+        auto size = 0u;
+        for (auto current = slot; ; current = m_parentSlots[current])
+        {
+            if (size < 64u)
+                stack[size++] = current;
+            else
+                spill.push_back(current);
+            if (current == top)
+                break;
+        }
+        while (!spill.empty())
+        {
+            ComputeLocalMatrix(spill.back());
+            ComputeWorld(spill.back());
+            spill.pop_back();
+        }
+        while (size > 0u)
+        {
+            ComputeLocalMatrix(stack[--size]);
+            ComputeWorld(stack[size]);
+        }
+    }
+
+    TransformHandle TransformSystem::Create()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TransformHandle handle;
+        if (m_freeHandles.empty())
+        {
+            handle = static_cast<TransformHandle>(m_slots.size());
+            m_slots.push_back(sNullSlot);
+            m_parents.push_back(sNullTransform);
+            m_firstChildren.push_back(sNullTransform);
+            m_nextSiblings.push_back(sNullTransform);
+        }
+        else
+        {
+            handle = m_freeHandles.back();
+            m_freeHandles.pop_back();
+        }
+
+        // Transforms without a parent can use any slot
+        uint32_t slot;
+        if (m_freeSlots.empty())
+            slot = AppendSlot();
+        else
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        m_local.SetLocation(slot, Vector3f::Zero());
+        m_local.SetRotation(slot, Quaternionf::Identity());
+        m_local.SetScaling(slot, Vector3f::Ones());
+        m_local.SetPivot(slot, Vector3f::Zero());
+        m_parentSlots[slot] = sNullSlot;
+        m_handles[slot] = handle;
+        m_dirty[slot] = 1u;
+        m_slots[handle] = slot;
+        m_parents[handle] = sNullTransform;
+        m_firstChildren[handle] = sNullTransform;
+        m_nextSiblings[handle] = sNullTransform;
+        ++m_numTransforms;
+        return handle;
+    }
+
+    void TransformSystem::Release(TransformHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (m_firstChildren[handle] != sNullTransform)
+        {
+            const auto child = m_firstChildren[handle];
+            MarkDirty(child);
+            Unlink(child);
+        }
+        Unlink(handle);
+        FreeSlot(m_slots[handle]);
+        m_slots[handle] = sNullSlot;
+        m_freeHandles.push_back(handle);
+        --m_numTransforms;
+    }
+
+    bool TransformSystem::SetParent(TransformHandle handle, TransformHandle parent)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto ancestor = parent; ancestor != sNullTransform; ancestor = m_parents[ancestor])
+        {
+            if (ancestor == handle)
+            {
+                ORBIT_ERROR("A transform can not be attached to itself or one of its children.");
+                return false;
+            }
+        }
+
+        Unlink(handle);
+        Link(handle, parent);
+        if (parent != sNullTransform && m_slots[parent] > m_slots[handle])
+            Relocate(handle);
+        MarkDirty(handle);
+        return true;
+    }
+
+    void TransformSystem::Update()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeSlots.size() > m_numTransforms)
+            Compact();
+        const auto count = static_cast<uint32_t>(m_handles.size());
+
+        // The local matrices only depend on their own slot. Runs of batches that contain
+        // dirty slots are computed at once, recomputing their clean and free slots is harmless
+        auto runStart = 0u;
+        for (auto batch = 0u; batch < count; batch += sBatchSize)
+        {
+            const auto batchEnd = std::min(batch + sBatchSize, count);
+            const auto dirty = std::any_of(m_dirty.begin() + batch, m_dirty.begin() + batchEnd, [](uint8_t flag) { return flag != 0u; });
+            if (!dirty && runStart < batch)
+                TransformMatrices::Compute(m_local, runStart, batch - runStart, m_localMatrices.data() + runStart);
+            if (!dirty)
+                runStart = batchEnd;
+        }
+        if (runStart < count)
+            TransformMatrices::Compute(m_local, runStart, count - runStart, m_localMatrices.data() + runStart);
+
+        // Parents come first, their world matrices are up to date when the children read them
+        for (auto slot = 0u; slot < count; ++slot)
+        {
+            if (m_dirty[slot])
+                ComputeWorld(slot);
+        }
+    }
+
+    Vector3f TransformSystem::GetLocation(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_local.GetLocation(m_slots[handle]);
+    }
+
+    void TransformSystem::SetLocation(TransformHandle handle, const Vector3f& location)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_local.SetLocation(m_slots[handle], location);
+        MarkDirty(handle);
+    }
+
+    Quaternionf TransformSystem::GetRotation(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_local.GetRotation(m_slots[handle]);
+    }
+
+    void TransformSystem::SetRotation(TransformHandle handle, const Quaternionf& rotation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_local.SetRotation(m_slots[handle], rotation);
+        MarkDirty(handle);
+    }
+
+    Vector3f TransformSystem::GetScaling(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_local.GetScaling(m_slots[handle]);
+    }
+
+    void TransformSystem::SetScaling(TransformHandle handle, const Vector3f& scaling)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_local.SetScaling(m_slots[handle], scaling);
+        MarkDirty(handle);
+    }
+
+    Vector3f TransformSystem::GetPivot(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_local.GetPivot(m_slots[handle]);
+    }
+
+    void TransformSystem::SetPivot(TransformHandle handle, const Vector3f& pivot)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_local.SetPivot(m_slots[handle], pivot);
+        MarkDirty(handle);
+    }
+
+    Matrix4f TransformSystem::GetWorldMatrix(TransformHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_worldMatrices[CleanSlot(handle)];
+    }
+
+    Quaternionf TransformSystem::GetWorldRotation(TransformHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_worldRotations[CleanSlot(handle)];
+    }
+
+    Vector3f TransformSystem::GetWorldScaling(TransformHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_worldScalings[CleanSlot(handle)];
+    }
+
+    Vector3f TransformSystem::GetWorldLocation(TransformHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto slot = CleanSlot(handle);
+        const auto location = m_local.GetLocation(slot);
+        const auto parent = m_parentSlots[slot];
+        if (parent == sNullSlot)
+            return location;
+        const Vector4f world = Vector4f{ location.x(), location.y(), location.z(), 1.f }.transpose() * m_worldMatrices[parent];
+        return world.head<3>();
+    }
+
+    TransformHandle TransformSystem::GetParent(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parents[handle];
+    }
+
+    bool TransformSystem::IsDirty(TransformHandle handle) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dirty[m_slots[handle]] != 0u;
+    }
+
+    uint32_t TransformSystem::NumTransforms() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_numTransforms;
+    }
+
+    uint32_t TransformSystem::NumSlots() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<uint32_t>(m_handles.size());
+    }
+
+}
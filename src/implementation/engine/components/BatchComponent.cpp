@@ -1,4 +1,8 @@
 #include "implementation/engine/components/BatchComponent.hpp"
+#include "interfaces/engine/SceneBase.hpp"
+#include "interfaces/rendering/Camera.hpp"
+
+#include <algorithm>
 
 namespace orbit
 {
@@ -6,9 +10,13 @@ namespace orbit
     BatchComponent::BatchComponent(GameObject* object, ResourceId meshId) :
         Renderable(object)
     {
-        m_mesh = std::make_shared<Mesh<Vertex>>();
-        m_mesh->SetId(meshId);
-        m_mesh->Load();
+        // Components of the same mesh share it, so the render queue can merge their draws
+        m_mesh = ENGINE->RMLoadResource<Mesh<Vertex>>(meshId);
+    }
+
+    BatchComponent::~BatchComponent()
+    {
+        RemoveProxies();
     }
 
     TransformPtr BatchComponent::AddTransform(TransformPtr transform)
@@ -17,21 +25,188 @@ namespace orbit
         return transform;
     }
 
+    bool BatchComponent::RemoveTransform(const TransformPtr& transform)
+    {
+        auto it = std::find(m_transforms.begin(), m_transforms.end(), transform);
+        if (it == m_transforms.end())
+            return false;
+
+        // The per instance arrays are kept in the order of the transforms. They are
+        // filled during Draw, transforms added since then do not have entries yet
+        const auto index = static_cast<size_t>(it - m_transforms.begin());
+        const auto swapRemove = [index](auto& values) {
+            values[index] = values.back();
+            values.pop_back();
+        };
+        if (m_proxies.size() == m_transforms.size())
+        {
+            if (auto spatialIndex = m_spatialIndex.lock())
+                spatialIndex->Remove(m_proxies[index]);
+            swapRemove(m_proxies);
+        }
+        else
+            RemoveProxies();
+        if (m_instanceLods.size() == m_transforms.size())
+            swapRemove(m_instanceLods);
+        else
+            m_instanceLods.clear();
+        swapRemove(m_transforms);
+        return true;
+    }
+
+    void BatchComponent::RemoveProxies() const
+    {
+        if (auto index = m_spatialIndex.lock())
+        {
+            for (auto proxy : m_proxies)
+                index->Remove(proxy);
+        }
+        m_proxies.clear();
+        m_spatialIndex.reset();
+    }
+
+    void BatchComponent::UpdateBounds() const
+    {
+        const auto& bounds = m_mesh->GetBoundingSphere();
+        m_instanceBounds.Resize(m_transforms.size());
+        for (auto i = 0u; i < m_transforms.size(); ++i)
+            m_instanceBounds.Set(i, bounds.Transformed(m_transforms[i]->LocalToWorldMatrix()));
+
+        auto scene = ENGINE->GetCurrentScene();
+        auto index = scene ? scene->GetSpatialIndex() : nullptr;
+        if (index != m_spatialIndex.lock())
+        {
+            RemoveProxies();
+            m_spatialIndex = index;
+        }
+        if (!index)
+            return;
+
+        // RemoveTransform swaps the proxies along with the instances, so proxy i belongs to
+        // instance i. Instances added since the last update get their proxies here
+        for (auto i = 0u; i < m_proxies.size(); ++i)
+            index->Move(m_proxies[i], BoundingBox::FromSphere(m_instanceBounds.Get(i)));
+        for (auto i = m_proxies.size(); i < m_transforms.size(); ++i)
+            m_proxies.push_back(index->Insert(BoundingBox::FromSphere(m_instanceBounds.Get(i)), m_transforms[i].get()));
+    }
+
+    bool BatchComponent::SelectInstances() const
+    {
+        UpdateBounds();
+
+        const auto numLods = m_mesh->NumLods();
+        auto changed = m_instanceLods.size() != m_transforms.size();
+        m_instanceLods.resize(m_transforms.size(), 0u);
+        m_lodInstanceCounts.assign(numLods, 0u);
+
+        auto scene = ENGINE->GetCurrentScene();
+        auto camera = scene ? scene->GetCamera() : nullptr;
+
+        m_previousVisibleInstances.swap(m_visibleInstances);
+        m_visibleInstances.resize(m_transforms.size());
+        if (camera)
+        {
+            const auto frustum = Frustum::FromMatrix(camera->GetViewProjectionMatrix());
+            m_visibleInstances.resize(FrustumCulling::CullSpheres(frustum, m_instanceBounds, m_visibleInstances.data()));
+        }
+        else
+        {
+            for (auto i = 0u; i < m_transforms.size(); ++i)
+                m_visibleInstances[i] = i;
+        }
+        changed |= m_visibleInstances != m_previousVisibleInstances;
+
+        // Culled instances keep their lod, it is the starting point when they become visible again
+        if (numLods > 1u && camera)
+        {
+            const auto view = camera->GetViewMatrix();
+            const auto projection = camera->GetProjectionMatrix();
+            for (auto i : m_visibleInstances)
+            {
+                const auto screenSize = m_instanceBounds.Get(i).ProjectedSize(view, projection);
+                const auto lod = m_mesh->SelectLod(screenSize, m_instanceLods[i]);
+                changed |= lod != m_instanceLods[i];
+                m_instanceLods[i] = lod;
+            }
+        }
+        else
+        {
+            std::fill(m_instanceLods.begin(), m_instanceLods.end(), 0u);
+        }
+
+        for (auto i : m_visibleInstances)
+            ++m_lodInstanceCounts[m_instanceLods[i]];
+        return changed;
+    }
+
+    void BatchComponent::FillInstanceBuffer(InstanceBuffer<Matrix4f>& buffer) const
+    {
+        // Counting sort by lod, so that every lod is a contiguous range of instances
+        std::vector<uint32_t> offsets(m_lodInstanceCounts.size(), 0u);
+        for (auto lod = 1u; lod < offsets.size(); ++lod)
+            offsets[lod] = offsets[lod - 1] + m_lodInstanceCounts[lod - 1];
+
+        // Only the visible instances are written, the buffer uploads the ones that changed
+        buffer.Resize(static_cast<uint32_t>(m_visibleInstances.size()));
+        for (auto i : m_visibleInstances)
+            buffer.SetInstance(offsets[m_instanceLods[i]]++, m_transforms[i]->LocalToWorldMatrix());
+    }
+
+    void BatchComponent::DrawClusters(uint32_t numInstances) const
+    {
+        auto scene = ENGINE->GetCurrentScene();
+        auto camera = scene ? scene->GetCamera() : nullptr;
+        if (!camera)
+        {
+            m_mesh->DrawLod(0u, numInstances);
+            return;
+        }
+
+        const auto view = camera->GetViewMatrix();
+        const Vector3f cameraPosition = view.inverse().block<1, 3>(3, 0).transpose();
+        const auto frustum = Frustum::FromMatrix(camera->GetViewProjectionMatrix());
+
+        // Lod 0 instances keep their relative order in the instance buffer
+        auto instance = 0u;
+        for (auto i : m_visibleInstances)
+        {
+            if (instance == numInstances)
+                break;
+            if (m_instanceLods[i] != 0u)
+                continue;
+            ENGINE->Renderer()->SetDepth((m_transforms[i]->GetCombinedTranslation() - cameraPosition).norm());
+            m_mesh->DrawClusters(m_transforms[i]->LocalToWorldMatrix(), frustum, cameraPosition, instance++);
+        }
+    }
+
+    void BatchComponent::DrawLods() const
+    {
+        auto startInstance = 0u;
+        for (auto lod = 0u; lod < m_lodInstanceCounts.size(); ++lod)
+        {
+            if (lod == 0u && m_mesh->HasClusters() && 
+                m_lodInstanceCounts[lod] > 0u && m_lodInstanceCounts[lod] <= sMaxClusterCulledInstances)
+                DrawClusters(m_lodInstanceCounts[lod]);
+            else if (m_lodInstanceCounts[lod] > 0u)
+                m_mesh->DrawLod(lod, m_lodInstanceCounts[lod], startInstance);
+            startInstance += m_lodInstanceCounts[lod];
+        }
+    }
+
     void BatchComponent::Draw() const
     {
         if (!m_mesh) return;
 
-        VertexBuffer<Matrix4f> transformBuffer;
-        transformBuffer.ResizeBuffer(m_transforms.size());
-        auto i = 0u;
-        for (auto transform : m_transforms)
-            transformBuffer.SetVertex(i++, transform->LocalToWorldMatrix());
+        SelectInstances();
+        if (m_visibleInstances.empty())
+            return;
 
-        transformBuffer.UpdateBuffer();
-        transformBuffer.Bind(1, sizeof(Matrix4f), 0);
+        FillInstanceBuffer(m_instanceBuffer);
+        m_instanceBuffer.UpdateBuffer();
 
-        m_mesh->Bind();
-        m_mesh->Draw(m_transforms.size());        
+        ENGINE->Renderer()->SetInstances(&m_instanceBuffer, sizeof(Matrix4f), m_instanceBuffer.GetInstances());
+        ENGINE->Renderer()->SetGeometry(m_mesh->GetGeometry());
+        DrawLods();
     }
     
 }
\ No newline at end of file
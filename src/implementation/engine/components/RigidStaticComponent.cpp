@@ -13,17 +13,25 @@ namespace orbit
     RigidStaticComponent::RigidStaticComponent(GameObject* boundObject, ResourceId meshId) :
         Physically(boundObject)
     {
-        m_mesh = std::make_shared<Mesh<Vertex>>();
-        m_mesh->SetId(meshId);
-        m_mesh->Load();
+        // Meshes and cooked collision meshes are shared by all components through the resource manager
+        if (ENGINE->RMGetResourceType(meshId) == ResourceType::COLLISION_MESH)
+        {
+            m_collisionMesh = ENGINE->RMLoadResource<CollisionMesh>(meshId);
+            return;
+        }
+        m_mesh = ENGINE->RMLoadResource<Mesh<Vertex>>(meshId);
     }
 
     RigidStaticComponent::~RigidStaticComponent()
     {
+        // All shapes share the material
         std::vector<PxMaterial*> materials;
-        materials.resize(m_shape->getNbMaterials());
-        m_shape->getMaterials(materials.data(), materials.size());
-        PX_RELEASE(m_shape);
+        if (!m_shapes.empty())
+        {
+            materials.resize(m_shapes.front()->getNbMaterials());
+            m_shapes.front()->getMaterials(materials.data(), materials.size());
+        }
+        m_shapes.clear();
         for (auto material : materials)
         {
             PX_RELEASE(material);
@@ -48,28 +56,57 @@ namespace orbit
         return std::make_shared<RigidStaticComponent>(boundObject, meshId);
     }
 
+    void RigidStaticComponent::CreateShape(PxMaterial& material, const PxGeometry& geometry)
+    {
+        m_shapes.emplace_back(ENGINE->GetPhysics()->createShape(geometry, material));
+    }
+
     void RigidStaticComponent::CookBody(MaterialProperties material_p, Vector3f meshScale, size_t vertexPositionOffset)
     {
-        const auto& vertexData = m_mesh->GetVertexBuffer();
-        const auto& indexData = m_mesh->GetIndexBuffer();
+        if (!m_collisionMesh && !m_mesh)
+        {
+            ORBIT_ERROR("Failed to load the collision mesh.");
+            return;
+        }
 
-        std::vector<Vector3f> colliderPositions;
-        colliderPositions.reserve(vertexData->NumVertices());
-        const auto stride = vertexData->GetBufferSize() / vertexData->NumVertices();
-        for (auto i = 0u; i < vertexData->NumVertices(); ++i)
+        auto material = ENGINE->GetPhysics()->createMaterial(
+            material_p.staticFriction, 
+            material_p.dynamicFriction, 
+            material_p.restitution
+        );
+        if (m_collisionMesh)
         {
-            auto position = vertexData->GetVertices().at(i).position;
-            colliderPositions.emplace_back(position);
+            // Convex decompositions are compounds of one shape per hull
+            for (auto part = 0u; part < m_collisionMesh->NumParts(); ++part)
+                CreateShape(*material, m_collisionMesh->GetGeometry(meshScale, part).any());
+            // Without shapes nothing releases the material later
+            if (m_collisionMesh->NumParts() == 0u)
+            {
+                ORBIT_ERROR("The collision mesh has no parts.");
+                PX_RELEASE(material);
+            }
+            return;
         }
 
+        ORBIT_INFO_LEVEL(ORBIT_LEVEL_DEBUG, "Cooking mesh %lld at runtime, let orbtool cook a COLLISION_MESH instead.", m_mesh->GetId());
+        // Pooled meshes have no buffers of their own, copy the full resolution geometry
+        std::vector<Vertex> vertices;
+        std::vector<int32_t> indices;
+        m_mesh->CopyGeometry(&vertices, &indices);
+
+        std::vector<Vector3f> colliderPositions;
+        colliderPositions.reserve(vertices.size());
+        for (const auto& vertex : vertices)
+            colliderPositions.emplace_back(vertex.position);
+
         PxTriangleMeshDesc meshDesc;
         meshDesc.points.count = static_cast<PxU32>(colliderPositions.size());
         meshDesc.points.stride = sizeof(Vector3f);
         meshDesc.points.data = colliderPositions.data();
 
-        meshDesc.triangles.count = static_cast<PxU32>(indexData->NumIndices() / 3);
+        meshDesc.triangles.count = static_cast<PxU32>(indices.size() / 3);
         meshDesc.triangles.stride = 3 * sizeof(uint32_t);
-        meshDesc.triangles.data = indexData->GetIndices().data();
+        meshDesc.triangles.data = indices.data();
 
         PxDefaultMemoryOutputStream writeBuffer;
         PxTriangleMeshCookingResult::Enum result;
@@ -78,20 +115,12 @@ namespace orbit
         {
             PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
             auto colliderMesh = Engine::Get()->GetPhysics()->createTriangleMesh(readBuffer);
-
-            auto material = Engine::Get()->GetPhysics()->createMaterial(
-                material_p.staticFriction, 
-                material_p.dynamicFriction, 
-                material_p.restitution
-            );
-            m_geometry.triangleMesh = colliderMesh;
-            m_geometry.scale = PxMeshScale(Math<float>::EigenToPx3(meshScale));
-
-            m_shape = std::unique_ptr<PxShape, PxDelete<PxShape>>(ENGINE->GetPhysics()->createShape(m_geometry, *material));
+            CreateShape(*material, PxTriangleMeshGeometry(colliderMesh, PxMeshScale(Math<float>::EigenToPx3(meshScale))));
         }
         else
         {
             ORBIT_ERROR("Failed to cook triangle mesh.");
+            PX_RELEASE(material);
         }
     }
 
@@ -103,7 +132,8 @@ namespace orbit
         
         auto id = m_nextId++;
         m_bodies[id] = std::unique_ptr<PxRigidStatic, PxDelete<PxRigidStatic>>(body);
-        body->attachShape(*m_shape);
+        for (const auto& shape : m_shapes)
+            body->attachShape(*shape);
         ENGINE->GetPhysXScene()->addActor(*body);
         return id;
     }
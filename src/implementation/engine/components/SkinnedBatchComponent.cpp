@@ -0,0 +1,159 @@
+#include "implementation/engine/components/SkinnedBatchComponent.hpp"
+#include "implementation/rendering/Skinning.hpp"
+
+#include <algorithm>
+
+namespace orbit
+{
+
+    void SkinnedBatchComponent::BatchGeometry::Bind() const
+    {
+        indices->Bind(0);
+        vertices->Bind(0, sizeof(Vertex), 0);
+    }
+
+    SkinnedBatchComponent::SkinnedBatchComponent(GameObject* object, ResourceId meshId) :
+        Renderable(object)
+    {
+        m_mesh = ENGINE->RMLoadResource<Mesh<Vertex>>(meshId);
+        if (!m_mesh)
+            return;
+        // Static meshes move to the MeshPool and have no buffers to skin from
+        if (!m_mesh->IsSkinned())
+        {
+            ORBIT_ERROR("Mesh %lld is not skinned, draw it with a BatchComponent", meshId);
+            m_mesh = nullptr;
+            return;
+        }
+        m_skeleton = ENGINE->RMLoadResource<Skeleton>(m_mesh->GetSkeletonId());
+    }
+
+    TransformPtr SkinnedBatchComponent::AddInstance(TransformPtr transform, ResourceId clipId, float speed, float offset)
+    {
+        if (!m_mesh)
+            return transform;
+
+        auto clip = ENGINE->RMLoadResource<AnimationClip>(clipId);
+        if (clip && (!m_skeleton || clip->NumTracks() != m_skeleton->NumJoints()))
+        {
+            ORBIT_ERROR("Animation clip %lld does not match the skeleton of mesh %lld", clipId, m_mesh->GetId());
+            clip = nullptr;
+        }
+
+        m_instances.emplace_back(Instance{ transform, clip, speed, offset });
+        return transform;
+    }
+
+    bool SkinnedBatchComponent::BuildBatch() const
+    {
+        if (m_batchSize == m_instances.size())
+            return false;
+        m_batchSize = m_instances.size();
+
+        const auto numVertices = m_mesh->GetVertexBuffer()->NumVertices();
+        const auto& indices = m_mesh->GetIndexBuffer()->GetIndices();
+        m_vertices.ResizeBuffer(static_cast<uint32_t>(numVertices * m_batchSize));
+
+        // Submesh after submesh, so each one stays a single range of the batch
+        std::vector<int32_t> batchIndices;
+        m_submeshes.clear();
+        for (const auto& submesh : m_mesh->GetSubmeshes())
+        {
+            auto range = submesh;
+            range.startVertex = 0u;
+            range.vertexCount = numVertices * m_batchSize;
+            range.startIndex = batchIndices.size();
+            range.indexCount = submesh.indexCount * m_batchSize;
+            for (auto i = 0u; i < m_batchSize; ++i)
+            {
+                const auto base = static_cast<int32_t>(i * numVertices + submesh.startVertex);
+                for (auto index = submesh.startIndex; index < submesh.startIndex + submesh.indexCount; ++index)
+                    batchIndices.push_back(base + indices[index]);
+            }
+            m_submeshes.push_back(range);
+        }
+        m_indices.SetIndices(std::move(batchIndices));
+        m_indices.UpdateBuffer();
+
+        m_geometry.indices = &m_indices;
+        m_geometry.vertices = &m_vertices;
+        return true;
+    }
+
+    void SkinnedBatchComponent::SkinInstances() const
+    {
+        const auto time = static_cast<float>(m_clock.GetElapsedTime().asSeconds());
+        const auto& source = m_mesh->GetVertexBuffer()->GetVertices();
+        const auto& weights = m_mesh->GetSkinWeights();
+        const auto numVertices = source.size();
+        const auto numSkinned = static_cast<uint32_t>(m_skeleton ? std::min(source.size(), weights.size()) : 0u);
+        const auto numJoints = m_skeleton ? m_skeleton->NumJoints() : 0u;
+
+        // Transforms are locked, read them once on this thread instead of from every job
+        m_worldMatrices.resize(m_instances.size());
+        for (auto i = 0u; i < m_instances.size(); ++i)
+            m_worldMatrices[i] = m_instances[i].transform->LocalToWorldMatrix();
+
+        ENGINE->ParallelFor(m_instances.size(), sInstancesPerJob, [&](size_t begin, size_t end) {
+            std::vector<JointPose> poses(numJoints);
+            std::vector<Matrix4f> modelTransforms(numJoints);
+            std::vector<Matrix4f> palette(numJoints);
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto& instance = m_instances[i];
+                const auto& world = m_worldMatrices[i];
+                auto* target = m_vertices.GetVertices().data() + i * numVertices;
+                // The world matrix is folded into the palette, which moves the
+                // vertices to world space at no extra cost per vertex
+                if (instance.clip)
+                {
+                    instance.clip->Sample(instance.offset + time * instance.speed, poses.data());
+                    Skinning::ComputePalette(*m_skeleton, poses.data(), modelTransforms.data(), palette.data());
+                    for (auto& matrix : palette)
+                        matrix = world * matrix;
+                }
+                else
+                {
+                    std::fill(palette.begin(), palette.end(), world);
+                }
+                Skinning::SkinVertices(source.data(), weights.data(), numSkinned, palette.data(), target);
+
+                // Vertices without weights follow the instance
+                const Matrix3f rotation = world.topLeftCorner<3, 3>();
+                for (auto v = numSkinned; v < numVertices; ++v)
+                {
+                    const auto& vertex = source[v];
+                    auto& moved = target[v];
+                    moved.position = (world * Vector4f(vertex.position.x(), vertex.position.y(), vertex.position.z(), 1.f)).head<3>();
+                    moved.normal = (rotation * vertex.normal).normalized();
+                    moved.tangent = (rotation * vertex.tangent).normalized();
+                    moved.uv = vertex.uv;
+                }
+            }
+        });
+    }
+
+    void SkinnedBatchComponent::Draw() const
+    {
+        if (!m_mesh || m_instances.empty()) return;
+
+        const auto rebuilt = BuildBatch();
+        SkinInstances();
+        if (rebuilt)
+            m_vertices.UpdateBuffer();
+        else
+            m_vertices.UpdateRange(0u, m_vertices.NumVertices());
+
+        if (m_transformBuffer.NumVertices() == 0u)
+        {
+            m_transformBuffer.ResizeBuffer(1u);
+            m_transformBuffer.SetVertex(0u, Matrix4f::Identity());
+            m_transformBuffer.UpdateBuffer();
+        }
+        ENGINE->Renderer()->SetInstances(&m_transformBuffer, sizeof(Matrix4f));
+        ENGINE->Renderer()->SetGeometry(&m_geometry);
+        for (const auto& submesh : m_submeshes)
+            ENGINE->Renderer()->Draw(submesh, 1u);
+    }
+
+}
@@ -0,0 +1,59 @@
+#include "implementation/engine/components/SplineFollowerComponent.hpp"
+
+namespace orbit
+{
+
+    SplineFollowerComponent::SplineFollowerComponent(GameObject* object, ResourceId splineId, bool orient) :
+        Updatable(object),
+        m_orient(orient)
+    {
+        m_spline = ENGINE->RMLoadResource<Spline>(splineId);
+        if (!m_spline)
+            ORBIT_ERROR("Unable to load spline %lld, its followers won't move", splineId);
+    }
+
+    TransformPtr SplineFollowerComponent::AddFollower(TransformPtr transform, float distance, float speed, const Vector3f& offset)
+    {
+        m_transforms.push_back(transform);
+        m_distances.push_back(m_spline ? m_spline->WrapDistance(distance) : distance);
+        m_speeds.push_back(speed);
+        m_offsets.push_back(offset);
+        return transform;
+    }
+
+    void SplineFollowerComponent::Update(const Time& dTime)
+    {
+        if (!m_spline || m_transforms.empty())
+            return;
+
+        const auto seconds = static_cast<float>(dTime.asSeconds());
+        const auto count = static_cast<uint32_t>(m_transforms.size());
+        m_positions.resize(count);
+        m_directions.resize(count);
+
+        ENGINE->ParallelFor(count, sFollowersPerJob, [&](size_t begin, size_t end) {
+            // Distances are kept on the spline, so they don't lose precision over time
+            for (auto i = begin; i < end; ++i)
+                m_distances[i] = m_spline->WrapDistance(m_distances[i] + m_speeds[i] * seconds);
+            m_spline->Evaluate(&m_distances[begin], static_cast<uint32_t>(end - begin), &m_positions[begin], &m_directions[begin]);
+
+            for (auto i = begin; i < end; ++i)
+            {
+                // Forward (y) along the spline, up (z) as close to the world's z axis as possible
+                const Vector3f& forward = m_directions[i];
+                Vector3f right = forward.cross(Vector3f::UnitZ());
+                if (right.squaredNorm() < 1e-6f)
+                    right = forward.cross(Vector3f::UnitX());
+                right.normalize();
+                Matrix3f frame;
+                frame << right, forward, right.cross(forward);
+
+                auto& transform = m_transforms[i];
+                transform->SetTranslation(m_positions[i] + frame * m_offsets[i]);
+                if (m_orient)
+                    transform->SetRotation(Quaternionf(frame));
+            }
+        });
+    }
+
+}
@@ -12,20 +12,20 @@ namespace orbit
     {
         if (!m_mesh || !m_transforms.size()) return;
 
-        if (m_recacheNeccessary)
+        // The instances have to be regrouped whenever one of them changes its lod or visibility
+        const auto changed = SelectInstances();
+        if (m_visibleInstances.empty())
+            return;
+        if (changed || m_recacheNeccessary)
         {
             m_recacheNeccessary = false;
-            m_transformBuffer.ResizeBuffer(m_transforms.size());
-            auto i = 0u;
-            for (auto transform : m_transforms)
-                m_transformBuffer.SetVertex(i++, transform->LocalToWorldMatrix());
-
+            FillInstanceBuffer(m_transformBuffer);
             m_transformBuffer.UpdateBuffer();
         }
 
-        m_transformBuffer.Bind(1, sizeof(Matrix4f), 0);
-        m_mesh->Bind();
-        m_mesh->Draw(m_transforms.size());
+        ENGINE->Renderer()->SetInstances(&m_transformBuffer, sizeof(Matrix4f), m_transformBuffer.GetInstances());
+        ENGINE->Renderer()->SetGeometry(m_mesh->GetGeometry());
+        DrawLods();
     }
 
 }
\ No newline at end of file
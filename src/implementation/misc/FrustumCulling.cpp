@@ -0,0 +1,99 @@
+#include "implementation/misc/FrustumCulling.hpp"
+#include "implementation/misc/Simd.hpp"
+
+namespace orbit
+{
+
+    static constexpr uint32_t sBatchSize = 8u;
+
+    // @brief: appends the indices of the set bits without branching. The index of the
+    //  last write never exceeds the index of the sphere, so visible does not overflow
+    static inline uint32_t Compact(uint32_t mask, uint32_t first, uint32_t* visible, uint32_t numVisible)
+    {
+        for (auto bit = 0u; bit < sBatchSize; ++bit)
+        {
+            visible[numVisible] = first + bit;
+            numVisible += (mask >> bit) & 1u;
+        }
+        return numVisible;
+    }
+
+    // @brief: the remaining spheres that do not fill a batch
+    static uint32_t CullTail(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t first, uint32_t* visible, uint32_t numVisible)
+    {
+        for (auto i = first; i < spheres.Size(); ++i)
+        {
+            if (frustum.Intersects(spheres.Get(i)))
+                visible[numVisible++] = i;
+        }
+        return numVisible;
+    }
+
+    uint32_t FrustumCulling::CullSpheres(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible)
+    {
+        return CpuSupportsAvx2() ? CullSpheresAvx2(frustum, spheres, visible) : CullSpheresSse(frustum, spheres, visible);
+    }
+
+    uint32_t FrustumCulling::CullSpheresSse(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible)
+    {
+        const auto count = static_cast<uint32_t>(spheres.Size());
+        const auto numBatched = count - count % sBatchSize;
+        auto numVisible = 0u;
+        for (auto i = 0u; i < numBatched; i += sBatchSize)
+        {
+            // Two halves of 4 spheres, a sphere is visible when it is not completely
+            // behind any plane: dot(normal, center) + distance >= -radius
+            auto mask = 0u;
+            for (auto half = 0u; half < sBatchSize; half += 4u)
+            {
+                const auto x = _mm_loadu_ps(spheres.x.data() + i + half);
+                const auto y = _mm_loadu_ps(spheres.y.data() + i + half);
+                const auto z = _mm_loadu_ps(spheres.z.data() + i + half);
+                const auto negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius.data() + i + half));
+                auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (const auto& plane : frustum.planes)
+                {
+                    auto distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x())), _mm_set1_ps(plane.w()));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y())));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z())));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+                }
+                mask |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << half;
+            }
+            numVisible = Compact(mask, i, visible, numVisible);
+        }
+        return CullTail(frustum, spheres, numBatched, visible, numVisible);
+    }
+
+    ORBIT_TARGET_AVX2 uint32_t FrustumCulling::CullSpheresAvx2(const Frustum& frustum, const BoundingSphereArrays& spheres, uint32_t* visible)
+    {
+        __m256 planes[6][4];
+        for (auto p = 0u; p < 6u; ++p)
+        {
+            for (auto c = 0u; c < 4u; ++c)
+                planes[p][c] = _mm256_set1_ps(frustum.planes[p][c]);
+        }
+
+        const auto count = static_cast<uint32_t>(spheres.Size());
+        const auto numBatched = count - count % sBatchSize;
+        auto numVisible = 0u;
+        for (auto i = 0u; i < numBatched; i += sBatchSize)
+        {
+            const auto x = _mm256_loadu_ps(spheres.x.data() + i);
+            const auto y = _mm256_loadu_ps(spheres.y.data() + i);
+            const auto z = _mm256_loadu_ps(spheres.z.data() + i);
+            const auto negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.radius.data() + i));
+            auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const auto& plane : planes)
+            {
+                auto distance = _mm256_fmadd_ps(x, plane[0], plane[3]);
+                distance = _mm256_fmadd_ps(y, plane[1], distance);
+                distance = _mm256_fmadd_ps(z, plane[2], distance);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+            numVisible = Compact(static_cast<uint32_t>(_mm256_movemask_ps(inside)), i, visible, numVisible);
+        }
+        return CullTail(frustum, spheres, numBatched, visible, numVisible);
+    }
+
+}
@@ -0,0 +1,94 @@
+#include "implementation/misc/Spline.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace orbit
+{
+
+    bool Spline::LoadImpl(std::ifstream* stream)
+    {
+        uint32_t flags = 0u;
+        stream->read((char*)&flags, sizeof(uint32_t));
+        stream->read((char*)&m_numSegments, sizeof(uint32_t));
+        stream->read((char*)&m_numSamples, sizeof(uint32_t));
+        stream->read((char*)&m_length, sizeof(float));
+        if (m_numSegments == 0u || m_numSamples == 0u || !(m_length > 0.f))
+        {
+            ORBIT_ERROR("Spline %lld is empty", GetId());
+            return false;
+        }
+        m_closed = (flags & SPLINE_CLOSED) != 0u;
+        m_sampleScale = m_numSamples / m_length;
+
+        m_controlPoints.resize(3u * m_numSegments + 1u);
+        m_samples.resize(m_numSamples + 1u);
+        stream->read((char*)m_controlPoints.data(), sizeof(Vector3f) * m_controlPoints.size());
+        stream->read((char*)m_samples.data(), sizeof(float) * m_samples.size());
+        return true;
+    }
+
+    void Spline::UnloadImpl()
+    {
+        m_controlPoints.clear();
+        m_samples.clear();
+        m_numSegments = 0u;
+        m_numSamples = 0u;
+        m_length = 0.f;
+    }
+
+    float Spline::WrapDistance(float distance) const
+    {
+        if (!m_closed)
+            return std::clamp(distance, 0.f, m_length);
+        distance = std::fmod(distance, m_length);
+        return distance < 0.f ? distance + m_length : distance;
+    }
+
+    float Spline::ParameterAt(float distance) const
+    {
+        const auto x = WrapDistance(distance) * m_sampleScale;
+        const auto i = std::min(static_cast<uint32_t>(x), m_numSamples - 1u);
+        return m_samples[i] + (m_samples[i + 1u] - m_samples[i]) * (x - i);
+    }
+
+    Vector3f Spline::Evaluate(float parameter) const
+    {
+        const auto segment = std::min(static_cast<uint32_t>(std::max(parameter, 0.f)), m_numSegments - 1u);
+        const auto t = std::clamp(parameter - segment, 0.f, 1.f);
+        const auto s = 1.f - t;
+        const auto* p = &m_controlPoints[segment * 3u];
+        return (s * s * s) * p[0] + (3.f * s * s * t) * p[1] + (3.f * s * t * t) * p[2] + (t * t * t) * p[3];
+    }
+
+    Vector3f Spline::Derivative(float parameter) const
+    {
+        const auto segment = std::min(static_cast<uint32_t>(std::max(parameter, 0.f)), m_numSegments - 1u);
+        const auto t = std::clamp(parameter - segment, 0.f, 1.f);
+        const auto s = 1.f - t;
+        const auto* p = &m_controlPoints[segment * 3u];
+        return (3.f * s * s) * (p[1] - p[0]) + (6.f * s * t) * (p[2] - p[1]) + (3.f * t * t) * (p[3] - p[2]);
+    }
+
+    void Spline::Evaluate(const float* distances, uint32_t count, Vector3f* positions, Vector3f* directions) const
+    {
+        // Table lookup, segment and Bernstein weights without any branches but the clamps
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto parameter = ParameterAt(distances[i]);
+            const auto segment = std::min(static_cast<uint32_t>(parameter), m_numSegments - 1u);
+            const auto t = std::clamp(parameter - segment, 0.f, 1.f);
+            const auto s = 1.f - t;
+            const auto* p = &m_controlPoints[segment * 3u];
+            positions[i] = (s * s * s) * p[0] + (3.f * s * s * t) * p[1] + (3.f * s * t * t) * p[2] + (t * t * t) * p[3];
+            if (directions)
+            {
+                const Vector3f derivative = (s * s) * (p[1] - p[0]) + (2.f * s * t) * (p[2] - p[1]) + (t * t) * (p[3] - p[2]);
+                const auto norm = derivative.norm();
+                directions[i] = norm > 0.f ? Vector3f(derivative / norm) : Vector3f(p[3] - p[0]).normalized();
+            }
+        }
+    }
+
+}
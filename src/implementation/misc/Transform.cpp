@@ -4,60 +4,48 @@ namespace orbit
 {
 
 	Transform::Transform() :
-		m_location(Vector3f::Zero()),
-		m_pivot(Vector3f::Zero()),
-		m_rotation(Quaternionf::Identity()),
-		m_scaling(Vector3f::Ones()),
-		m_isDirty(true),
-		m_isRotationDirty(true),
-		m_cachedRotation(std::make_shared<Matrix3f>())
+		m_handle(TransformSystem::Get().Create())
 	{
 	}
 
-	void Transform::RecalculateMatrix() const
+	Transform::Transform(const Transform& other) :
+		m_handle(TransformSystem::Get().Create())
 	{
-		m_isDirty = false;
-		auto S = Translation3f(m_pivot);
-		auto S_ = Translation3f(-m_pivot);
-
-		auto aS = S * Scaling(m_scaling) * S_;
-		auto aT = Translation3f(m_location);
-		auto aR = S * m_rotation * S_;
-
-		auto a = aT * aR * aS;
-		auto m = a.matrix();
-		if (m_parent)
-			m = m_parent->LocalToWorldMatrix() * m;
+		*this = other;
+	}
 
-		_matrix = m.transpose();
+	Transform::~Transform()
+	{
+		TransformSystem::Get().Release(m_handle);
 	}
 
-	const Matrix3f& Transform::GetRotation() const
+	Transform& Transform::operator=(const Transform& other)
 	{
-		if (m_isRotationDirty)
-		{
-			m_isRotationDirty = false;
-			*m_cachedRotation = m_rotation.toRotationMatrix();
-		}
+		if (this == &other)
+			return *this;
 
-		return *m_cachedRotation;
+		auto& system = TransformSystem::Get();
+		system.SetLocation(m_handle, system.GetLocation(other.m_handle));
+		system.SetRotation(m_handle, system.GetRotation(other.m_handle));
+		system.SetScaling(m_handle, system.GetScaling(other.m_handle));
+		system.SetPivot(m_handle, system.GetPivot(other.m_handle));
+		SetParent(other.m_parent);
+		return *this;
 	}
 
-	Matrix3f& Transform::GetRotation()
+	Matrix3f Transform::GetRotation() const
 	{
-		if (m_isRotationDirty)
-		{
-			m_isRotationDirty = false;
-			*m_cachedRotation = m_rotation.toRotationMatrix();
-		}
+		return GetRotationQuaternion().toRotationMatrix();
+	}
 
-		return *m_cachedRotation;
+	Quaternionf Transform::GetRotationQuaternion() const
+	{
+		return TransformSystem::Get().GetRotation(m_handle);
 	}
 
-	const Matrix4f& Transform::LocalToWorldMatrix() const
+	Matrix4f Transform::LocalToWorldMatrix() const
 	{
-		if (m_isDirty) RecalculateMatrix();
-		return _matrix;
+		return TransformSystem::Get().GetWorldMatrix(m_handle);
 	}
 
 	Matrix4f Transform::WorldToLocalMatrix() const
@@ -67,23 +55,32 @@ namespace orbit
 
 	Matrix3f Transform::GetCombinedRotation() const
 	{
-		if (m_parent)
-			return m_parent->GetCombinedRotation() * GetRotation();
-		return GetRotation();
+		return TransformSystem::Get().GetWorldRotation(m_handle).toRotationMatrix();
+	}
+
+	Vector3f Transform::GetTranslation() const
+	{
+		return TransformSystem::Get().GetLocation(m_handle);
 	}
 
 	Vector3f Transform::GetCombinedTranslation() const
 	{
-		if (m_parent)
-			return m_parent->GetCombinedTranslation() + m_location;
-		return m_location;
+		return TransformSystem::Get().GetWorldLocation(m_handle);
+	}
+
+	Vector3f Transform::GetScaling() const
+	{
+		return TransformSystem::Get().GetScaling(m_handle);
 	}
 
 	Vector3f Transform::GetCombinedScaling() const
 	{
-		if (m_parent)
-			return m_scaling.cwiseProduct(m_parent->GetCombinedScaling());
-		return m_scaling;
+		return TransformSystem::Get().GetWorldScaling(m_handle);
+	}
+
+	Vector3f Transform::GetOrigin() const
+	{
+		return TransformSystem::Get().GetPivot(m_handle);
 	}
 
 	Vector3f Transform::TransformVector(const Vector3f& vector) const
@@ -140,17 +137,15 @@ namespace orbit
 
 	void Transform::Translate(const Vector3f& translation)
 	{
-		m_location += translation;
-		m_isDirty = true;
+		SetTranslation(GetTranslation() + translation);
 	}
 
 	void Transform::Rotate(const Quaternionf& rotation)
 	{
-		m_rotation = rotation * m_rotation;
-		if (fabsf(1.f - m_rotation.squaredNorm()) < 0.01f)
-			m_rotation.normalize(); // counter floating point arithmetic errors
-		m_isDirty = true;
-		m_isRotationDirty = true;
+		auto rotated = rotation * GetRotationQuaternion();
+		if (fabsf(1.f - rotated.squaredNorm()) < 0.01f)
+			rotated.normalize(); // counter floating point arithmetic errors
+		SetRotation(rotated);
 	}
 
 	void Transform::Rotate(const Vector3f& euler)
@@ -169,8 +164,7 @@ namespace orbit
 
 	void Transform::Scale(const Vector3f& scaling)
 	{
-		m_scaling = m_scaling.cwiseProduct(scaling);
-		m_isDirty = true;
+		SetScaling(GetScaling().cwiseProduct(scaling));
 	}
 
 	void Transform::Scale(float uscale)
@@ -180,57 +174,47 @@ namespace orbit
 
 	void Transform::SetTranslation(const Vector3f& translation)
 	{
-		m_location = translation;
-		m_isDirty = true;
+		TransformSystem::Get().SetLocation(m_handle, translation);
 	}
 
 	void Transform::SetRotation(const Quaternionf& rotation)
 	{
-		m_rotation = rotation;
-		m_isDirty = true;
-		m_isRotationDirty = true;
+		TransformSystem::Get().SetRotation(m_handle, rotation);
 	}
 
 	void Transform::SetRotation(float angle, const Vector3f& axis)
 	{
-		m_rotation = AngleAxisf(angle, axis);
-		m_isDirty = true;
-		m_isRotationDirty = true;
+		SetRotation(Quaternionf(AngleAxisf(angle, axis)));
 	}
 
 	void Transform::SetRotation(const Vector3f& euler)
 	{
-		m_rotation =
+		SetRotation(Quaternionf(
 			AngleAxisf(euler.x(), Vector3f::UnitZ()) *
 			AngleAxisf(euler.y(), Vector3f::UnitY()) *
-			AngleAxisf(euler.z(), Vector3f::UnitX());
-		m_isDirty = true;
-		m_isRotationDirty = true;
+			AngleAxisf(euler.z(), Vector3f::UnitX())
+		));
 	}
 
 	void Transform::SetScaling(const Vector3f& scaling)
 	{
-		m_scaling = scaling;
-		m_isDirty = true;
+		TransformSystem::Get().SetScaling(m_handle, scaling);
 	}
 
 	void Transform::SetScaling(float uscaling)
 	{
-		m_scaling = Vector3f{ uscaling, uscaling, uscaling };
-		m_isDirty = true;
+		SetScaling(Vector3f{ uscaling, uscaling, uscaling });
 	}
 
 	void Transform::SetParent(std::shared_ptr<Transform> parent)
 	{
-		m_parent = parent;
-		m_isDirty = true;
-		m_isRotationDirty = true;
+		if (TransformSystem::Get().SetParent(m_handle, parent ? parent->m_handle : sNullTransform))
+			m_parent = parent;
 	}
 
 	void Transform::SetOrigin(const Vector3f& origin)
 	{
-		m_pivot = origin;
-		m_isDirty = true;
+		TransformSystem::Get().SetPivot(m_handle, origin);
 	}
 
 }
\ No newline at end of file
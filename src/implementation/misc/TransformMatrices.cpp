@@ -0,0 +1,191 @@
+#include "implementation/misc/TransformMatrices.hpp"
+#include "implementation/misc/Simd.hpp"
+
+namespace orbit
+{
+
+    static constexpr uint32_t sBatchSize = 8u;
+
+    // The matrix is translation(location) * translation(pivot) * rotation * scaling * translation(-pivot).
+    // Its upper 3x3 block is the rotation with scaled columns, the translation is
+    // location + pivot - block * pivot. The transposed column major matrix stores
+    // the rows of the matrix one after another
+
+    void TransformMatrices::ComputeOne(const TransformArrays& transforms, uint32_t index, Matrix4f& matrix)
+    {
+        const auto x = transforms.rotation[0][index];
+        const auto y = transforms.rotation[1][index];
+        const auto z = transforms.rotation[2][index];
+        const auto w = transforms.rotation[3][index];
+        const float rotation[3][3] = {
+            { 1.f - 2.f * (y * y + z * z), 2.f * (x * y - z * w), 2.f * (x * z + y * w) },
+            { 2.f * (x * y + z * w), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - x * w) },
+            { 2.f * (x * z - y * w), 2.f * (y * z + x * w), 1.f - 2.f * (x * x + y * y) },
+        };
+
+        auto* rows = matrix.data();
+        for (auto r = 0u; r < 3u; ++r)
+        {
+            auto translation = transforms.location[r][index] + transforms.pivot[r][index];
+            for (auto c = 0u; c < 3u; ++c)
+            {
+                rows[r * 4u + c] = rotation[r][c] * transforms.scaling[c][index];
+                translation -= rows[r * 4u + c] * transforms.pivot[c][index];
+            }
+            rows[r * 4u + 3u] = translation;
+        }
+        rows[12] = 0.f;
+        rows[13] = 0.f;
+        rows[14] = 0.f;
+        rows[15] = 1.f;
+    }
+
+    void TransformMatrices::Compute(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices)
+    {
+        if (CpuSupportsAvx2())
+            ComputeAvx2(transforms, first, count, matrices);
+        else
+            ComputeSse(transforms, first, count, matrices);
+    }
+
+    static inline __m128 Load4(const std::vector<float>& component, uint32_t index)
+    {
+        return _mm_loadu_ps(component.data() + index);
+    }
+
+    ORBIT_TARGET_AVX2 static inline __m256 Load8(const std::vector<float>& component, uint32_t index)
+    {
+        return _mm256_loadu_ps(component.data() + index);
+    }
+
+    // @brief: computes the matrices of 4 transforms, one transform per lane
+    static inline void ComputeFour(const TransformArrays& transforms, uint32_t index, Matrix4f* matrices)
+    {
+        const auto x = Load4(transforms.rotation[0], index);
+        const auto y = Load4(transforms.rotation[1], index);
+        const auto z = Load4(transforms.rotation[2], index);
+        const auto w = Load4(transforms.rotation[3], index);
+        const __m128 scaling[3] = { Load4(transforms.scaling[0], index), Load4(transforms.scaling[1], index), Load4(transforms.scaling[2], index) };
+        const __m128 pivot[3] = { Load4(transforms.pivot[0], index), Load4(transforms.pivot[1], index), Load4(transforms.pivot[2], index) };
+
+        const auto x2 = _mm_add_ps(x, x);
+        const auto y2 = _mm_add_ps(y, y);
+        const auto z2 = _mm_add_ps(z, z);
+        const auto xx = _mm_mul_ps(x, x2);
+        const auto yy = _mm_mul_ps(y, y2);
+        const auto zz = _mm_mul_ps(z, z2);
+        const auto xy = _mm_mul_ps(x, y2);
+        const auto xz = _mm_mul_ps(x, z2);
+        const auto yz = _mm_mul_ps(y, z2);
+        const auto wx = _mm_mul_ps(w, x2);
+        const auto wy = _mm_mul_ps(w, y2);
+        const auto wz = _mm_mul_ps(w, z2);
+        const auto one = _mm_set1_ps(1.f);
+        const __m128 rotation[3][3] = {
+            { _mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_sub_ps(xy, wz), _mm_add_ps(xz, wy) },
+            { _mm_add_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_sub_ps(yz, wx) },
+            { _mm_sub_ps(xz, wy), _mm_add_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)) },
+        };
+
+        for (auto r = 0u; r < 3u; ++r)
+        {
+            // One register per column of the row, transposed into one register per transform
+            __m128 row[4];
+            auto translation = _mm_add_ps(Load4(transforms.location[r], index), pivot[r]);
+            for (auto c = 0u; c < 3u; ++c)
+            {
+                row[c] = _mm_mul_ps(rotation[r][c], scaling[c]);
+                translation = _mm_sub_ps(translation, _mm_mul_ps(row[c], pivot[c]));
+            }
+            row[3] = translation;
+            _MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+            for (auto i = 0u; i < 4u; ++i)
+                _mm_storeu_ps(matrices[i].data() + r * 4u, row[i]);
+        }
+        const auto lastRow = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+        for (auto i = 0u; i < 4u; ++i)
+            _mm_storeu_ps(matrices[i].data() + 12u, lastRow);
+    }
+
+    void TransformMatrices::ComputeSse(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices)
+    {
+        const auto numBatched = count - count % sBatchSize;
+        for (auto i = 0u; i < numBatched; i += sBatchSize)
+        {
+            ComputeFour(transforms, first + i, matrices + i);
+            ComputeFour(transforms, first + i + 4u, matrices + i + 4u);
+        }
+        for (auto i = numBatched; i < count; ++i)
+            ComputeOne(transforms, first + i, matrices[i]);
+    }
+
+    ORBIT_TARGET_AVX2 void TransformMatrices::ComputeAvx2(const TransformArrays& transforms, uint32_t first, uint32_t count, Matrix4f* matrices)
+    {
+        const auto one = _mm256_set1_ps(1.f);
+        const auto lastRow = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+        const auto numBatched = count - count % sBatchSize;
+        for (auto i = 0u; i < numBatched; i += sBatchSize)
+        {
+            const auto index = first + i;
+            const auto x = Load8(transforms.rotation[0], index);
+            const auto y = Load8(transforms.rotation[1], index);
+            const auto z = Load8(transforms.rotation[2], index);
+            const auto w = Load8(transforms.rotation[3], index);
+            const __m256 scaling[3] = { Load8(transforms.scaling[0], index), Load8(transforms.scaling[1], index), Load8(transforms.scaling[2], index) };
+            const __m256 pivot[3] = { Load8(transforms.pivot[0], index), Load8(transforms.pivot[1], index), Load8(transforms.pivot[2], index) };
+
+            const auto x2 = _mm256_add_ps(x, x);
+            const auto y2 = _mm256_add_ps(y, y);
+            const auto z2 = _mm256_add_ps(z, z);
+            const auto xx = _mm256_mul_ps(x, x2);
+            const auto yy = _mm256_mul_ps(y, y2);
+            const auto zz = _mm256_mul_ps(z, z2);
+            const auto xy = _mm256_mul_ps(x, y2);
+            const auto xz = _mm256_mul_ps(x, z2);
+            const auto yz = _mm256_mul_ps(y, z2);
+            const auto wx = _mm256_mul_ps(w, x2);
+            const auto wy = _mm256_mul_ps(w, y2);
+            const auto wz = _mm256_mul_ps(w, z2);
+            const __m256 rotation[3][3] = {
+                { _mm256_sub_ps(one, _mm256_add_ps(yy, zz)), _mm256_sub_ps(xy, wz), _mm256_add_ps(xz, wy) },
+                { _mm256_add_ps(xy, wz), _mm256_sub_ps(one, _mm256_add_ps(xx, zz)), _mm256_sub_ps(yz, wx) },
+                { _mm256_sub_ps(xz, wy), _mm256_add_ps(yz, wx), _mm256_sub_ps(one, _mm256_add_ps(xx, yy)) },
+            };
+
+            for (auto r = 0u; r < 3u; ++r)
+            {
+                __m256 row[4];
+                auto translation = _mm256_add_ps(Load8(transforms.location[r], index), pivot[r]);
+                for (auto c = 0u; c < 3u; ++c)
+                {
+                    row[c] = _mm256_mul_ps(rotation[r][c], scaling[c]);
+                    translation = _mm256_fnmadd_ps(row[c], pivot[c], translation);
+                }
+                row[3] = translation;
+
+                // Transposes the 4x4 blocks of both 128 bit lanes, the lower lane holds
+                // the rows of transforms 0 to 3, the upper one of transforms 4 to 7
+                const auto t0 = _mm256_unpacklo_ps(row[0], row[1]);
+                const auto t1 = _mm256_unpacklo_ps(row[2], row[3]);
+                const auto t2 = _mm256_unpackhi_ps(row[0], row[1]);
+                const auto t3 = _mm256_unpackhi_ps(row[2], row[3]);
+                const __m256 transposed[4] = {
+                    _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+                    _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)),
+                };
+                for (auto j = 0u; j < 4u; ++j)
+                {
+                    _mm_storeu_ps(matrices[i + j].data() + r * 4u, _mm256_castps256_ps128(transposed[j]));
+                    _mm_storeu_ps(matrices[i + j + 4u].data() + r * 4u, _mm256_extractf128_ps(transposed[j], 1));
+                }
+            }
+            for (auto j = 0u; j < sBatchSize; ++j)
+                _mm_storeu_ps(matrices[i + j].data() + 12u, lastRow);
+        }
+        for (auto i = numBatched; i < count; ++i)
+            ComputeOne(transforms, first + i, matrices[i]);
+    }
+
+}
@@ -0,0 +1,141 @@
+#include "implementation/rendering/AnimationClip.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace orbit
+{
+
+    // @method: finds the two keys around a frame
+    // @param t: receives the blend factor between the two keys
+    // @return: the index of the first key
+    static uint32_t FindKey(const uint16_t* frames, uint32_t numKeys, float frame, float* t)
+    {
+        *t = 0.f;
+        if (numKeys < 2u)
+            return 0u;
+
+        const auto it = std::upper_bound(frames, frames + numKeys, frame, [](float value, uint16_t key) {
+            return value < static_cast<float>(key);
+        });
+        const auto index = static_cast<uint32_t>(std::clamp<std::ptrdiff_t>((it - frames) - 1, 0, numKeys - 2));
+        const auto span = static_cast<float>(frames[index + 1u] - frames[index]);
+        *t = std::clamp((frame - frames[index]) / span, 0.f, 1.f);
+        return index;
+    }
+
+    static void Lerp(const float* a, const float* b, float t, float* result)
+    {
+        for (auto i = 0u; i < 3u; ++i)
+            result[i] = a[i] + (b[i] - a[i]) * t;
+    }
+
+    bool AnimationClip::LoadImpl(std::ifstream* stream)
+    {
+        uint32_t numTracks = 0u;
+        m_skeletonId = ReadReferenceId(stream);
+        stream->read((char*)&m_sampleRate, sizeof(float));
+        stream->read((char*)&m_numFrames, sizeof(uint32_t));
+        stream->read((char*)&numTracks, sizeof(uint32_t));
+
+        std::vector<AnimationTrackHeader> headers(numTracks);
+        stream->read((char*)headers.data(), sizeof(AnimationTrackHeader) * numTracks);
+        m_tracks.resize(numTracks);
+        uint32_t numKeys[3] = { 0u, 0u, 0u };
+        for (auto i = 0u; i < numTracks; ++i)
+        {
+            const auto& header = headers[i];
+            if (header.numRotationKeys == 0u || header.numTranslationKeys == 0u || header.numScaleKeys == 0u)
+            {
+                ORBIT_ERROR("Track %u of animation clip %lld has a channel without keys", i, GetId());
+                return false;
+            }
+            m_tracks[i] = Track{
+                numKeys[0], header.numRotationKeys,
+                numKeys[1], header.numTranslationKeys,
+                numKeys[2], header.numScaleKeys
+            };
+            numKeys[0] += header.numRotationKeys;
+            numKeys[1] += header.numTranslationKeys;
+            numKeys[2] += header.numScaleKeys;
+        }
+
+        m_rotationFrames.resize(numKeys[0]);
+        m_rotations.resize(numKeys[0]);
+        m_translationFrames.resize(numKeys[1]);
+        m_translations.resize(numKeys[1] * 3u);
+        m_scaleFrames.resize(numKeys[2]);
+        m_scales.resize(numKeys[2] * 3u);
+        stream->read((char*)m_rotationFrames.data(), sizeof(uint16_t) * m_rotationFrames.size());
+        stream->read((char*)m_rotations.data(), sizeof(QuantizedQuaternion) * m_rotations.size());
+        stream->read((char*)m_translationFrames.data(), sizeof(uint16_t) * m_translationFrames.size());
+        stream->read((char*)m_translations.data(), sizeof(float) * m_translations.size());
+        stream->read((char*)m_scaleFrames.data(), sizeof(uint16_t) * m_scaleFrames.size());
+        stream->read((char*)m_scales.data(), sizeof(float) * m_scales.size());
+        return true;
+    }
+
+    void AnimationClip::UnloadImpl()
+    {
+        m_tracks.clear();
+        m_rotationFrames.clear();
+        m_rotations.clear();
+        m_translationFrames.clear();
+        m_translations.clear();
+        m_scaleFrames.clear();
+        m_scales.clear();
+    }
+
+    void AnimationClip::Sample(float time, JointPose* poses, bool loop) const
+    {
+        const auto duration = GetDuration();
+        if (loop && duration > 0.f)
+        {
+            time = std::fmod(time, duration);
+            if (time < 0.f)
+                time += duration;
+        }
+        const auto frame = std::clamp(time * m_sampleRate, 0.f, static_cast<float>(std::max(m_numFrames, 1u) - 1u));
+
+        for (auto i = 0u; i < m_tracks.size(); ++i)
+        {
+            const auto& track = m_tracks[i];
+            auto& pose = poses[i];
+            float t;
+
+            // Normalized lerp along the shorter arc, like orbtool does when it drops keys
+            auto key = track.firstRotation + FindKey(m_rotationFrames.data() + track.firstRotation, track.numRotations, frame, &t);
+            m_rotations[key].Decode(pose.rotation);
+            if (t > 0.f)
+            {
+                float next[4];
+                m_rotations[key + 1u].Decode(next);
+                const auto dot = pose.rotation[0] * next[0] + pose.rotation[1] * next[1] + pose.rotation[2] * next[2] + pose.rotation[3] * next[3];
+                const auto b = dot < 0.f ? -t : t;
+                auto length = 0.f;
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    pose.rotation[c] = pose.rotation[c] * (1.f - t) + next[c] * b;
+                    length += pose.rotation[c] * pose.rotation[c];
+                }
+                const auto scale = 1.f / std::sqrt(length);
+                for (auto c = 0u; c < 4u; ++c)
+                    pose.rotation[c] *= scale;
+            }
+
+            key = track.firstTranslation + FindKey(m_translationFrames.data() + track.firstTranslation, track.numTranslations, frame, &t);
+            if (t > 0.f)
+                Lerp(&m_translations[key * 3u], &m_translations[(key + 1u) * 3u], t, pose.translation);
+            else
+                std::copy_n(&m_translations[key * 3u], 3u, pose.translation);
+
+            key = track.firstScale + FindKey(m_scaleFrames.data() + track.firstScale, track.numScales, frame, &t);
+            if (t > 0.f)
+                Lerp(&m_scales[key * 3u], &m_scales[(key + 1u) * 3u], t, pose.scale);
+            else
+                std::copy_n(&m_scales[key * 3u], 3u, pose.scale);
+        }
+    }
+
+}
@@ -36,6 +36,8 @@ namespace orbit
         m_timePerParticle(0.f),
         m_running(false)
     {
+        // Particles are PhysX actors, the scene is not thread safe for writes
+        UpdateOnMainThread();
         LoadFromDesc(desc);
     }
 
@@ -120,11 +122,11 @@ namespace orbit
         {
 
             m_transforms->UpdateBuffer();
-            m_transforms->Bind(1, sizeof(Matrix4f), 0);
+            ENGINE->Renderer()->SetInstances(m_transforms.get(), sizeof(Matrix4f), m_transforms->GetVertices().data());
 
             auto mesh = ENGINE->RMLoadResource<Mesh<Vertex>>(m_particleMesh);
 
-            mesh->Bind();
+            ENGINE->Renderer()->SetGeometry(mesh->GetGeometry());
             mesh->Draw(m_transforms->NumVertices());
         }
     }
@@ -0,0 +1,270 @@
+#include "implementation/rendering/RenderQueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace orbit
+{
+
+    static constexpr uint32_t sSortIdBits = 12u;
+    static constexpr uint32_t sDepthBits = 24u;
+    // @brief: marks the end of a group's member list and packets without a group
+    static constexpr uint32_t sNoMember = ~0u;
+
+    uint64_t RenderQueue::SortIndex(uint32_t field, uint64_t id)
+    {
+        // Indices wrap around for more than 4096 ids. Different ids with the
+        // same index are still drawn correctly, they are just not grouped
+        auto it = m_sortIds[field].emplace(id, static_cast<uint32_t>(m_sortIds[field].size())).first;
+        return it->second & ((1u << sSortIdBits) - 1u);
+    }
+
+    uint64_t RenderQueue::ComputeKey(const DrawPacket& packet)
+    {
+        // The bits of positive floats are ordered like the floats, the upper bits
+        // keep the exponent and the most significant bits of the mantissa
+        uint32_t depthBits = 0u;
+        const auto depth = std::max(packet.depth, 0.f);
+        std::memcpy(&depthBits, &depth, sizeof(float));
+        const uint64_t quantizedDepth = depthBits >> (32u - sDepthBits);
+
+        const auto pipeline = SortIndex(0u, packet.submesh.pipelineStateId);
+        const auto material = SortIndex(1u, packet.submesh.materialId);
+        const auto geometry = SortIndex(2u, reinterpret_cast<uint64_t>(packet.geometry));
+        const auto state = (pipeline << (2u * sSortIdBits)) | (material << sSortIdBits) | geometry;
+        const uint64_t pass = static_cast<uint64_t>(packet.pass) << 60u;
+        if (packet.pass == RenderPass::TRANSPARENT_PASS)
+        {
+            const auto farToNear = ~quantizedDepth & ((1ull << sDepthBits) - 1u);
+            return pass | (farToNear << (3u * sSortIdBits)) | state;
+        }
+        return pass | (state << sDepthBits) | quantizedDepth;
+    }
+
+    void RenderQueue::Submit(const DrawPacket& packet)
+    {
+        m_packets.push_back(packet);
+        m_keys.push_back(ComputeKey(packet));
+    }
+
+    const std::vector<const DrawPacket*>& RenderQueue::Sort()
+    {
+        const auto count = static_cast<uint32_t>(m_packets.size());
+        m_order.resize(count);
+        m_sortedOrder.resize(count);
+        m_sortedKeys.resize(count);
+        for (auto i = 0u; i < count; ++i)
+            m_order[i] = i;
+
+        // Least significant digit first radix sort with 8 bit digits. Digits
+        // that are equal for all keys (the unused high bits of the ids) are skipped
+        auto& keys = m_sortKeys;
+        keys.assign(m_keys.begin(), m_keys.end());
+        for (auto shift = 0u; shift < 64u; shift += 8u)
+        {
+            uint32_t histogram[256] = {};
+            for (auto key : keys)
+                ++histogram[(key >> shift) & 0xFFu];
+            if (histogram[(keys.empty() ? 0u : keys[0] >> shift) & 0xFFu] == count)
+                continue;
+
+            uint32_t offset = 0u;
+            for (auto& bucket : histogram)
+            {
+                const auto size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (auto i = 0u; i < count; ++i)
+            {
+                const auto target = histogram[(keys[i] >> shift) & 0xFFu]++;
+                m_sortedKeys[target] = keys[i];
+                m_sortedOrder[target] = m_order[i];
+            }
+            keys.swap(m_sortedKeys);
+            m_order.swap(m_sortedOrder);
+        }
+
+        m_sortedPackets.resize(count);
+        for (auto i = 0u; i < count; ++i)
+            m_sortedPackets[i] = &m_packets[m_order[i]];
+        return m_sortedPackets;
+    }
+
+    static bool IsMergeable(const DrawPacket& packet)
+    {
+        // Transparent packets have to stay in their back to front order
+        return packet.pass == RenderPass::OPAQUE_PASS && packet.instanceData && packet.instances &&
+            packet.instanceStride > 0u && packet.instanceStride % sizeof(InstanceChunk) == 0u;
+    }
+
+    bool RenderQueue::MergeKey::operator==(const MergeKey& other) const
+    {
+        return geometry == other.geometry && pipelineStateId == other.pipelineStateId && materialId == other.materialId &&
+            startVertex == other.startVertex && vertexCount == other.vertexCount &&
+            startIndex == other.startIndex && indexCount == other.indexCount && instanceStride == other.instanceStride;
+    }
+
+    size_t RenderQueue::MergeKeyHash::operator()(const MergeKey& key) const
+    {
+        // The geometry and the index range tell most groups apart
+        auto hash = std::hash<const void*>{}(key.geometry);
+        const auto combine = [&hash](uint64_t value) { hash ^= std::hash<uint64_t>{}(value) + 0x9E3779B97F4A7C15ull + (hash << 6u) + (hash >> 2u); };
+        combine(key.pipelineStateId);
+        combine(key.materialId);
+        combine(key.startIndex);
+        combine(key.indexCount);
+        combine(key.startVertex);
+        combine(key.vertexCount);
+        combine(key.instanceStride);
+        return hash;
+    }
+
+    void RenderQueue::MergeGroup(const std::vector<const DrawPacket*>& sorted, uint32_t group)
+    {
+        const auto head = m_groupHeads[group];
+        if (m_groupMembers[group] == 1u)
+        {
+            m_executedMerges.push_back(static_cast<int32_t>(head));
+            return;
+        }
+
+        // The merged instances start at a multiple of the stride, so that they can be
+        // addressed with startInstance
+        const auto& first = *sorted[head];
+        const auto chunksPerInstance = first.instanceStride / static_cast<uint32_t>(sizeof(InstanceChunk));
+        const auto offset = (static_cast<uint32_t>(m_mergedInstances.size()) + chunksPerInstance - 1u) / chunksPerInstance * chunksPerInstance;
+        m_mergedInstances.resize(offset + m_groupInstances[group] * chunksPerInstance);
+        auto target = offset;
+        for (auto i = head; i != sNoMember; i = m_nextMember[i])
+        {
+            const auto& packet = *sorted[i];
+            const auto* source = static_cast<const uint8_t*>(packet.instanceData) + packet.startInstance * packet.instanceStride;
+            std::memcpy(&m_mergedInstances[target], source, packet.instanceCount * packet.instanceStride);
+            target += packet.instanceCount * chunksPerInstance;
+        }
+
+        auto merged = first;
+        merged.instanceCount = m_groupInstances[group];
+        merged.startInstance = offset / chunksPerInstance;
+        merged.instances = nullptr;
+        merged.instanceData = nullptr;
+        m_mergedPackets.push_back(merged);
+        m_executedMerges.push_back(-static_cast<int32_t>(m_mergedPackets.size()));
+        m_numMergedPackets += m_groupMembers[group];
+    }
+
+    const std::vector<const DrawPacket*>& RenderQueue::MergeInstances(const std::vector<const DrawPacket*>& sorted)
+    {
+        m_mergedPackets.clear();
+        m_mergedInstances.clear();
+        m_executedMerges.clear();
+        m_numMergedPackets = 0u;
+        m_groupIds.clear();
+        m_groupHeads.clear();
+        m_groupTails.clear();
+        m_groupMembers.clear();
+        m_groupInstances.clear();
+
+        // Every mergeable packet is appended to the group of its state and index range
+        const auto count = static_cast<uint32_t>(sorted.size());
+        m_groupOf.assign(count, sNoMember);
+        m_nextMember.assign(count, sNoMember);
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto& packet = *sorted[i];
+            if (!IsMergeable(packet))
+                continue;
+
+            const MergeKey key{ packet.geometry, packet.submesh.pipelineStateId, packet.submesh.materialId,
+                packet.submesh.startVertex, packet.submesh.vertexCount, packet.submesh.startIndex, packet.submesh.indexCount,
+                packet.instanceStride };
+            const auto inserted = m_groupIds.emplace(key, static_cast<uint32_t>(m_groupHeads.size()));
+            const auto group = inserted.first->second;
+            if (inserted.second)
+            {
+                m_groupHeads.push_back(i);
+                m_groupTails.push_back(i);
+                m_groupMembers.push_back(0u);
+                m_groupInstances.push_back(0u);
+            }
+            else
+            {
+                m_nextMember[m_groupTails[group]] = i;
+                m_groupTails[group] = i;
+            }
+            ++m_groupMembers[group];
+            m_groupInstances[group] += packet.instanceCount;
+            m_groupOf[i] = group;
+        }
+
+        // A group is drawn at the position of its head, its other members are skipped
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto group = m_groupOf[i];
+            if (group == sNoMember)
+                m_executedMerges.push_back(static_cast<int32_t>(i));
+            else if (m_groupHeads[group] == i)
+                MergeGroup(sorted, group);
+        }
+
+        // Merged packets are only referenced once they do not move anymore
+        m_executedPackets.resize(m_executedMerges.size());
+        for (auto i = 0u; i < m_executedMerges.size(); ++i)
+        {
+            const auto merge = m_executedMerges[i];
+            m_executedPackets[i] = merge >= 0 ? sorted[merge] : &m_mergedPackets[-merge - 1];
+        }
+        return m_executedPackets;
+    }
+
+    void RenderQueue::SetMergedInstanceBuffer(const InstanceBindable* instances)
+    {
+        for (auto& packet : m_mergedPackets)
+            packet.instances = instances;
+    }
+
+    void RenderQueue::UpdateStats(const std::vector<const DrawPacket*>& executed)
+    {
+        m_stats = RenderQueueStats{};
+        m_stats.numPackets = static_cast<uint32_t>(m_packets.size());
+        m_stats.numDraws = static_cast<uint32_t>(executed.size());
+        m_stats.mergedPackets = m_numMergedPackets;
+        m_stats.mergedDraws = static_cast<uint32_t>(m_mergedPackets.size());
+        for (auto i = 1u; i < executed.size(); ++i)
+        {
+            const auto& previous = *executed[i - 1u];
+            const auto& current = *executed[i];
+            m_stats.pipelineChanges += previous.submesh.pipelineStateId != current.submesh.pipelineStateId;
+            m_stats.materialChanges += previous.submesh.materialId != current.submesh.materialId;
+            m_stats.geometryChanges += previous.geometry != current.geometry;
+            m_stats.instanceChanges += previous.instances != current.instances;
+        }
+        for (auto i = 1u; i < m_packets.size(); ++i)
+        {
+            const auto& previous = m_packets[i - 1u];
+            const auto& current = m_packets[i];
+            m_stats.unsortedPipelineChanges += previous.submesh.pipelineStateId != current.submesh.pipelineStateId;
+            m_stats.unsortedMaterialChanges += previous.submesh.materialId != current.submesh.materialId;
+            m_stats.unsortedGeometryChanges += previous.geometry != current.geometry;
+            m_stats.unsortedInstanceChanges += previous.instances != current.instances;
+        }
+    }
+
+    void RenderQueue::Clear()
+    {
+        // Ids of destroyed geometry would pile up otherwise
+        for (auto& sortIds : m_sortIds)
+        {
+            if (sortIds.size() > (1u << sSortIdBits))
+                sortIds.clear();
+        }
+        m_packets.clear();
+        m_keys.clear();
+        m_sortedPackets.clear();
+        m_executedPackets.clear();
+        m_mergedPackets.clear();
+    }
+
+}
@@ -0,0 +1,50 @@
+#include "implementation/rendering/Skeleton.hpp"
+#include "implementation/misc/Logger.hpp"
+
+#include <algorithm>
+
+namespace orbit
+{
+
+    bool Skeleton::LoadImpl(std::ifstream* stream)
+    {
+        uint32_t numJoints = 0u;
+        stream->read((char*)&numJoints, sizeof(uint32_t));
+        m_names.resize(numJoints);
+        m_parents.resize(numJoints);
+        m_bindPose.resize(numJoints);
+        m_inverseBindPoses.resize(numJoints);
+        for (auto joint = 0u; joint < numJoints; ++joint)
+        {
+            uint32_t nameLen = 0u;
+            stream->read((char*)&nameLen, sizeof(uint32_t));
+            m_names[joint].resize(nameLen);
+            stream->read(m_names[joint].data(), nameLen);
+            stream->read((char*)&m_parents[joint], sizeof(int32_t));
+            stream->read((char*)&m_bindPose[joint], sizeof(JointPose));
+            stream->read((char*)m_inverseBindPoses[joint].data(), sizeof(float) * 16);
+
+            if (m_parents[joint] >= static_cast<int32_t>(joint))
+            {
+                ORBIT_ERROR("Joint %u of skeleton %lld is stored before its parent", joint, GetId());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Skeleton::UnloadImpl()
+    {
+        m_names.clear();
+        m_parents.clear();
+        m_bindPose.clear();
+        m_inverseBindPoses.clear();
+    }
+
+    int32_t Skeleton::FindJoint(const std::string& name) const
+    {
+        auto it = std::find(m_names.begin(), m_names.end(), name);
+        return it != m_names.end() ? static_cast<int32_t>(it - m_names.begin()) : -1;
+    }
+
+}
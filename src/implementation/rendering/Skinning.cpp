@@ -0,0 +1,83 @@
+#include "implementation/rendering/Skinning.hpp"
+
+#include <xmmintrin.h>
+
+namespace orbit
+{
+
+    Matrix4f Skinning::PoseToMatrix(const JointPose& pose)
+    {
+        const Quaternionf rotation(pose.rotation[3], pose.rotation[0], pose.rotation[1], pose.rotation[2]);
+        Matrix4f matrix = Matrix4f::Identity();
+        matrix.topLeftCorner<3, 3>() = rotation.toRotationMatrix() * Map<const Vector3f>(pose.scale).asDiagonal();
+        matrix.block<3, 1>(0, 3) = Map<const Vector3f>(pose.translation);
+        return matrix;
+    }
+
+    void Skinning::ComputePalette(const Skeleton& skeleton, const JointPose* poses, Matrix4f* modelTransforms, Matrix4f* palette)
+    {
+        const auto& parents = skeleton.GetParents();
+        const auto& inverseBindPoses = skeleton.GetInverseBindPoses();
+        // Parents come first, so their model transform is always ready
+        for (auto joint = 0u; joint < parents.size(); ++joint)
+        {
+            const auto local = PoseToMatrix(poses[joint]);
+            modelTransforms[joint] = parents[joint] < 0 ? local : modelTransforms[parents[joint]] * local;
+            palette[joint] = modelTransforms[joint] * inverseBindPoses[joint];
+        }
+    }
+
+    // @method: transforms a direction (w = 0) or a point (w = 1) by the blended columns
+    static inline __m128 Transform(const __m128* columns, const Vector3f& v, bool point)
+    {
+        auto result = _mm_add_ps(
+            _mm_mul_ps(columns[0], _mm_set1_ps(v.x())),
+            _mm_add_ps(
+                _mm_mul_ps(columns[1], _mm_set1_ps(v.y())),
+                _mm_mul_ps(columns[2], _mm_set1_ps(v.z()))));
+        return point ? _mm_add_ps(result, columns[3]) : result;
+    }
+
+    static inline Vector3f Store(__m128 value, bool normalize)
+    {
+        alignas(16) float result[4];
+        _mm_store_ps(result, value);
+        Vector3f v(result[0], result[1], result[2]);
+        if (normalize)
+            v.normalize();
+        return v;
+    }
+
+    void Skinning::SkinVertices(const Vertex* source, const SkinWeights* weights, uint32_t numVertices, const Matrix4f* palette, Vertex* target)
+    {
+        // Eigen stores matrices column by column, each column is one SSE register
+        constexpr float sWeightScale = 1.f / 255.f;
+        for (auto i = 0u; i < numVertices; ++i)
+        {
+            const auto& influence = weights[i];
+            const auto* matrix = palette[influence.joints[0]].data();
+            auto weight = _mm_set1_ps(influence.weights[0] * sWeightScale);
+            __m128 columns[4];
+            for (auto c = 0u; c < 4u; ++c)
+                columns[c] = _mm_mul_ps(_mm_loadu_ps(matrix + c * 4u), weight);
+
+            for (auto j = 1u; j < 4u; ++j)
+            {
+                if (influence.weights[j] == 0u)
+                    continue;
+                matrix = palette[influence.joints[j]].data();
+                weight = _mm_set1_ps(influence.weights[j] * sWeightScale);
+                for (auto c = 0u; c < 4u; ++c)
+                    columns[c] = _mm_add_ps(columns[c], _mm_mul_ps(_mm_loadu_ps(matrix + c * 4u), weight));
+            }
+
+            const auto& vertex = source[i];
+            auto& skinned = target[i];
+            skinned.position = Store(Transform(columns, vertex.position, true), false);
+            skinned.normal = Store(Transform(columns, vertex.normal, false), true);
+            skinned.tangent = Store(Transform(columns, vertex.tangent, false), true);
+            skinned.uv = vertex.uv;
+        }
+    }
+
+}
@@ -1,11 +1,20 @@
 #include "interfaces/engine/SceneBase.hpp"
 #include "implementation/engine/Engine.hpp"
+#include "implementation/engine/TransformSystem.hpp"
 #include "implementation/backends/impl/ConstantBufferImpl.hpp"
 #include "implementation/misc/Logger.hpp"
 
 namespace orbit
 {
 
+    ISceneBase::~ISceneBase()
+    {
+        for (auto& object : m_objectsVector)
+            object->SetRegistry(nullptr);
+        m_objectsMap.clear();
+        m_objectsVector.clear();
+    }
+
     bool ISceneBase::Load()
     {
         m_sceneBuffer = std::make_shared<ConstantBuffer<Matrix4f, Matrix4f, SceneShaderInfo, Light[100]>>();
@@ -25,10 +34,36 @@ namespace orbit
         m_loaded = false;
     }
 
+    static GameObject& ObjectOf(const GObjectPtr& object) { return *object; }
+    template<typename Component>
+    static GameObject& ObjectOf(const ComponentEntry<Component>& entry) { return *entry.object; }
+
+    // @brief: runs the function for objects or component entries. Objects only touch
+    //  their own state, so they run across the workers. Objects that have to be
+    //  updated on the main thread run afterwards
+    template<typename Entries, typename Function>
+    static void RunPhase(const Entries& entries, const Function& function)
+    {
+        ENGINE->ParallelFor(entries.size(), [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                const auto& object = ObjectOf(entries[i]);
+                if (ISceneBase::IsUpdated(object) && !object.IsUpdatedOnMainThread())
+                    function(entries[i]);
+            }
+        });
+        for (const auto& entry : entries)
+        {
+            const auto& object = ObjectOf(entry);
+            if (ISceneBase::IsUpdated(object) && object.IsUpdatedOnMainThread())
+                function(entry);
+        }
+    }
+
     void ISceneBase::Update(const Time& dt)
     {
-        std::vector<std::future<void>> results{};
-        results.reserve(ENGINE->GetParallelRenderCount());
+        // The transforms changed by the last updates are recomputed in one pass
+        TransformSystem::Get().Update();
 
         auto c = m_camera->GetTransform()->GetCombinedTranslation();
 
@@ -46,35 +81,59 @@ namespace orbit
         m_sceneBuffer->UpdateBuffer();
         m_sceneBuffer->BindBuffer(0, { BindShaderType::PixelShader, BindShaderType::VertexShader });
 
-        const auto workPerThread = std::max(static_cast<size_t>(1u), m_objectsVector.size() / ENGINE->GetParallelRenderCount());
-		for (auto i = 0U; i < ENGINE->GetParallelRenderCount(); ++i)
-		{
-			if (i * workPerThread >= m_objectsVector.size())
-				break;
-			
-			auto beginIdx = i * workPerThread;
-			auto endIdx =
-				(i + 1) * workPerThread < m_objectsVector.size()
-				? (i + 1) * workPerThread
-				: m_objectsVector.size();
-
-			auto begin = m_objectsVector.begin() + beginIdx;
-			auto end = m_objectsVector.begin() + endIdx;
-
-			//results.emplace_back(std::async([&](std::vector<GObjectPtr>::iterator begin, std::vector<GObjectPtr>::iterator end) {
-                std::for_each(begin, end, [&](GObjectPtr object) {
-                    if (object->IsLoaded() && object->IsActive())
-                    {
-                        object->Draw();
-                        object->Update(dt);
-                        object->PhysicsUpdate(dt.asMilliseconds());
-                    }
-                });
-            //}, begin, end));
-		}
-
-		for (auto i = 0U; i < results.size(); ++i)
-			results.at(i).wait();
+        // Draw calls are recorded on the render thread and executed sorted by state once
+        // everything is submitted. Objects are drawn before they are updated, like the
+        // camera in the scene buffer
+        auto renderer = ENGINE->Renderer();
+        renderer->BeginQueue();
+        for (const auto& entry : m_componentRegistry.Renderables())
+        {
+            if (IsUpdated(*entry.object))
+                entry.component->Draw();
+        }
+        for (const auto& object : m_objectsVector)
+        {
+            if (IsUpdated(*object))
+                object->Draw();
+        }
+        m_entities.Each<HostedRenderable>([](Entity, HostedRenderable& hosted) {
+            hosted.component->Draw();
+        });
+        renderer->ExecuteQueue();
+
+        // The batches moved their proxies while they were drawn, queries during the
+        // updates see the positions of the drawn frame
+        m_spatialIndex->Refit();
+
+        // Components are updated before the objects, which might read them
+        RunPhase(m_componentRegistry.Updatables(), [&](const ComponentEntry<Updatable>& entry) {
+            entry.component->Update(dt);
+        });
+        RunPhase(m_objectsVector, [&](const GObjectPtr& object) {
+            object->Update(dt);
+        });
+        RunPhase(m_componentRegistry.Physicals(), [&](const ComponentEntry<Physically>& entry) {
+            entry.component->Update(dt.asMilliseconds());
+        });
+        RunPhase(m_objectsVector, [&](const GObjectPtr& object) {
+            object->PhysicsUpdate(dt.asMilliseconds());
+        });
+
+        // Hosted components are stored contiguously per archetype
+        m_entities.EachChunk<HostedUpdatable>([&](size_t count, const Entity*, HostedUpdatable* hosted) {
+            ENGINE->ParallelFor(count, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i)
+                    hosted[i].component->Update(dt);
+            });
+        });
+        m_entities.EachChunk<HostedPhysically>([&](size_t count, const Entity*, HostedPhysically* hosted) {
+            ENGINE->ParallelFor(count, [&](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i)
+                    hosted[i].component->Update(dt.asMilliseconds());
+            });
+        });
+        for (auto& system : m_systems)
+            system(m_entities, dt);
     }
 
     bool ISceneBase::AddObject(const std::string& identifier, GObjectPtr object)
@@ -89,6 +148,7 @@ namespace orbit
 
         m_objectsVector.emplace_back(object);
         m_objectsMap.emplace(identifier, object);
+        object->SetRegistry(&m_componentRegistry);
         object->Init();
         return true;
     }
@@ -108,8 +168,11 @@ namespace orbit
         if (it == m_objectsMap.end())
             return nullptr;
         
+        auto object = it->second;
         m_objectsMap.erase(it);
-        return it->second;
+        m_objectsVector.erase(std::find(m_objectsVector.begin(), m_objectsVector.end(), object));
+        object->SetRegistry(nullptr);
+        return object;
     }
 
     void ISceneBase::RemoveLight(Light* light)
@@ -67,4 +67,69 @@ namespace orbit
         BindHullShaderImpl(id);
     }
 
-}
\ No newline at end of file
+    void IRenderer::SetGeometry(const GeometryBindable* geometry)
+    {
+        m_geometry = geometry;
+        m_depth = 0.f;
+        if (!m_recording && geometry)
+            geometry->Bind();
+    }
+
+    void IRenderer::SetInstances(const InstanceBindable* instances, uint32_t stride, const void* data)
+    {
+        m_instances = instances;
+        m_instanceStride = stride;
+        m_instanceData = data;
+        if (!m_recording && instances)
+            instances->Bind(1, stride, 0);
+    }
+
+    void IRenderer::Draw(const Submesh& submesh, uint32_t instanceCount, uint32_t startInstance)
+    {
+        if (!m_recording)
+        {
+            DrawImpl(submesh, instanceCount, startInstance);
+            return;
+        }
+        m_queue.Submit(DrawPacket{ submesh, instanceCount, startInstance, m_geometry, m_instances, m_instanceStride, m_depth, m_pass, m_instanceData });
+    }
+
+    void IRenderer::BeginQueue()
+    {
+        m_queue.Clear();
+        m_recording = true;
+        m_geometry = nullptr;
+        m_instances = nullptr;
+        m_instanceData = nullptr;
+        m_depth = 0.f;
+        m_pass = RenderPass::OPAQUE_PASS;
+    }
+
+    void IRenderer::ExecuteQueue()
+    {
+        m_recording = false;
+        const auto& sorted = m_queue.Sort();
+        const auto& packets = m_mergeInstances ? m_queue.MergeInstances(sorted) : sorted;
+        if (m_mergeInstances && !m_queue.GetMergedInstances().empty())
+            m_queue.SetMergedInstanceBuffer(UpdateMergedInstancesImpl(m_queue.GetMergedInstances()));
+        m_queue.UpdateStats(packets);
+
+        const GeometryBindable* geometry = nullptr;
+        const InstanceBindable* instances = nullptr;
+        for (const auto packet : packets)
+        {
+            if (packet->geometry != geometry && packet->geometry)
+                packet->geometry->Bind();
+            if (packet->instances != instances && packet->instances)
+                packet->instances->Bind(1, packet->instanceStride, 0);
+            geometry = packet->geometry;
+            instances = packet->instances;
+            DrawImpl(packet->submesh, packet->instanceCount, packet->startInstance);
+        }
+        m_queue.Clear();
+        m_geometry = nullptr;
+        m_instances = nullptr;
+        m_instanceData = nullptr;
+    }
+
+}
@@ -43,7 +43,10 @@ float4 getVertexNormal(float2 uv, float4 inNormal, float4 inTangent)
 		float4 N = inNormal;
 		float3 B = normalize(cross(N.xyz, T.xyz));
 		float3x3 TBN = float3x3(T.xyz, B, N.xyz);
-		float3 normal = normalMap.Sample(MinMagMipLinearWrap, uv).xyz * 2.f - 1.f;
+		// Block compressed normal maps (BC5) only store x and y
+		float3 normal;
+		normal.xy = normalMap.Sample(MinMagMipLinearWrap, uv).xy * 2.f - 1.f;
+		normal.z = sqrt(saturate(1.f - dot(normal.xy, normal.xy)));
 		return normalize(float4(mul(TBN, normal), 0.f));
 	}
 	return inNormal;